@@ -0,0 +1,77 @@
+#include "AllocationTracker.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    // every allocation is prefixed with its size. The header is as large as the maximum alignment so that the
+    // returned pointer stays suitably aligned.
+    constexpr std::size_t HEADER_SIZE = alignof(std::max_align_t);
+
+    std::atomic<std::size_t> current{0};
+    std::atomic<std::size_t> peak{0};
+    std::atomic<std::size_t> count{0};
+
+    void *tracked_allocate(std::size_t size) {
+        auto *block = static_cast<unsigned char *>(std::malloc(size + HEADER_SIZE));
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        *reinterpret_cast<std::size_t *>(block) = size;
+        const auto now = current.fetch_add(size) + size;
+        auto previous_peak = peak.load();
+        while (now > previous_peak && !peak.compare_exchange_weak(previous_peak, now)) {}
+        count++;
+        return block + HEADER_SIZE;
+    }
+
+    void tracked_free(void *pointer) noexcept {
+        if (pointer != nullptr) {
+            auto *block = static_cast<unsigned char *>(pointer) - HEADER_SIZE;
+            current.fetch_sub(*reinterpret_cast<std::size_t *>(block));
+            std::free(block);
+        }
+    }
+}
+
+void *operator new(std::size_t size) {
+    return tracked_allocate(size);
+}
+
+void *operator new[](std::size_t size) {
+    return tracked_allocate(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+    tracked_free(pointer);
+}
+
+namespace CloudSync::bench {
+    void AllocationTracker::reset_peak() {
+        peak = current.load();
+    }
+
+    std::size_t AllocationTracker::current_bytes() {
+        return current;
+    }
+
+    std::size_t AllocationTracker::peak_bytes() {
+        return peak;
+    }
+
+    std::size_t AllocationTracker::allocations() {
+        return count;
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+namespace CloudSync::bench {
+    /**
+     * Keeps track of the heap memory that is allocated through the global `operator new` of the benchmark
+     * executable.
+     */
+    class AllocationTracker {
+    public:
+        /// Resets the peak to the amount of memory that is currently allocated.
+        static void reset_peak();
+
+        /// @return bytes that are currently allocated.
+        static std::size_t current_bytes();
+
+        /// @return highest amount of allocated bytes since the last call to `reset_peak()`.
+        static std::size_t peak_bytes();
+
+        /// @return number of allocations since the start of the program.
+        static std::size_t allocations();
+    };
+}
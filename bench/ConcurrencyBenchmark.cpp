@@ -0,0 +1,101 @@
+#include "CloudSync/TransferScheduler.hpp"
+#include "CloudSync/exceptions/cloud/CloudException.hpp"
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace Catch;
+using namespace CloudSync;
+
+namespace {
+    constexpr int TRANSFERS = 300;
+    constexpr int CAPACITY = 4;
+    constexpr std::size_t WORKERS = 16;
+    constexpr auto TRANSFER_TIME = std::chrono::milliseconds(5);
+    constexpr auto THROTTLE_TIME = std::chrono::milliseconds(1);
+
+    /// a provider that throttles every request beyond the first `CAPACITY` ones in flight
+    class ThrottlingEndpoint {
+    public:
+        void request() {
+            if (++m_admitted > CAPACITY) {
+                m_admitted--;
+                std::this_thread::sleep_for(THROTTLE_TIME);
+                m_throttled++;
+                throw exceptions::cloud::Throttled("429");
+            }
+            std::this_thread::sleep_for(TRANSFER_TIME);
+            m_admitted--;
+        }
+
+        [[nodiscard]] int throttled() const {
+            return m_throttled;
+        }
+
+    private:
+        std::atomic<int> m_admitted{0};
+        std::atomic<int> m_throttled{0};
+    };
+
+    struct Result {
+        double milliseconds;
+        int throttled;
+        std::size_t final_limit;
+    };
+
+    /// runs the transfers against the endpoint, a throttled one is submitted again like a client would retry it
+    Result run(bool adaptive) {
+        TransferSchedulerOptions options;
+        options.workers = WORKERS;
+        options.interactive_workers = 0;
+        options.max_per_host = WORKERS;
+        options.adaptive_concurrency = adaptive;
+        TransferScheduler scheduler(options);
+        ThrottlingEndpoint endpoint;
+        const auto submit = [&scheduler, &endpoint] {
+            return scheduler.submit(TransferLane::BACKGROUND, "cloud.example.com", [&endpoint] {
+                endpoint.request();
+            });
+        };
+        const auto start = TransferScheduler::Clock::now();
+        std::deque<std::future<void>> running;
+        for (int i = 0; i < TRANSFERS; i++) {
+            running.push_back(submit());
+        }
+        while (!running.empty()) {
+            auto done = std::move(running.front());
+            running.pop_front();
+            try {
+                done.get();
+            } catch (const exceptions::cloud::Throttled &) {
+                running.push_back(submit());
+            }
+        }
+        const auto stats = scheduler.stats();
+        const auto limit = stats.limit_per_host.find("cloud.example.com");
+        return {
+                std::chrono::duration<double, std::milli>(TransferScheduler::Clock::now() - start).count(),
+                endpoint.throttled(),
+                limit == stats.limit_per_host.end() ? WORKERS : limit->second};
+    }
+
+    void print(const std::string &name, const Result &result) {
+        std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(9) << result.milliseconds << " ms"
+                  << std::setw(7) << result.throttled << " throttled"
+                  << "  limit: " << result.final_limit << std::endl;
+    }
+}
+
+TEST_CASE("300 transfers against a provider that takes 4 at once", "[benchmark][concurrency]") {
+    const auto fixed = run(false);
+    const auto adaptive = run(true);
+    print("fixed", fixed);
+    print("adaptive", adaptive);
+    REQUIRE(adaptive.throttled < fixed.throttled);
+}
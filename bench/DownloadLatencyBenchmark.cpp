@@ -0,0 +1,118 @@
+#include "onedrive/OneDriveFile.hpp"
+#include "request/Request.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+using namespace Catch;
+using namespace CloudSync;
+
+namespace {
+    constexpr auto ROUND_TRIP = std::chrono::milliseconds(20);
+    constexpr int READS = 25;
+    const std::string BASE_URL = "https://graph.microsoft.com/v1.0/me/drive/root";
+    const std::string DOWNLOAD_URL = "https://public.ch.files.1drv.com/filedownloadlink";
+
+    /**
+     * Local stand-in for graph: `:/content` answers with a redirect to the download url, which the request follows
+     * like curl does with `set_follow_redirects(true)`. Every hop costs one simulated round trip.
+     */
+    class SimulatedGraph : public request::Request, public std::enable_shared_from_this<SimulatedGraph> {
+    public:
+        [[nodiscard]] std::shared_ptr<Request> clone() const override {
+            return std::make_shared<SimulatedGraph>();
+        }
+
+        std::shared_ptr<Request> resource(const std::string &verb, const std::string &url) override {
+            m_url = url;
+            return shared_from_this();
+        }
+
+        std::shared_ptr<Request> header(const std::string &, const std::string &) override {
+            return shared_from_this();
+        }
+
+        std::shared_ptr<Request> query_param(const std::string &, const std::string &) override {
+            return shared_from_this();
+        }
+
+        std::shared_ptr<Request> postfield(const std::string &, const std::string &) override {
+            return shared_from_this();
+        }
+
+        std::shared_ptr<Request> mime_postfield(const std::string &, const std::string &) override {
+            return shared_from_this();
+        }
+
+        std::shared_ptr<Request> basic_auth(const std::string &, const std::string &) override {
+            return shared_from_this();
+        }
+
+        std::shared_ptr<Request> token_auth(const std::string &) override {
+            return shared_from_this();
+        }
+
+        std::shared_ptr<Request> body(const std::string &) override {
+            return shared_from_this();
+        }
+
+        std::shared_ptr<Request> binary_body(const std::vector<std::uint8_t> &) override {
+            return shared_from_this();
+        }
+
+        std::shared_ptr<Request> file_body(const std::filesystem::path &) override {
+            return shared_from_this();
+        }
+
+        request::StringResponse request() override {
+            if (m_url != DOWNLOAD_URL) {
+                // 302 to the download url
+                std::this_thread::sleep_for(ROUND_TRIP);
+            }
+            std::this_thread::sleep_for(ROUND_TRIP);
+            return request::StringResponse(200, "content");
+        }
+
+        request::BinaryResponse request_binary() override {
+            const auto response = request();
+            return request::BinaryResponse(200, {response.data.begin(), response.data.end()});
+        }
+
+        void set_proxy(const std::string &, const std::string &, const std::string &) override {}
+
+    private:
+        std::string m_url;
+    };
+
+    /// @return the median latency of a read() in milliseconds
+    double median_read_latency(const File &file) {
+        std::vector<double> latencies;
+        for (int i = 0; i < READS; i++) {
+            const auto start = std::chrono::steady_clock::now();
+            REQUIRE(file.read() == "content");
+            latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(latencies.begin(), latencies.end());
+        return latencies[latencies.size() / 2];
+    }
+}
+
+TEST_CASE("reading a onedrive file with a simulated round trip of 20ms", "[benchmark][onedrive]") {
+    const auto request = std::make_shared<SimulatedGraph>();
+    const auto credentials = std::make_shared<credentials::OAuth2CredentialsImpl>(
+            "token", std::chrono::system_clock::now() + std::chrono::hours(1), "refresh");
+    const onedrive::OneDriveFile redirected(BASE_URL, "/file.txt", credentials, request, "file.txt", "revision");
+    const onedrive::OneDriveFile direct(
+            BASE_URL, "/file.txt", credentials, request, "file.txt", "revision", 7, {}, "", std::nullopt, DOWNLOAD_URL);
+
+    const auto redirected_latency = median_read_latency(redirected);
+    const auto direct_latency = median_read_latency(direct);
+    std::cout << std::left << std::setw(10) << "onedrive" << std::fixed << std::setprecision(1)
+              << " :/content: " << redirected_latency << " ms"
+              << "  downloadUrl: " << direct_latency << " ms"
+              << "  (" << redirected_latency / direct_latency << "x)" << std::endl;
+    REQUIRE(direct_latency < redirected_latency);
+}
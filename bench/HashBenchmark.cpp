@@ -0,0 +1,101 @@
+#include "hash/DropboxContentHasher.hpp"
+#include "hash/QuickXorHash.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+using namespace Catch;
+using namespace CloudSync;
+
+namespace {
+    constexpr std::size_t CONTENT_SIZE = 256 * 1024 * 1024;
+    constexpr int RUNS = 3;
+
+    std::vector<std::uint8_t> content() {
+        std::vector<std::uint8_t> data(CONTENT_SIZE);
+        std::uint32_t state = 2463534242;
+        for (auto &byte: data) {
+            // xorshift, so the content doesn't compress into a pattern the cpu could predict
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            byte = static_cast<std::uint8_t>(state);
+        }
+        return data;
+    }
+
+    /// runs `hash` a few times. @return the throughput of the fastest run in GB/s.
+    double throughput(const std::function<std::string()> &hash, std::string &digest) {
+        auto fastest = std::chrono::steady_clock::duration::max();
+        for (int run = 0; run < RUNS; run++) {
+            const auto start = std::chrono::steady_clock::now();
+            digest = hash();
+            fastest = std::min(fastest, std::chrono::steady_clock::now() - start);
+        }
+        return static_cast<double>(CONTENT_SIZE) / std::chrono::duration<double>(fastest).count() / 1e9;
+    }
+
+    void report(const std::string &algorithm, const std::string &baseline_name, double baseline,
+                const std::string &optimized_name, double optimized) {
+        std::cout << std::left << std::setw(10) << algorithm << std::fixed << std::setprecision(2)
+                  << " " << baseline_name << ": " << baseline << " GB/s"
+                  << "  " << optimized_name << ": " << optimized << " GB/s"
+                  << "  (" << std::setprecision(1) << optimized / baseline << "x)" << std::endl;
+    }
+
+    /// QuickXorHash like the reference implementation, which shifts every single byte into the state.
+    std::string quick_xor_bytewise(const std::vector<std::uint8_t> &data) {
+        std::uint64_t cells[3] = {};
+        std::size_t shift = 0;
+        for (const auto byte: data) {
+            const auto cell = shift / 64;
+            const auto offset = shift % 64;
+            const std::size_t bits_in_cell = cell == 2 ? 32 : 64;
+            cells[cell] ^= static_cast<std::uint64_t>(byte) << offset;
+            if (offset > bits_in_cell - 8) {
+                cells[cell == 2 ? 0 : cell + 1] ^= static_cast<std::uint64_t>(byte) >> (bits_in_cell - offset);
+            }
+            shift = (shift + 11) % 160;
+        }
+        // only the state is compared, the encoding isn't part of the measurement
+        return std::to_string(cells[0]) + std::to_string(cells[1]) + std::to_string(cells[2] & 0xffffffff);
+    }
+}
+
+TEST_CASE("dropbox content hash of 256 MiB", "[benchmark][hash][dropbox]") {
+    const auto data = content();
+    std::string single_digest;
+    std::string parallel_digest;
+    const auto single = throughput([&data] {
+        hash::DropboxContentHasher hasher(1);
+        hasher.update(data);
+        return hasher.finish();
+    }, single_digest);
+    const auto parallel = throughput([&data] {
+        hash::DropboxContentHasher hasher;
+        hasher.update(data);
+        return hasher.finish();
+    }, parallel_digest);
+    report("dropbox", "1 thread", single,
+           std::to_string(std::max(1u, std::thread::hardware_concurrency())) + " threads", parallel);
+    REQUIRE(single_digest == parallel_digest);
+}
+
+TEST_CASE("QuickXorHash of 256 MiB", "[benchmark][hash][onedrive]") {
+    const auto data = content();
+    std::string bytewise_digest;
+    std::string folded_digest;
+    const auto bytewise = throughput([&data] {
+        return quick_xor_bytewise(data);
+    }, bytewise_digest);
+    const auto folded = throughput([&data] {
+        hash::QuickXorHash hasher;
+        hasher.update(data);
+        return hasher.finish();
+    }, folded_digest);
+    report("quickxor", "bytewise", bytewise, "folded", folded);
+}
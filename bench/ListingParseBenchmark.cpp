@@ -0,0 +1,133 @@
+#include "AllocationTracker.hpp"
+#include "fixtures/ListingFixtures.hpp"
+#include "request/JsonRecordReader.hpp"
+#include <catch2/catch.hpp>
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace CloudSync::bench;
+using json = nlohmann::json;
+
+namespace {
+    constexpr std::size_t PAGE_SIZE = 2000;
+
+    /// the strings the providers copy out of each listing entry
+    struct Entry {
+        std::string name;
+        std::string path;
+        std::string revision;
+        std::string type;
+    };
+
+    std::vector<Entry> dropbox_dom(const std::string &data) {
+        std::vector<Entry> entries;
+        const auto page = json::parse(data);
+        for (const auto &entry: page.at("entries")) {
+            entries.push_back({entry.at("name"), entry.at("path_display"), entry.value("rev", ""), entry.at(".tag")});
+        }
+        return entries;
+    }
+
+    std::vector<Entry> graph_dom(const std::string &data) {
+        std::vector<Entry> entries;
+        const auto page = json::parse(data);
+        for (const auto &item: page.at("value")) {
+            entries.push_back({
+                item.at("name"),
+                item.at("parentReference").at("path"),
+                item.at("eTag"),
+                item.find("file") != item.end() ? "file" : "folder"});
+        }
+        return entries;
+    }
+
+    std::vector<Entry> drive_dom(const std::string &data) {
+        std::vector<Entry> entries;
+        const auto page = json::parse(data);
+        for (const auto &file: page.at("files")) {
+            entries.push_back({file.at("name"), file.at("id"), file.at("version"), file.at("mimeType")});
+        }
+        return entries;
+    }
+
+    const std::vector<std::string> DROPBOX_FIELDS = {".tag", "name", "path_display", "rev"};
+    const std::vector<std::string> DROPBOX_PAGE_FIELDS = {"cursor", "has_more"};
+    const std::vector<std::string> GRAPH_FIELDS = {"name", "eTag", "root", "file", "folder", "parentReference/path"};
+    const std::vector<std::string> DRIVE_FIELDS = {"id", "name", "mimeType", "version", "size", "modifiedTime"};
+
+    /// runs `parse` once and reports the highest amount of heap memory that has been in use while doing so.
+    std::size_t peak_memory(const std::function<std::size_t()> &parse) {
+        AllocationTracker::reset_peak();
+        const auto baseline = AllocationTracker::current_bytes();
+        const auto parsed = parse();
+        REQUIRE(parsed == PAGE_SIZE);
+        return AllocationTracker::peak_bytes() - baseline;
+    }
+
+    void report(const std::string &provider, std::size_t page_bytes, std::size_t dom_peak, std::size_t sax_peak) {
+        std::cout << std::left << std::setw(10) << provider
+                  << " page: " << std::setw(9) << page_bytes << " B"
+                  << "  peak DOM: " << std::setw(9) << dom_peak << " B"
+                  << "  peak SAX: " << std::setw(9) << sax_peak << " B"
+                  << "  (" << std::fixed << std::setprecision(1)
+                  << static_cast<double>(dom_peak) / static_cast<double>(sax_peak) << "x)" << std::endl;
+    }
+}
+
+TEST_CASE("parsing a 2000 entry dropbox list_folder page", "[benchmark][dropbox]") {
+    const auto page = fixtures::dropbox_list_folder_page(PAGE_SIZE);
+    report("dropbox", page.size(),
+           peak_memory([&page] { return dropbox_dom(page).size(); }),
+           peak_memory([&page] { return request::JsonRecordReader::read(page, "entries", DROPBOX_FIELDS, DROPBOX_PAGE_FIELDS).records.size(); }));
+
+    BENCHMARK("DOM") {
+        return dropbox_dom(page);
+    };
+    BENCHMARK("SAX") {
+        return request::JsonRecordReader::read(page, "entries", DROPBOX_FIELDS, DROPBOX_PAGE_FIELDS);
+    };
+}
+
+TEST_CASE("parsing a 2000 entry graph children page", "[benchmark][onedrive]") {
+    const auto page = fixtures::graph_children_page(PAGE_SIZE);
+    report("onedrive", page.size(),
+           peak_memory([&page] { return graph_dom(page).size(); }),
+           peak_memory([&page] { return request::JsonRecordReader::read(page, "value", GRAPH_FIELDS).records.size(); }));
+
+    BENCHMARK("DOM") {
+        return graph_dom(page);
+    };
+    BENCHMARK("SAX") {
+        return request::JsonRecordReader::read(page, "value", GRAPH_FIELDS);
+    };
+}
+
+TEST_CASE("parsing a 2000 entry drive files page", "[benchmark][gdrive]") {
+    const auto page = fixtures::drive_v3_files_page(PAGE_SIZE);
+    report("gdrive", page.size(),
+           peak_memory([&page] { return drive_dom(page).size(); }),
+           peak_memory([&page] { return request::JsonRecordReader::read(page, "files", DRIVE_FIELDS).records.size(); }));
+
+    BENCHMARK("DOM") {
+        return drive_dom(page);
+    };
+    BENCHMARK("SAX") {
+        return request::JsonRecordReader::read(page, "files", DRIVE_FIELDS);
+    };
+}
+
+TEST_CASE("size of a 2000 entry drive files page", "[benchmark][gdrive]") {
+    const auto v2_page = fixtures::drive_v2_files_page(PAGE_SIZE);
+    const auto v3_page = fixtures::drive_v3_files_page(PAGE_SIZE);
+    const auto v2_bytes_per_entry = static_cast<double>(v2_page.size()) / PAGE_SIZE;
+    const auto v3_bytes_per_entry = static_cast<double>(v3_page.size()) / PAGE_SIZE;
+    std::cout << std::left << std::setw(10) << "gdrive" << std::fixed << std::setprecision(1)
+              << " v2: " << v2_bytes_per_entry << " B/entry"
+              << "  v3: " << v3_bytes_per_entry << " B/entry"
+              << "  (" << v2_bytes_per_entry / v3_bytes_per_entry << "x)" << std::endl;
+    REQUIRE(v3_page.size() < v2_page.size());
+}
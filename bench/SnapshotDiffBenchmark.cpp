@@ -0,0 +1,146 @@
+#include "AllocationTracker.hpp"
+#include "CloudSync/SnapshotDiff.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace CloudSync::bench;
+
+namespace {
+    struct Snapshots {
+        std::vector<SnapshotEntry> before;
+        std::vector<SnapshotEntry> after;
+    };
+
+    /// two listings in no particular order, the newer one with 1% of the files added, removed & modified each
+    Snapshots snapshots(std::size_t size) {
+        Snapshots snapshots;
+        snapshots.before.reserve(size);
+        snapshots.after.reserve(size);
+        for (std::size_t i = 0; i < size; i++) {
+            auto path = "photos/" + std::to_string(i % 1000) + "/IMG_" + std::to_string(i) + ".jpg";
+            const auto revision = "5e18e1bede" + std::to_string(i);
+            if (i % 100 != 0) {
+                snapshots.before.push_back({path, revision, i});
+            }
+            if (i % 100 != 1) {
+                snapshots.after.push_back({std::move(path), i % 100 == 2 ? revision + "b" : revision, i});
+            }
+        }
+        std::mt19937 random(42);
+        std::shuffle(snapshots.before.begin(), snapshots.before.end(), random);
+        std::shuffle(snapshots.after.begin(), snapshots.after.end(), random);
+        return snapshots;
+    }
+
+    /// how consumers diff listings without `SnapshotDiff`: one snapshot in a hash map, looked up by the other one
+    SnapshotDiff hash_map_diff(std::vector<SnapshotEntry> before, std::vector<SnapshotEntry> after) {
+        std::unordered_map<std::string, SnapshotEntry *> known;
+        for (auto &entry: before) {
+            known[entry.path] = &entry;
+        }
+        SnapshotDiff diff;
+        for (auto &entry: after) {
+            const auto old_entry = known.find(entry.path);
+            if (old_entry == known.end()) {
+                diff.added.push_back(std::move(entry));
+                continue;
+            }
+            if (old_entry->second->revision != entry.revision || old_entry->second->size != entry.size) {
+                diff.modified.push_back(std::move(entry));
+            }
+            known.erase(old_entry);
+        }
+        for (auto &[path, entry]: known) {
+            diff.removed.push_back(std::move(*entry));
+        }
+        return diff;
+    }
+
+    struct Measurement {
+        double milliseconds;
+        std::size_t peak_bytes;
+        SnapshotDiff diff;
+    };
+
+    Measurement measure(const std::function<SnapshotDiff()> &run) {
+        AllocationTracker::reset_peak();
+        const auto baseline = AllocationTracker::current_bytes();
+        const auto start = std::chrono::steady_clock::now();
+        auto diff = run();
+        const auto duration = std::chrono::steady_clock::now() - start;
+        return {std::chrono::duration<double, std::milli>(duration).count(),
+                AllocationTracker::peak_bytes() - baseline, std::move(diff)};
+    }
+
+    void report(const std::string &name, const Measurement &measurement) {
+        std::cout << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(9) << measurement.milliseconds << " ms"
+                  << "  peak: " << std::setw(7) << static_cast<double>(measurement.peak_bytes) / 1024 / 1024 << " MiB"
+                  << std::endl;
+    }
+
+    void compare(std::size_t size) {
+        const auto input = snapshots(size);
+        const auto workers = std::max(1u, std::thread::hardware_concurrency());
+        std::cout << size << " entries, " << workers << " threads" << std::endl;
+
+        // every variant takes the snapshots over, releasing them is part of the measurement
+        auto before = input.before;
+        auto after = input.after;
+        const auto hash_map = measure([&before, &after] {
+            return hash_map_diff(std::move(before), std::move(after));
+        });
+        report("  hash map", hash_map);
+
+        before = input.before;
+        after = input.after;
+        const auto single = measure([&before, &after] {
+            return SnapshotDiff::between(std::move(before), std::move(after), 1);
+        });
+        report("  sorted merge, 1 thread", single);
+
+        before = input.before;
+        after = input.after;
+        const auto parallel = measure([&before, &after] {
+            return SnapshotDiff::between(std::move(before), std::move(after));
+        });
+        report("  sorted merge, parallel", parallel);
+
+        // a snapshot that has been kept from an earlier diff is sorted already
+        before = input.before;
+        std::sort(before.begin(), before.end(), [](const SnapshotEntry &first, const SnapshotEntry &second) {
+            return first.path < second.path;
+        });
+        after = before;
+        const auto presorted = measure([&before, &after] {
+            return SnapshotDiff::between(std::move(before), std::move(after));
+        });
+        report("  sorted input, parallel", presorted);
+
+        REQUIRE(single.diff.added.size() == size / 100);
+        REQUIRE(single.diff.removed.size() == size / 100);
+        REQUIRE(single.diff.modified.size() == size / 100);
+        REQUIRE(hash_map.diff.added.size() == single.diff.added.size());
+        REQUIRE(hash_map.diff.removed.size() == single.diff.removed.size());
+        REQUIRE(hash_map.diff.modified.size() == single.diff.modified.size());
+        REQUIRE(parallel.diff.modified.size() == single.diff.modified.size());
+        REQUIRE(presorted.diff.empty());
+    }
+}
+
+TEST_CASE("diffing listings of 100k entries", "[benchmark][diff]") {
+    compare(100000);
+}
+
+TEST_CASE("diffing listings of 1M entries", "[benchmark][diff]") {
+    compare(1000000);
+}
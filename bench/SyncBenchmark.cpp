@@ -0,0 +1,102 @@
+#include "CloudSync/SyncEngine.hpp"
+#include "fixtures/MemoryCloud.hpp"
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+using namespace Catch;
+using namespace CloudSync;
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr std::size_t DIRECTORIES = 20;
+    constexpr std::size_t FILES_PER_DIRECTORY = 50;
+    constexpr std::size_t FILE_SIZE = 4 * 1024;
+    // every 100th file is changed on each side, about 1% of the tree
+    constexpr std::size_t CHANGE_EVERY = 100;
+
+    std::string file_name(std::size_t index) {
+        return "dir" + std::to_string(index / FILES_PER_DIRECTORY) + "/file" + std::to_string(index) + ".bin";
+    }
+
+    void write_file(const fs::path &file, std::size_t size, char fill) {
+        fs::create_directories(file.parent_path());
+        std::ofstream(file, std::ios::binary) << std::string(size, fill);
+    }
+
+    std::vector<std::uint8_t> read_file(const fs::path &file) {
+        std::ifstream input(file, std::ios::binary);
+        return {std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    }
+
+    void report(const std::string &step, const SyncResult &result, const fixtures::MemoryStore &store,
+                std::chrono::steady_clock::duration duration) {
+        const auto changes = std::max<std::size_t>(result.changes(), 1);
+        std::cout << std::left << std::setw(22) << step << std::right
+                  << " changes: " << std::setw(5) << result.changes()
+                  << "  requests: " << std::setw(5) << store.requests
+                  << "  requests/change: " << std::fixed << std::setprecision(2) << std::setw(6)
+                  << static_cast<double>(store.requests) / static_cast<double>(changes)
+                  << "  bytes/change: " << std::setw(8)
+                  << (store.bytes_uploaded + store.bytes_downloaded) / changes
+                  << "  " << std::setprecision(1)
+                  << std::chrono::duration<double, std::milli>(duration).count() << " ms" << std::endl;
+    }
+
+    SyncResult run(const std::string &step, SyncEngine &engine, fixtures::MemoryStore &store) {
+        store.reset_counters();
+        const auto start = std::chrono::steady_clock::now();
+        auto result = engine.sync();
+        report(step, result, store, std::chrono::steady_clock::now() - start);
+        REQUIRE(result.conflicts.empty());
+        REQUIRE(result.errors.empty());
+        return result;
+    }
+}
+
+TEST_CASE("syncing 1000 files with an in-memory cloud", "[benchmark][sync]") {
+    const auto workspace = fs::temp_directory_path() / ("cloudsync-sync-benchmark-" + std::to_string(
+            std::chrono::steady_clock::now().time_since_epoch().count()));
+    const auto local_root = workspace / "local";
+    const auto store = std::make_shared<fixtures::MemoryStore>();
+    const auto remote_root = std::make_shared<fixtures::MemoryDirectory>(store, "/");
+    const std::size_t files = DIRECTORIES * FILES_PER_DIRECTORY;
+    for (std::size_t i = 0; i < files; i++) {
+        write_file(local_root / file_name(i), FILE_SIZE, 'a');
+    }
+    SyncOptions options;
+    options.prune_unchanged_directories = true;
+    SyncEngine engine(local_root, remote_root, workspace / "state", options);
+
+    const auto initial = run("initial upload", engine, *store);
+    REQUIRE(initial.uploads == files);
+
+    // the uploads have changed the revisions of the directories, which are learned by listing them once more
+    const auto relisted = run("learn new revisions", engine, *store);
+    REQUIRE(relisted.changes() == 0);
+
+    const auto unchanged = run("nothing changed", engine, *store);
+    REQUIRE(unchanged.changes() == 0);
+    REQUIRE(store->requests == 1);
+
+    for (std::size_t i = 0; i < files; i += CHANGE_EVERY) {
+        // the local change alters the size, so it is seen regardless of the resolution of the file times
+        write_file(local_root / file_name(i), FILE_SIZE + 1, 'b');
+        const auto remote_file = fixtures::join("/", file_name(i + CHANGE_EVERY / 2));
+        store->write(remote_file, std::vector<std::uint8_t>(FILE_SIZE, 'c'), "*");
+    }
+    const auto changed = run("1% changed per side", engine, *store);
+    REQUIRE(changed.uploads == files / CHANGE_EVERY);
+    REQUIRE(changed.downloads == files / CHANGE_EVERY);
+
+    for (std::size_t i = 0; i < files; i++) {
+        fixtures::MemoryStore::Node node;
+        REQUIRE(store->find(fixtures::join("/", file_name(i)), node));
+        REQUIRE(node.content == read_file(local_root / file_name(i)));
+    }
+    fs::remove_all(workspace);
+}
@@ -0,0 +1,57 @@
+#include "CloudSync/TransferScheduler.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace Catch;
+using namespace CloudSync;
+
+namespace {
+    constexpr auto TRANSFER_TIME = std::chrono::milliseconds(5);
+    constexpr int BACKGROUND_TRANSFERS = 200;
+    constexpr std::size_t WORKERS = 4;
+
+    /**
+     * Queues a bulk upload of simulated transfers, then a single file open behind it.
+     * @return how long the file open has waited to start, in milliseconds
+     */
+    double open_latency(TransferLane open_lane) {
+        TransferSchedulerOptions options;
+        options.workers = WORKERS;
+        options.interactive_workers = 0;
+        TransferScheduler scheduler(options);
+        std::vector<std::future<void>> bulk;
+        for (int i = 0; i < BACKGROUND_TRANSFERS; i++) {
+            bulk.push_back(scheduler.submit(TransferLane::BACKGROUND, "cloud.example.com", [] {
+                std::this_thread::sleep_for(TRANSFER_TIME);
+            }));
+        }
+        // the open arrives while the bulk upload is running
+        while (scheduler.stats().background.running < WORKERS) {
+            std::this_thread::yield();
+        }
+        const auto submitted = TransferScheduler::Clock::now();
+        TransferScheduler::Clock::time_point started;
+        scheduler.submit(open_lane, "cloud.example.com", [&started] {
+            started = TransferScheduler::Clock::now();
+        }).get();
+        for (auto &transfer: bulk) {
+            transfer.get();
+        }
+        return std::chrono::duration<double, std::milli>(started - submitted).count();
+    }
+}
+
+TEST_CASE("opening a file while 200 uploads of 5ms are queued", "[benchmark][scheduler]") {
+    const auto queued_behind = open_latency(TransferLane::BACKGROUND);
+    const auto interactive = open_latency(TransferLane::INTERACTIVE);
+    std::cout << std::left << std::setw(10) << "scheduler" << std::fixed << std::setprecision(1)
+              << " same lane: " << queued_behind << " ms"
+              << "  interactive lane: " << interactive << " ms"
+              << "  (" << queued_behind / std::max(interactive, 0.1) << "x)" << std::endl;
+    REQUIRE(interactive < queued_behind);
+}
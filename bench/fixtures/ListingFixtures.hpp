@@ -0,0 +1,134 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <string>
+
+/**
+ * Listing pages shaped like the responses recorded from the providers APIs. Names, ids & hashes are
+ * generated so pages of any size can be created.
+ */
+namespace CloudSync::bench::fixtures {
+    using json = nlohmann::json;
+
+    inline std::string padded_id(const std::string &prefix, std::size_t i) {
+        std::string id = std::to_string(i);
+        return prefix + std::string(22 - std::min<std::size_t>(22, id.size()), 'A') + id;
+    }
+
+    /// `POST /2/files/list_folder` response
+    inline std::string dropbox_list_folder_page(std::size_t entries) {
+        json page = {{"entries", json::array()}, {"cursor", "AAEunngK5i6uSxwrSlvTngxpzli3qKoVouhB8LtojjN9gA"}, {"has_more", false}};
+        for (std::size_t i = 0; i < entries; i++) {
+            const std::string name = "document-" + std::to_string(i);
+            if (i % 10 == 0) {
+                page["entries"].push_back({
+                    {".tag", "folder"},
+                    {"name", name},
+                    {"path_lower", "/projects/" + name},
+                    {"path_display", "/Projects/" + name},
+                    {"id", padded_id("id:", i)}
+                });
+            } else {
+                page["entries"].push_back({
+                    {".tag", "file"},
+                    {"name", name + ".txt"},
+                    {"path_lower", "/projects/" + name + ".txt"},
+                    {"path_display", "/Projects/" + name + ".txt"},
+                    {"id", padded_id("id:", i)},
+                    {"client_modified", "2020-01-29T21:00:50Z"},
+                    {"server_modified", "2020-01-29T21:00:50Z"},
+                    {"rev", "0159d4da2a6fc21000000" + std::to_string(1000000 + i)},
+                    {"size", 11048 + i},
+                    {"is_downloadable", true},
+                    {"content_hash", "a59943f6fe5e4cbc5405e1e6a93c95b8e1c5e07c1e6ba6c3bd5e2f2f6a3" + std::to_string(10000 + i)}
+                });
+            }
+        }
+        return page.dump();
+    }
+
+    /// `GET /me/drive/root:/path:/children` response without `$select`
+    inline std::string graph_children_page(std::size_t entries) {
+        json page = {{"@odata.context", "https://graph.microsoft.com/v1.0/$metadata#users('me')/drive/root/children"},
+                     {"value", json::array()}};
+        const json identity = {
+            {"application", {{"displayName", "libCloudSync"}, {"id", "4416d53b"}}},
+            {"user", {{"email", "john@example.com"}, {"id", "6f7b1b0e3d1c2a9e"}, {"displayName", "John Doe"}}}
+        };
+        for (std::size_t i = 0; i < entries; i++) {
+            const std::string name = "document-" + std::to_string(i);
+            const std::string id = padded_id("01BYE5RZ", i);
+            json item = {
+                {"createdDateTime", "2020-01-29T21:00:50Z"},
+                {"eTag", "\"{" + id + "},1\""},
+                {"id", id},
+                {"lastModifiedDateTime", "2020-01-29T21:00:50Z"},
+                {"name", name},
+                {"webUrl", "https://example-my.sharepoint.com/personal/john/Documents/Projects/" + name},
+                {"cTag", "\"c:{" + id + "},1\""},
+                {"size", 11048 + i},
+                {"createdBy", identity},
+                {"lastModifiedBy", identity},
+                {"parentReference", {
+                    {"driveType", "business"},
+                    {"driveId", "b!-RIj2DuyvEyV1T4NlOaMHk8XkS_I8MdFlUCq1BlcjgmhRfAj3-Z8RY2VpuvV_tpd"},
+                    {"id", "01BYE5RZ6QN3ZWBTUFOFD3GSPGOHDJD36K"},
+                    {"path", "/drive/root:/Projects"}
+                }},
+                {"fileSystemInfo", {{"createdDateTime", "2020-01-29T21:00:50Z"}, {"lastModifiedDateTime", "2020-01-29T21:00:50Z"}}}
+            };
+            if (i % 10 == 0) {
+                item["folder"] = {{"childCount", 4}, {"view", {{"viewType", "thumbnails"}, {"sortBy", "name"}, {"sortOrder", "ascending"}}}};
+            } else {
+                item["name"] = name + ".txt";
+                item["@microsoft.graph.downloadUrl"] = "https://example-my.sharepoint.com/personal/john/_layouts/15/download.aspx?UniqueId=" + id + "&Translate=false&tempauth=eyJ0eXAiOiJKV1QiLCJhbGciOiJub25lIn0";
+                item["file"] = {
+                    {"mimeType", "text/plain"},
+                    {"hashes", {{"quickXorHash", "dF3KB9CzGSbOFYG52JXGpk5/l+g="}, {"sha1Hash", "B9E23B8F0A5A1E2D6A57D8D29D3F9E9C9B9E3E38"}}}
+                };
+            }
+            page["value"].push_back(item);
+        }
+        return page.dump();
+    }
+
+    /// `GET /drive/v2/files?fields=items(kind,id,title,mimeType,etag,fileSize,modifiedDate,parents(id,isRoot))` response
+    inline std::string drive_v2_files_page(std::size_t entries) {
+        json page = {{"items", json::array()}};
+        for (std::size_t i = 0; i < entries; i++) {
+            json file = {
+                {"kind", "drive#file"},
+                {"id", padded_id("1dInfWIELU8Hc1sP", i)},
+                {"etag", "\"MTU4MDMzMTY1MDAwMA\""},
+                {"title", "document-" + std::to_string(i) + (i % 10 == 0 ? "" : ".txt")},
+                {"mimeType", i % 10 == 0 ? "application/vnd.google-apps.folder" : "text/plain"},
+                {"modifiedDate", "2020-01-29T21:00:50.000Z"},
+                {"parents", {{{"id", "0ANREbljg-Vs3Uk9PVA"}, {"isRoot", true}}}}
+            };
+            if (i % 10 != 0) {
+                file["fileSize"] = std::to_string(11048 + i);
+            }
+            page["items"].push_back(file);
+        }
+        return page.dump();
+    }
+
+    /// `GET /drive/v3/files?fields=nextPageToken,files(id,name,mimeType,version,size,modifiedTime)` response
+    inline std::string drive_v3_files_page(std::size_t entries) {
+        json page = {{"files", json::array()}};
+        for (std::size_t i = 0; i < entries; i++) {
+            json file = {
+                {"id", padded_id("1dInfWIELU8Hc1sP", i)},
+                {"name", "document-" + std::to_string(i) + (i % 10 == 0 ? "" : ".txt")},
+                {"mimeType", i % 10 == 0 ? "application/vnd.google-apps.folder" : "text/plain"},
+                {"version", std::to_string(1000 + i)},
+                {"modifiedTime", "2020-01-29T21:00:50.000Z"}
+            };
+            if (i % 10 != 0) {
+                file["size"] = std::to_string(11048 + i);
+            }
+            page["files"].push_back(file);
+        }
+        return page.dump();
+    }
+}
@@ -20,7 +20,7 @@ class LibCloudSyncConan(ConanFile):
     license = "AGPL-3.0-or-later"
     generators = "cmake_find_package", "cmake_paths"
     exports = "VERSION"
-    exports_sources = "lib/*", "test/*", "cmake/*", "example/*", "it/*", "VERSION", "LICENSE", "CMakeLists.txt"
+    exports_sources = "lib/*", "test/*", "bench/*", "cmake/*", "example/*", "it/*", "VERSION", "LICENSE", "CMakeLists.txt"
     author = "jothepro"
     options = {
         "shared": [True, False],
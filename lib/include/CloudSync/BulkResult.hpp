@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace CloudSync {
+    /**
+     * @brief Outcome of a single item of a bulk operation like `Directory::remove_many()`.
+     *
+     * A failing item doesn't abort the rest of the operation. Instead the exception that the corresponding single
+     * operation would have thrown is kept in `error`.
+     */
+    struct BulkResult {
+        /// the path as it has been passed to the bulk operation
+        std::filesystem::path path;
+
+        /// the exception this item has failed with, `nullptr` if it succeeded
+        std::exception_ptr error;
+
+        [[nodiscard]] bool ok() const {
+            return !error;
+        }
+
+        /// throws the exception this item has failed with. Does nothing if the item succeeded.
+        void rethrow_if_failed() const {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+
+    /**
+     * @brief Outcome of a single item of a bulk operation that returns a value for every item.
+     * @tparam T the value that is returned for a successful item, e.g. a `ResourceInfo` for `Directory::stat_many()`.
+     */
+    template<typename T>
+    struct BulkValue : public BulkResult {
+        /// only valid if the item succeeded
+        T value{};
+    };
+
+    /// @brief A file for `Directory::upload_many()`.
+    struct FileUpload {
+        /// path of the file, relative to the directory it is uploaded into
+        std::filesystem::path path;
+
+        std::vector<std::uint8_t> content;
+
+        /// last modification of the file, kept in the cloud where the provider allows to set it on upload
+        std::optional<std::chrono::system_clock::time_point> modified;
+    };
+}
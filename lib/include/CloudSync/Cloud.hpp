@@ -32,6 +32,21 @@ namespace CloudSync {
          */
         [[nodiscard]] virtual std::shared_ptr<Directory> root() const = 0;
 
+        /**
+         * Find files & folders anywhere in the cloud. Shorthand for `cloud->root()->search(query, on_page);`.
+         * @code
+         * SearchQuery query;
+         * query.name = "report";
+         * query.kind = ResourceInfo::Kind::FILE;
+         * cloud->search(query, [](const std::vector<SearchResult> &page) {
+         *     // ...
+         *     return true;
+         * });
+         * @endcode
+         * @see Directory::search()
+         */
+        virtual void search(const SearchQuery &query, const SearchPageHandler &on_page) const = 0;
+
 
         /**
          * Invalidates the login credentials to the currently used cloud, if possible.
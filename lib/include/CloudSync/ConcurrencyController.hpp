@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+
+namespace CloudSync {
+    /// @brief Settings of a ConcurrencyController.
+    struct ConcurrencyLimits {
+        /// requests in flight before anything is known about the endpoint
+        std::size_t initial = 4;
+
+        std::size_t min = 1;
+
+        std::size_t max = 64;
+
+        /// the limit is multiplied by this when the endpoint throttles requests or gets slower
+        double backoff = 0.5;
+
+        /// the endpoint counts as slower once requests take this many times as long as the fastest ones recently
+        double latency_tolerance = 2.0;
+
+        /// the limit isn't raised after a round in which more than this share of the requests has failed
+        double max_failure_rate = 0.1;
+    };
+
+    /**
+     * @brief Finds out how many requests an endpoint can take at once, by additive increase & multiplicative
+     * decrease (AIMD).
+     *
+     * Outcomes are counted in rounds of as many requests as the limit allows. After a round in which the latency
+     * has stayed flat and nearly all requests have succeeded, the limit is raised by one. It is multiplied by
+     * `ConcurrencyLimits::backoff` as soon as a request is throttled, e.g. by `exceptions::cloud::Throttled`, and
+     * after a round whose latency has grown beyond `ConcurrencyLimits::latency_tolerance`. A round lowers it once
+     * at most, because the requests in flight when the endpoint has started throttling are likely to fail as well.
+     *
+     * A `Retry-After` of a throttled request pauses the endpoint, see `paused_until()`.
+     * @note All methods are thread-safe.
+     */
+    class ConcurrencyController {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit ConcurrencyController(ConcurrencyLimits limits = {});
+
+        /// @return how many requests should be in flight at most right now
+        [[nodiscard]] std::size_t limit() const;
+
+        /// @return no request should be sent before this time, because the endpoint has asked to retry later
+        [[nodiscard]] Clock::time_point paused_until() const;
+
+        /// records a request that has succeeded after `latency`
+        void succeeded(Clock::duration latency);
+
+        /// records a request that has been throttled, with the delay that the endpoint wants, if it has sent one
+        void throttled(std::optional<Clock::duration> retry_after = std::nullopt);
+
+        /// records a request that has failed for another reason
+        void failed();
+
+        /**
+         * Records a request by the exception it has failed with, `nullptr` if it has succeeded. Throttling, either as
+         * `exceptions::cloud::Throttled` or as the 429 or 503 response it is made of, counts as `throttled()`,
+         * communication & server errors as `failed()`. Any other error is an answer of the endpoint, which counts as
+         * `succeeded()`.
+         */
+        void report(Clock::duration latency, const std::exception_ptr &error);
+
+    private:
+        const ConcurrencyLimits m_limits;
+        mutable std::mutex m_mutex;
+        std::size_t m_limit;
+        Clock::time_point m_paused_until;
+
+        /// lowest latency that has been seen recently, which slower rounds are compared to
+        std::optional<Clock::duration> m_baseline;
+
+        // the current round
+        std::size_t m_round_size = 0;
+        std::size_t m_completed = 0;
+        std::size_t m_failed = 0;
+        Clock::duration m_total_latency{0};
+        std::optional<Clock::duration> m_min_latency;
+        /// the limit has been lowered at the start of the round, it isn't lowered again until the round has ended
+        bool m_lowered = false;
+
+        void lower();
+
+        /// ends the round once `m_round_size` requests have completed
+        void complete_round_if_needed();
+
+        void start_round(bool lowered);
+    };
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace CloudSync {
+    /**
+     * @brief Hash of the content of a file, as reported by the provider.
+     *
+     * Unlike a revision, the hash only depends on the content. Hash a local file with `of_file()` and the same
+     * algorithm to find out if it matches the file in the cloud without downloading it.
+     */
+    struct ContentHash {
+        enum class Algorithm : std::uint8_t {
+            /// [dropbox content hash](https://www.dropbox.com/developers/reference/content-hash)
+            DROPBOX,
+            /// [QuickXorHash](https://learn.microsoft.com/en-us/onedrive/developer/code-snippets/quickxorhash) of onedrive
+            QUICK_XOR,
+            MD5,
+            SHA1,
+            SHA256
+        };
+
+        Algorithm algorithm = Algorithm::SHA256;
+
+        /// the digest in lowercase hex, except for `QUICK_XOR`, which is base64 like onedrive reports it.
+        std::string value;
+
+        bool operator==(const ContentHash &other) const {
+            return algorithm == other.algorithm && value == other.value;
+        }
+
+        bool operator!=(const ContentHash &other) const {
+            return !(*this == other);
+        }
+
+        /**
+         * Hashes a local file. Dropbox hashes are computed on all cores.
+         * @throws std::filesystem::filesystem_error if the file can't be read.
+         */
+        static ContentHash of_file(Algorithm algorithm, const std::filesystem::path &path);
+    };
+}
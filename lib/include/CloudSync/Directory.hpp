@@ -1,7 +1,11 @@
 #pragma once
 
+#include "BulkResult.hpp"
 #include "File.hpp"
 #include "Resource.hpp"
+#include "ResourceInfo.hpp"
+#include "SearchQuery.hpp"
+#include <vector>
 
 namespace CloudSync {
     /**
@@ -20,6 +24,40 @@ namespace CloudSync {
          */
         [[nodiscard]] virtual std::vector<std::shared_ptr<Resource>> list_resources() const = 0;
 
+        /**
+         * list the current directories content as plain values.
+         *
+         * Makes the same requests as `list_resources()`, but doesn't create a File or Directory object for every entry.
+         * Prefer this for large directories and only request full handles for the entries you need with `get_resource()`.
+         * @return name, id, revision, size, modification time & type of every resource in this directory.
+         */
+        [[nodiscard]] virtual std::vector<ResourceInfo> list_resource_info() const = 0;
+
+        /**
+         * Create a handle for an entry of this directory without making a network call.
+         * @param info an entry that has been returned by `list_resource_info()` of this directory.
+         * @return a File or a Directory, depending on `info.kind`.
+         */
+        [[nodiscard]] virtual std::shared_ptr<Resource> get_resource(const ResourceInfo &info) const = 0;
+
+        /**
+         * @note On nextcloud/owncloud the revision of a directory changes whenever anything below it changes, so a
+         *       walk can skip a whole subtree if its revision is still the same. On onedrive it is the `eTag` of the
+         *       folder item.
+         * @return the revision/etag of the directory, or an empty string if the provider doesn't have directory
+         *         revisions (dropbox, google drive, webdav servers that don't report one). Handles that have been
+         *         created without a network call, like the root, don't know their revision until `poll_change()`.
+         */
+        [[nodiscard]] virtual std::string revision() const = 0;
+
+        /**
+         * Checks for a new revision of the directory with a single request, without listing its content. If a new
+         * revision exists, the revision of the directory will be updated.
+         * @return `true` if the revision has changed or hasn't been known before, otherwise `false`. Always `false`
+         *         if the provider doesn't have directory revisions.
+         */
+        virtual bool poll_change() = 0;
+
         /**
          * change directory
          * @note The provided path will **always** be handled as relative path. Leading slashes will be ignored. If you need
@@ -44,6 +82,18 @@ namespace CloudSync {
          */
         virtual std::shared_ptr<Directory> create_directory(const std::filesystem::path &path) const = 0;
 
+        /**
+         * Make sure that a directory exists, like `mkdir -p`.
+         *
+         * Unlike `create_directory()` this doesn't fail if the directory is already there. The folder itself is
+         * requested first, its parents are only looked at if the provider reports them missing. Folders that have
+         * been created or found are remembered by the cloud and not requested again.
+         * @param path to the folder. Intermediates are created if they don't exist.
+         * @throws ResourceConflict if a file is in the way of the folder or one of its parents.
+         * @return the directory. Its modification time is not known.
+         */
+        virtual std::shared_ptr<Directory> ensure_directory(const std::filesystem::path &path) const = 0;
+
         /**
          * Create a new file.
          * @param path to the new file. Intermediate folders are created if they don't exist.
@@ -51,11 +101,74 @@ namespace CloudSync {
          */
         virtual std::shared_ptr<File> create_file(const std::filesystem::path &path) const = 0;
 
+        /**
+         * Create a new file with content, in a single request where the provider allows it.
+         * @note The content is sent as a whole. Use `File::upload()` for large files.
+         * @param path to the new file. Intermediate folders are created if they don't exist.
+         * @throws ResourceConflict if a resource already exists at `path`. It is never overwritten.
+         * @return the newly created file
+         */
+        virtual std::shared_ptr<File> create_file(
+                const std::filesystem::path &path, const std::vector<std::uint8_t> &content) const = 0;
+
         /**
          * get file from path
          * @param path to the file. The file must already exist.
          * @return the requested file
          */
         virtual std::shared_ptr<File> get_file(const std::filesystem::path &path) const = 0;
+
+        /**
+         * Remove many files & folders with as few requests as the provider allows.
+         * @param paths relative paths of the resources to remove.
+         * @return one result per path, in the order of `paths`. Failed items hold the exception that `remove()` would
+         * have thrown for them.
+         */
+        virtual std::vector<BulkResult> remove_many(const std::vector<std::filesystem::path> &paths) const = 0;
+
+        /**
+         * Create many directories with as few requests as the provider allows.
+         * @param paths relative paths of the new folders. Intermediates are created if they don't exist.
+         * @return one result per path, in the order of `paths`, holding the new directory or the exception that
+         * `create_directory()` would have thrown.
+         */
+        virtual std::vector<BulkValue<std::shared_ptr<Directory>>> create_directories(
+                const std::vector<std::filesystem::path> &paths) const = 0;
+
+        /**
+         * Look up the metadata of many files & folders with as few requests as the provider allows.
+         * @param paths relative paths of the resources.
+         * @return one result per path, in the order of `paths`. Use `get_resource()` to get a handle for an entry
+         * whose path is a direct child of this directory.
+         */
+        [[nodiscard]] virtual std::vector<BulkValue<ResourceInfo>> stat_many(
+                const std::vector<std::filesystem::path> &paths) const = 0;
+
+        /**
+         * Upload many small files with as few requests as the provider allows. Files that already exist are
+         * overwritten, regardless of their revision. Intermediate folders are created if they don't exist.
+         * @note The content of every file is sent as a whole. Use `File::upload()` for large files.
+         * @return one result per file, in the order of `files`, holding a handle with the new revision of the file or
+         * the exception the upload has failed with.
+         */
+        virtual std::vector<BulkValue<std::shared_ptr<File>>> upload_many(const std::vector<FileUpload> &files) const = 0;
+
+        /**
+         * Find files & folders at any depth below this directory.
+         *
+         * The query is answered by the search of the provider where there is one. Only plain webdav servers are
+         * walked folder by folder. Results are handed to `on_page` as soon as a page of them has arrived.
+         * @param on_page receives the results, one page at a time. Return `false` to stop the search.
+         * @warning this makes one or more network calls every time it is called. Providers update their search
+         * index asynchronously, so resources that have just been changed may be missing.
+         */
+        virtual void search(const SearchQuery &query, const SearchPageHandler &on_page) const = 0;
+
+        /**
+         * Create a handle for this directory that sends its requests over a connection of its own, without making a
+         * network call. Handles are not thread-safe, so every thread that works with the cloud at the same time needs
+         * one. Resources that are reached through the returned directory share its connection.
+         */
+        [[nodiscard]] virtual std::shared_ptr<Directory> with_new_connection() const = 0;
     };
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "ContentHash.hpp"
 #include "Resource.hpp"
+#include <cstdint>
+#include <optional>
 
 namespace CloudSync {
     /**
@@ -20,6 +23,23 @@ namespace CloudSync {
          */
         [[nodiscard]] virtual std::string revision() const = 0;
 
+        /**
+         * @return size of the file in bytes, as reported by the cloud when this file object has been created or last
+         *         updated. Use this together with `modified()` to decide wether a file needs to be downloaded.
+         */
+        [[nodiscard]] virtual std::uint64_t size() const = 0;
+
+        /// @return mimetype of the file, or an empty string if the provider doesn't report one (dropbox).
+        [[nodiscard]] virtual std::string content_type() const = 0;
+
+        /**
+         * @return the hash of the content as reported by the provider: the content hash on dropbox, the QuickXorHash
+         *         (or SHA-256) on onedrive, the MD5 on google drive and the strongest checksum a nextcloud client
+         *         has stored with the file. `std::nullopt` if the provider doesn't report one for this file (webdav,
+         *         google docs, or after a write whose response doesn't include it).
+         */
+        [[nodiscard]] virtual std::optional<ContentHash> content_hash() const = 0;
+
         /// Read the content of the file into a string.
         [[nodiscard]] virtual std::string read() const = 0;
 
@@ -38,6 +58,36 @@ namespace CloudSync {
         /// Write the content of the file from a binary data-structure.
         virtual void write_binary(const std::vector<std::uint8_t>& content) = 0;
 
+        /**
+         * @brief Overwrite a part of the file, without sending the rest of its content.
+         * @throws Resource::ResourceHasChanged if the file has changed on the server.
+         * @throws exceptions::cloud::OperationNotSupported if the provider or server can't write parts of a file. Only
+         * webdav servers based on sabre/dav with partial updates enabled can.
+         * @param offset position of the first byte to overwrite. Writing past the end of the file extends it.
+         * @param data bytes that replace the content at `offset`.
+         */
+        virtual void write_range(std::uint64_t offset, const std::vector<std::uint8_t>& data) = 0;
+
+        /**
+         * @brief Add `data` to the end of the file, without sending its current content.
+         * @throws Resource::ResourceHasChanged if the file has changed on the server.
+         * @throws exceptions::cloud::OperationNotSupported if the provider or server can't write parts of a file.
+         */
+        virtual void append(const std::vector<std::uint8_t>& data) = 0;
+
+        /**
+         * @brief Write the content of the file from a file on the local filesystem.
+         *
+         * Large files are sent in chunks through the upload sessions of the provider, without reading the whole
+         * file into memory. A chunk that fails is sent again and the upload continues where the server has stopped
+         * receiving, instead of starting over. Small files are written with a single request. Plain WebDAV servers
+         * have no upload sessions, the file is streamed to them with a single request.
+         * @throws Resource::ResourceHasChanged if the file has changed on the server.
+         * @throws std::filesystem::filesystem_error if the local file can't be read.
+         * @param local_file path of the file that should be uploaded.
+         */
+        virtual void upload(const std::filesystem::path& local_file) = 0;
+
         /**
          * Checks for a new file version. If a new version exists, the revision of the file will be updated.
          * @return `true` if a new version exists, otherwise `false`
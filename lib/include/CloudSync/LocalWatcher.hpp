@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Directory.hpp"
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace CloudSync {
+    /// @brief Settings of a LocalWatcher.
+    struct LocalWatcherOptions {
+        /// a file is uploaded once it hasn't been written to for this long, so a burst of writes leads to one upload
+        std::chrono::milliseconds quiet_period{500};
+
+        /// a file that is written to all the time is uploaded at the latest this long after it has first changed
+        std::chrono::milliseconds max_delay{10000};
+
+        /// how often directories that can't be watched are scanned for changes instead, and watching them is retried
+        std::chrono::milliseconds rescan_interval{60000};
+
+        /**
+         * at most this many directories are watched, `0` for as many as the kernel allows. The kernel limit
+         * (`fs.inotify.max_user_watches`) is shared by all programs of a user, so a lower limit leaves room for
+         * them.
+         */
+        std::size_t max_watches = 0;
+
+        /**
+         * state file of the SyncEngine that syncs the same directories, empty if there is none. Uploads are recorded
+         * next to it, so the next sync knows that the files are the same on both sides. Without it, the next sync
+         * sees them as changed on both sides, and resolves them as conflicts unless the provider reports a content
+         * hash to compare them with (WebDAV doesn't). It also tells which files in the cloud are unchanged since the
+         * last sync: without it, only files that the watcher has created itself are replaced.
+         */
+        std::filesystem::path state_file;
+    };
+
+    /**
+     * @brief Uploads the files of a local directory to the cloud as soon as they are changed. Only available on linux.
+     *
+     * Changes are seen through inotify instead of scanning the tree, and bursts of changes to the same file are
+     * uploaded once. A file that has been changed in the cloud since it has last been synced or uploaded is never
+     * overwritten: its upload fails, and the next `SyncEngine::sync()` resolves the conflict. Removals are not
+     * uploaded, use `SyncEngine` to bring both sides in sync and the watcher to upload local edits in between, with
+     * `LocalWatcherOptions::state_file` set to the state file of the engine. The engine must run in the same process
+     * as the watcher.
+     *
+     * Directories that can't be watched because the watch limit has been reached are scanned every
+     * `rescan_interval` instead, for files that have been modified since the last scan.
+     * @code
+     * LocalWatcher watcher("/home/john/Documents", cloud->root()->get_directory("Documents"), {},
+     *     [](const std::filesystem::path &path, std::exception_ptr error) {
+     *         if (error) {
+     *             std::cerr << "uploading " << path << " has failed" << std::endl;
+     *         }
+     *     });
+     * watcher.start();
+     * @endcode
+     */
+    class LocalWatcher {
+    public:
+        /**
+         * called from the upload thread after every upload
+         * @param path of the file or directory relative to the local root
+         * @param error why the upload has failed, `nullptr` if it has succeeded. `ResourceHasChanged` or
+         *        `ResourceConflict` if the file has been changed in the cloud, which is left to the next sync.
+         */
+        using UploadHandler = std::function<void(const std::filesystem::path &path, std::exception_ptr error)>;
+
+        /**
+         * @param local_root the local directory to watch
+         * @param remote_root the directory in the cloud that the files are uploaded to
+         */
+        LocalWatcher(
+                std::filesystem::path local_root,
+                std::shared_ptr<Directory> remote_root,
+                LocalWatcherOptions options = {},
+                UploadHandler on_upload = nullptr);
+
+        /// stops the watcher, see `stop()`
+        ~LocalWatcher();
+
+        LocalWatcher(const LocalWatcher &) = delete;
+
+        LocalWatcher &operator=(const LocalWatcher &) = delete;
+
+        /**
+         * Starts watching in a background thread and uploading in another one. Only changes from now on are
+         * uploaded, use `SyncEngine::sync()` to catch up on the ones before.
+         * @throws std::system_error if inotify isn't available or the user has reached the limit of inotify instances.
+         */
+        void start();
+
+        /// Stops watching. Files whose quiet period hasn't ended yet are uploaded before it returns.
+        void stop();
+
+        /// @return the local directories that aren't watched because the watch limit has been reached
+        [[nodiscard]] std::vector<std::filesystem::path> unwatched_directories() const;
+
+    private:
+        class Worker;
+
+        const std::filesystem::path m_local_root;
+        const std::shared_ptr<Directory> m_remote_root;
+        const LocalWatcherOptions m_options;
+        const UploadHandler m_on_upload;
+        std::unique_ptr<Worker> m_worker;
+    };
+}
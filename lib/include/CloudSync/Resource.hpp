@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
@@ -15,6 +16,12 @@ namespace CloudSync {
 
         [[nodiscard]] virtual std::filesystem::path path() const = 0;
 
+        /**
+         * @return last modification time as reported by the cloud when this resource object has been created or last
+         *         updated. Defaults to the epoch if the provider doesn't report one.
+         */
+        [[nodiscard]] virtual std::chrono::system_clock::time_point modified() const = 0;
+
         /**
          * remove this resource.
          *
@@ -29,6 +36,28 @@ namespace CloudSync {
          */
         virtual void remove() = 0;
 
+        /**
+         * Copy this resource on the server, without downloading & uploading its content. Directories are copied with
+         * everything they contain.
+         * @param path destination of the copy. Absolute paths start at the root of the cloud, relative paths at the
+         *        directory that contains this resource, so `copy.txt` creates a copy right next to it. The parent
+         *        directory of the destination must already exist.
+         * @throws exceptions::resource::ResourceConflict if a resource already exists at the destination.
+         * @throws exceptions::resource::PermissionDenied if the destination is the root or lies inside of this directory.
+         * @throws exceptions::cloud::CommunicationError if a provider that copies in the background (OneDrive) hasn't
+         *         finished the copy within 30 minutes. The copy may still appear later.
+         * @return a handle for the copy
+         */
+        virtual std::shared_ptr<Resource> copy_to(const std::filesystem::path &path) const = 0;
+
+        /**
+         * Move or rename this resource on the server. Takes the same destinations as `copy_to()`.
+         *
+         * @warning Stop using this resource object after calling `move_to()`, use the returned handle instead.
+         * @return a handle for the resource at its new location
+         */
+        virtual std::shared_ptr<Resource> move_to(const std::filesystem::path &path) = 0;
+
         /**
          * Wether the Resource is a file or a directory.
          * @return true if resource is a file, false if it is a directory.
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ContentHash.hpp"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace CloudSync {
+    /**
+     * @brief Plain description of a directory entry, as returned by `Directory::list_resource_info()`.
+     *
+     * Unlike a Resource this doesn't hold any connection to the cloud, so large listings can be kept in a single
+     * contiguous array. Use `Directory::get_resource()` to get a File or Directory handle for an entry.
+     */
+    struct ResourceInfo {
+        enum class Kind : std::uint8_t {
+            FILE, DIRECTORY
+        };
+
+        /// name of the file or directory
+        std::string name;
+
+        /// provider specific id of the resource. Empty if the provider addresses resources by path only (webdav).
+        std::string id;
+
+        /// revision/etag of the resource. May be empty for directories.
+        std::string revision;
+
+        /// size in bytes. Always `0` for directories.
+        std::uint64_t size = 0;
+
+        /// last modification time. Defaults to the epoch if the provider didn't report one.
+        std::chrono::system_clock::time_point modified;
+
+        /// mimetype of a file. Empty for directories and if the provider doesn't report one.
+        std::string content_type;
+
+        /// hash of the content of a file, see `File::content_hash()`. Empty for directories.
+        std::optional<ContentHash> content_hash;
+
+        Kind kind = Kind::FILE;
+
+        [[nodiscard]] bool is_file() const {
+            return kind == Kind::FILE;
+        }
+    };
+}
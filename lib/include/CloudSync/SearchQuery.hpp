@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ResourceInfo.hpp"
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace CloudSync {
+    /**
+     * @brief Conditions for `Cloud::search()` & `Directory::search()`. A resource has to fulfill all conditions that
+     * are set. An empty query matches everything.
+     */
+    struct SearchQuery {
+        /// text the name of a resource has to contain, compared case insensitive. Empty matches every name.
+        std::string name;
+
+        /// only look for files or only for directories
+        std::optional<ResourceInfo::Kind> kind;
+
+        /// mimetype a file has to have. Directories and files of providers that don't report one never match.
+        std::string content_type;
+
+        /// only look for resources that have been modified after this point in time
+        std::optional<std::chrono::system_clock::time_point> modified_after;
+
+        /**
+         * Providers interpret a search differently, e.g. by matching whole words only. Their results are narrowed
+         * down with this, so every provider returns the same.
+         * @return true if `info` fulfills all conditions of this query.
+         */
+        [[nodiscard]] bool matches(const ResourceInfo &info) const;
+    };
+
+    /// @brief A resource that has been found by a search.
+    struct SearchResult {
+        /// absolute path of the resource
+        std::filesystem::path path;
+
+        ResourceInfo info;
+    };
+
+    /**
+     * Receives the results of a search, one page at a time.
+     * @return `false` to stop the search, `true` to continue with the next page.
+     */
+    using SearchPageHandler = std::function<bool(const std::vector<SearchResult> &)>;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ResourceInfo.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CloudSync {
+    /// @brief A file or directory in a snapshot of a tree, see `SnapshotDiff`.
+    struct SnapshotEntry {
+        /// path relative to the root of the snapshot. Leading, trailing & repeated slashes and `.` segments are ignored.
+        std::string path;
+
+        /// revision of the resource, see `ResourceInfo::revision`. Leave it empty in both snapshots to compare sizes only.
+        std::string revision;
+
+        std::uint64_t size = 0;
+
+        ResourceInfo::Kind kind = ResourceInfo::Kind::FILE;
+    };
+
+    /**
+     * @brief The differences between two snapshots of the same tree, e.g. two listings of a directory in the cloud
+     * or a listing and a local scan.
+     * @code
+     * std::vector<SnapshotEntry> current;
+     * for (const auto &info: directory->list_resource_info()) {
+     *     current.push_back({info.name, info.revision, info.size, info.kind});
+     * }
+     * const auto diff = SnapshotDiff::between(std::move(previous), current);
+     * @endcode
+     */
+    struct SnapshotDiff {
+        /// entries of the newer snapshot whose path isn't in the older one, sorted by path
+        std::vector<SnapshotEntry> added;
+
+        /// entries of the older snapshot whose path isn't in the newer one, sorted by path
+        std::vector<SnapshotEntry> removed;
+
+        /// entries of the newer snapshot whose revision or size differ from the older one, sorted by path
+        std::vector<SnapshotEntry> modified;
+
+        [[nodiscard]] bool empty() const {
+            return added.empty() && removed.empty() && modified.empty();
+        }
+
+        /**
+         * Compares two snapshots. Both are sorted by their normalized paths, with several threads for large
+         * snapshots, and walked side by side once. Unlike a hash map of one of them, this needs no index of the
+         * entries. Snapshots that are sorted already aren't sorted again, which makes the whole diff take linear time.
+         *
+         * An entry whose kind has changed is reported as removed and added. If a path appears several times in one
+         * snapshot, only one of its entries is used.
+         * @param before the older snapshot
+         * @param after the newer snapshot
+         * @param max_workers threads used for sorting, `0` for one per cpu core
+         */
+        static SnapshotDiff between(
+                std::vector<SnapshotEntry> before, std::vector<SnapshotEntry> after, std::size_t max_workers = 0);
+    };
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "BulkResult.hpp"
+#include "Directory.hpp"
+#include "TransferScheduler.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CloudSync {
+    /// @brief Settings of a SyncEngine.
+    struct SyncOptions {
+        /// number of uploads & downloads that run at the same time, each with a connection of its own
+        std::size_t max_parallel_transfers = 4;
+
+        /**
+         * Runs the transfers in the background lane of this scheduler instead of on threads of their own, so they
+         * give way to interactive transfers of the same scheduler. At most `max_parallel_transfers` of them are
+         * queued at once. Transfers that the scheduler rejects are reported as errors and retried by the next sync.
+         */
+        std::shared_ptr<TransferScheduler> scheduler;
+
+        /// key of the host that the transfers are limited by in the scheduler, see `TransferScheduler::host_of()`
+        std::string scheduler_host;
+
+        /**
+         * Don't list directories in the cloud whose revision is still the same as after the last sync, and take
+         * their content from the state instead. Only enable this for providers whose directory revisions change
+         * with everything below them, like nextcloud & owncloud. An unchanged tree then costs a single request.
+         */
+        bool prune_unchanged_directories = false;
+    };
+
+    /// @brief What a single `SyncEngine::sync()` has done.
+    struct SyncResult {
+        /// files that have been uploaded, new or changed
+        std::size_t uploads = 0;
+
+        /// files that have been downloaded, new or changed
+        std::size_t downloads = 0;
+
+        /// files & directories that have been removed in the cloud, because they have been removed locally
+        std::size_t remote_removals = 0;
+
+        /// files & directories that have been removed locally, because they have been removed in the cloud
+        std::size_t local_removals = 0;
+
+        /// directories that have been created on either side
+        std::size_t created_directories = 0;
+
+        std::uint64_t bytes_uploaded = 0;
+
+        std::uint64_t bytes_downloaded = 0;
+
+        /**
+         * Paths that have been changed locally and in the cloud since the last sync. They are left as they are on
+         * both sides and are reported again by every sync until one of the sides is changed back or removed.
+         */
+        std::vector<std::filesystem::path> conflicts;
+
+        /// paths whose transfer has failed for another reason, with the exception. They are retried by the next sync.
+        std::vector<BulkResult> errors;
+
+        /// @return number of files & directories that have been changed on either side
+        [[nodiscard]] std::size_t changes() const {
+            return uploads + downloads + remote_removals + local_removals + created_directories;
+        }
+    };
+
+    /**
+     * @brief Keeps a local directory and a directory in the cloud in sync, in both directions.
+     *
+     * The revisions, sizes & modification times of the last sync are kept in a state file. Each sync compares both
+     * sides with it and only transfers what has changed since. Uploads are guarded by the revision of the last sync,
+     * so a file that has been changed on both sides is reported as a conflict and never overwritten.
+     *
+     * While a sync is running, every transfer is recorded in a journal next to the state file before it starts and
+     * again once it is done. If the sync is interrupted, the next one looks up the unfinished transfers in the cloud
+     * and picks them up again, without relying on the state being up to date.
+     * @code
+     * SyncEngine engine("/home/john/Documents", cloud->root()->get_directory("Documents"), "/home/john/.documents.sync");
+     * const auto result = engine.sync();
+     * for (const auto &path: result.conflicts) {
+     *     std::cerr << "changed on both sides: " << path << std::endl;
+     * }
+     * @endcode
+     */
+    class SyncEngine {
+    public:
+        /**
+         * @param local_root the local directory. It is created if it doesn't exist.
+         * @param remote_root the directory in the cloud
+         * @param state_file where the state of the last sync is kept. Use a separate file for every pair of
+         *        directories. The journal is kept next to it, with `.journal` appended to its name. Both are ignored
+         *        if they lie inside `local_root`.
+         */
+        SyncEngine(
+                std::filesystem::path local_root,
+                std::shared_ptr<Directory> remote_root,
+                std::filesystem::path state_file,
+                SyncOptions options = {});
+
+        /**
+         * Brings both sides in sync and stores the new state. An interrupted sync is resumed first.
+         * @note Symlinks and other special local files are ignored.
+         * @throws exceptions::cloud::CloudException if the directory in the cloud can't be listed. Nothing is changed
+         *         then.
+         * @throws std::filesystem::filesystem_error if the local directory can't be read.
+         * @return what has been done, including the conflicts and failed transfers.
+         */
+        SyncResult sync();
+
+        /**
+         * Finishes the transfers of a sync that has been interrupted, without listing either side. Transfers whose
+         * file has been changed since are left to the next sync, which lists the directories they are in again.
+         * Does nothing if the last sync has finished.
+         * @note Transfers start over from the beginning, upload sessions aren't kept.
+         * @throws exceptions::cloud::CloudException if the unfinished transfers can't be looked up in the cloud. The
+         *         journal is kept then.
+         * @throws std::runtime_error if the journal can't be read.
+         * @return the transfers that have been finished.
+         */
+        SyncResult resume();
+
+    private:
+        const std::filesystem::path m_local_root;
+        const std::shared_ptr<Directory> m_remote_root;
+        const std::filesystem::path m_state_file;
+        const SyncOptions m_options;
+    };
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "ConcurrencyController.hpp"
+#include "exceptions/Exception.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace CloudSync {
+    /// @brief The queue a transfer waits in, see `TransferScheduler`.
+    enum class TransferLane : std::uint8_t {
+        /// transfers that a user is waiting for, like opening a file. They always start before background transfers.
+        INTERACTIVE,
+        /// bulk transfers like a sync, which only start when no interactive transfer is waiting
+        BACKGROUND
+    };
+
+    /// @brief Settings of a TransferScheduler.
+    struct TransferSchedulerOptions {
+        /// number of threads that run transfers
+        std::size_t workers = 4;
+
+        /**
+         * threads out of `workers` that only run interactive transfers, so an interactive transfer never has to wait
+         * for a long background transfer to finish
+         */
+        std::size_t interactive_workers = 1;
+
+        /// at most this many transfers run against the same host at once, `0` for no limit
+        std::size_t max_per_host = 4;
+
+        /// limits for single hosts or providers by their key, instead of `max_per_host`
+        std::map<std::string, std::size_t> host_limits;
+
+        /**
+         * Find out how many transfers each host can take at once, with a ConcurrencyController per host. The limits
+         * above are upper bounds then. Transfers that throw exceptions::cloud::Throttled lower the limit of their host
+         * and pause it for the `Retry-After` the provider has sent.
+         */
+        bool adaptive_concurrency = false;
+
+        /// settings of the controllers if `adaptive_concurrency` is enabled, `max` is capped by the limit of the host
+        ConcurrencyLimits adaptive_limits;
+
+        /// interactive transfers are rejected once this many are waiting, `0` for no limit
+        std::size_t max_queued_interactive = 0;
+
+        /// background transfers are rejected once this many are waiting, `0` for no limit
+        std::size_t max_queued_background = 1024;
+    };
+
+    /// @brief What has happened in a lane of a TransferScheduler.
+    struct TransferLaneStats {
+        /// transfers that are waiting to start
+        std::size_t queued = 0;
+
+        /// transfers that are running right now
+        std::size_t running = 0;
+
+        /// transfers that have been started since the scheduler has been created
+        std::uint64_t started = 0;
+
+        /// transfers that have been rejected because the lane was full
+        std::uint64_t rejected = 0;
+
+        /// transfers that have been started after their deadline
+        std::uint64_t missed_deadlines = 0;
+
+        /// time the started transfers have spent waiting, in total
+        std::chrono::microseconds total_wait{0};
+
+        /// longest time a started transfer has waited
+        std::chrono::microseconds max_wait{0};
+
+        [[nodiscard]] std::chrono::microseconds average_wait() const {
+            return started == 0 ? std::chrono::microseconds(0) : total_wait / static_cast<std::int64_t>(started);
+        }
+    };
+
+    /// @brief Snapshot of the queues of a TransferScheduler.
+    struct TransferSchedulerStats {
+        TransferLaneStats interactive;
+
+        TransferLaneStats background;
+
+        /// transfers that are running right now by the key of their host, hosts without any are left out
+        std::map<std::string, std::size_t> running_per_host;
+
+        /// current limits of the hosts that have been seen, if the concurrency is adaptive
+        std::map<std::string, std::size_t> limit_per_host;
+    };
+
+    namespace exceptions {
+        /// @brief Thrown by `TransferScheduler::submit()` if the lane is full or the scheduler has been stopped.
+        class TransferRejected : public Exception {
+        public:
+            explicit TransferRejected(const std::string &what) : Exception(what) {};
+        };
+    }
+
+    /**
+     * @brief Runs transfers on a pool of threads, ordered by urgency and limited per host.
+     *
+     * Library calls block the thread they are made from and a resource handle shouldn't be used by two threads at
+     * once. The scheduler runs them on threads of its own instead, so a user who opens a file doesn't wait behind a
+     * bulk upload. Each transfer should use a handle of its own, e.g. from `Directory::with_new_connection()`.
+     *
+     * Interactive transfers always start before background ones. Within a lane, transfers with the earliest deadline
+     * start first, then the ones without a deadline in the order they have been submitted. A transfer whose host
+     * already runs as many transfers as it is allowed to is passed over until one of them has finished. With
+     * `TransferSchedulerOptions::adaptive_concurrency`, that limit follows how the host copes with the load.
+     * @code
+     * TransferScheduler scheduler;
+     * const auto host = TransferScheduler::host_of(cloud->get_base_url());
+     * auto opened = scheduler.submit(TransferLane::INTERACTIVE, host, [&file, &content] {
+     *     content = file->read_binary();
+     * }, TransferScheduler::Clock::now() + std::chrono::seconds(1));
+     * opened.get();
+     * @endcode
+     */
+    class TransferScheduler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// a transfer. Exceptions it throws are passed on to the future that `submit()` has returned.
+        using Transfer = std::function<void()>;
+
+        /// starts the threads
+        explicit TransferScheduler(TransferSchedulerOptions options = {});
+
+        /// stops the scheduler, see `stop()`
+        ~TransferScheduler();
+
+        TransferScheduler(const TransferScheduler &) = delete;
+
+        TransferScheduler &operator=(const TransferScheduler &) = delete;
+
+        /**
+         * Queues a transfer.
+         * @param lane the queue the transfer waits in
+         * @param host key of the host or provider that the transfer is limited by, e.g. from `host_of()`
+         * @param deadline when the transfer should have started at the latest, nothing if it isn't urgent
+         * @return becomes ready once the transfer has finished, with the exception it has thrown if any.
+         * @throws exceptions::TransferRejected if the lane is full or the scheduler has been stopped.
+         */
+        std::future<void> submit(
+                TransferLane lane,
+                const std::string &host,
+                Transfer transfer,
+                std::optional<Clock::time_point> deadline = std::nullopt);
+
+        /**
+         * Waits for the running transfers to finish and stops the threads. Transfers that haven't started yet are
+         * dropped, their futures fail with exceptions::TransferRejected.
+         */
+        void stop();
+
+        /// @return the current state of the queues and what has happened so far
+        [[nodiscard]] TransferSchedulerStats stats() const;
+
+        /// @return the host & port of `url` in lower case, to be used as the key of a host
+        static std::string host_of(const std::string &url);
+
+    private:
+        class Queue;
+
+        std::unique_ptr<Queue> m_queue;
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "CloudSync/exceptions/Exception.hpp"
+#include <chrono>
+#include <optional>
 
 namespace CloudSync::exceptions::cloud {
     /// Base-exception for all cloud-related errors.
@@ -39,6 +41,35 @@ namespace CloudSync::exceptions::cloud {
                 : CloudException("The communication with the server has failed. " + what) {};
     };
 
+    /**
+     * @brief Thrown if the provider has turned a request down because too many have been sent (429 Too Many
+     * Requests, 503 Service Unavailable).
+     *
+     * Nothing has been changed on the server. Retry the request later, after `retry_after` if the provider has said
+     * how long to wait, and send fewer requests at once. `TransferScheduler` does this on its own if its
+     * concurrency is adaptive.
+     */
+    class Throttled : public CommunicationError {
+    public:
+        explicit Throttled(const std::string &what = "", std::optional<std::chrono::seconds> retry_after = std::nullopt)
+                : CommunicationError("The cloud is throttling requests. " + what), retry_after(retry_after) {};
+
+        /// how long the provider wants the client to wait before the next request, if it has said so
+        const std::optional<std::chrono::seconds> retry_after;
+    };
+
+    /**
+     * @brief Thrown if the provider or the server doesn't support an operation, e.g. partial writes on a webdav server
+     * without the sabre/dav partial update plugin.
+     *
+     * Nothing has been changed on the server. Fall back to an operation that every provider supports.
+     */
+    class OperationNotSupported : public CloudException {
+    public:
+        explicit OperationNotSupported(const std::string &what)
+                : CloudException("The operation is not supported by the cloud: " + what) {};
+    };
+
     /**
      @brief Thrown if the server response cannot be parsed.
      *
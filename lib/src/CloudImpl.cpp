@@ -15,3 +15,7 @@ void CloudImpl::test_connection() const {
 std::string CloudImpl::get_base_url() const {
     return m_base_url;
 }
+
+void CloudImpl::search(const SearchQuery &query, const SearchPageHandler &on_page) const {
+    this->root()->search(query, on_page);
+}
@@ -10,6 +10,8 @@ namespace CloudSync {
 
         std::string get_base_url() const override;
 
+        void search(const SearchQuery &query, const SearchPageHandler &on_page) const override;
+
         virtual ~CloudImpl() = default;
 
     protected:
@@ -0,0 +1,130 @@
+#include "CloudSync/ConcurrencyController.hpp"
+#include "CloudSync/exceptions/cloud/CloudException.hpp"
+#include "request/exceptions/RequestException.hpp"
+#include "request/exceptions/response/ResponseException.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace CloudSync;
+
+namespace {
+    /// how fast the baseline follows rounds that are slower than it, so a network that has become slower is accepted
+    constexpr int BASELINE_DRIFT = 8;
+}
+
+ConcurrencyController::ConcurrencyController(ConcurrencyLimits limits)
+        : m_limits(limits)
+        , m_limit(std::clamp(limits.initial, std::max<std::size_t>(limits.min, 1), std::max(limits.max, limits.min))) {
+    start_round(false);
+}
+
+std::size_t ConcurrencyController::limit() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_limit;
+}
+
+ConcurrencyController::Clock::time_point ConcurrencyController::paused_until() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_paused_until;
+}
+
+void ConcurrencyController::succeeded(Clock::duration latency) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_completed++;
+    m_total_latency += latency;
+    m_min_latency = m_min_latency ? std::min(*m_min_latency, latency) : latency;
+    complete_round_if_needed();
+}
+
+void ConcurrencyController::throttled(std::optional<Clock::duration> retry_after) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (retry_after) {
+        m_paused_until = std::max(m_paused_until, Clock::now() + *retry_after);
+    }
+    if (!m_lowered) {
+        lower();
+        return;
+    }
+    m_completed++;
+    m_failed++;
+    complete_round_if_needed();
+}
+
+void ConcurrencyController::failed() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_completed++;
+    m_failed++;
+    complete_round_if_needed();
+}
+
+void ConcurrencyController::report(Clock::duration latency, const std::exception_ptr &error) {
+    if (!error) {
+        succeeded(latency);
+        return;
+    }
+    try {
+        std::rethrow_exception(error);
+    } catch (const exceptions::cloud::Throttled &e) {
+        throttled(e.retry_after);
+    } catch (const request::exceptions::response::TooManyRequests &e) {
+        throttled(e.retry_after);
+    } catch (const request::exceptions::response::ServiceUnavailable &e) {
+        throttled(e.retry_after);
+    } catch (const exceptions::cloud::CommunicationError &) {
+        failed();
+    } catch (const request::exceptions::RequestException &) {
+        failed();
+    } catch (const request::exceptions::response::ServerError &) {
+        failed();
+    } catch (...) {
+        // e.g. a file that has been changed in the meantime. The endpoint has answered, which is all that counts here.
+        succeeded(latency);
+    }
+}
+
+void ConcurrencyController::lower() {
+    // the requests that are still in flight have been sent with the old limit, their outcome says little
+    const auto in_flight = m_limit;
+    const auto lowered = static_cast<std::size_t>(std::floor(static_cast<double>(m_limit) * m_limits.backoff));
+    m_limit = std::clamp(lowered, std::max<std::size_t>(m_limits.min, 1), m_limit);
+    start_round(true);
+    m_round_size = in_flight;
+}
+
+void ConcurrencyController::complete_round_if_needed() {
+    if (m_completed < m_round_size) {
+        return;
+    }
+    if (m_lowered) {
+        start_round(false);
+        return;
+    }
+    const auto succeeded = m_completed - m_failed;
+    if (succeeded != 0) {
+        const auto average = m_total_latency / succeeded;
+        const auto baseline = m_baseline;
+        if (!m_baseline || *m_min_latency < *m_baseline) {
+            m_baseline = m_min_latency;
+        } else {
+            *m_baseline += (*m_min_latency - *m_baseline) / BASELINE_DRIFT;
+        }
+        if (baseline && std::chrono::duration<double>(average).count()
+                        > std::chrono::duration<double>(*baseline).count() * m_limits.latency_tolerance) {
+            lower();
+            return;
+        }
+    }
+    if (static_cast<double>(m_failed) <= static_cast<double>(m_completed) * m_limits.max_failure_rate) {
+        m_limit = std::min(m_limit + 1, std::max(m_limits.max, m_limits.min));
+    }
+    start_round(false);
+}
+
+void ConcurrencyController::start_round(bool lowered) {
+    m_round_size = m_limit;
+    m_completed = 0;
+    m_failed = 0;
+    m_total_latency = Clock::duration(0);
+    m_min_latency.reset();
+    m_lowered = lowered;
+}
@@ -1,4 +1,5 @@
 #include "DirectoryImpl.hpp"
+#include "CloudSync/exceptions/resource/ResourceException.hpp"
 #include <utility>
 
 using namespace CloudSync;
@@ -11,15 +12,87 @@ std::filesystem::path DirectoryImpl::path() const {
     return m_path;
 }
 
+std::chrono::system_clock::time_point DirectoryImpl::modified() const {
+    return m_modified;
+}
+
 bool DirectoryImpl::is_file() const {
     return false;
 }
 
+std::string DirectoryImpl::revision() const {
+    return m_revision;
+}
+
+bool DirectoryImpl::poll_change() {
+    return false;
+}
+
 std::filesystem::path DirectoryImpl::append_path(const std::filesystem::path &child_path) const {
     std::string full_path = (m_path / child_path).lexically_normal().generic_string();
     return {remove_trailing_slashes(full_path)};
 }
 
+std::filesystem::path DirectoryImpl::destination_path(const std::filesystem::path &path) const {
+    if (m_path.generic_string() == "/") {
+        throw exceptions::resource::PermissionDenied(m_path);
+    }
+    const std::filesystem::path destination = remove_trailing_slashes(
+            (m_path.parent_path() / path).lexically_normal().generic_string());
+    const auto relative_destination = destination.lexically_relative(m_path);
+    if (destination.generic_string() == "/"
+        || (!relative_destination.empty() && *relative_destination.begin() != "..")) {
+        // a directory can't be copied or moved into itself
+        throw exceptions::resource::PermissionDenied(destination);
+    }
+    return destination;
+}
+
+bool DirectoryImpl::deliver_search_page(
+        const SearchQuery &query, std::vector<SearchResult> page, const SearchPageHandler &on_page) const {
+    page.erase(std::remove_if(page.begin(), page.end(), [this, &query](const SearchResult &result) {
+        const auto relative_path = result.path.lexically_relative(m_path);
+        return relative_path.empty() || relative_path == "." || *relative_path.begin() == ".."
+               || !query.matches(result.info);
+    }), page.end());
+    return page.empty() || on_page(page);
+}
+
+std::vector<std::filesystem::path> DirectoryImpl::paths_of(const std::vector<FileUpload> &files) {
+    std::vector<std::filesystem::path> paths;
+    paths.reserve(files.size());
+    for (const auto &file: files) {
+        paths.push_back(file.path);
+    }
+    return paths;
+}
+
+std::vector<BulkValue<std::shared_ptr<File>>> DirectoryImpl::upload_parallel(
+        const std::vector<FileUpload> &files,
+        const std::function<std::shared_ptr<File>(const std::shared_ptr<request::Request> &, const FileUpload &)> &upload) const {
+    struct Upload : BulkValue<std::shared_ptr<File>> {
+        const FileUpload *file = nullptr;
+    };
+    auto uploads = bulk_results<Upload>(paths_of(files));
+    for (std::size_t i = 0; i < files.size(); i++) {
+        uploads[i].file = &files[i];
+    }
+    run_parallel<Upload>(uploads, [&upload](const std::shared_ptr<request::Request> &request, Upload &item) {
+        item.value = upload(request, *item.file);
+    });
+    return {uploads.begin(), uploads.end()};
+}
+
+std::exception_ptr DirectoryImpl::translated_error(const std::function<void()> &translate) {
+    try {
+        translate();
+    } catch (...) {
+        return std::current_exception();
+    }
+    // the translator didn't know what to do with it, so the original exception is kept
+    return std::current_exception();
+}
+
 std::string DirectoryImpl::remove_trailing_slashes(const std::string& input) {
     std::string output = input;
     while (output.size() > 2 && output.back() == '/') {
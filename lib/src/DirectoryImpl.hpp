@@ -2,6 +2,11 @@
 
 #include "CloudSync/Directory.hpp"
 #include "request/Request.hpp"
+#include "util/EndpointConcurrency.hpp"
+#include "util/Parallel.hpp"
+#include <algorithm>
+#include <functional>
+#include <vector>
 
 namespace CloudSync {
     class DirectoryImpl : public Directory {
@@ -10,18 +15,29 @@ namespace CloudSync {
 
         [[nodiscard]] std::filesystem::path path() const override;
 
+        [[nodiscard]] std::chrono::system_clock::time_point modified() const override;
+
         [[nodiscard]] bool is_file() const override;
 
+        [[nodiscard]] std::string revision() const override;
+
+        /// providers with directory revisions override this. Without them there is nothing to poll.
+        bool poll_change() override;
+
     protected:
         DirectoryImpl(
                 std::string baseUrl,
                 std::filesystem::path dir,
                 std::shared_ptr<request::Request> request,
-                std::string name)
+                std::string name,
+                std::chrono::system_clock::time_point modified = {},
+                std::string revision = "")
                 : m_base_url(std::move(baseUrl))
                 , m_path(std::move(dir))
                 , m_request(std::move(request))
-                , m_name(std::move(name)) {
+                , m_name(std::move(name))
+                , m_modified(modified)
+                , m_revision(std::move(revision)) {
             assert(m_path.generic_string().length() >= 1 && m_path.generic_string()[0] == '/');
             assert(m_path.generic_string() == "/" ? m_name.empty() : !m_name.empty());
         };
@@ -31,9 +47,81 @@ namespace CloudSync {
     protected:
         const std::string m_name;
         const std::filesystem::path m_path;
+        const std::chrono::system_clock::time_point m_modified;
+        std::string m_revision;
 
         std::filesystem::path append_path(const std::filesystem::path& child_path = "") const;
         static std::string remove_trailing_slashes(const std::string& input);
+
+        /**
+         * @return the absolute destination for `copy_to()` & `move_to()`
+         * @throws exceptions::resource::PermissionDenied if this is the root, or the destination is the root or lies
+         *         inside of this directory.
+         */
+        [[nodiscard]] std::filesystem::path destination_path(const std::filesystem::path &path) const;
+
+        /// @return one result per path, with only the path set.
+        template<typename RESULT_T>
+        static std::vector<RESULT_T> bulk_results(const std::vector<std::filesystem::path> &paths) {
+            std::vector<RESULT_T> results(paths.size());
+            for (std::size_t i = 0; i < paths.size(); i++) {
+                results[i].path = paths[i];
+            }
+            return results;
+        }
+
+        /**
+         * Hands the results of one page of a provider search to `on_page`, without those that don't match `query`
+         * or don't lie below this directory. Pages that end up empty are not handed over.
+         * @return what `on_page` has returned, `true` if it hasn't been called.
+         */
+        bool deliver_search_page(
+                const SearchQuery &query, std::vector<SearchResult> page, const SearchPageHandler &on_page) const;
+
+        /// @return the paths of `files`, in the same order
+        static std::vector<std::filesystem::path> paths_of(const std::vector<FileUpload> &files);
+
+        /**
+         * Runs `operation` for every item of `results` on as many threads as the controller of the endpoint allows,
+         * see `util::endpoint_controller()`. Each thread uses its own clone of the request. Anything `operation`
+         * throws is stored in the item it has been thrown for, and every outcome is reported to the controller.
+         */
+        template<typename RESULT_T>
+        void run_parallel(
+                std::vector<RESULT_T> &results,
+                const std::function<void(const std::shared_ptr<request::Request> &, RESULT_T &)> &operation) const {
+            auto &controller = util::endpoint_controller(m_base_url);
+            std::vector<std::shared_ptr<request::Request>> requests;
+            const auto workers = std::min(results.size(), controller.limit());
+            for (std::size_t i = 0; i < workers; i++) {
+                requests.push_back(workers == 1 ? m_request : m_request->clone());
+            }
+            util::parallel_for(results.size(), workers, controller, [&](std::size_t worker, std::size_t index) {
+                const auto started = ConcurrencyController::Clock::now();
+                try {
+                    operation(requests[worker], results[index]);
+                } catch (...) {
+                    results[index].error = std::current_exception();
+                }
+                controller.report(ConcurrencyController::Clock::now() - started, results[index].error);
+            });
+        }
+
+        /**
+         * Uploads `files` on as many threads as `run_parallel()` uses, for providers that can't upload many files at once.
+         * @param upload uploads a single file with the given request and returns its handle.
+         * @return the results of `upload_many()`. Anything `upload` throws is stored in the item of the file.
+         */
+        std::vector<BulkValue<std::shared_ptr<File>>> upload_parallel(
+                const std::vector<FileUpload> &files,
+                const std::function<std::shared_ptr<File>(const std::shared_ptr<request::Request> &, const FileUpload &)> &upload) const;
+
+        /**
+         * Must be called from within a `catch` block.
+         * @param translate an exception translator call, like `[&]{ XExceptionTranslator::translate(path); }`
+         * @return the exception `translate` turns the current exception into.
+         */
+        static std::exception_ptr translated_error(const std::function<void()> &translate);
     };
 }
 
@@ -1,4 +1,6 @@
 #include "FileImpl.hpp"
+#include "CloudSync/exceptions/resource/ResourceException.hpp"
+#include "CloudSync/exceptions/cloud/CloudException.hpp"
 
 using namespace CloudSync;
 
@@ -14,6 +16,51 @@ std::string CloudSync::FileImpl::revision() const {
     return m_revision;
 }
 
+std::chrono::system_clock::time_point FileImpl::modified() const {
+    return m_modified;
+}
+
+std::uint64_t FileImpl::size() const {
+    return m_size;
+}
+
+std::string FileImpl::content_type() const {
+    return m_content_type;
+}
+
+std::optional<ContentHash> FileImpl::content_hash() const {
+    return m_content_hash;
+}
+
 bool FileImpl::is_file() const {
     return true;
 }
+
+void FileImpl::upload(const std::filesystem::path &local_file) {
+    const upload::UploadSource source(local_file);
+    if (source.size() <= upload::ChunkedUpload::SINGLE_REQUEST_SIZE) {
+        // a session would cost at least two more requests
+        this->write_binary(source.read(0, source.size()));
+    } else {
+        this->upload_chunked(source);
+    }
+}
+
+std::filesystem::path FileImpl::destination_path(const std::filesystem::path &path) const {
+    auto destination = (m_path.parent_path() / path).lexically_normal();
+    if (!destination.has_filename() && destination.has_relative_path()) {
+        destination = destination.parent_path();
+    }
+    if (destination.generic_string() == "/") {
+        throw exceptions::resource::PermissionDenied(destination);
+    }
+    return destination;
+}
+
+void FileImpl::write_range(std::uint64_t, const std::vector<std::uint8_t> &) {
+    throw exceptions::cloud::OperationNotSupported("partial writes of " + m_path.generic_string());
+}
+
+void FileImpl::append(const std::vector<std::uint8_t> &) {
+    throw exceptions::cloud::OperationNotSupported("appending to " + m_path.generic_string());
+}
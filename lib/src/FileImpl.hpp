@@ -2,6 +2,7 @@
 
 #include "CloudSync/File.hpp"
 #include "request/Request.hpp"
+#include "upload/ChunkedUpload.hpp"
 #include <utility>
 
 namespace CloudSync {
@@ -13,25 +14,67 @@ namespace CloudSync {
 
         [[nodiscard]] std::string revision() const override;
 
+        [[nodiscard]] std::chrono::system_clock::time_point modified() const override;
+
+        [[nodiscard]] std::uint64_t size() const override;
+
+        [[nodiscard]] std::string content_type() const override;
+
+        [[nodiscard]] std::optional<ContentHash> content_hash() const override;
+
         [[nodiscard]] bool is_file() const override;
 
+        /// @return the provider specific id, see ResourceInfo::id. Empty for providers that address files by path.
+        [[nodiscard]] virtual std::string id() const {
+            return "";
+        }
+
+        void upload(const std::filesystem::path &local_file) override;
+
+        /// providers that can write parts of a file override this
+        void write_range(std::uint64_t offset, const std::vector<std::uint8_t> &data) override;
+
+        /// providers that can write parts of a file override this
+        void append(const std::vector<std::uint8_t> &data) override;
+
     protected:
         FileImpl(
                 std::string baseUrl,
                 std::filesystem::path dir,
                 std::shared_ptr<request::Request> request,
-                std::string name, std::string revision)
+                std::string name, std::string revision,
+                std::uint64_t size = 0,
+                std::chrono::system_clock::time_point modified = {},
+                std::string content_type = "",
+                std::optional<ContentHash> content_hash = std::nullopt)
                 : m_base_url(std::move(baseUrl))
                 , m_path(std::move(dir))
                 , m_request(std::move(request))
                 , m_name(std::move(name))
-                , m_revision(std::move(revision)) {
+                , m_revision(std::move(revision))
+                , m_size(size)
+                , m_modified(modified)
+                , m_content_type(std::move(content_type))
+                , m_content_hash(std::move(content_hash)) {
             assert(!m_name.empty());
             assert(m_path.generic_string().length() > 1 && m_path.generic_string()[0] == '/');
             assert(!m_revision.empty());
         };
 
+        /// uploads a file that is larger than upload::ChunkedUpload::SINGLE_REQUEST_SIZE
+        virtual void upload_chunked(const upload::UploadSource &source) = 0;
+
+        /**
+         * @return the absolute destination for `copy_to()` & `move_to()`
+         * @throws exceptions::resource::PermissionDenied if it's the root
+         */
+        [[nodiscard]] std::filesystem::path destination_path(const std::filesystem::path &path) const;
+
         std::string m_revision;
+        std::uint64_t m_size;
+        std::chrono::system_clock::time_point m_modified;
+        std::string m_content_type;
+        std::optional<ContentHash> m_content_hash;
         const std::string m_base_url;
         std::shared_ptr<request::Request> m_request;
         const std::string m_name;
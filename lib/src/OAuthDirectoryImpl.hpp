@@ -12,8 +12,11 @@ namespace CloudSync {
                 std::filesystem::path dir,
                 std::shared_ptr<credentials::OAuth2CredentialsImpl> credentials,
                 std::shared_ptr<request::Request> request,
-                std::string name)
-                : DirectoryImpl(std::move(baseUrl), std::move(dir), std::move(request), std::move(name))
+                std::string name,
+                std::chrono::system_clock::time_point modified = {},
+                std::string revision = "")
+                : DirectoryImpl(std::move(baseUrl), std::move(dir), std::move(request), std::move(name), modified,
+                                std::move(revision))
                 , m_credentials(std::move(credentials)) {};
         const std::shared_ptr<credentials::OAuth2CredentialsImpl> m_credentials;
     };
@@ -12,8 +12,13 @@ namespace CloudSync {
                       std::filesystem::path dir,
                       std::shared_ptr<credentials::OAuth2CredentialsImpl> credentials,
                       std::shared_ptr<request::Request> request,
-                      std::string name, std::string revision)
-                      : FileImpl(std::move(baseUrl), std::move(dir), std::move(request), std::move(name), std::move(revision))
+                      std::string name, std::string revision,
+                      std::uint64_t size = 0,
+                      std::chrono::system_clock::time_point modified = {},
+                      std::string content_type = "",
+                      std::optional<ContentHash> content_hash = std::nullopt)
+                      : FileImpl(std::move(baseUrl), std::move(dir), std::move(request), std::move(name), std::move(revision),
+                                 size, modified, std::move(content_type), std::move(content_hash))
                       , m_credentials(std::move(credentials)) {};
         const std::shared_ptr<credentials::OAuth2CredentialsImpl> m_credentials;
     };
@@ -0,0 +1,32 @@
+#include "CloudSync/SearchQuery.hpp"
+#include <algorithm>
+#include <cctype>
+
+using namespace CloudSync;
+
+namespace {
+    char lower(char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+}
+
+bool SearchQuery::matches(const ResourceInfo &info) const {
+    if (kind && info.kind != *kind) {
+        return false;
+    }
+    if (!content_type.empty() && (!info.is_file() || info.content_type != content_type)) {
+        return false;
+    }
+    if (modified_after && info.modified <= *modified_after) {
+        return false;
+    }
+    if (!name.empty()) {
+        const auto match = std::search(
+                info.name.begin(), info.name.end(), name.begin(), name.end(),
+                [](char a, char b) { return lower(a) == lower(b); });
+        if (match == info.name.end()) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,141 @@
+#include "CloudSync/SnapshotDiff.hpp"
+#include "util/Parallel.hpp"
+#include <algorithm>
+#include <thread>
+#include <tuple>
+
+using namespace CloudSync;
+
+namespace {
+    /// smaller snapshots are sorted by a single thread, starting threads would take longer
+    constexpr std::size_t MIN_ENTRIES_PER_WORKER = 16 * 1024;
+
+    /// orders entries with the same path by their other fields, so the same one is kept no matter how they are sorted
+    bool by_path(const SnapshotEntry &first, const SnapshotEntry &second) {
+        const int order = first.path.compare(second.path);
+        if (order != 0) {
+            return order < 0;
+        }
+        return std::tie(first.revision, first.size, first.kind) < std::tie(second.revision, second.size, second.kind);
+    }
+
+    bool needs_normalization(const std::string &path) {
+        if (path.empty()) {
+            return false;
+        }
+        if (path.front() == '/' || path.back() == '/' || path == "." || path.compare(0, 2, "./") == 0) {
+            return true;
+        }
+        return path.find("//") != std::string::npos || path.find("/./") != std::string::npos
+               || (path.size() >= 2 && path.compare(path.size() - 2, 2, "/.") == 0);
+    }
+
+    /// removes empty & `.` segments. `..` segments are kept, they can't be resolved without the file system.
+    void normalize(std::string &path) {
+        if (!needs_normalization(path)) {
+            return;
+        }
+        std::string normalized;
+        normalized.reserve(path.size());
+        std::size_t start = 0;
+        while (start <= path.size()) {
+            auto end = path.find('/', start);
+            if (end == std::string::npos) {
+                end = path.size();
+            }
+            const auto length = end - start;
+            if (length != 0 && !(length == 1 && path[start] == '.')) {
+                if (!normalized.empty()) {
+                    normalized += '/';
+                }
+                normalized.append(path, start, length);
+            }
+            start = end + 1;
+        }
+        path = std::move(normalized);
+    }
+
+    /// normalizes and sorts `entries` by path
+    void sort_by_path(std::vector<SnapshotEntry> &entries, std::size_t max_workers) {
+        const auto workers = std::max<std::size_t>(std::min(max_workers, entries.size() / MIN_ENTRIES_PER_WORKER), 1);
+        std::vector<std::size_t> bounds(workers + 1);
+        for (std::size_t i = 0; i <= workers; i++) {
+            bounds[i] = entries.size() * i / workers;
+        }
+        const auto run = [&entries, &bounds](std::size_t index) {
+            return entries.begin() + static_cast<std::ptrdiff_t>(bounds[std::min(index, bounds.size() - 1)]);
+        };
+        util::parallel_for(workers, workers, [&](std::size_t, std::size_t index) {
+            for (auto entry = run(index); entry != run(index + 1); ++entry) {
+                normalize(entry->path);
+            }
+            if (!std::is_sorted(run(index), run(index + 1), by_path)) {
+                std::sort(run(index), run(index + 1), by_path);
+            }
+        });
+        // merge neighbouring runs pairwise, until a single one is left
+        for (std::size_t width = 1; width < workers; width *= 2) {
+            const auto merges = (workers + 2 * width - 1) / (2 * width);
+            util::parallel_for(merges, merges, [&](std::size_t, std::size_t index) {
+                const auto first = run(index * 2 * width);
+                const auto middle = run(index * 2 * width + width);
+                const auto last = run(index * 2 * width + 2 * width);
+                if (middle != first && middle != last && by_path(*middle, *(middle - 1))) {
+                    std::inplace_merge(first, middle, last, by_path);
+                }
+            });
+        }
+    }
+
+    /// keeps a single entry of each path in a sorted snapshot
+    void remove_duplicates(std::vector<SnapshotEntry> &entries) {
+        if (entries.empty()) {
+            return;
+        }
+        std::size_t kept = 0;
+        for (std::size_t i = 1; i < entries.size(); i++) {
+            if (entries[i].path != entries[kept].path) {
+                kept++;
+            }
+            if (i != kept) {
+                entries[kept] = std::move(entries[i]);
+            }
+        }
+        entries.resize(kept + 1);
+    }
+}
+
+SnapshotDiff SnapshotDiff::between(
+        std::vector<SnapshotEntry> before, std::vector<SnapshotEntry> after, std::size_t max_workers) {
+    if (max_workers == 0) {
+        max_workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    sort_by_path(before, max_workers);
+    sort_by_path(after, max_workers);
+    remove_duplicates(before);
+    remove_duplicates(after);
+
+    SnapshotDiff diff;
+    auto old_entry = before.begin();
+    auto new_entry = after.begin();
+    while (old_entry != before.end() || new_entry != after.end()) {
+        const int order = old_entry == before.end() ? 1
+                          : new_entry == after.end() ? -1
+                          : old_entry->path.compare(new_entry->path);
+        if (order < 0) {
+            diff.removed.push_back(std::move(*old_entry++));
+        } else if (order > 0) {
+            diff.added.push_back(std::move(*new_entry++));
+        } else {
+            if (old_entry->kind != new_entry->kind) {
+                diff.removed.push_back(std::move(*old_entry));
+                diff.added.push_back(std::move(*new_entry));
+            } else if (old_entry->revision != new_entry->revision || old_entry->size != new_entry->size) {
+                diff.modified.push_back(std::move(*new_entry));
+            }
+            ++old_entry;
+            ++new_entry;
+        }
+    }
+    return diff;
+}
@@ -0,0 +1,301 @@
+#include "CloudSync/TransferScheduler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace CloudSync;
+
+namespace {
+    using Clock = TransferScheduler::Clock;
+
+    struct QueuedTransfer {
+        TransferScheduler::Transfer transfer;
+        std::promise<void> done;
+        Clock::time_point submitted;
+        std::optional<Clock::time_point> deadline;
+    };
+
+    /// earliest deadline first, transfers without one after those with one, then in the order they have been submitted
+    using QueueKey = std::pair<Clock::time_point, std::uint64_t>;
+
+    struct Lane {
+        /// waiting transfers by their host, so a host that is at its limit doesn't hold up the others
+        std::map<std::string, std::map<QueueKey, QueuedTransfer>> waiting;
+        TransferLaneStats stats;
+        std::size_t max_queued = 0;
+    };
+
+    std::chrono::microseconds to_microseconds(Clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration);
+    }
+}
+
+class TransferScheduler::Queue {
+public:
+    explicit Queue(TransferSchedulerOptions options)
+            : m_options(std::move(options)) {
+        m_lanes[index_of(TransferLane::INTERACTIVE)].max_queued = m_options.max_queued_interactive;
+        m_lanes[index_of(TransferLane::BACKGROUND)].max_queued = m_options.max_queued_background;
+        const auto workers = std::max<std::size_t>(m_options.workers, 1);
+        // at least one thread is left for background transfers
+        const auto interactive_workers = std::min(m_options.interactive_workers, workers - 1);
+        for (std::size_t i = 0; i < workers; i++) {
+            m_threads.emplace_back(&Queue::work, this, i < interactive_workers);
+        }
+    }
+
+    ~Queue() {
+        stop();
+    }
+
+    std::future<void> submit(
+            TransferLane lane, const std::string &host, Transfer transfer, std::optional<Clock::time_point> deadline) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto &queue = m_lanes[index_of(lane)];
+        if (m_stopping) {
+            throw exceptions::TransferRejected("the transfer scheduler has been stopped");
+        }
+        if (queue.max_queued != 0 && queue.stats.queued >= queue.max_queued) {
+            queue.stats.rejected++;
+            throw exceptions::TransferRejected("too many transfers are waiting");
+        }
+        QueuedTransfer queued{std::move(transfer), {}, Clock::now(), deadline};
+        auto done = queued.done.get_future();
+        const QueueKey key = {deadline.value_or(Clock::time_point::max()), m_next_sequence++};
+        queue.waiting[host].emplace(key, std::move(queued));
+        queue.stats.queued++;
+        lock.unlock();
+        m_changed.notify_all();
+        return done;
+    }
+
+    void stop() {
+        std::vector<QueuedTransfer> dropped;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping) {
+                return;
+            }
+            m_stopping = true;
+            for (auto &lane: m_lanes) {
+                for (auto &[host, waiting]: lane.waiting) {
+                    for (auto &[key, queued]: waiting) {
+                        dropped.push_back(std::move(queued));
+                    }
+                }
+                lane.waiting.clear();
+                lane.stats.queued = 0;
+            }
+        }
+        m_changed.notify_all();
+        for (auto &thread: m_threads) {
+            thread.join();
+        }
+        for (auto &queued: dropped) {
+            queued.done.set_exception(std::make_exception_ptr(
+                    exceptions::TransferRejected("the transfer scheduler has been stopped")));
+        }
+    }
+
+    TransferSchedulerStats stats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TransferSchedulerStats stats;
+        stats.interactive = m_lanes[index_of(TransferLane::INTERACTIVE)].stats;
+        stats.background = m_lanes[index_of(TransferLane::BACKGROUND)].stats;
+        for (const auto &[host, running]: m_running) {
+            if (running != 0) {
+                stats.running_per_host.emplace(host, running);
+            }
+        }
+        for (const auto &[host, controller]: m_controllers) {
+            stats.limit_per_host.emplace(host, controller->limit());
+        }
+        return stats;
+    }
+
+private:
+    const TransferSchedulerOptions m_options;
+    std::vector<std::thread> m_threads;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    bool m_stopping = false;
+    Lane m_lanes[2];
+    std::map<std::string, std::size_t> m_running;
+    /// only used if the concurrency is adaptive. Controllers are never removed, so pointers to them stay valid.
+    std::map<std::string, std::unique_ptr<ConcurrencyController>> m_controllers;
+    std::uint64_t m_next_sequence = 0;
+
+    static std::size_t index_of(TransferLane lane) {
+        return lane == TransferLane::INTERACTIVE ? 0 : 1;
+    }
+
+    /// @return the fixed limit of `host`, `0` if there is none
+    [[nodiscard]] std::size_t fixed_limit_of(const std::string &host) const {
+        const auto limit = m_options.host_limits.find(host);
+        return limit != m_options.host_limits.end() ? limit->second : m_options.max_per_host;
+    }
+
+    ConcurrencyController *controller_of(const std::string &host) {
+        if (!m_options.adaptive_concurrency) {
+            return nullptr;
+        }
+        auto &controller = m_controllers[host];
+        if (!controller) {
+            auto limits = m_options.adaptive_limits;
+            if (const auto fixed_limit = fixed_limit_of(host); fixed_limit != 0) {
+                limits.max = std::min(limits.max, fixed_limit);
+            }
+            controller = std::make_unique<ConcurrencyController>(limits);
+        }
+        return controller.get();
+    }
+
+    /**
+     * @param wake_up set to when a host that has been paused by its controller can take transfers again, if that is
+     *        earlier than its current value
+     */
+    bool has_capacity(const std::string &host, Clock::time_point now, std::optional<Clock::time_point> &wake_up) {
+        auto max_running = fixed_limit_of(host);
+        if (auto *controller = controller_of(host)) {
+            if (const auto paused_until = controller->paused_until(); paused_until > now) {
+                wake_up = std::min(wake_up.value_or(paused_until), paused_until);
+                return false;
+            }
+            max_running = controller->limit();
+        }
+        if (max_running == 0) {
+            return true;
+        }
+        const auto running = m_running.find(host);
+        return running == m_running.end() || running->second < max_running;
+    }
+
+    /// @return the most urgent transfer of `lane` whose host isn't at its limit, `waiting.end()` if there is none
+    decltype(Lane::waiting)::iterator next_of(
+            Lane &lane, Clock::time_point now, std::optional<Clock::time_point> &wake_up) {
+        auto next = lane.waiting.end();
+        for (auto host = lane.waiting.begin(); host != lane.waiting.end(); ++host) {
+            if ((next == lane.waiting.end() || host->second.begin()->first < next->second.begin()->first)
+                && has_capacity(host->first, now, wake_up)) {
+                next = host;
+            }
+        }
+        return next;
+    }
+
+    void work(bool interactive_only) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            Lane *lane = nullptr;
+            decltype(Lane::waiting)::iterator host;
+            while (!m_stopping) {
+                const auto now = Clock::now();
+                std::optional<Clock::time_point> wake_up;
+                for (auto &candidate: m_lanes) {
+                    host = next_of(candidate, now, wake_up);
+                    if (host != candidate.waiting.end()) {
+                        lane = &candidate;
+                        break;
+                    }
+                    if (interactive_only) {
+                        break;
+                    }
+                }
+                if (lane) {
+                    break;
+                }
+                if (wake_up) {
+                    m_changed.wait_until(lock, *wake_up);
+                } else {
+                    m_changed.wait(lock);
+                }
+            }
+            if (m_stopping) {
+                return;
+            }
+            const auto host_key = host->first;
+            auto *controller = controller_of(host_key);
+            auto queued = std::move(host->second.begin()->second);
+            host->second.erase(host->second.begin());
+            if (host->second.empty()) {
+                lane->waiting.erase(host);
+            }
+
+            const auto started = Clock::now();
+            const auto waited = to_microseconds(started - queued.submitted);
+            auto &stats = lane->stats;
+            stats.queued--;
+            stats.running++;
+            stats.started++;
+            stats.total_wait += waited;
+            stats.max_wait = std::max(stats.max_wait, waited);
+            if (queued.deadline && started > *queued.deadline) {
+                stats.missed_deadlines++;
+            }
+            m_running[host_key]++;
+
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                queued.transfer();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            if (controller) {
+                controller->report(Clock::now() - started, error);
+            }
+            if (error) {
+                queued.done.set_exception(error);
+            } else {
+                queued.done.set_value();
+            }
+            lock.lock();
+
+            stats.running--;
+            m_running[host_key]--;
+            // the host may have room for a transfer that has been passed over
+            m_changed.notify_all();
+        }
+    }
+};
+
+TransferScheduler::TransferScheduler(TransferSchedulerOptions options)
+        : m_queue(std::make_unique<Queue>(std::move(options))) {}
+
+TransferScheduler::~TransferScheduler() = default;
+
+std::future<void> TransferScheduler::submit(
+        TransferLane lane, const std::string &host, Transfer transfer, std::optional<Clock::time_point> deadline) {
+    return m_queue->submit(lane, host, std::move(transfer), deadline);
+}
+
+void TransferScheduler::stop() {
+    m_queue->stop();
+}
+
+TransferSchedulerStats TransferScheduler::stats() const {
+    return m_queue->stats();
+}
+
+std::string TransferScheduler::host_of(const std::string &url) {
+    auto start = url.find("://");
+    start = start == std::string::npos ? 0 : start + 3;
+    auto end = url.find_first_of("/?#", start);
+    if (end == std::string::npos) {
+        end = url.size();
+    }
+    // user info isn't part of the host
+    if (const auto at = url.rfind('@', end); at != std::string::npos && at >= start) {
+        start = at + 1;
+    }
+    auto host = url.substr(start, end - start);
+    std::transform(host.begin(), host.end(), host.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return host;
+}
@@ -5,6 +5,7 @@ using namespace CloudSync;
 using namespace CloudSync::credentials;
 
 std::string OAuth2CredentialsImpl::get_current_access_token() {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if(m_access_token.empty() && m_refresh_token.empty()) {
         const auto response_json = m_request->POST(m_token_endpoint)
                 ->postfield("client_id", m_client_id)
@@ -2,6 +2,7 @@
 
 #include "CloudSync/OAuth2Credentials.hpp"
 #include "request/Request.hpp"
+#include <mutex>
 #include <utility>
 
 namespace CloudSync::credentials {
@@ -34,6 +35,8 @@ namespace CloudSync::credentials {
         void set_request(const std::shared_ptr<request::Request>& request);
         void set_token_endpoint(const std::string& token_endpoint);
     private:
+        /// bulk operations ask for the token from several threads
+        std::mutex m_mutex;
         std::shared_ptr<request::Request> m_request;
         std::string m_token_endpoint;
         const std::string m_client_id;
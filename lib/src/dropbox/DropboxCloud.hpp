@@ -15,11 +15,16 @@ namespace CloudSync::dropbox {
                 : OAuthCloudImpl("https://www.dropbox.com", "https://api.dropbox.com/oauth2/token", credentials, request) {}
 
         std::shared_ptr<Directory> root() const override {
-            return std::make_shared<DropboxDirectory>("/", m_credentials, m_request, "");
+            return std::make_shared<DropboxDirectory>(
+                    "/", m_credentials, m_request, "", std::chrono::system_clock::time_point(), m_known_directories);
         }
 
         std::string get_user_display_name() const override;
 
         void logout() override;
+
+    private:
+        /// directories that are known to exist, shared by all directories of this cloud
+        const std::shared_ptr<util::KnownDirectories> m_known_directories = std::make_shared<util::KnownDirectories>();
     };
 }
@@ -5,7 +5,12 @@
 #include "DropboxExceptionTranslator.hpp"
 #include "CloudSync/exceptions/resource/ResourceException.hpp"
 #include "CloudSync/exceptions/cloud/CloudException.hpp"
+#include "util/DateTime.hpp"
+#include <algorithm>
+#include <cstdlib>
 #include <filesystem>
+#include <iterator>
+#include <thread>
 #include <vector>
 
 using namespace CloudSync;
@@ -14,38 +19,48 @@ using namespace CloudSync::dropbox;
 using json = nlohmann::json;
 namespace fs = std::filesystem;
 
+const std::vector<std::string> DropboxDirectory::ENTRY_FIELDS = {
+        ".tag", "name", "path_display", "rev", "id", "size", "server_modified", "content_hash"};
+
+const std::vector<std::string> DropboxDirectory::LIST_FOLDER_FIELDS = {"cursor", "has_more"};
+
+const std::string DropboxDirectory::SEARCH_MATCH_METADATA = "metadata/metadata/";
+
+const std::vector<std::string> DropboxDirectory::SEARCH_MATCH_FIELDS = [] {
+    std::vector<std::string> fields;
+    for (const auto &field: ENTRY_FIELDS) {
+        fields.push_back(SEARCH_MATCH_METADATA + field);
+    }
+    return fields;
+}();
+
+const std::size_t DropboxDirectory::MAX_SEARCH_RESULTS = 1000;
+
+const std::size_t DropboxDirectory::MAX_BATCH_ENTRIES = 1000;
+
+const std::chrono::milliseconds DropboxDirectory::BATCH_POLL_INTERVAL = 100ms;
+
+const std::chrono::milliseconds DropboxDirectory::MAX_BATCH_POLL_INTERVAL = 2000ms;
+
 std::vector<std::shared_ptr<Resource>> DropboxDirectory::list_resources() const {
     std::vector<std::shared_ptr<Resource>> resources;
     try {
-        const auto token = m_credentials->get_current_access_token();
-        const auto path_string = m_path.generic_string();
-        const json response_json = m_request->POST("https://api.dropboxapi.com/2/files/list_folder")
-                ->token_auth(token)
-                ->accept(Request::MIMETYPE_JSON)
-                ->json_body({
-                        {"path", path_string == "/" ? "" : path_string},
-                        {"recursive", false}
-                })->request().json();
-        for (const auto &entry: response_json.at("entries")) {
+        for (const auto &entry: this->list_folder()) {
             resources.push_back(this->parseEntry(entry));
         }
-        // the following code takes care of paging
-        bool hasMore = response_json.at("has_more");
-        std::string cursor = response_json.at("cursor");
-        while(hasMore) {
-            const auto token = m_credentials->get_current_access_token();
-            const json continue_response_json = m_request->POST(
-                            "https://api.dropboxapi.com/2/files/list_folder/continue")
-                    ->token_auth(token)
-                    ->accept(Request::MIMETYPE_JSON)
-                    ->json_body({
-                            {"cursor", cursor}
-                    })->request().json();
-            hasMore = continue_response_json.at("has_more");
-            cursor = continue_response_json.at("cursor");
-            for (const auto &entry: continue_response_json.at("entries")) {
-                resources.push_back(this->parseEntry(entry));
-            }
+    } catch (...) {
+        DropboxExceptionTranslator::translate(m_path);
+    }
+    return resources;
+}
+
+std::vector<ResourceInfo> DropboxDirectory::list_resource_info() const {
+    std::vector<ResourceInfo> resources;
+    try {
+        const auto entries = this->list_folder();
+        resources.reserve(entries.size());
+        for (const auto &entry: entries) {
+            resources.push_back(parse_resource_info(entry));
         }
     } catch (...) {
         DropboxExceptionTranslator::translate(m_path);
@@ -53,21 +68,34 @@ std::vector<std::shared_ptr<Resource>> DropboxDirectory::list_resources() const
     return resources;
 }
 
+std::shared_ptr<Resource> DropboxDirectory::get_resource(const ResourceInfo &info) const {
+    const auto resource_path = append_path(info.name).generic_string();
+    if (info.is_file()) {
+        return std::make_shared<DropboxFile>(
+                resource_path, m_credentials, m_request, info.name, info.revision, info.size, info.modified,
+                info.content_hash);
+    } else {
+        return std::make_shared<DropboxDirectory>(
+                resource_path, m_credentials, m_request, info.name, info.modified, m_known_directories);
+    }
+}
+
 std::shared_ptr<Directory> DropboxDirectory::get_directory(const std::filesystem::path &path) const {
     const auto resource_path = append_path(path);
     std::shared_ptr<DropboxDirectory> directory;
     // get_metadata is not supported for the root folder
     if (resource_path.generic_string() == "/") {
-        directory = std::make_shared<DropboxDirectory>("/", m_credentials, m_request, "");
+        directory = std::make_shared<DropboxDirectory>(
+                "/", m_credentials, m_request, "", std::chrono::system_clock::time_point(), m_known_directories);
     } else {
         try {
             const auto token = m_credentials->get_current_access_token();
-            const json response_json = m_request->POST("https://api.dropboxapi.com/2/files/get_metadata")
+            const auto entry = m_request->POST("https://api.dropboxapi.com/2/files/get_metadata")
                     ->token_auth(token)
                     ->accept(Request::MIMETYPE_JSON)
                     ->json_body({{"path", resource_path.generic_string()}})
-                    ->request().json();
-            directory = std::dynamic_pointer_cast<DropboxDirectory>(this->parseEntry(response_json, "folder"));
+                    ->request().json_records("", ENTRY_FIELDS);
+            directory = std::dynamic_pointer_cast<DropboxDirectory>(this->parseEntry(entry.record(), "folder"));
 
         } catch (...) {
             DropboxExceptionTranslator::translate(resource_path);
@@ -85,43 +113,115 @@ void DropboxDirectory::remove() {
         m_request->POST("https://api.dropboxapi.com/2/files/delete_v2")
                 ->token_auth(token)
                 ->json_body({{"path", m_path.generic_string()}})->request();
+        m_known_directories->remove(m_path);
     } catch (...) {
         DropboxExceptionTranslator::translate(m_path);
     }
 }
 
+std::shared_ptr<Resource> DropboxDirectory::copy_to(const std::filesystem::path &path) const {
+    return this->transfer("https://api.dropboxapi.com/2/files/copy_v2", destination_path(path));
+}
+
+std::shared_ptr<Resource> DropboxDirectory::move_to(const std::filesystem::path &path) {
+    const auto moved = this->transfer("https://api.dropboxapi.com/2/files/move_v2", destination_path(path));
+    m_known_directories->remove(m_path);
+    return moved;
+}
+
 std::shared_ptr<Directory> DropboxDirectory::create_directory(const std::filesystem::path &path) const {
     const auto resource_path = append_path(path);
     std::shared_ptr<Directory> directory;
     try {
         const auto token = m_credentials->get_current_access_token();
-        const json response_json = m_request->POST("https://api.dropboxapi.com/2/files/create_folder_v2")
+        const auto response = m_request->POST("https://api.dropboxapi.com/2/files/create_folder_v2")
                 ->token_auth(token)
                 ->accept(Request::MIMETYPE_JSON)
                 ->json_body({
                         {"path", resource_path.generic_string()}
-                })->request().json();
+                })->request().json_records("metadata", ENTRY_FIELDS);
         directory = std::dynamic_pointer_cast<DropboxDirectory>(
-                        this->parseEntry(response_json.at("metadata"), "folder"));
+                        this->parseEntry(response.record(), "folder"));
+        m_known_directories->add(directory->path());
     } catch (...) {
         DropboxExceptionTranslator::translate(resource_path);
     }
     return directory;
 }
 
+std::shared_ptr<Directory> DropboxDirectory::ensure_directory(const std::filesystem::path &path) const {
+    const auto resource_path = append_path(path);
+    if (!m_known_directories->contains(resource_path)) {
+        try {
+            // missing parents are created along with the folder
+            const auto token = m_credentials->get_current_access_token();
+            m_request->POST("https://api.dropboxapi.com/2/files/create_folder_v2")
+                    ->token_auth(token)
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->json_body({
+                            {"path", resource_path.generic_string()},
+                            {"autorename", false}
+                    })->request();
+        } catch (const request::exceptions::response::Conflict &e) {
+            // a folder at the path is what has been asked for, a file or a missing permission is not
+            bool is_folder = false;
+            try {
+                const std::string error_summary = e.json().at("error_summary");
+                is_folder = error_summary.rfind("path/conflict/folder", 0) == 0;
+            } catch (...) {
+                // translated below
+            }
+            if (!is_folder) {
+                DropboxExceptionTranslator::translate(resource_path);
+            }
+        } catch (...) {
+            DropboxExceptionTranslator::translate(resource_path);
+        }
+        m_known_directories->add(resource_path);
+    }
+    return std::make_shared<DropboxDirectory>(
+            resource_path.generic_string(), m_credentials, m_request, resource_path.filename().generic_string(),
+            std::chrono::system_clock::time_point(), m_known_directories);
+}
+
 std::shared_ptr<File> DropboxDirectory::create_file(const std::filesystem::path &path) const {
     const auto resource_path = append_path(path);
     std::shared_ptr<File> file;
     try {
         const auto token = m_credentials->get_current_access_token();
-        const json response_json = m_request->POST("https://content.dropboxapi.com/2/files/upload")
+        const auto entry = m_request->POST("https://content.dropboxapi.com/2/files/upload")
                 ->token_auth(token)
                 ->content_type(Request::MIMETYPE_BINARY)
                 ->accept(Request::MIMETYPE_JSON)
                 ->query_param("arg", json{
                         {"path", resource_path.generic_string()}
-                }.dump())->request().json();
-        file = std::dynamic_pointer_cast<DropboxFile>(this->parseEntry(response_json, "file"));
+                }.dump())->request().json_records("", ENTRY_FIELDS);
+        file = std::dynamic_pointer_cast<DropboxFile>(this->parseEntry(entry.record(), "file"));
+    } catch (...) {
+        DropboxExceptionTranslator::translate(resource_path);
+    }
+    return file;
+}
+
+std::shared_ptr<File> DropboxDirectory::create_file(
+        const std::filesystem::path &path, const std::vector<std::uint8_t> &content) const {
+    const auto resource_path = append_path(path);
+    std::shared_ptr<File> file;
+    try {
+        // `add` fails with a conflict instead of overwriting or renaming, missing parents are created on the way
+        const auto token = m_credentials->get_current_access_token();
+        const auto entry = m_request->POST("https://content.dropboxapi.com/2/files/upload")
+                ->token_auth(token)
+                ->content_type(Request::MIMETYPE_BINARY)
+                ->accept(Request::MIMETYPE_JSON)
+                ->query_param("arg", json{
+                        {"path", resource_path.generic_string()},
+                        {"mode", "add"},
+                        {"autorename", false}
+                }.dump())
+                ->binary_body(content)
+                ->request().json_records("", ENTRY_FIELDS);
+        file = std::dynamic_pointer_cast<DropboxFile>(this->parseEntry(entry.record(), "file"));
     } catch (...) {
         DropboxExceptionTranslator::translate(resource_path);
     }
@@ -133,27 +233,213 @@ std::shared_ptr<File> DropboxDirectory::get_file(const std::filesystem::path &pa
     std::shared_ptr<DropboxFile> file;
     try {
         const auto token = m_credentials->get_current_access_token();
-        json response_json = m_request->POST("https://api.dropboxapi.com/2/files/get_metadata")
+        const auto entry = m_request->POST("https://api.dropboxapi.com/2/files/get_metadata")
                 ->token_auth(token)
                 ->accept(Request::MIMETYPE_JSON)
                 ->json_body({
                         {"path", resource_path.generic_string()}
-                })->request().json();
-        file = std::dynamic_pointer_cast<DropboxFile>(this->parseEntry(response_json, "file"));
+                })->request().json_records("", ENTRY_FIELDS);
+        file = std::dynamic_pointer_cast<DropboxFile>(this->parseEntry(entry.record(), "file"));
     } catch (...) {
         DropboxExceptionTranslator::translate(resource_path);
     }
     return file;
 }
 
+std::vector<BulkResult> DropboxDirectory::remove_many(const std::vector<std::filesystem::path> &paths) const {
+    auto results = bulk_results<BulkResult>(paths);
+    std::vector<std::size_t> batch;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        if (append_path(results[i].path).generic_string() == "/") {
+            results[i].error = std::make_exception_ptr(exceptions::resource::PermissionDenied("/"));
+        } else {
+            batch.push_back(i);
+        }
+    }
+    for (std::size_t offset = 0; offset < batch.size(); offset += MAX_BATCH_ENTRIES) {
+        const auto end = std::min(batch.size(), offset + MAX_BATCH_ENTRIES);
+        try {
+            json entries = json::array();
+            for (auto i = offset; i < end; i++) {
+                entries.push_back({{"path", append_path(results[batch[i]].path).generic_string()}});
+            }
+            const auto token = m_credentials->get_current_access_token();
+            const auto job = m_request->POST("https://api.dropboxapi.com/2/files/delete_batch")
+                    ->token_auth(token)
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->json_body({{"entries", entries}})
+                    ->request().json();
+            const auto completed = this->await_batch_job(job, "https://api.dropboxapi.com/2/files/delete_batch/check");
+            const auto &completed_entries = completed.at("entries");
+            for (auto i = offset; i < end; i++) {
+                const auto &entry = completed_entries.at(i - offset);
+                if (entry.at(".tag") != "success") {
+                    results[batch[i]].error = batch_entry_error(entry, append_path(results[batch[i]].path));
+                } else {
+                    m_known_directories->remove(append_path(results[batch[i]].path));
+                }
+            }
+        } catch (...) {
+            const auto error = translated_error([this] { DropboxExceptionTranslator::translate(m_path); });
+            for (auto i = offset; i < end; i++) {
+                results[batch[i]].error = error;
+            }
+        }
+    }
+    return results;
+}
+
+std::vector<BulkValue<std::shared_ptr<Directory>>> DropboxDirectory::create_directories(
+        const std::vector<std::filesystem::path> &paths) const {
+    auto results = bulk_results<BulkValue<std::shared_ptr<Directory>>>(paths);
+    for (std::size_t offset = 0; offset < results.size(); offset += MAX_BATCH_ENTRIES) {
+        const auto end = std::min(results.size(), offset + MAX_BATCH_ENTRIES);
+        try {
+            json batch_paths = json::array();
+            for (auto i = offset; i < end; i++) {
+                batch_paths.push_back(append_path(results[i].path).generic_string());
+            }
+            const auto token = m_credentials->get_current_access_token();
+            const auto job = m_request->POST("https://api.dropboxapi.com/2/files/create_folder_batch")
+                    ->token_auth(token)
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->json_body({
+                            {"paths", batch_paths},
+                            {"autorename", false},
+                            {"force_async", false}
+                    })->request().json();
+            const auto completed = this->await_batch_job(
+                    job, "https://api.dropboxapi.com/2/files/create_folder_batch/check");
+            const auto &completed_entries = completed.at("entries");
+            for (auto i = offset; i < end; i++) {
+                const auto &entry = completed_entries.at(i - offset);
+                if (entry.at(".tag") == "success") {
+                    const auto &metadata = entry.at("metadata");
+                    m_known_directories->add(std::string(metadata.at("path_display")));
+                    results[i].value = std::make_shared<DropboxDirectory>(
+                            metadata.at("path_display"), m_credentials, m_request, metadata.at("name"),
+                            std::chrono::system_clock::time_point(), m_known_directories);
+                } else {
+                    results[i].error = batch_entry_error(entry, append_path(results[i].path));
+                }
+            }
+        } catch (...) {
+            const auto error = translated_error([this] { DropboxExceptionTranslator::translate(m_path); });
+            for (auto i = offset; i < end; i++) {
+                results[i].error = error;
+            }
+        }
+    }
+    return results;
+}
+
+std::vector<BulkValue<ResourceInfo>> DropboxDirectory::stat_many(const std::vector<std::filesystem::path> &paths) const {
+    // there is no batch version of get_metadata
+    auto results = bulk_results<BulkValue<ResourceInfo>>(paths);
+    run_parallel<BulkValue<ResourceInfo>>(
+            results,
+            [this](const std::shared_ptr<Request> &request, BulkValue<ResourceInfo> &result) {
+                const DropboxDirectory worker(m_path.generic_string(), m_credentials, request, m_name);
+                result.value = worker.stat_resource(append_path(result.path));
+            });
+    return results;
+}
+
+std::vector<BulkValue<std::shared_ptr<File>>> DropboxDirectory::upload_many(const std::vector<FileUpload> &files) const {
+    using Result = BulkValue<std::shared_ptr<File>>;
+    auto results = bulk_results<Result>(paths_of(files));
+    // Every file gets an upload session of its own that is closed with its only chunk. Committing all sessions with
+    // a single finish_batch call takes the namespace lock once, instead of once per file.
+    struct Session : BulkResult {
+        const FileUpload *file = nullptr;
+        std::string id;
+    };
+    auto sessions = bulk_results<Session>(paths_of(files));
+    for (std::size_t i = 0; i < files.size(); i++) {
+        sessions[i].file = &files[i];
+    }
+    run_parallel<Session>(sessions, [this](const std::shared_ptr<Request> &request, Session &session) {
+        try {
+            const auto token = m_credentials->get_current_access_token();
+            session.id = request->POST("https://content.dropboxapi.com/2/files/upload_session/start")
+                    ->token_auth(token)
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->content_type(Request::MIMETYPE_BINARY)
+                    ->query_param("arg", json{{"close", true}}.dump())
+                    ->binary_body(session.file->content)
+                    ->request().json().at("session_id");
+        } catch (...) {
+            DropboxExceptionTranslator::translate(append_path(session.path));
+        }
+    });
+    std::vector<std::size_t> batch;
+    for (std::size_t i = 0; i < sessions.size(); i++) {
+        if (sessions[i].ok()) {
+            batch.push_back(i);
+        } else {
+            results[i].error = sessions[i].error;
+        }
+    }
+    for (std::size_t offset = 0; offset < batch.size(); offset += MAX_BATCH_ENTRIES) {
+        const auto end = std::min(batch.size(), offset + MAX_BATCH_ENTRIES);
+        try {
+            json entries = json::array();
+            for (auto i = offset; i < end; i++) {
+                const auto &session = sessions[batch[i]];
+                entries.push_back({
+                        {"cursor", {{"session_id", session.id}, {"offset", session.file->content.size()}}},
+                        {"commit", {
+                                {"path", append_path(session.path).generic_string()},
+                                {"mode", "overwrite"},
+                                {"autorename", false},
+                                {"mute", true}
+                        }}
+                });
+            }
+            const auto token = m_credentials->get_current_access_token();
+            const auto completed = m_request->POST("https://api.dropboxapi.com/2/files/upload_session/finish_batch_v2")
+                    ->token_auth(token)
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->json_body({{"entries", entries}})
+                    ->request().json();
+            const auto &completed_entries = completed.at("entries");
+            for (auto i = offset; i < end; i++) {
+                const auto &entry = completed_entries.at(i - offset);
+                auto &result = results[batch[i]];
+                if (entry.at(".tag") == "success") {
+                    // the metadata of the file is inlined into the entry
+                    result.value = std::make_shared<DropboxFile>(
+                            entry.at("path_display"),
+                            m_credentials,
+                            m_request,
+                            entry.at("name"),
+                            entry.at("rev"),
+                            entry.value("size", std::uint64_t(0)),
+                            util::parse_iso8601(entry.value("server_modified", ""))
+                                    .value_or(std::chrono::system_clock::time_point()),
+                            DropboxFile::parse_content_hash(entry.value("content_hash", "")));
+                } else {
+                    result.error = batch_entry_error(entry, append_path(result.path));
+                }
+            }
+        } catch (...) {
+            const auto error = translated_error([this] { DropboxExceptionTranslator::translate(m_path); });
+            for (auto i = offset; i < end; i++) {
+                results[batch[i]].error = error;
+            }
+        }
+    }
+    return results;
+}
+
 std::shared_ptr<Resource>
-DropboxDirectory::parseEntry(const json &entry, const std::string &resourceTypeFallback) const {
+DropboxDirectory::parseEntry(const request::JsonRecord &entry, const std::string &resourceTypeFallback) const {
     std::shared_ptr<Resource> resource;
     std::string resourceType;
-    const std::string name = entry.at("name");
-    std::string path = entry.at("path_display");
-    if (entry.find(".tag") != entry.end()) {
-        resourceType = entry[".tag"];
+    const std::string &name = entry.at("name");
+    const std::string &path = entry.at("path_display");
+    if (entry.contains(".tag")) {
+        resourceType = entry.at(".tag");
     } else {
         if (!resourceTypeFallback.empty()) {
             resourceType = resourceTypeFallback;
@@ -165,9 +451,207 @@ DropboxDirectory::parseEntry(const json &entry, const std::string &resourceTypeF
         throw exceptions::resource::NoSuchResource(path);
     }
     if (resourceType == "folder") {
-        resource = std::make_shared<DropboxDirectory>(path, m_credentials, m_request, name);
+        resource = std::make_shared<DropboxDirectory>(
+                path, m_credentials, m_request, name, std::chrono::system_clock::time_point(), m_known_directories);
     } else if (resourceType == "file") {
-        resource = std::make_shared<DropboxFile>(path, m_credentials, m_request, name, entry.at("rev"));
+        resource = std::make_shared<DropboxFile>(
+                path,
+                m_credentials,
+                m_request,
+                name,
+                entry.at("rev"),
+                std::strtoull(entry.value("size", "0").c_str(), nullptr, 10),
+                util::parse_iso8601(entry.value("server_modified")).value_or(std::chrono::system_clock::time_point()),
+                DropboxFile::parse_content_hash(entry.value("content_hash")));
     }
     return resource;
-}
\ No newline at end of file
+}
+std::shared_ptr<Directory> DropboxDirectory::with_new_connection() const {
+    return std::make_shared<DropboxDirectory>(
+            m_path.generic_string(), m_credentials, m_request->clone(), m_name, m_modified, m_known_directories);
+}
+
+void DropboxDirectory::search(const SearchQuery &query, const SearchPageHandler &on_page) const {
+    const auto to_results = [](const std::vector<request::JsonRecord> &entries, const std::string &prefix) {
+        std::vector<SearchResult> results;
+        results.reserve(entries.size());
+        for (const auto &entry: entries) {
+            results.push_back({entry.at(prefix + "path_display"), parse_resource_info(entry, prefix)});
+        }
+        return results;
+    };
+    try {
+        if (query.name.empty()) {
+            // search_v2 needs a text to look for, so the whole subtree is listed instead
+            this->list_folder(true, [&](const std::vector<request::JsonRecord> &entries) {
+                return this->deliver_search_page(query, to_results(entries, ""), on_page);
+            });
+            return;
+        }
+        const auto path_string = m_path.generic_string();
+        json options = {
+                {"path", path_string == "/" ? "" : path_string},
+                {"max_results", MAX_SEARCH_RESULTS},
+                {"file_status", "active"},
+                {"filename_only", true}};
+        if (query.kind == ResourceInfo::Kind::DIRECTORY) {
+            options["file_categories"] = {"folder"};
+        }
+        auto response = m_request->POST("https://api.dropboxapi.com/2/files/search_v2")
+                ->token_auth(m_credentials->get_current_access_token())
+                ->accept(Request::MIMETYPE_JSON)
+                ->json_body({
+                        {"query", query.name},
+                        {"options", options}
+                })->request().json_records("matches", SEARCH_MATCH_FIELDS, LIST_FOLDER_FIELDS);
+        while (this->deliver_search_page(query, to_results(response.records, SEARCH_MATCH_METADATA), on_page)
+               && response.page.value("has_more") == "true") {
+            response = m_request->POST("https://api.dropboxapi.com/2/files/search/continue_v2")
+                    ->token_auth(m_credentials->get_current_access_token())
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->json_body({
+                            {"cursor", response.page.at("cursor")}
+                    })->request().json_records("matches", SEARCH_MATCH_FIELDS, LIST_FOLDER_FIELDS);
+        }
+    } catch (...) {
+        DropboxExceptionTranslator::translate(m_path);
+    }
+}
+
+std::vector<request::JsonRecord> DropboxDirectory::list_folder() const {
+    std::vector<request::JsonRecord> entries;
+    this->list_folder(false, [&entries](std::vector<request::JsonRecord> &page) {
+        std::move(page.begin(), page.end(), std::back_inserter(entries));
+        return true;
+    });
+    return entries;
+}
+
+void DropboxDirectory::list_folder(
+        bool recursive, const std::function<bool(std::vector<request::JsonRecord> &)> &on_page) const {
+    const auto token = m_credentials->get_current_access_token();
+    const auto path_string = m_path.generic_string();
+    auto response = m_request->POST("https://api.dropboxapi.com/2/files/list_folder")
+            ->token_auth(token)
+            ->accept(Request::MIMETYPE_JSON)
+            ->json_body({
+                    {"path", path_string == "/" ? "" : path_string},
+                    {"recursive", recursive}
+            })->request().json_records("entries", ENTRY_FIELDS, LIST_FOLDER_FIELDS);
+    // the following code takes care of paging
+    while (on_page(response.records) && response.page.at("has_more") == "true") {
+        const auto token = m_credentials->get_current_access_token();
+        response = m_request->POST("https://api.dropboxapi.com/2/files/list_folder/continue")
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->json_body({
+                        {"cursor", response.page.at("cursor")}
+                })->request().json_records("entries", ENTRY_FIELDS, LIST_FOLDER_FIELDS);
+    }
+}
+
+std::shared_ptr<Resource> DropboxDirectory::transfer(const std::string &endpoint, const std::filesystem::path &destination) const {
+    std::shared_ptr<Resource> directory;
+    try {
+        const auto token = m_credentials->get_current_access_token();
+        const auto response = m_request->POST(endpoint)
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->json_body({
+                        {"from_path", m_path.generic_string()},
+                        {"to_path", destination.generic_string()},
+                        {"autorename", false}
+                })->request().json_records("metadata", ENTRY_FIELDS);
+        directory = this->parseEntry(response.record(), "folder");
+    } catch (...) {
+        DropboxExceptionTranslator::translate(m_path);
+    }
+    return directory;
+}
+
+ResourceInfo DropboxDirectory::stat_resource(const std::filesystem::path &resource_path) const {
+    ResourceInfo info;
+    // get_metadata is not supported for the root folder
+    if (resource_path.generic_string() == "/") {
+        info.kind = ResourceInfo::Kind::DIRECTORY;
+        return info;
+    }
+    try {
+        const auto token = m_credentials->get_current_access_token();
+        const auto entry = m_request->POST("https://api.dropboxapi.com/2/files/get_metadata")
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->json_body({{"path", resource_path.generic_string()}})
+                ->request().json_records("", ENTRY_FIELDS);
+        info = parse_resource_info(entry.record());
+    } catch (...) {
+        DropboxExceptionTranslator::translate(resource_path);
+    }
+    return info;
+}
+
+json DropboxDirectory::await_batch_job(json launch_result, const std::string &check_url) const {
+    auto job = std::move(launch_result);
+    if (job.at(".tag") == "async_job_id") {
+        const std::string job_id = job.at("async_job_id");
+        auto delay = BATCH_POLL_INTERVAL;
+        while (true) {
+            const auto token = m_credentials->get_current_access_token();
+            job = m_request->POST(check_url)
+                    ->token_auth(token)
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->json_body({{"async_job_id", job_id}})
+                    ->request().json();
+            if (job.at(".tag") != "in_progress") {
+                break;
+            }
+            std::this_thread::sleep_for(delay);
+            delay = std::min(delay * 2, MAX_BATCH_POLL_INTERVAL);
+        }
+    }
+    if (job.at(".tag") != "complete") {
+        throw exceptions::cloud::CommunicationError("batch job has failed: " + job.dump());
+    }
+    return job;
+}
+
+std::exception_ptr DropboxDirectory::batch_entry_error(const json &entry, const std::filesystem::path &path) {
+    // The failure is a union like `{".tag": "path_lookup", "path_lookup": {".tag": "not_found"}}`. Flattened into an
+    // error summary it can be handled like the error response of the single operation.
+    std::string error_summary;
+    const json *failure = &entry.at("failure");
+    while (failure->is_object() && failure->contains(".tag")) {
+        const std::string tag = failure->at(".tag");
+        error_summary += tag + "/";
+        if (!failure->contains(tag)) {
+            break;
+        }
+        failure = &failure->at(tag);
+    }
+    try {
+        throw request::exceptions::response::Conflict(json{{"error_summary", error_summary}}.dump());
+    } catch (...) {
+        return translated_error([&path] { DropboxExceptionTranslator::translate(path); });
+    }
+}
+
+ResourceInfo DropboxDirectory::parse_resource_info(const request::JsonRecord &entry, const std::string &prefix) {
+    ResourceInfo info;
+    info.name = entry.at(prefix + "name");
+    info.id = entry.value(prefix + "id");
+    const std::string &type = entry.at(prefix + ".tag");
+    if (type == "file") {
+        info.kind = ResourceInfo::Kind::FILE;
+        info.revision = entry.at(prefix + "rev");
+        info.size = std::strtoull(entry.value(prefix + "size", "0").c_str(), nullptr, 10);
+        if (const auto modified = util::parse_iso8601(entry.value(prefix + "server_modified"))) {
+            info.modified = *modified;
+        }
+        info.content_hash = DropboxFile::parse_content_hash(entry.value(prefix + "content_hash"));
+    } else if (type == "folder") {
+        info.kind = ResourceInfo::Kind::DIRECTORY;
+    } else {
+        throw exceptions::cloud::CommunicationError("unknown resource type");
+    }
+    return info;
+}
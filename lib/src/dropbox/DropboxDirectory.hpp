@@ -2,7 +2,10 @@
 
 #include "OAuthDirectoryImpl.hpp"
 #include "request/Response.hpp"
+#include "request/JsonRecordReader.hpp"
+#include "util/KnownDirectories.hpp"
 #include <nlohmann/json.hpp>
+#include <functional>
 
 using json = nlohmann::json;
 
@@ -12,32 +15,115 @@ namespace CloudSync::dropbox {
         DropboxDirectory(const std::string &dir,
                          const std::shared_ptr<credentials::OAuth2CredentialsImpl>& credentials,
                          const std::shared_ptr<request::Request> &request,
-                         const std::string &name)
-                : OAuthDirectoryImpl("", dir, credentials, request, name){};
+                         const std::string &name,
+                         std::chrono::system_clock::time_point modified = {},
+                         std::shared_ptr<util::KnownDirectories> knownDirectories = nullptr)
+                : OAuthDirectoryImpl("", dir, credentials, request, name, modified)
+                , m_known_directories(knownDirectories ? std::move(knownDirectories) : std::make_shared<util::KnownDirectories>()) {};
 
         [[nodiscard]] std::vector<std::shared_ptr<Resource>> list_resources() const override;
 
+        [[nodiscard]] std::vector<ResourceInfo> list_resource_info() const override;
+
+        [[nodiscard]] std::shared_ptr<Resource> get_resource(const ResourceInfo &info) const override;
+
         [[nodiscard]] std::shared_ptr<Directory> get_directory(const std::filesystem::path &path) const override;
 
         void remove() override;
 
+        std::shared_ptr<Resource> copy_to(const std::filesystem::path &path) const override;
+
+        std::shared_ptr<Resource> move_to(const std::filesystem::path &path) override;
+
         std::shared_ptr<Directory> create_directory(const std::filesystem::path &path) const override;
 
         std::shared_ptr<File> create_file(const std::filesystem::path &path) const override;
 
+        std::shared_ptr<File> create_file(
+                const std::filesystem::path &path, const std::vector<std::uint8_t> &content) const override;
+
         std::shared_ptr<File> get_file(const std::filesystem::path &path) const override;
 
+        std::shared_ptr<Directory> ensure_directory(const std::filesystem::path &path) const override;
+
+        std::vector<BulkResult> remove_many(const std::vector<std::filesystem::path> &paths) const override;
+
+        std::vector<BulkValue<std::shared_ptr<Directory>>> create_directories(
+                const std::vector<std::filesystem::path> &paths) const override;
+
+        [[nodiscard]] std::vector<BulkValue<ResourceInfo>> stat_many(
+                const std::vector<std::filesystem::path> &paths) const override;
+
+        std::vector<BulkValue<std::shared_ptr<File>>> upload_many(const std::vector<FileUpload> &files) const override;
+
+        void search(const SearchQuery &query, const SearchPageHandler &on_page) const override;
+
+        [[nodiscard]] std::shared_ptr<Directory> with_new_connection() const override;
+
     private:
+        /// fields of a dropbox metadata object that are needed to describe a resource
+        static const std::vector<std::string> ENTRY_FIELDS;
+        static const std::vector<std::string> LIST_FOLDER_FIELDS;
+        /// ENTRY_FIELDS of the metadata a `search_v2` match holds
+        static const std::vector<std::string> SEARCH_MATCH_FIELDS;
+        /// path of the metadata within a `search_v2` match
+        static const std::string SEARCH_MATCH_METADATA;
+        /// most matches `search_v2` returns per page
+        static const std::size_t MAX_SEARCH_RESULTS;
+        /// most entries `delete_batch`, `create_folder_batch` & `upload_session/finish_batch_v2` accept per call
+        static const std::size_t MAX_BATCH_ENTRIES;
+        /// first delay before an unfinished batch job is checked again. Doubles with every check.
+        static const std::chrono::milliseconds BATCH_POLL_INTERVAL;
+        static const std::chrono::milliseconds MAX_BATCH_POLL_INTERVAL;
+
+        /// directories of this cloud that are known to exist, shared by all of its directory handles
+        const std::shared_ptr<util::KnownDirectories> m_known_directories;
+
+        /// calls `list_folder` and follows the cursor until all entries of this directory have been returned.
+        [[nodiscard]] std::vector<request::JsonRecord> list_folder() const;
+
+        /**
+         * Hands the entries of this directory to `on_page`, one page at a time, until it returns `false`.
+         * @param recursive also list the entries of all subfolders, including this folder itself.
+         */
+        void list_folder(bool recursive, const std::function<bool(std::vector<request::JsonRecord> &)> &on_page) const;
+
+        /// @param prefix path of the metadata object within `entry`
+        static ResourceInfo parse_resource_info(const request::JsonRecord &entry, const std::string &prefix = "");
+
+        /**
+         * Calls `copy_v2` or `move_v2` for this folder, which fail if the destination exists.
+         * @return a handle for the folder at `destination`
+         */
+        [[nodiscard]] std::shared_ptr<Resource> transfer(const std::string &endpoint, const std::filesystem::path &destination) const;
+
+        /// `get_metadata` for a single resource
+        [[nodiscard]] ResourceInfo stat_resource(const std::filesystem::path &resource_path) const;
+
+        /**
+         * Waits for a batch job to finish.
+         * @param launch_result response of the call that started the batch. May already be complete.
+         * @param check_url endpoint that reports the state of the job.
+         * @return the completed job, containing one result per batch entry.
+         */
+        [[nodiscard]] nlohmann::json await_batch_job(nlohmann::json launch_result, const std::string &check_url) const;
+
+        /**
+         * Converts the `failure` of a batch entry into the exception the corresponding single operation would throw.
+         * Must be called with the entry of a failed item.
+         */
+        static std::exception_ptr batch_entry_error(const nlohmann::json &entry, const std::filesystem::path &path);
+
         /**
-         * Takes a json object describing a dropbox resource and converts it into a
+         * Takes a record describing a dropbox resource and converts it into a
          * Resource object.
          *
          * @param resourceTypeFallback [""|"folder"|"file"] If the type fallback is
-         * provided and the json object **does not** contain any type information,
-         * the fallback type will decide on the resulting Resource type. If the json
-         * object **does** contains type information, it will be validated against
+         * provided and the record **does not** contain any type information,
+         * the fallback type will decide on the resulting Resource type. If the
+         * record **does** contains type information, it will be validated against
          * the fallback type. The parsing will fail if they don't match up.
          */
-        std::shared_ptr<Resource> parseEntry(const json &entry, const std::string &resourceTypeFallback = "") const;
+        std::shared_ptr<Resource> parseEntry(const request::JsonRecord &entry, const std::string &resourceTypeFallback = "") const;
     };
 }
@@ -1,7 +1,10 @@
 #include "DropboxFile.hpp"
 #include "request/Request.hpp"
 #include "DropboxExceptionTranslator.hpp"
+#include "DropboxUploadSession.hpp"
 #include "CloudSync/exceptions/resource/ResourceException.hpp"
+#include "util/DateTime.hpp"
+#include "util/EndpointConcurrency.hpp"
 #include <nlohmann/json.hpp>
 
 using namespace CloudSync;
@@ -20,6 +23,35 @@ void DropboxFile::remove() {
     }
 }
 
+std::shared_ptr<Resource> DropboxFile::copy_to(const std::filesystem::path &path) const {
+    return this->transfer("https://api.dropboxapi.com/2/files/copy_v2", destination_path(path));
+}
+
+std::shared_ptr<Resource> DropboxFile::move_to(const std::filesystem::path &path) {
+    return this->transfer("https://api.dropboxapi.com/2/files/move_v2", destination_path(path));
+}
+
+std::shared_ptr<DropboxFile> DropboxFile::transfer(const std::string &endpoint, const std::filesystem::path &destination) const {
+    std::shared_ptr<DropboxFile> file;
+    try {
+        const auto token = m_credentials->get_current_access_token();
+        const auto metadata = m_request->POST(endpoint)
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->json_body({
+                        {"from_path", m_path.generic_string()},
+                        {"to_path", destination.generic_string()},
+                        {"autorename", false}
+                })->request().json().at("metadata");
+        file = std::make_shared<DropboxFile>(
+                metadata.at("path_display"), m_credentials, m_request, metadata.at("name"), metadata.at("rev"));
+        file->update_metadata(metadata);
+    } catch (...) {
+        DropboxExceptionTranslator::translate(m_path);
+    }
+    return file;
+}
+
 bool DropboxFile::poll_change() {
     bool hasChanged = false;
     try {
@@ -30,9 +62,9 @@ bool DropboxFile::poll_change() {
                 ->json_body({{"path", m_path.generic_string()}})->request().json();
         const std::string newRevision = response_json.at("rev");
         if (this->revision() != newRevision) {
-            m_revision = newRevision;
             hasChanged = true;
         }
+        update_metadata(response_json);
     } catch (...) {
         DropboxExceptionTranslator::translate(m_path);
     }
@@ -84,7 +116,7 @@ std::shared_ptr<request::Request> DropboxFile::prepare_write_request() const {
 
 void DropboxFile::write(const std::string& content) {
     try {
-        m_revision = prepare_write_request()->body(content)->request().json().at("rev");
+        update_metadata(prepare_write_request()->body(content)->request().json());
     } catch(const request::exceptions::response::Conflict &e) {
         throw exceptions::resource::ResourceHasChanged(m_path);
     } catch (...) {
@@ -94,10 +126,37 @@ void DropboxFile::write(const std::string& content) {
 
 void DropboxFile::write_binary(const std::vector<std::uint8_t> &content) {
     try {
-        m_revision = prepare_write_request()->binary_body(content)->request().json().at("rev");
+        update_metadata(prepare_write_request()->binary_body(content)->request().json());
     } catch(const request::exceptions::response::Conflict &e) {
         throw exceptions::resource::ResourceHasChanged(m_path);
     } catch (...) {
         DropboxExceptionTranslator::translate(m_path);
     }
 }
+
+void DropboxFile::upload_chunked(const upload::UploadSource &source) {
+    try {
+        DropboxUploadSession session(m_path.generic_string(), this->revision(), m_credentials, m_request);
+        upload::ChunkedUpload(
+                m_request, session, source, util::endpoint_controller("https://content.dropboxapi.com")).run();
+        update_metadata(session.metadata());
+    } catch (...) {
+        DropboxExceptionTranslator::translate(m_path);
+    }
+}
+
+std::optional<ContentHash> DropboxFile::parse_content_hash(const std::string &content_hash) {
+    if (content_hash.empty()) {
+        return std::nullopt;
+    }
+    return ContentHash{ContentHash::Algorithm::DROPBOX, content_hash};
+}
+
+void DropboxFile::update_metadata(const json &metadata) {
+    m_revision = metadata.at("rev");
+    m_content_hash = parse_content_hash(metadata.value("content_hash", ""));
+    m_size = metadata.value("size", std::uint64_t(0));
+    if (const auto modified = util::parse_iso8601(metadata.value("server_modified", ""))) {
+        m_modified = *modified;
+    }
+}
@@ -1,5 +1,6 @@
 #include "OAuthFileImpl.hpp"
 #include "request/Request.hpp"
+#include <nlohmann/json.hpp>
 
 namespace CloudSync::dropbox {
     class DropboxFile : public OAuthFileImpl {
@@ -8,11 +9,19 @@ namespace CloudSync::dropbox {
                 const std::string &dir,
                 const std::shared_ptr<credentials::OAuth2CredentialsImpl>& credentials,
                 const std::shared_ptr<request::Request> &request, const std::string &name,
-                const std::string &revision)
-                : OAuthFileImpl("", dir, credentials, request, name, revision) {};
+                const std::string &revision,
+                std::uint64_t size = 0,
+                std::chrono::system_clock::time_point modified = {},
+                std::optional<ContentHash> content_hash = std::nullopt)
+                : OAuthFileImpl("", dir, credentials, request, name, revision, size, modified, "",
+                                std::move(content_hash)) {};
 
         void remove() override;
 
+        std::shared_ptr<Resource> copy_to(const std::filesystem::path &path) const override;
+
+        std::shared_ptr<Resource> move_to(const std::filesystem::path &path) override;
+
         bool poll_change() override;
 
         [[nodiscard]] std::string read() const override;
@@ -23,8 +32,23 @@ namespace CloudSync::dropbox {
 
         void write_binary(const std::vector<std::uint8_t> & content) override;
 
+        /// @return the hash for the `content_hash` field of a file metadata object, `std::nullopt` if it's empty.
+        static std::optional<ContentHash> parse_content_hash(const std::string &content_hash);
+
+    protected:
+        void upload_chunked(const upload::UploadSource &source) override;
+
     private:
+        /**
+         * Calls `copy_v2` or `move_v2`, which fail if the destination exists.
+         * @return a handle for the file at `destination`
+         */
+        std::shared_ptr<DropboxFile> transfer(const std::string &endpoint, const std::filesystem::path &destination) const;
+
         std::shared_ptr<request::Request> prepare_read_request() const;
         std::shared_ptr<request::Request> prepare_write_request() const;
+
+        /// takes revision, size, modification time & content hash from a dropbox file metadata object.
+        void update_metadata(const nlohmann::json &metadata);
     };
 }
@@ -0,0 +1,59 @@
+#include "DropboxUploadSession.hpp"
+#include "CloudSync/exceptions/resource/ResourceException.hpp"
+
+using namespace CloudSync;
+using namespace CloudSync::request;
+using namespace CloudSync::dropbox;
+using json = nlohmann::json;
+
+const std::size_t DropboxUploadSession::CHUNK_GRANULARITY = 4 * 1024 * 1024;
+
+const std::size_t DropboxUploadSession::MAX_CHUNK_SIZE = 37 * CHUNK_GRANULARITY;
+
+upload::UploadSession::Limits DropboxUploadSession::limits(std::uint64_t) const {
+    return {CHUNK_GRANULARITY, MAX_CHUNK_SIZE, CHUNK_GRANULARITY, true};
+}
+
+void DropboxUploadSession::start(std::uint64_t) {
+    const auto token = m_credentials->get_current_access_token();
+    m_session_id = m_request->POST("https://content.dropboxapi.com/2/files/upload_session/start")
+            ->token_auth(token)
+            ->accept(Request::MIMETYPE_JSON)
+            ->content_type(Request::MIMETYPE_BINARY)
+            ->query_param("arg", json{{"close", false}, {"session_type", "concurrent"}}.dump())
+            ->request().json().at("session_id");
+}
+
+void DropboxUploadSession::upload_chunk(const std::shared_ptr<request::Request> &request, const upload::Chunk &chunk) {
+    const auto token = m_credentials->get_current_access_token();
+    request->POST("https://content.dropboxapi.com/2/files/upload_session/append_v2")
+            ->token_auth(token)
+            ->content_type(Request::MIMETYPE_BINARY)
+            ->query_param("arg", json{
+                {"cursor", {{"session_id", m_session_id}, {"offset", chunk.offset}}},
+                {"close", chunk.last}
+            }.dump())
+            ->binary_body(chunk.data)
+            ->request();
+}
+
+void DropboxUploadSession::finish(std::uint64_t total_size) {
+    try {
+        const auto token = m_credentials->get_current_access_token();
+        m_metadata = m_request->POST("https://content.dropboxapi.com/2/files/upload_session/finish")
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->content_type(Request::MIMETYPE_BINARY)
+                ->query_param("arg", json{
+                    {"cursor", {{"session_id", m_session_id}, {"offset", total_size}}},
+                    {"commit", {
+                        {"path", m_path},
+                        {"mode", {{".tag", "update"}, {"update", m_revision}}}
+                    }}
+                }.dump())
+                ->request().json();
+    } catch (const request::exceptions::response::Conflict &e) {
+        // like files/upload in update mode
+        throw exceptions::resource::ResourceHasChanged(m_path);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "upload/ChunkedUpload.hpp"
+#include "credentials/OAuth2CredentialsImpl.hpp"
+#include <nlohmann/json.hpp>
+
+namespace CloudSync::dropbox {
+    /**
+     * Chunked upload through `upload_session/start`, `append_v2` & `finish`. The session is a concurrent one, so
+     * chunks are appended in parallel.
+     */
+    class DropboxUploadSession : public upload::UploadSession {
+    public:
+        DropboxUploadSession(
+                std::string path,
+                std::string revision,
+                std::shared_ptr<credentials::OAuth2CredentialsImpl> credentials,
+                std::shared_ptr<request::Request> request)
+                : m_path(std::move(path))
+                , m_revision(std::move(revision))
+                , m_credentials(std::move(credentials))
+                , m_request(std::move(request)) {};
+
+        [[nodiscard]] Limits limits(std::uint64_t total_size) const override;
+
+        void start(std::uint64_t total_size) override;
+
+        void upload_chunk(const std::shared_ptr<request::Request> &request, const upload::Chunk &chunk) override;
+
+        /// @throws exceptions::resource::ResourceHasChanged if the file has a different revision by now.
+        void finish(std::uint64_t total_size) override;
+
+        /// @return metadata of the uploaded file, once the session has finished.
+        [[nodiscard]] const nlohmann::json &metadata() const {
+            return m_metadata;
+        }
+
+    private:
+        /// concurrent sessions need all chunks but the last one to be a multiple of 4 MiB
+        static const std::size_t CHUNK_GRANULARITY;
+        /// a single request may carry up to 150 MB
+        static const std::size_t MAX_CHUNK_SIZE;
+
+        const std::string m_path;
+        const std::string m_revision;
+        const std::shared_ptr<credentials::OAuth2CredentialsImpl> m_credentials;
+        const std::shared_ptr<request::Request> m_request;
+        std::string m_session_id;
+        nlohmann::json m_metadata;
+    };
+}
@@ -0,0 +1,164 @@
+#include "GDriveBatch.hpp"
+#include "request/exceptions/ParseError.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <optional>
+
+using namespace CloudSync::gdrive;
+using CloudSync::request::exceptions::ParseError;
+
+namespace {
+    const std::string CONTENT_ID_PREFIX = "item-";
+    const std::string RESPONSE_CONTENT_ID_PREFIX = "response-item-";
+
+    std::string to_lower(std::string value) {
+        std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+        return value;
+    }
+
+    std::string trim(const std::string &value) {
+        const auto whitespace = " \t\r\n";
+        const auto start = value.find_first_not_of(whitespace);
+        if (start == std::string::npos) {
+            return "";
+        }
+        return value.substr(start, value.find_last_not_of(whitespace) - start + 1);
+    }
+
+    /// splits `message` into the header block and everything after the first empty line
+    std::pair<std::string, std::string> split_headers(const std::string &message) {
+        auto separator = message.find("\r\n\r\n");
+        std::size_t separator_length = 4;
+        const auto lf_separator = message.find("\n\n");
+        if (lf_separator < separator) {
+            separator = lf_separator;
+            separator_length = 2;
+        }
+        if (separator == std::string::npos) {
+            return {message, ""};
+        }
+        return {message.substr(0, separator), message.substr(separator + separator_length)};
+    }
+
+    std::optional<std::string> header_value(const std::string &headers, const std::string &name) {
+        std::size_t line_start = 0;
+        while (line_start < headers.size()) {
+            auto line_end = headers.find('\n', line_start);
+            if (line_end == std::string::npos) {
+                line_end = headers.size();
+            }
+            const auto line = headers.substr(line_start, line_end - line_start);
+            const auto colon = line.find(':');
+            if (colon != std::string::npos && to_lower(trim(line.substr(0, colon))) == name) {
+                return trim(line.substr(colon + 1));
+            }
+            line_start = line_end + 1;
+        }
+        return std::nullopt;
+    }
+
+    std::string boundary_of(const std::string &content_type) {
+        const auto position = to_lower(content_type).find("boundary=");
+        if (position == std::string::npos) {
+            throw ParseError("batch response has no boundary");
+        }
+        auto boundary = content_type.substr(position + 9);
+        boundary = boundary.substr(0, boundary.find(';'));
+        boundary = trim(boundary);
+        if (boundary.size() >= 2 && boundary.front() == '"' && boundary.back() == '"') {
+            boundary = boundary.substr(1, boundary.size() - 2);
+        }
+        return boundary;
+    }
+}
+
+const std::size_t GDriveBatch::MAX_PARTS = 100;
+
+std::string GDriveBatch::encode(const std::vector<Part> &parts, const std::string &boundary) {
+    std::string body;
+    for (std::size_t i = 0; i < parts.size(); i++) {
+        const auto &part = parts[i];
+        body += "--" + boundary + "\r\n"
+                "Content-Type: application/http\r\n"
+                "Content-ID: <" + CONTENT_ID_PREFIX + std::to_string(i) + ">\r\n"
+                "\r\n" +
+                part.method + " " + part.url + " HTTP/1.1\r\n";
+        if (!part.body.empty()) {
+            body += "Content-Type: application/json; charset=UTF-8\r\n"
+                    "\r\n" + part.body + "\r\n";
+        } else {
+            body += "\r\n";
+        }
+    }
+    body += "--" + boundary + "--\r\n";
+    return body;
+}
+
+std::vector<GDriveBatch::PartResponse> GDriveBatch::decode(
+        const std::string &data, const std::string &content_type, std::size_t part_count) {
+    const auto delimiter = "--" + boundary_of(content_type);
+    std::vector<std::optional<PartResponse>> responses(part_count);
+    auto position = data.find(delimiter);
+    while (position != std::string::npos) {
+        const auto part_start = position + delimiter.size();
+        if (data.compare(part_start, 2, "--") == 0) {
+            // closing delimiter
+            break;
+        }
+        const auto part_end = data.find(delimiter, part_start);
+        if (part_end == std::string::npos) {
+            throw ParseError("unterminated batch response part");
+        }
+        const auto [part_headers, http_message] = split_headers(data.substr(part_start, part_end - part_start));
+        // the content id of a response is the one of the request, prefixed with `response-`
+        auto content_id = header_value(part_headers, "content-id").value_or("");
+        content_id.erase(std::remove(content_id.begin(), content_id.end(), '<'), content_id.end());
+        content_id.erase(std::remove(content_id.begin(), content_id.end(), '>'), content_id.end());
+        if (content_id.compare(0, RESPONSE_CONTENT_ID_PREFIX.size(), RESPONSE_CONTENT_ID_PREFIX) != 0) {
+            throw ParseError("unexpected batch response content id '" + content_id + "'");
+        }
+        const auto index = std::strtoull(content_id.c_str() + RESPONSE_CONTENT_ID_PREFIX.size(), nullptr, 10);
+        if (index >= part_count) {
+            throw ParseError("unexpected batch response content id '" + content_id + "'");
+        }
+        // status line: `HTTP/1.1 404 Not Found`
+        const auto [response_headers, response_body] = split_headers(trim(http_message));
+        const auto status_start = response_headers.find(' ');
+        if (status_start == std::string::npos) {
+            throw ParseError("batch response part without status line");
+        }
+        PartResponse response;
+        response.code = std::strtol(response_headers.c_str() + status_start + 1, nullptr, 10);
+        response.data = trim(response_body);
+        responses[index] = std::move(response);
+        position = part_end;
+    }
+    std::vector<PartResponse> result;
+    result.reserve(part_count);
+    for (auto &response: responses) {
+        if (!response) {
+            throw ParseError("missing batch response part");
+        }
+        result.push_back(std::move(*response));
+    }
+    return result;
+}
+
+std::string GDriveBatch::url_encode(const std::string &value) {
+    static const char HEX[] = "0123456789ABCDEF";
+    std::string encoded;
+    encoded.reserve(value.size());
+    for (const unsigned char c: value) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            encoded += static_cast<char>(c);
+        } else {
+            encoded += '%';
+            encoded += HEX[c >> 4];
+            encoded += HEX[c & 0x0F];
+        }
+    }
+    return encoded;
+}
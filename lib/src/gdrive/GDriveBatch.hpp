@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace CloudSync::gdrive {
+    /**
+     * Encodes & decodes the `multipart/mixed` bodies of the google batch endpoint, which runs up to MAX_PARTS
+     * drive requests with a single HTTP call.
+     */
+    class GDriveBatch {
+    public:
+        /// a single request of a batch
+        struct Part {
+            std::string method;
+            /// path & query of the request, without scheme & host. E.g. `/drive/v3/files/{id}`
+            std::string url;
+            /// json body. Empty if the request has no body.
+            std::string body;
+        };
+
+        /// the response to a single request of a batch
+        struct PartResponse {
+            long code = 0;
+            std::string data;
+        };
+
+        static const std::size_t MAX_PARTS;
+
+        /// @return the body of a batch request. The matching content type is `multipart/mixed; boundary={boundary}`.
+        static std::string encode(const std::vector<Part> &parts, const std::string &boundary);
+
+        /**
+         * Splits the body of a batch response into the responses of the single requests.
+         * @param content_type content type header of the response, which contains the boundary.
+         * @param part_count number of parts the batch request has been made of.
+         * @return one response per part, in the order of the parts of the request.
+         * @throws request::exceptions::ParseError if the body is malformed or a response is missing.
+         */
+        static std::vector<PartResponse> decode(
+                const std::string &data, const std::string &content_type, std::size_t part_count);
+
+        /// percent-encodes `value` for use in the query of a part url.
+        static std::string url_encode(const std::string &value);
+    };
+}
@@ -13,7 +13,7 @@ namespace CloudSync::gdrive {
         GDriveCloud(std::string root_name,
                     const std::shared_ptr<credentials::OAuth2CredentialsImpl> credentials,
                     const std::shared_ptr<request::Request> &request)
-                : OAuthCloudImpl("https://www.googleapis.com/drive/v2", "https://oauth2.googleapis.com/token", credentials, request), m_root_name(std::move(root_name)) {}
+                : OAuthCloudImpl("https://www.googleapis.com/drive/v3", "https://oauth2.googleapis.com/token", credentials, request), m_root_name(std::move(root_name)) {}
 
         std::shared_ptr<Directory> root() const override {
             return std::make_shared<GDriveDirectory>(
@@ -24,7 +24,9 @@ namespace CloudSync::gdrive {
                     "/",
                     m_credentials,
                     m_request,
-                    "");
+                    "",
+                    std::chrono::system_clock::time_point(),
+                    m_path_cache);
         }
 
         std::string get_user_display_name() const override;
@@ -33,5 +35,7 @@ namespace CloudSync::gdrive {
 
     private:
         std::string m_root_name;
+        /// path to id mapping shared by all directories & files of this cloud
+        const std::shared_ptr<GDrivePathCache> m_path_cache = std::make_shared<GDrivePathCache>();
     };
 }
@@ -3,8 +3,12 @@
 #include "GDriveExceptionTranslator.hpp"
 #include "GDriveFile.hpp"
 #include "CloudSync/exceptions/resource/ResourceException.hpp"
-#include "CloudSync/exceptions/cloud/CloudException.hpp"
+#include "util/DateTime.hpp"
+#include <cstdlib>
 #include <filesystem>
+#include <future>
+#include <iterator>
+#include <map>
 
 using json = nlohmann::json;
 using namespace CloudSync;
@@ -12,32 +16,97 @@ using namespace CloudSync::request;
 using namespace CloudSync::gdrive;
 namespace fs = std::filesystem;
 
+const std::string GDriveDirectory::FILE_FIELD_MASK = "id,name,mimeType,version,size,modifiedTime,md5Checksum";
+
+const std::string GDriveDirectory::LIST_FIELD_MASK = "nextPageToken,files(" + FILE_FIELD_MASK + ")";
+
+const std::string GDriveDirectory::SEARCH_FIELD_MASK = "nextPageToken,files(" + FILE_FIELD_MASK + ",parents)";
+
+const std::string GDriveDirectory::FOLDER_MIMETYPE = "application/vnd.google-apps.folder";
+
+const std::vector<std::string> GDriveDirectory::FILE_FIELDS = {
+        "id", "name", "mimeType", "version", "size", "modifiedTime", "md5Checksum", "parents/0"};
+
+const std::vector<std::string> GDriveDirectory::PAGE_FIELDS = {"nextPageToken"};
+
+const std::string GDriveDirectory::MAX_PAGE_SIZE = "1000";
+
+const std::string GDriveDirectory::BATCH_BOUNDARY = "cloudsync_batch";
+
+const std::string GDriveDirectory::UPLOAD_BOUNDARY = "cloudsync_upload";
+
 std::vector<std::shared_ptr<Resource>> GDriveDirectory::list_resources() const {
     std::vector<std::shared_ptr<Resource>> resource_list;
     try {
-        const auto token = m_credentials->get_current_access_token();
-        const auto response_json = m_request->GET(m_base_url + "/files")
-                ->token_auth(token)
-                ->query_param("q", "'" + this->m_resource_id + "' in parents and trashed = false")
-                ->query_param("fields", "items(kind,id,title,mimeType,etag,parents(id,isRoot))")
-                ->accept(Request::MIMETYPE_JSON)
-                ->request().json();
-        for (const auto &file: response_json.at("items")) {
-            resource_list.push_back(this->parse_file(file));
-        }
+        this->list_files([this, &resource_list](const std::vector<JsonRecord> &files) {
+            for (const auto &file: files) {
+                resource_list.push_back(this->parse_file(file));
+            }
+        });
     } catch (...) {
         GDriveExceptionTranslator::translate(path());
     }
     return resource_list;
 }
 
+std::vector<ResourceInfo> GDriveDirectory::list_resource_info() const {
+    std::vector<ResourceInfo> resource_list;
+    try {
+        this->list_files([&resource_list](const std::vector<JsonRecord> &files) {
+            resource_list.reserve(resource_list.size() + files.size());
+            for (const auto &file: files) {
+                resource_list.push_back(parse_resource_info(file));
+            }
+        });
+    } catch (...) {
+        GDriveExceptionTranslator::translate(path());
+    }
+    return resource_list;
+}
+
+std::shared_ptr<Resource> GDriveDirectory::get_resource(const ResourceInfo &info) const {
+    const auto resource_path = append_path(info.name);
+    if (info.is_file()) {
+        return std::make_shared<GDriveFile>(
+                m_base_url,
+                m_root_name,
+                info.id,
+                resource_path.generic_string(),
+                m_credentials,
+                m_request,
+                info.name,
+                info.revision,
+                info.size,
+                info.modified,
+                info.content_type,
+                info.content_hash,
+                m_path_cache);
+    } else {
+        return std::make_shared<GDriveDirectory>(
+                m_base_url,
+                m_root_name,
+                info.id,
+                m_resource_id,
+                resource_path,
+                m_credentials,
+                m_request,
+                info.name,
+                info.modified,
+                m_path_cache);
+    }
+}
+
 std::shared_ptr<Directory> GDriveDirectory::get_directory(const std::filesystem::path &path) const {
     std::shared_ptr<Directory> newDir;
     // calculate "diff" between current position & wanted path. What do we need
     // to do to get there?
-    const auto relative_path = append_path(path).lexically_relative(m_path);
+    const auto resource_path = append_path(path);
+    const auto relative_path = resource_path.lexically_relative(m_path);
     try {
-        if (relative_path == ".") {
+        if (const auto cached = this->cached_directory(resource_path)) {
+            // the folder has been seen before, no need to walk there
+            newDir = cached;
+        } else if (relative_path == ".") {
             // no path change required, return current dir
             newDir = std::make_shared<GDriveDirectory>(
                     m_base_url,
@@ -47,7 +116,9 @@ std::shared_ptr<Directory> GDriveDirectory::get_directory(const std::filesystem:
                     m_path,
                     m_credentials,
                     m_request,
-                    m_name);
+                    m_name,
+                    m_modified,
+                    m_path_cache);
         } else if (relative_path.begin() == --relative_path.end() && *relative_path.begin() != "..") {
             // depth of navigation = 1, get a list of all folders in folder and
             // pick the desired one.
@@ -63,7 +134,9 @@ std::shared_ptr<Directory> GDriveDirectory::get_directory(const std::filesystem:
                     m_path,
                     m_credentials,
                     m_request,
-                    name());
+                    name(),
+                    m_modified,
+                    m_path_cache);
             for (const auto &path_component: relative_path) {
                 if (path_component == "..") {
                     current_dir = current_dir->parent();
@@ -89,12 +162,29 @@ void GDriveDirectory::remove() {
             m_request->DELETE(m_base_url + "/files/" + this->m_resource_id)
                     ->token_auth(token)
                     ->request();
+            m_path_cache->remove(m_path);
         }
     } catch (...) {
         GDriveExceptionTranslator::translate(path());
     }
 }
 
+std::shared_ptr<Resource> GDriveDirectory::copy_to(const std::filesystem::path &path) const {
+    const auto destination = destination_path(path);
+    std::shared_ptr<GDriveDirectory> copy;
+    try {
+        copy = this->destination_parent(destination)->create_folder(destination.filename().generic_string());
+        this->copy_children(*copy);
+    } catch (...) {
+        GDriveExceptionTranslator::translate(destination);
+    }
+    return copy;
+}
+
+std::shared_ptr<Resource> GDriveDirectory::move_to(const std::filesystem::path &path) {
+    return this->move_item(m_resource_id, m_path, destination_path(path));
+}
+
 std::shared_ptr<Directory> GDriveDirectory::create_directory(const std::filesystem::path &path) const {
     std::shared_ptr<Directory> new_directory;
     std::string folder_name;
@@ -104,23 +194,7 @@ std::shared_ptr<Directory> GDriveDirectory::create_directory(const std::filesyst
         if(base_directory->child_resource_exists(folder_name)) {
             throw exceptions::resource::ResourceConflict(full_path);
         } else {
-            const auto token = m_credentials->get_current_access_token();
-            const auto response_json = m_request->POST(m_base_url + "/files")
-                    ->token_auth(token)
-                    ->accept(Request::MIMETYPE_JSON)
-                    ->query_param("fields", "kind,id,title,mimeType,etag,parents(id,isRoot)")
-                    ->json_body({
-                            {"mimeType", "application/vnd.google-apps.folder"},
-                            {"title",    folder_name},
-                            {
-                             "parents",  {
-                                             {
-                                                 {"id", base_directory->m_resource_id}
-                                             }
-                                         }
-                            }
-                    })->request().json();
-            new_directory = std::dynamic_pointer_cast<Directory>(base_directory->parse_file(response_json, ResourceType::FOLDER));
+            new_directory = base_directory->create_folder(folder_name);
         }
     } catch (...) {
         GDriveExceptionTranslator::translate(full_path);
@@ -137,22 +211,16 @@ std::shared_ptr<File> GDriveDirectory::create_file(const std::filesystem::path &
             throw exceptions::resource::ResourceConflict(path);
         } else {
             const auto token = m_credentials->get_current_access_token();
-            const auto response_json = m_request->POST(m_base_url + "/files")
+            const auto response = m_request->POST(m_base_url + "/files")
                     ->token_auth(token)
                     ->accept(Request::MIMETYPE_JSON)
-                    ->query_param("fields", "kind,id,title,mimeType,etag,parents(id,isRoot)")
+                    ->query_param("fields", FILE_FIELD_MASK)
                     ->json_body({
                             {"mimeType", "text/plain"},
-                            {"title",    file_name},
-                            {
-                             "parents",  {
-                                             {
-                                                 {"id", base_dir->m_resource_id}
-                                             }
-                                         }
-                            }
-                    })->request().json();
-            new_file = std::dynamic_pointer_cast<GDriveFile>(base_dir->parse_file(response_json, ResourceType::FILE));
+                            {"name",     file_name},
+                            {"parents",  {base_dir->m_resource_id}}
+                    })->request().json_records("", FILE_FIELDS);
+            new_file = std::dynamic_pointer_cast<GDriveFile>(base_dir->parse_file(response.record(), ResourceType::FILE));
         }
     } catch (...) {
         GDriveExceptionTranslator::translate(base_dir->path() / path);
@@ -160,22 +228,44 @@ std::shared_ptr<File> GDriveDirectory::create_file(const std::filesystem::path &
     return new_file;
 }
 
+std::shared_ptr<File> GDriveDirectory::create_file(
+        const std::filesystem::path &path, const std::vector<std::uint8_t> &content) const {
+    std::string file_name;
+    std::shared_ptr<File> new_file;
+    const auto resource_path = append_path(path);
+    try {
+        const auto base_dir = this->parent(path.generic_string(), file_name, true);
+        // drive allows many files with the same name, so a conflict can only be found by looking for one
+        if (base_dir->child_resource_exists(file_name)) {
+            throw exceptions::resource::ResourceConflict(resource_path);
+        }
+        const auto token = m_credentials->get_current_access_token();
+        const auto response = m_request->POST(GDriveFile::UPLOAD_URL)
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->query_param("uploadType", "multipart")
+                ->query_param("fields", FILE_FIELD_MASK)
+                ->content_type("multipart/related; boundary=" + UPLOAD_BOUNDARY)
+                ->binary_body(multipart_upload_body({
+                        {"name", file_name},
+                        {"parents", {base_dir->m_resource_id}}
+                }, content))
+                ->request().json_records("", FILE_FIELDS);
+        new_file = std::dynamic_pointer_cast<GDriveFile>(base_dir->parse_file(response.record(), ResourceType::FILE));
+    } catch (...) {
+        GDriveExceptionTranslator::translate(resource_path);
+    }
+    return new_file;
+}
+
 std::shared_ptr<File> GDriveDirectory::get_file(const std::filesystem::path &path) const {
     std::shared_ptr<GDriveFile> file;
     std::string file_name;
     const auto full_path = append_path(path);
     try {
         const auto base_dir = this->parent(path.generic_string(), file_name);
-        const auto token = m_credentials->get_current_access_token();
-        const auto response_json = m_request->GET(m_base_url + "/files")
-                ->token_auth(token)
-                ->accept(Request::MIMETYPE_JSON)
-                ->query_param("q", "'" + base_dir->m_resource_id + "' in parents and title = '" + file_name + "' and trashed = false")
-                ->query_param("fields", "items(kind,id,title,mimeType,etag,parents(id,isRoot))")
-                ->request().json();
-        if (!response_json.at("items").empty()) {
-            file = std::dynamic_pointer_cast<GDriveFile>(
-                    base_dir->parse_file(response_json.at("items").at(0), ResourceType::FILE));
+        if (const auto record = base_dir->find_child(file_name)) {
+            file = std::dynamic_pointer_cast<GDriveFile>(base_dir->parse_file(*record, ResourceType::FILE));
         } else {
             throw exceptions::resource::NoSuchResource(full_path);
         }
@@ -185,23 +275,486 @@ std::shared_ptr<File> GDriveDirectory::get_file(const std::filesystem::path &pat
     return file;
 }
 
+std::shared_ptr<Directory> GDriveDirectory::ensure_directory(const std::filesystem::path &path) const {
+    const auto resource_path = append_path(path);
+    std::shared_ptr<GDriveDirectory> directory;
+    try {
+        // the walk starts at the deepest folder of the path that is cached or this directory, the root is always known
+        auto known_path = resource_path;
+        while (!(directory = this->cached_directory(known_path))) {
+            if (known_path == m_path) {
+                directory = std::static_pointer_cast<GDriveDirectory>(this->get_directory(""));
+                break;
+            }
+            known_path = known_path.parent_path();
+        }
+        // nothing can exist inside of a folder that has just been created, so there is no need to look for it
+        bool created = false;
+        for (const auto &component: resource_path.lexically_relative(known_path)) {
+            const auto name = component.generic_string();
+            if (name == "." || name.empty()) {
+                continue;
+            }
+            const auto record = created ? std::nullopt : directory->find_child(name);
+            if (!record) {
+                directory = directory->create_folder(name);
+                created = true;
+            } else if (record->at("mimeType") == "application/vnd.google-apps.folder") {
+                directory = std::static_pointer_cast<GDriveDirectory>(directory->parse_file(*record, ResourceType::FOLDER));
+            } else {
+                throw exceptions::resource::ResourceConflict(directory->append_path(name));
+            }
+        }
+    } catch (...) {
+        GDriveExceptionTranslator::translate(resource_path);
+    }
+    return directory;
+}
+
+std::vector<BulkResult> GDriveDirectory::remove_many(const std::vector<std::filesystem::path> &paths) const {
+    auto results = bulk_results<BulkResult>(paths);
+    // drive deletes by id, so everything that isn't cached has to be looked up first
+    std::vector<std::string> ids(results.size());
+    std::vector<std::filesystem::path> lookup_paths;
+    std::vector<std::size_t> lookup_indices;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const auto resource_path = append_path(results[i].path);
+        if (resource_path.generic_string() == "/") {
+            results[i].error = std::make_exception_ptr(exceptions::resource::PermissionDenied(resource_path));
+        } else if (const auto entry = m_path_cache->get(resource_path)) {
+            ids[i] = entry->id;
+        } else {
+            lookup_paths.push_back(results[i].path);
+            lookup_indices.push_back(i);
+        }
+    }
+    const auto lookups = this->stat_many(lookup_paths);
+    for (std::size_t i = 0; i < lookups.size(); i++) {
+        if (lookups[i].ok()) {
+            ids[lookup_indices[i]] = lookups[i].value.id;
+        } else {
+            results[lookup_indices[i]].error = lookups[i].error;
+        }
+    }
+    std::vector<std::size_t> batch;
+    std::vector<GDriveBatch::Part> parts;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        if (results[i].ok()) {
+            batch.push_back(i);
+            parts.push_back({"DELETE", batch_part_url(m_base_url + "/files/" + ids[i]), ""});
+        }
+    }
+    try {
+        const auto responses = this->send_batch(parts);
+        for (std::size_t i = 0; i < batch.size(); i++) {
+            auto &result = results[batch[i]];
+            const auto resource_path = append_path(result.path);
+            try {
+                batch_response(responses[i]);
+                m_path_cache->remove(resource_path);
+            } catch (...) {
+                result.error = translated_error([&resource_path] { GDriveExceptionTranslator::translate(resource_path); });
+            }
+        }
+    } catch (...) {
+        const auto error = translated_error([this] { GDriveExceptionTranslator::translate(m_path); });
+        for (const auto i: batch) {
+            results[i].error = error;
+        }
+    }
+    return results;
+}
+
+std::vector<BulkValue<std::shared_ptr<Directory>>> GDriveDirectory::create_directories(
+        const std::vector<std::filesystem::path> &paths) const {
+    auto results = bulk_results<BulkValue<std::shared_ptr<Directory>>>(paths);
+    // A folder is created in its parent, so parents that are part of the same call have to be created first.
+    // Drive allows duplicate names, so a path that is given more than once is created only once.
+    std::map<std::ptrdiff_t, std::vector<std::size_t>> levels;
+    std::map<std::filesystem::path, std::size_t> first_of_path;
+    std::vector<std::pair<std::size_t, std::size_t>> duplicates;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const auto resource_path = append_path(results[i].path);
+        if (const auto [first, inserted] = first_of_path.emplace(resource_path, i); !inserted) {
+            duplicates.emplace_back(i, first->second);
+            continue;
+        }
+        levels[std::distance(resource_path.begin(), resource_path.end())].push_back(i);
+    }
+    for (const auto &[depth, level]: levels) {
+        // drive allows duplicate names, so existing folders have to be found first to report a conflict
+        std::vector<std::filesystem::path> level_paths;
+        for (const auto i: level) {
+            level_paths.push_back(results[i].path);
+        }
+        const auto existing = this->stat_many(level_paths);
+        std::vector<std::size_t> batch;
+        std::vector<std::shared_ptr<GDriveDirectory>> batch_parents;
+        std::vector<GDriveBatch::Part> parts;
+        for (std::size_t j = 0; j < level.size(); j++) {
+            auto &result = results[level[j]];
+            const auto resource_path = append_path(result.path);
+            try {
+                if (existing[j].ok()) {
+                    throw exceptions::resource::ResourceConflict(resource_path);
+                }
+                // only a missing resource may be created, any other error is reported as is
+                existing[j].rethrow_if_failed();
+            } catch (const exceptions::resource::NoSuchResource &) {
+                try {
+                    std::string folder_name;
+                    const auto parent = this->parent(result.path.generic_string(), folder_name, true);
+                    batch.push_back(level[j]);
+                    batch_parents.push_back(parent);
+                    parts.push_back({
+                            "POST",
+                            batch_part_url(m_base_url + "/files?fields=" + GDriveBatch::url_encode(FILE_FIELD_MASK)),
+                            json{
+                                    {"mimeType", "application/vnd.google-apps.folder"},
+                                    {"name", folder_name},
+                                    {"parents", {parent->m_resource_id}}
+                            }.dump()});
+                } catch (...) {
+                    result.error = translated_error([&resource_path] { GDriveExceptionTranslator::translate(resource_path); });
+                }
+            } catch (...) {
+                result.error = std::current_exception();
+            }
+        }
+        try {
+            const auto responses = this->send_batch(parts);
+            for (std::size_t j = 0; j < batch.size(); j++) {
+                auto &result = results[batch[j]];
+                const auto resource_path = append_path(result.path);
+                try {
+                    const auto created = batch_response(responses[j]).json_records("", FILE_FIELDS);
+                    result.value = std::dynamic_pointer_cast<Directory>(
+                            batch_parents[j]->parse_file(created.record(), ResourceType::FOLDER));
+                } catch (...) {
+                    result.error = translated_error([&resource_path] { GDriveExceptionTranslator::translate(resource_path); });
+                }
+            }
+        } catch (...) {
+            const auto error = translated_error([this] { GDriveExceptionTranslator::translate(m_path); });
+            for (const auto i: batch) {
+                results[i].error = error;
+            }
+        }
+    }
+    for (const auto &[duplicate, first]: duplicates) {
+        results[duplicate].value = results[first].value;
+        results[duplicate].error = results[first].error;
+    }
+    return results;
+}
+
+std::vector<BulkValue<ResourceInfo>> GDriveDirectory::stat_many(const std::vector<std::filesystem::path> &paths) const {
+    auto results = bulk_results<BulkValue<ResourceInfo>>(paths);
+    std::vector<std::size_t> batch;
+    std::vector<std::shared_ptr<GDriveDirectory>> batch_parents;
+    std::vector<GDriveBatch::Part> parts;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const auto resource_path = append_path(results[i].path);
+        if (resource_path.generic_string() == "/") {
+            // the root can't be queried
+            results[i].value.id = m_root_name;
+            results[i].value.kind = ResourceInfo::Kind::DIRECTORY;
+            continue;
+        }
+        try {
+            // parents are mostly cached, so resolving them one by one is cheap
+            const auto parent = std::static_pointer_cast<GDriveDirectory>(
+                    this->get_directory(resource_path.parent_path().lexically_relative(m_path)));
+            batch.push_back(i);
+            batch_parents.push_back(parent);
+            parts.push_back({
+                    "GET",
+                    batch_part_url(m_base_url + "/files"
+                                   + "?q=" + GDriveBatch::url_encode(
+                                           "'" + parent->m_resource_id + "' in parents and name = "
+                                           + query_literal(resource_path.filename().generic_string())
+                                           + " and trashed = false")
+                                   + "&fields=" + GDriveBatch::url_encode(LIST_FIELD_MASK)
+                                   + "&pageSize=" + MAX_PAGE_SIZE),
+                    ""});
+        } catch (...) {
+            results[i].error = std::current_exception();
+        }
+    }
+    try {
+        const auto responses = this->send_batch(parts);
+        for (std::size_t j = 0; j < batch.size(); j++) {
+            auto &result = results[batch[j]];
+            const auto resource_path = append_path(result.path);
+            try {
+                const auto page = batch_response(responses[j]).json_records("files", FILE_FIELDS, PAGE_FIELDS);
+                std::optional<JsonRecord> file;
+                if (!page.records.empty()) {
+                    file = page.records.front();
+                } else if (!page.page.value("nextPageToken").empty()) {
+                    // an empty page does not mean that there are no more results
+                    file = batch_parents[j]->find_child(resource_path.filename().generic_string());
+                }
+                if (!file) {
+                    throw exceptions::resource::NoSuchResource(resource_path);
+                }
+                // remember the id, it's likely to be needed next
+                batch_parents[j]->parse_file(*file);
+                result.value = parse_resource_info(*file);
+            } catch (...) {
+                result.error = translated_error([&resource_path] { GDriveExceptionTranslator::translate(resource_path); });
+            }
+        }
+    } catch (...) {
+        const auto error = translated_error([this] { GDriveExceptionTranslator::translate(m_path); });
+        for (const auto i: batch) {
+            results[i].error = error;
+        }
+    }
+    return results;
+}
+
+std::vector<BulkValue<std::shared_ptr<File>>> GDriveDirectory::upload_many(const std::vector<FileUpload> &files) const {
+    // Parents are resolved & created one after another. Drive allows many folders with the same name, so creating
+    // a missing parent for two files at the same time would leave a duplicate behind.
+    std::map<fs::path, std::shared_ptr<GDriveDirectory>> parents;
+    std::map<fs::path, std::exception_ptr> parent_errors;
+    for (const auto &file: files) {
+        const auto parent_path = append_path(file.path).parent_path();
+        if (parents.count(parent_path) == 0 && parent_errors.count(parent_path) == 0) {
+            try {
+                std::string file_name;
+                parents[parent_path] = this->parent(file.path.generic_string(), file_name, true);
+            } catch (...) {
+                parent_errors[parent_path] = translated_error([&parent_path] {
+                    GDriveExceptionTranslator::translate(parent_path);
+                });
+            }
+        }
+    }
+    // existing files are updated, all others are created
+    const auto existing = this->stat_many(paths_of(files));
+    std::map<fs::path, const BulkValue<ResourceInfo> *> existing_by_path;
+    for (const auto &info: existing) {
+        existing_by_path[append_path(info.path)] = &info;
+    }
+    return upload_parallel(files, [&](const std::shared_ptr<Request> &request, const FileUpload &file) {
+        const auto resource_path = append_path(file.path);
+        if (const auto error = parent_errors.find(resource_path.parent_path()); error != parent_errors.end()) {
+            std::rethrow_exception(error->second);
+        }
+        const auto &parent = parents.at(resource_path.parent_path());
+        const auto &info = *existing_by_path.at(resource_path);
+        std::shared_ptr<File> uploaded_file;
+        try {
+            try {
+                info.rethrow_if_failed();
+            } catch (const exceptions::resource::NoSuchResource &) {
+                // will be created
+            }
+            std::shared_ptr<Request> upload_request;
+            if (info.ok()) {
+                if (info.value.kind != ResourceInfo::Kind::FILE) {
+                    throw exceptions::resource::ResourceConflict(resource_path);
+                }
+                upload_request = request->PATCH(GDriveFile::UPLOAD_URL + "/" + info.value.id)
+                        ->query_param("uploadType", "media")
+                        ->content_type(Request::MIMETYPE_BINARY)
+                        ->binary_body(file.content);
+            } else {
+                upload_request = request->POST(GDriveFile::UPLOAD_URL)
+                        ->query_param("uploadType", "multipart")
+                        ->content_type("multipart/related; boundary=" + UPLOAD_BOUNDARY)
+                        ->binary_body(multipart_upload_body({
+                                {"name", resource_path.filename().generic_string()},
+                                {"parents", {parent->m_resource_id}}
+                        }, file.content));
+            }
+            const auto token = m_credentials->get_current_access_token();
+            const auto response = upload_request
+                    ->token_auth(token)
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->query_param("fields", FILE_FIELD_MASK)
+                    ->request().json_records("", FILE_FIELDS);
+            uploaded_file = std::dynamic_pointer_cast<GDriveFile>(parent->parse_file(response.record(), ResourceType::FILE));
+        } catch (...) {
+            GDriveExceptionTranslator::translate(resource_path);
+        }
+        return uploaded_file;
+    });
+}
+
+std::shared_ptr<Directory> GDriveDirectory::with_new_connection() const {
+    return this->with_request(m_request->clone());
+}
+
+void GDriveDirectory::search(const SearchQuery &query, const SearchPageHandler &on_page) const {
+    std::string q = "trashed = false";
+    if (!query.name.empty()) {
+        q += " and name contains " + query_literal(query.name);
+    }
+    if (query.kind == ResourceInfo::Kind::DIRECTORY) {
+        q += " and mimeType = '" + FOLDER_MIMETYPE + "'";
+    } else if (query.kind == ResourceInfo::Kind::FILE) {
+        q += " and mimeType != '" + FOLDER_MIMETYPE + "'";
+    }
+    if (!query.content_type.empty()) {
+        q += " and mimeType = " + query_literal(query.content_type);
+    }
+    if (query.modified_after) {
+        q += " and modifiedTime > '" + util::format_iso8601(*query.modified_after) + "'";
+    }
+    try {
+        // Drive searches the whole drive and only reports the id of the parent of a result. The paths of the
+        // parents are looked up until this folder is reached, results outside of it are left out.
+        std::map<std::string, std::optional<fs::path>> folder_paths;
+        std::string folder_id = m_resource_id;
+        if (m_path.generic_string() == "/") {
+            // the root is mostly addressed by an alias like `root`, but parents are always reported by their id
+            folder_id = m_request->GET(m_base_url + "/files/" + m_resource_id)
+                    ->token_auth(m_credentials->get_current_access_token())
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->query_param("fields", "id")
+                    ->request().json_records("", FILE_FIELDS).record().at("id");
+        }
+        folder_paths[folder_id] = m_path;
+        this->query_files(q, [&](const std::vector<JsonRecord> &files) {
+            this->resolve_folder_paths(files, folder_paths);
+            std::vector<SearchResult> results;
+            for (const auto &file: files) {
+                const auto parent_path = folder_paths.find(file.value("parents/0"));
+                if (parent_path == folder_paths.end() || !parent_path->second) {
+                    continue;
+                }
+                const auto resource_path = *parent_path->second / file.at("name");
+                auto info = parse_resource_info(file);
+                if (!info.is_file()) {
+                    folder_paths.emplace(info.id, resource_path);
+                }
+                results.push_back({resource_path, std::move(info)});
+            }
+            return this->deliver_search_page(query, std::move(results), on_page);
+        }, SEARCH_FIELD_MASK);
+    } catch (...) {
+        GDriveExceptionTranslator::translate(m_path);
+    }
+}
+
+std::shared_ptr<Resource> GDriveDirectory::copy_file(const std::string &id, const fs::path &destination) const {
+    std::shared_ptr<Resource> copy;
+    try {
+        const auto parent = this->destination_parent(destination);
+        const auto token = m_credentials->get_current_access_token();
+        const auto response = m_request->POST(m_base_url + "/files/" + id + "/copy")
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->query_param("fields", FILE_FIELD_MASK)
+                ->json_body({
+                        {"name", destination.filename().generic_string()},
+                        {"parents", {parent->m_resource_id}}
+                })->request().json_records("", FILE_FIELDS);
+        copy = parent->parse_file(response.record(), ResourceType::FILE);
+    } catch (...) {
+        GDriveExceptionTranslator::translate(destination);
+    }
+    return copy;
+}
+
+std::shared_ptr<Resource> GDriveDirectory::move_item(
+        const std::string &id, const fs::path &source, const fs::path &destination) const {
+    std::shared_ptr<Resource> moved;
+    try {
+        std::string source_name;
+        const auto source_parent = this->cached_directory("/")->parent(source.generic_string(), source_name);
+        const auto parent = this->destination_parent(destination);
+        const auto token = m_credentials->get_current_access_token();
+        auto request = m_request->PATCH(m_base_url + "/files/" + id)
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->query_param("fields", FILE_FIELD_MASK);
+        if (parent->m_resource_id != source_parent->m_resource_id) {
+            request->query_param("addParents", parent->m_resource_id)
+                    ->query_param("removeParents", source_parent->m_resource_id);
+        }
+        const auto response = request
+                ->json_body({{"name", destination.filename().generic_string()}})
+                ->request().json_records("", FILE_FIELDS);
+        // everything that has been cached below the old path is gone
+        m_path_cache->remove(source);
+        moved = parent->parse_file(response.record());
+    } catch (...) {
+        GDriveExceptionTranslator::translate(source);
+    }
+    return moved;
+}
+
+std::shared_ptr<GDriveDirectory> GDriveDirectory::destination_parent(const fs::path &destination) const {
+    std::string name;
+    // resolved from the root, the destination may be anywhere in the drive
+    const auto parent = this->cached_directory("/")->parent(destination.generic_string(), name);
+    if (parent->child_resource_exists(name)) {
+        throw exceptions::resource::ResourceConflict(destination);
+    }
+    return parent;
+}
+
+std::shared_ptr<GDriveDirectory> GDriveDirectory::create_folder(const std::string &name) const {
+    const auto token = m_credentials->get_current_access_token();
+    const auto response = m_request->POST(m_base_url + "/files")
+            ->token_auth(token)
+            ->accept(Request::MIMETYPE_JSON)
+            ->query_param("fields", FILE_FIELD_MASK)
+            ->json_body({
+                    {"mimeType", "application/vnd.google-apps.folder"},
+                    {"name",     name},
+                    {"parents",  {m_resource_id}}
+            })->request().json_records("", FILE_FIELDS);
+    return std::static_pointer_cast<GDriveDirectory>(this->parse_file(response.record(), ResourceType::FOLDER));
+}
+
+void GDriveDirectory::copy_children(const GDriveDirectory &target) const {
+    std::vector<JsonRecord> folders;
+    std::vector<GDriveBatch::Part> parts;
+    this->list_files([this, &target, &folders, &parts](const std::vector<JsonRecord> &files) {
+        for (const auto &file: files) {
+            if (file.at("mimeType") == "application/vnd.google-apps.folder") {
+                folders.push_back(file);
+            } else {
+                parts.push_back({
+                        "POST",
+                        batch_part_url(m_base_url + "/files/" + file.at("id") + "/copy?fields="
+                                       + GDriveBatch::url_encode(FILE_FIELD_MASK)),
+                        json{
+                                {"name", file.at("name")},
+                                {"parents", {target.m_resource_id}}
+                        }.dump()});
+            }
+        }
+    });
+    for (const auto &response: this->send_batch(parts)) {
+        // remember the ids of the copies, they are likely to be used next
+        target.parse_file(batch_response(response).json_records("", FILE_FIELDS).record(), ResourceType::FILE);
+    }
+    for (const auto &folder: folders) {
+        const auto source = std::static_pointer_cast<GDriveDirectory>(this->parse_file(folder, ResourceType::FOLDER));
+        source->copy_children(*target.create_folder(folder.at("name")));
+    }
+}
+
 std::shared_ptr<Resource>
-GDriveDirectory::parse_file(const json &file, ResourceType expected_type, const std::string &custom_path) const {
+GDriveDirectory::parse_file(const request::JsonRecord &file, ResourceType expected_type, const std::string &custom_path) const {
     std::shared_ptr<Resource> resource;
-    const std::string name = file.at("title");
-    const std::string id = file.at("id");
-    const std::string mime_type = file.at("mimeType");
+    const std::string &name = file.at("name");
+    const std::string &id = file.at("id");
+    const std::string &mime_type = file.at("mimeType");
     const std::string resource_path = (m_path / name).lexically_normal().generic_string();
-    std::string parent_id;
-    if (file.at("parents").at(0).at("isRoot") == true) {
-        parent_id = "root";
-    } else {
-        parent_id = file.at("parents").at(0).at("id");
-    }
-    if (file.at("kind") != "drive#file") {
-        throw exceptions::cloud::CommunicationError("unknown file kind");
-    }
-    if (mime_type == "application/vnd.google-apps.folder") {
+    // parents are only requested if they are not known already: Everything else has been found in this folder.
+    const std::string parent_id = file.value("parents/0", m_resource_id);
+    const auto modified = util::parse_iso8601(file.value("modifiedTime"))
+            .value_or(std::chrono::system_clock::time_point());
+    const bool is_folder = mime_type == "application/vnd.google-apps.folder";
+    m_path_cache->put(!custom_path.empty() ? custom_path : resource_path, {id, parent_id, is_folder, modified});
+    if (is_folder) {
         if (expected_type != ResourceType::ANY && expected_type != ResourceType::FOLDER) {
             throw exceptions::resource::NoSuchResource(resource_path);
         }
@@ -213,50 +766,215 @@ GDriveDirectory::parse_file(const json &file, ResourceType expected_type, const
                 !custom_path.empty() ? custom_path : resource_path,
                 m_credentials,
                 m_request,
-                name);
+                name,
+                modified,
+                m_path_cache);
     } else {
         if (expected_type != ResourceType::ANY && expected_type != ResourceType::FILE) {
             throw exceptions::resource::NoSuchResource(name);
         }
-        const std::string etag = file.at("etag");
         resource = std::make_shared<GDriveFile>(
                 m_base_url,
+                m_root_name,
                 id,
                 !custom_path.empty() ? custom_path : resource_path,
                 m_credentials,
                 m_request,
                 name,
-                etag);
+                file.at("version"),
+                std::strtoull(file.value("size", "0").c_str(), nullptr, 10),
+                modified,
+                mime_type,
+                GDriveFile::parse_content_hash(file.value("md5Checksum")),
+                m_path_cache);
     }
 
     return resource;
 }
 
+ResourceInfo GDriveDirectory::parse_resource_info(const request::JsonRecord &file) {
+    ResourceInfo info;
+    info.name = file.at("name");
+    info.id = file.at("id");
+    info.revision = file.value("version");
+    if (file.at("mimeType") == "application/vnd.google-apps.folder") {
+        info.kind = ResourceInfo::Kind::DIRECTORY;
+    } else {
+        info.kind = ResourceInfo::Kind::FILE;
+        info.size = std::strtoull(file.value("size", "0").c_str(), nullptr, 10);
+        info.content_type = file.at("mimeType");
+        info.content_hash = GDriveFile::parse_content_hash(file.value("md5Checksum"));
+    }
+    if (const auto modified = util::parse_iso8601(file.value("modifiedTime"))) {
+        info.modified = *modified;
+    }
+    return info;
+}
+
+std::string GDriveDirectory::query_literal(const std::string &value) {
+    // Drive escapes quotes & backslashes in string literals with a backslash
+    std::string escaped = "'";
+    for (const char c: value) {
+        if (c == '\'' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped + "'";
+}
+
+void GDriveDirectory::list_files(const std::function<void(const std::vector<request::JsonRecord> &)> &on_page) const {
+    std::vector<std::pair<std::string, GDrivePathCache::Entry>> children;
+    this->query_files(
+            "'" + this->m_resource_id + "' in parents and trashed = false",
+            [this, &children, &on_page](const std::vector<JsonRecord> &files) {
+                for (const auto &file: files) {
+                    children.push_back({file.at("name"), {
+                            file.at("id"),
+                            m_resource_id,
+                            file.at("mimeType") == "application/vnd.google-apps.folder",
+                            util::parse_iso8601(file.value("modifiedTime")).value_or(std::chrono::system_clock::time_point())}});
+                }
+                on_page(files);
+                return true;
+            });
+    // a complete listing replaces whatever has been cached for the children of this folder
+    m_path_cache->put_children(m_path, std::move(children));
+}
+
+void GDriveDirectory::query_files(
+        const std::string &query,
+        const std::function<bool(const std::vector<request::JsonRecord> &)> &on_page,
+        const std::string &field_mask,
+        bool prefetch) const {
+    auto page = this->fetch_files_page(m_request, m_credentials->get_current_access_token(), query, "", field_mask);
+    // `on_page` may use the request of this directory, so the next pages are requested with one of their own
+    std::shared_ptr<Request> prefetch_request;
+    while (true) {
+        const auto next_page_token = page.page.value("nextPageToken");
+        if (!prefetch) {
+            if (!on_page(page.records) || next_page_token.empty()) {
+                break;
+            }
+            page = this->fetch_files_page(
+                    m_request, m_credentials->get_current_access_token(), query, next_page_token, field_mask);
+            continue;
+        }
+        std::future<JsonRecords> next_page;
+        if (!next_page_token.empty()) {
+            if (!prefetch_request) {
+                prefetch_request = m_request->clone();
+            }
+            // The next page is requested while `on_page` handles this one. The token is refreshed up front,
+            // credentials are only ever used from the calling thread.
+            next_page = std::async(
+                    std::launch::async,
+                    &GDriveDirectory::fetch_files_page,
+                    this,
+                    prefetch_request,
+                    m_credentials->get_current_access_token(),
+                    query,
+                    next_page_token,
+                    field_mask);
+        }
+        if (!on_page(page.records) || !next_page.valid()) {
+            break;
+        }
+        page = next_page.get();
+    }
+}
+
+request::JsonRecords GDriveDirectory::fetch_files_page(
+        const std::shared_ptr<Request> &request, const std::string &token, const std::string &query,
+        const std::string &page_token, const std::string &field_mask) const {
+    auto page_request = request->GET(m_base_url + "/files")
+            ->token_auth(token)
+            ->accept(Request::MIMETYPE_JSON)
+            ->query_param("q", query)
+            ->query_param("fields", field_mask)
+            ->query_param("pageSize", MAX_PAGE_SIZE);
+    if (!page_token.empty()) {
+        page_request->query_param("pageToken", page_token);
+    }
+    return page_request->request().json_records("files", FILE_FIELDS, PAGE_FIELDS);
+}
+
+std::optional<request::JsonRecord> GDriveDirectory::find_child(const std::string &name) const {
+    std::optional<JsonRecord> child;
+    this->query_files(
+            "'" + this->m_resource_id + "' in parents and name = " + query_literal(name) + " and trashed = false",
+            [&child](const std::vector<JsonRecord> &files) {
+                if (!files.empty()) {
+                    child = files.front();
+                }
+                // an empty page does not mean that there are no more results
+                return !child.has_value();
+            },
+            LIST_FIELD_MASK,
+            // the first page mostly has the match, a prefetched page would only be waited for & thrown away
+            false);
+    return child;
+}
+
+std::vector<std::uint8_t> GDriveDirectory::multipart_upload_body(const json &metadata, const std::vector<std::uint8_t> &content) {
+    const std::string metadata_part = "--" + UPLOAD_BOUNDARY + "\r\n"
+                                      + "Content-Type: application/json; charset=UTF-8\r\n\r\n"
+                                      + metadata.dump() + "\r\n"
+                                      + "--" + UPLOAD_BOUNDARY + "\r\n"
+                                      + "Content-Type: " + Request::MIMETYPE_BINARY + "\r\n\r\n";
+    const std::string end = "\r\n--" + UPLOAD_BOUNDARY + "--";
+    std::vector<std::uint8_t> body(metadata_part.begin(), metadata_part.end());
+    body.insert(body.end(), content.begin(), content.end());
+    body.insert(body.end(), end.begin(), end.end());
+    return body;
+}
+
+std::shared_ptr<GDriveDirectory> GDriveDirectory::cached_directory(const std::filesystem::path &path) const {
+    std::shared_ptr<GDriveDirectory> directory;
+    if (path == "/") {
+        // the root is always known
+        directory = std::make_shared<GDriveDirectory>(
+                m_base_url,
+                m_root_name,
+                m_root_name,
+                m_root_name,
+                "/",
+                m_credentials,
+                m_request,
+                "",
+                std::chrono::system_clock::time_point(),
+                m_path_cache);
+    } else if (const auto entry = m_path_cache->get(path); entry && entry->is_folder) {
+        directory = std::make_shared<GDriveDirectory>(
+                m_base_url,
+                m_root_name,
+                entry->id,
+                entry->parent_id,
+                path,
+                m_credentials,
+                m_request,
+                path.filename().generic_string(),
+                entry->modified,
+                m_path_cache);
+    }
+    return directory;
+}
+
 /// @return parent of the current directory
 std::shared_ptr<GDriveDirectory> GDriveDirectory::parent() const {
     const auto parentPath = fs::path(this->path()).parent_path();
-    std::shared_ptr<GDriveDirectory> parentDirectory;
-    if (parentPath == "/") {
-        // query for root is not possible.
-        parentDirectory = std::make_shared<GDriveDirectory>(
-            m_base_url,
-            m_root_name,
-            m_root_name,
-            m_root_name,
-            "/",
-            m_credentials,
-            m_request,
-            "");
-    } else {
+    // query for root is not possible, but it's always cached.
+    std::shared_ptr<GDriveDirectory> parentDirectory = this->cached_directory(parentPath);
+    if (!parentDirectory) {
         const auto token = m_credentials->get_current_access_token();
-        const auto response_json = m_request->GET(m_base_url + "/files/" + this->m_parent_resource_id)
+        const auto response = m_request->GET(m_base_url + "/files/" + this->m_parent_resource_id)
                 ->token_auth(token)
                 ->accept(Request::MIMETYPE_JSON)
-                ->query_param("fields", "kind,id,title,mimeType,etag,parents(id,isRoot)")
-                ->request().json();
+                ->query_param("fields", FILE_FIELD_MASK + ",parents")
+                ->request().json_records("", FILE_FIELDS);
         parentDirectory = std::dynamic_pointer_cast<GDriveDirectory>(
                 this->parse_file(
-                        response_json,
+                        response.record(),
                         ResourceType::FOLDER, parentPath.generic_string()
                 )
         );
@@ -269,29 +987,19 @@ std::shared_ptr<GDriveDirectory> GDriveDirectory::parent(const std::string &path
     const auto relativePath = (fs::path(this->path()) / path).lexically_normal().lexically_relative(this->path());
     const auto relativeParentPath = relativePath.parent_path();
     folderName = relativePath.lexically_relative(relativeParentPath).generic_string();
-    try {
-        return std::static_pointer_cast<GDriveDirectory>(get_directory(relativeParentPath.generic_string()));
-    } catch (const exceptions::resource::NoSuchResource &e) {
-        if(createIfMissing && relativeParentPath != "") {
-            return std::static_pointer_cast<GDriveDirectory>(this->create_directory(relativeParentPath.generic_string()));
-        } else {
-            throw e;
-        }
+    if (createIfMissing) {
+        return std::static_pointer_cast<GDriveDirectory>(this->ensure_directory(relativeParentPath));
     }
+    return std::static_pointer_cast<GDriveDirectory>(get_directory(relativeParentPath.generic_string()));
 }
 
 std::shared_ptr<GDriveDirectory> GDriveDirectory::child(const std::string &name) const {
-    std::shared_ptr<GDriveDirectory> childDir;
-    const auto token = m_credentials->get_current_access_token();
-    const auto response_json = m_request->GET(m_base_url + "/files")
-            ->token_auth(token)
-            ->accept(Request::MIMETYPE_JSON)
-            ->query_param("q", "'" + this->m_resource_id + "' in parents and title = '" + name + "' and trashed = false")
-            ->query_param("fields", "items(kind,id,title,mimeType,etag,parents(id,isRoot))")
-            ->request().json();
-    if (!response_json.at("items").empty()) {
-        childDir = std::dynamic_pointer_cast<GDriveDirectory>(
-                this->parse_file(response_json.at("items").at(0), ResourceType::FOLDER));
+    std::shared_ptr<GDriveDirectory> childDir = this->cached_directory(append_path(name));
+    if (childDir) {
+        return childDir;
+    }
+    if (const auto record = this->find_child(name)) {
+        childDir = std::dynamic_pointer_cast<GDriveDirectory>(this->parse_file(*record, ResourceType::FOLDER));
     } else {
         throw exceptions::resource::NoSuchResource(append_path(name));
     }
@@ -299,12 +1007,99 @@ std::shared_ptr<GDriveDirectory> GDriveDirectory::child(const std::string &name)
 }
 
 bool GDriveDirectory::child_resource_exists(const std::string &resource_name) const {
-    const auto token = m_credentials->get_current_access_token();
-    const auto response_json = m_request->GET(m_base_url + "/files")
-            ->token_auth(token)
-            ->accept(Request::MIMETYPE_JSON)
-            ->query_param("q", "'" + this->m_resource_id + "' in parents and title = '" + resource_name + "' and trashed = false")
-            ->query_param("fields", "items(kind,id,title,mimeType,etag,parents(id,isRoot))")
-            ->request().json();
-    return !response_json.at("items").empty();
+    return this->find_child(resource_name).has_value();
+}
+
+void GDriveDirectory::resolve_folder_paths(
+        const std::vector<request::JsonRecord> &files,
+        std::map<std::string, std::optional<std::filesystem::path>> &folder_paths) const {
+    // name & parent of the folders that have been looked up
+    std::map<std::string, std::pair<std::string, std::string>> folders;
+    std::vector<std::string> unknown;
+    const auto look_up = [&folder_paths, &folders, &unknown](const std::string &id) {
+        if (!id.empty() && folder_paths.count(id) == 0 && folders.count(id) == 0
+            && std::find(unknown.begin(), unknown.end(), id) == unknown.end()) {
+            unknown.push_back(id);
+        }
+    };
+    for (const auto &file: files) {
+        look_up(file.value("parents/0"));
+    }
+    // one batch per level of the tree
+    while (!unknown.empty()) {
+        const auto ids = std::move(unknown);
+        unknown.clear();
+        std::vector<GDriveBatch::Part> parts;
+        for (const auto &id: ids) {
+            parts.push_back({"GET", batch_part_url(m_base_url + "/files/" + id + "?fields=id,name,parents"), ""});
+        }
+        const auto responses = this->send_batch(parts);
+        for (std::size_t i = 0; i < ids.size(); i++) {
+            try {
+                const auto folder = batch_response(responses[i]).json_records("", FILE_FIELDS);
+                const auto parent_id = folder.record().value("parents/0");
+                folders[ids[i]] = {folder.record().at("name"), parent_id};
+                look_up(parent_id);
+            } catch (const request::exceptions::response::NotFound &) {
+                // folders that can't be seen lie outside of this directory
+                folder_paths[ids[i]] = std::nullopt;
+            } catch (const request::exceptions::response::Forbidden &) {
+                folder_paths[ids[i]] = std::nullopt;
+            }
+        }
+    }
+    // every lookup has ended at a known folder or at one without a parent, which lies outside of this directory
+    const std::function<std::optional<fs::path>(const std::string &)> path_of = [&](const std::string &id) {
+        if (const auto known = folder_paths.find(id); known != folder_paths.end()) {
+            return known->second;
+        }
+        std::optional<fs::path> path;
+        if (const auto folder = folders.find(id); folder != folders.end() && !folder->second.second.empty()) {
+            if (const auto parent_path = path_of(folder->second.second)) {
+                path = *parent_path / folder->second.first;
+            }
+        }
+        folder_paths[id] = path;
+        return path;
+    };
+    for (const auto &folder: folders) {
+        path_of(folder.first);
+    }
+}
+
+std::shared_ptr<GDriveDirectory> GDriveDirectory::with_request(const std::shared_ptr<request::Request> &request) const {
+    return std::make_shared<GDriveDirectory>(
+            m_base_url, m_root_name, m_resource_id, m_parent_resource_id, m_path, m_credentials, request, m_name,
+            m_modified, m_path_cache);
+}
+
+std::string GDriveDirectory::batch_part_url(const std::string &url) const {
+    const auto host_end = url.find('/', url.find("://") + 3);
+    return host_end != std::string::npos ? url.substr(host_end) : "/";
+}
+
+std::vector<GDriveBatch::PartResponse> GDriveDirectory::send_batch(const std::vector<GDriveBatch::Part> &parts) const {
+    std::vector<GDriveBatch::PartResponse> responses;
+    responses.reserve(parts.size());
+    // `https://www.googleapis.com/drive/v3` is batched at `https://www.googleapis.com/batch/drive/v3`
+    const auto api_path = batch_part_url(m_base_url);
+    const auto batch_url = m_base_url.substr(0, m_base_url.size() - api_path.size()) + "/batch" + api_path;
+    for (std::size_t offset = 0; offset < parts.size(); offset += GDriveBatch::MAX_PARTS) {
+        const std::vector<GDriveBatch::Part> chunk(
+                parts.begin() + offset,
+                parts.begin() + std::min(parts.size(), offset + GDriveBatch::MAX_PARTS));
+        const auto token = m_credentials->get_current_access_token();
+        const auto response = m_request->POST(batch_url)
+                ->token_auth(token)
+                ->content_type("multipart/mixed; boundary=" + BATCH_BOUNDARY)
+                ->body(GDriveBatch::encode(chunk, BATCH_BOUNDARY))
+                ->request();
+        auto chunk_responses = GDriveBatch::decode(response.data, response.content_type, chunk.size());
+        std::move(chunk_responses.begin(), chunk_responses.end(), std::back_inserter(responses));
+    }
+    return responses;
+}
+
+request::StringResponse GDriveDirectory::batch_response(const GDriveBatch::PartResponse &response) {
+    return request::StringResponse(response.code, response.data, Request::MIMETYPE_JSON);
 }
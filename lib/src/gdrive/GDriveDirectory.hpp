@@ -1,7 +1,13 @@
 #pragma once
 
 #include "OAuthDirectoryImpl.hpp"
+#include "GDriveBatch.hpp"
+#include "GDrivePathCache.hpp"
+#include "request/JsonRecordReader.hpp"
 #include <nlohmann/json.hpp>
+#include <functional>
+#include <map>
+#include <optional>
 #include <utility>
 
 using json = nlohmann::json;
@@ -14,24 +20,68 @@ class GDriveDirectory : public OAuthDirectoryImpl {
                 std::string parentResourceId, const std::filesystem::path &dir,
                 const std::shared_ptr<credentials::OAuth2CredentialsImpl>& credentials,
                 const std::shared_ptr<request::Request> &request,
-                const std::string &name)
-                : OAuthDirectoryImpl(baseUrl, dir, credentials, request, name)
+                const std::string &name,
+                std::chrono::system_clock::time_point modified = {},
+                std::shared_ptr<GDrivePathCache> pathCache = nullptr)
+                : OAuthDirectoryImpl(baseUrl, dir, credentials, request, name, modified)
                 , m_resource_id(std::move(resourceId))
                 , m_parent_resource_id(std::move(parentResourceId))
-                , m_root_name(std::move(rootName)) {};
+                , m_root_name(std::move(rootName))
+                , m_path_cache(pathCache ? std::move(pathCache) : std::make_shared<GDrivePathCache>()) {};
 
         [[nodiscard]] std::vector<std::shared_ptr<Resource>> list_resources() const override;
 
+        [[nodiscard]] std::vector<ResourceInfo> list_resource_info() const override;
+
+        [[nodiscard]] std::shared_ptr<Resource> get_resource(const ResourceInfo &info) const override;
+
         [[nodiscard]] std::shared_ptr<Directory> get_directory(const std::filesystem::path &path) const override;
 
         void remove() override;
 
+        std::shared_ptr<Resource> copy_to(const std::filesystem::path &path) const override;
+
+        std::shared_ptr<Resource> move_to(const std::filesystem::path &path) override;
+
         std::shared_ptr<Directory> create_directory(const std::filesystem::path &path) const override;
 
         std::shared_ptr<File> create_file(const std::filesystem::path &path) const override;
 
+        std::shared_ptr<File> create_file(
+                const std::filesystem::path &path, const std::vector<std::uint8_t> &content) const override;
+
         std::shared_ptr<File> get_file(const std::filesystem::path &path) const override;
 
+        std::shared_ptr<Directory> ensure_directory(const std::filesystem::path &path) const override;
+
+        std::vector<BulkResult> remove_many(const std::vector<std::filesystem::path> &paths) const override;
+
+        std::vector<BulkValue<std::shared_ptr<Directory>>> create_directories(
+                const std::vector<std::filesystem::path> &paths) const override;
+
+        [[nodiscard]] std::vector<BulkValue<ResourceInfo>> stat_many(
+                const std::vector<std::filesystem::path> &paths) const override;
+
+        std::vector<BulkValue<std::shared_ptr<File>>> upload_many(const std::vector<FileUpload> &files) const override;
+
+        void search(const SearchQuery &query, const SearchPageHandler &on_page) const override;
+
+        [[nodiscard]] std::shared_ptr<Directory> with_new_connection() const override;
+
+        /**
+         * Copies the file with the given id to the absolute path `destination`. Used for the `copy_to()` of files.
+         * @return a handle for the copy
+         */
+        std::shared_ptr<Resource> copy_file(const std::string &id, const std::filesystem::path &destination) const;
+
+        /**
+         * Moves or renames the file or folder with the given id from `source` to `destination`, both absolute.
+         * Used for the `move_to()` of files & directories.
+         * @return a handle for the resource at `destination`
+         */
+        std::shared_ptr<Resource> move_item(
+                const std::string &id, const std::filesystem::path &source, const std::filesystem::path &destination) const;
+
     private:
         enum ResourceType {
             ANY, FILE, FOLDER
@@ -39,11 +89,106 @@ class GDriveDirectory : public OAuthDirectoryImpl {
         const std::string m_resource_id;
         const std::string m_parent_resource_id;
         const std::string m_root_name;
+        /// path to id mapping shared by all handles of the same cloud
+        const std::shared_ptr<GDrivePathCache> m_path_cache;
+
+        /// fields of a drive file resource that are needed to describe a resource
+        static const std::vector<std::string> FILE_FIELDS;
+        /// `fields` query parameter that asks for FILE_FIELDS, except for the parents
+        static const std::string FILE_FIELD_MASK;
+        /// `fields` query parameter for one page of a `files` listing
+        static const std::string LIST_FIELD_MASK;
+        /// `fields` query parameter for one page of a search, which also needs the parents of the results
+        static const std::string SEARCH_FIELD_MASK;
+        static const std::string FOLDER_MIMETYPE;
+        /// paging information of a `files` listing
+        static const std::vector<std::string> PAGE_FIELDS;
+        /// largest `pageSize` the `files` endpoint accepts
+        static const std::string MAX_PAGE_SIZE;
+        static const std::string BATCH_BOUNDARY;
+        static const std::string UPLOAD_BOUNDARY;
 
         std::shared_ptr<Resource> parse_file(
-                const json &file, ResourceType expected_type = ResourceType::ANY,
+                const request::JsonRecord &file, ResourceType expected_type = ResourceType::ANY,
                 const std::string &custom_path = "") const;
 
+        static ResourceInfo parse_resource_info(const request::JsonRecord &file);
+
+        /// @return `value` as a string literal of a `files` search query, with quotes & backslashes escaped
+        static std::string query_literal(const std::string &value);
+
+        /**
+         * Hands all files & folders that have this directory as parent to `on_page`, one page at a time.
+         * Once the listing is complete, the children of this folder in the path cache are replaced.
+         */
+        void list_files(const std::function<void(const std::vector<request::JsonRecord> &)> &on_page) const;
+
+        /**
+         * Runs the `files` search `query` over all pages of results. Paging stops early if `on_page` returns `false`.
+         * With `prefetch`, the next page is already being requested while `on_page` handles the current one, with a
+         * clone of the request of this directory, so `on_page` may use this directory. Lookups that mostly stop
+         * after the first page should turn it off, stopping early has to wait for the prefetched page otherwise.
+         */
+        void query_files(
+                const std::string &query,
+                const std::function<bool(const std::vector<request::JsonRecord> &)> &on_page,
+                const std::string &field_mask = LIST_FIELD_MASK,
+                bool prefetch = true) const;
+
+        /// @return the page of `query` results that starts at `page_token`, requested with `request`
+        request::JsonRecords fetch_files_page(
+                const std::shared_ptr<request::Request> &request, const std::string &token, const std::string &query,
+                const std::string &page_token, const std::string &field_mask) const;
+
+        /**
+         * Looks up the paths of the parents of `files` that are missing in `folder_paths`, one batch per level of
+         * the tree, and adds them. Folders that don't lie below a folder of `folder_paths` are added without a path.
+         */
+        void resolve_folder_paths(
+                const std::vector<request::JsonRecord> &files,
+                std::map<std::string, std::optional<std::filesystem::path>> &folder_paths) const;
+
+        /// @return a copy of this directory that sends its requests with `request`
+        [[nodiscard]] std::shared_ptr<GDriveDirectory> with_request(const std::shared_ptr<request::Request> &request) const;
+
+        /// @return the first file or folder named `name` in this directory, if there is one
+        std::optional<request::JsonRecord> find_child(const std::string &name) const;
+
+        /// @return `url` without scheme & host, as needed for the parts of a batch
+        [[nodiscard]] std::string batch_part_url(const std::string &url) const;
+
+        /**
+         * Sends `parts` to the batch endpoint, GDriveBatch::MAX_PARTS at a time.
+         * @return one response per part, in the order of `parts`.
+         */
+        [[nodiscard]] std::vector<GDriveBatch::PartResponse> send_batch(const std::vector<GDriveBatch::Part> &parts) const;
+
+        /// @throws the exception the single request would have thrown, if `response` is an error response.
+        static request::StringResponse batch_response(const GDriveBatch::PartResponse &response);
+
+        /// @return the body of a `multipart` upload, which creates a file with `metadata` & `content` in one request
+        static std::vector<std::uint8_t> multipart_upload_body(
+                const nlohmann::json &metadata, const std::vector<std::uint8_t> &content);
+
+        /// @return a handle for the cached folder at `path`, or `nullptr` if no folder is cached for that path.
+        std::shared_ptr<GDriveDirectory> cached_directory(const std::filesystem::path &path) const;
+
+        /**
+         * Drive allows many resources with the same name in a folder, so copies & moves check for one themselves.
+         * @return the folder `destination` is placed in
+         * @throws exceptions::resource::ResourceConflict if a resource already exists at `destination`
+         */
+        std::shared_ptr<GDriveDirectory> destination_parent(const std::filesystem::path &destination) const;
+
+        /// creates a folder named `name` in this folder, without checking for an existing one
+        std::shared_ptr<GDriveDirectory> create_folder(const std::string &name) const;
+
+        /**
+         * Drive can only copy files. Folders are copied by creating each of them at the destination and copying
+         * the files they contain, one batch per folder.
+         */
+        void copy_children(const GDriveDirectory &target) const;
+
         /// @return parent of the current directory
         std::shared_ptr<GDriveDirectory> parent() const;
 
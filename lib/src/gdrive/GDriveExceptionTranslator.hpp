@@ -30,13 +30,35 @@ namespace CloudSync::gdrive {
                 throw exceptions::cloud::AuthorizationFailed();
             } catch (request::exceptions::response::PreconditionFailed &e) {
                 throw exceptions::resource::ResourceHasChanged(path);
-            } catch (request::exceptions::response::Forbidden &) {
+            } catch (request::exceptions::response::Forbidden &e) {
+                // drive reports exceeded rate limits as 403
+                if (is_rate_limit(e)) {
+                    throw exceptions::cloud::Throttled(e.what());
+                }
                 throw exceptions::resource::PermissionDenied(path);
+            } catch (request::exceptions::response::TooManyRequests &e) {
+                throw exceptions::cloud::Throttled(e.what(), e.retry_after);
+            } catch (request::exceptions::response::ServiceUnavailable &e) {
+                throw exceptions::cloud::Throttled(e.what(), e.retry_after);
             } catch (nlohmann::json::exception &e) {
                 throw exceptions::cloud::InvalidResponse(e.what());
+            } catch (request::exceptions::ParseError &e) {
+                throw exceptions::cloud::InvalidResponse(e.what());
             } catch (request::exceptions::RequestException &e) {
                 throw exceptions::cloud::CommunicationError(e.what());
             }
         }
+
+    private:
+        static bool is_rate_limit(const request::exceptions::response::Forbidden &e) {
+            try {
+                const std::string reason = e.json().at("error").at("errors").at(0).at("reason");
+                return reason == "rateLimitExceeded" || reason == "userRateLimitExceeded";
+            } catch (const nlohmann::json::exception &) {
+                return false;
+            } catch (const request::exceptions::ParseError &) {
+                return false;
+            }
+        }
     };
 }
\ No newline at end of file
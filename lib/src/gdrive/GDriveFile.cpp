@@ -1,10 +1,21 @@
 #include "GDriveFile.hpp"
+#include "GDriveDirectory.hpp"
 #include "request/Request.hpp"
 #include "GDriveExceptionTranslator.hpp"
+#include "GDriveUploadSession.hpp"
+#include "util/DateTime.hpp"
+#include "util/EndpointConcurrency.hpp"
+#include "CloudSync/exceptions/resource/ResourceException.hpp"
+#include <cstdlib>
 
 using namespace CloudSync;
 using namespace CloudSync::request;
 using namespace CloudSync::gdrive;
+using json = nlohmann::json;
+
+const std::string GDriveFile::METADATA_FIELD_MASK = "version,size,modifiedTime,mimeType,md5Checksum";
+
+const std::string GDriveFile::UPLOAD_URL = "https://www.googleapis.com/upload/drive/v3/files";
 
 void GDriveFile::remove() {
     try {
@@ -12,25 +23,50 @@ void GDriveFile::remove() {
         m_request->DELETE(m_resource_path)
                 ->token_auth(token)
                 ->request();
+        if (m_path_cache) {
+            m_path_cache->remove(m_path);
+        }
     } catch (...) {
         GDriveExceptionTranslator::translate(m_path);
     }
 }
 
+std::shared_ptr<Resource> GDriveFile::copy_to(const std::filesystem::path &path) const {
+    return this->root()->copy_file(m_resource_id, destination_path(path));
+}
+
+std::shared_ptr<Resource> GDriveFile::move_to(const std::filesystem::path &path) {
+    return this->root()->move_item(m_resource_id, m_path, destination_path(path));
+}
+
+std::shared_ptr<GDriveDirectory> GDriveFile::root() const {
+    return std::make_shared<GDriveDirectory>(
+            m_base_url,
+            m_root_name,
+            m_root_name,
+            m_root_name,
+            "/",
+            m_credentials,
+            m_request,
+            "",
+            std::chrono::system_clock::time_point(),
+            m_path_cache);
+}
+
 bool GDriveFile::poll_change() {
     bool has_changed = false;
     try {
         const auto token = m_credentials->get_current_access_token();
         const auto response_json = m_request->GET(m_resource_path)
                 ->token_auth(token)
-                ->query_param("fields", "etag")
+                ->query_param("fields", METADATA_FIELD_MASK)
                 ->accept(Request::MIMETYPE_JSON)
                 ->request().json();
-        const std::string new_revision = response_json.at("etag");
+        const std::string new_revision = response_json.at("version");
         if (revision() != new_revision) {
             has_changed = true;
-            m_revision = new_revision;
         }
+        update_metadata(response_json);
     } catch (...) {
         GDriveExceptionTranslator::translate(m_path);
     }
@@ -59,19 +95,16 @@ std::vector<std::uint8_t> GDriveFile::read_binary() const {
 
 std::shared_ptr<request::Request> GDriveFile::prepare_read_request() const {
     const auto token = m_credentials->get_current_access_token();
-    const auto response_json = m_request->GET(m_resource_path)
+    // the media endpoint returns the content directly, without looking up the downloadUrl first
+    return m_request->GET(m_resource_path)
             ->token_auth(token)
-            ->query_param("fields", "downloadUrl")
-            ->accept(Request::MIMETYPE_JSON)
-            ->request().json();
-    const std::string web_content_link = response_json.at("downloadUrl");
-    return m_request->GET(web_content_link)->token_auth(token);
+            ->query_param("alt", "media");
 }
 
 void GDriveFile::write(const std::string& content) {
     try {
-        const auto res = prepare_write_request()->body(content)->request().json();
-        m_revision = res.at("etag");
+        require_unchanged();
+        update_metadata(prepare_write_request()->body(content)->request().json());
     } catch (...) {
         GDriveExceptionTranslator::translate(m_path);
     }
@@ -79,20 +112,61 @@ void GDriveFile::write(const std::string& content) {
 
 void GDriveFile::write_binary(const std::vector<std::uint8_t> &content) {
     try {
-        const auto res = prepare_write_request()->binary_body(content)->request().json();
-        m_revision = res.at("etag");
+        require_unchanged();
+        update_metadata(prepare_write_request()->binary_body(content)->request().json());
+    } catch (...) {
+        GDriveExceptionTranslator::translate(m_path);
+    }
+}
+
+void GDriveFile::upload_chunked(const upload::UploadSource &source) {
+    try {
+        require_unchanged();
+        GDriveUploadSession session(UPLOAD_URL + "/" + m_resource_id, METADATA_FIELD_MASK, m_credentials, m_request);
+        upload::ChunkedUpload(m_request, session, source, util::endpoint_controller(UPLOAD_URL)).run();
+        update_metadata(session.file());
     } catch (...) {
         GDriveExceptionTranslator::translate(m_path);
     }
 }
 
+void GDriveFile::require_unchanged() const {
+    // drive v3 ignores `If-Match`, so the version is compared before uploading
+    const auto token = m_credentials->get_current_access_token();
+    const auto response_json = m_request->GET(m_resource_path)
+            ->token_auth(token)
+            ->query_param("fields", "version")
+            ->accept(Request::MIMETYPE_JSON)
+            ->request().json();
+    if (response_json.at("version") != revision()) {
+        throw exceptions::resource::ResourceHasChanged(m_path);
+    }
+}
+
 std::shared_ptr<request::Request> GDriveFile::prepare_write_request() const {
     const auto token = m_credentials->get_current_access_token();
-    return m_request->PUT("https://www.googleapis.com/upload/drive/v2/files/" + m_resource_id)
+    return m_request->PATCH(UPLOAD_URL + "/" + m_resource_id)
             ->token_auth(token)
-            ->if_match(this->revision())
             ->content_type(Request::MIMETYPE_BINARY)
             ->accept(Request::MIMETYPE_JSON)
             ->query_param("uploadType", "media")
-            ->query_param("fields", "etag");
+            ->query_param("fields", METADATA_FIELD_MASK);
+}
+
+void GDriveFile::update_metadata(const json &file) {
+    m_revision = file.at("version");
+    // drive reports int64 values as strings
+    m_size = std::strtoull(file.value("size", "0").c_str(), nullptr, 10);
+    if (const auto modified = util::parse_iso8601(file.value("modifiedTime", ""))) {
+        m_modified = *modified;
+    }
+    m_content_type = file.value("mimeType", m_content_type);
+    m_content_hash = parse_content_hash(file.value("md5Checksum", ""));
+}
+
+std::optional<ContentHash> GDriveFile::parse_content_hash(const std::string &md5_checksum) {
+    if (md5_checksum.empty()) {
+        return std::nullopt;
+    }
+    return ContentHash{ContentHash::Algorithm::MD5, md5_checksum};
 }
@@ -3,18 +3,35 @@
 #include <utility>
 
 #include "OAuthFileImpl.hpp"
+#include "GDrivePathCache.hpp"
+#include <nlohmann/json.hpp>
 
 namespace CloudSync::gdrive {
+    class GDriveDirectory;
+
     class GDriveFile : public OAuthFileImpl {
     public:
         GDriveFile(
-                const std::string &baseUrl, std::string resourceId, const std::string &dir,
+                const std::string &baseUrl, std::string rootName, std::string resourceId, const std::string &dir,
                 const std::shared_ptr<credentials::OAuth2CredentialsImpl> credentials,
-                const std::shared_ptr<request::Request> &request, const std::string &name, const std::string &revision)
-                : OAuthFileImpl(baseUrl, dir, credentials, request, name, revision), m_resource_id(std::move(resourceId)) {};
+                const std::shared_ptr<request::Request> &request, const std::string &name, const std::string &revision,
+                std::uint64_t size = 0,
+                std::chrono::system_clock::time_point modified = {},
+                const std::string &content_type = "",
+                std::optional<ContentHash> content_hash = std::nullopt,
+                std::shared_ptr<GDrivePathCache> pathCache = nullptr)
+                : OAuthFileImpl(baseUrl, dir, credentials, request, name, revision, size, modified, content_type,
+                                std::move(content_hash))
+                , m_root_name(std::move(rootName))
+                , m_resource_id(std::move(resourceId))
+                , m_path_cache(std::move(pathCache)) {};
 
         void remove() override;
 
+        std::shared_ptr<Resource> copy_to(const std::filesystem::path &path) const override;
+
+        std::shared_ptr<Resource> move_to(const std::filesystem::path &path) override;
+
         bool poll_change() override;
 
         [[nodiscard]] std::string read() const override;
@@ -25,12 +42,41 @@ namespace CloudSync::gdrive {
 
         void write_binary(const std::vector<std::uint8_t>& content) override;
 
+        [[nodiscard]] std::string id() const override {
+            return m_resource_id;
+        }
+
+        /// @return the hash for the `md5Checksum` of a drive file, `std::nullopt` if it's empty (google docs).
+        static std::optional<ContentHash> parse_content_hash(const std::string &md5_checksum);
+
+        /// endpoint for requests that send file content
+        static const std::string UPLOAD_URL;
+
+    protected:
+        void upload_chunked(const upload::UploadSource &source) override;
+
     private:
+        /// id of the folder that is the root of the cloud
+        const std::string m_root_name;
         const std::string m_resource_id;
+        /// path to id mapping of the cloud this file belongs to. May be `nullptr`.
+        const std::shared_ptr<GDrivePathCache> m_path_cache;
 
         const std::string m_resource_path = m_base_url + "/files/" + m_resource_id;
 
+        /// @return a handle for the root of the cloud, which resolves the destinations of copies & moves
+        std::shared_ptr<GDriveDirectory> root() const;
+
         std::shared_ptr<request::Request> prepare_read_request() const;
         std::shared_ptr<request::Request> prepare_write_request() const;
+
+        /// @throws exceptions::resource::ResourceHasChanged if the version on the server differs from revision()
+        void require_unchanged() const;
+
+        /// `fields` query parameter for everything update_metadata() reads
+        static const std::string METADATA_FIELD_MASK;
+
+        /// takes revision, size, modification time, mimetype & md5 from a drive file resource.
+        void update_metadata(const nlohmann::json &file);
     };
 }
@@ -0,0 +1,89 @@
+#include "GDrivePathCache.hpp"
+
+using namespace CloudSync::gdrive;
+namespace fs = std::filesystem;
+
+std::optional<GDrivePathCache::Entry> GDrivePathCache::get(const fs::path &path) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto node = find(path);
+    return node ? node->entry : std::nullopt;
+}
+
+void GDrivePathCache::put(const fs::path &path, Entry entry) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    find(path, true)->entry = std::move(entry);
+}
+
+void GDrivePathCache::put_children(const fs::path &path, std::vector<std::pair<std::string, Entry>> children) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto &node = *find(path, true);
+    std::unordered_map<std::string, std::unique_ptr<Node>> new_children;
+    new_children.reserve(children.size());
+    for (auto &child: children) {
+        auto existing = node.children.find(child.first);
+        std::unique_ptr<Node> child_node;
+        if (existing != node.children.end() && existing->second->entry && existing->second->entry->id == child.second.id) {
+            // same resource as before, its descendants are still valid
+            child_node = std::move(existing->second);
+        } else {
+            child_node = std::make_unique<Node>();
+        }
+        child_node->entry = std::move(child.second);
+        new_children[child.first] = std::move(child_node);
+    }
+    node.children = std::move(new_children);
+}
+
+void GDrivePathCache::remove(const fs::path &path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto parent = find(path.parent_path(), false);
+    if (parent) {
+        parent->children.erase(path.filename().generic_string());
+    }
+}
+
+void GDrivePathCache::remove_id(const std::string &id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    remove_id(m_root, id);
+}
+
+void GDrivePathCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_root.children.clear();
+    m_root.entry.reset();
+}
+
+GDrivePathCache::Node *GDrivePathCache::find(const fs::path &path, bool create) {
+    Node *node = &m_root;
+    for (const auto &component: path.relative_path()) {
+        const auto name = component.generic_string();
+        if (name.empty()) {
+            // trailing separator
+            continue;
+        }
+        auto child = node->children.find(name);
+        if (child == node->children.end()) {
+            if (!create) {
+                return nullptr;
+            }
+            child = node->children.emplace(name, std::make_unique<Node>()).first;
+        }
+        node = child->second.get();
+    }
+    return node;
+}
+
+const GDrivePathCache::Node *GDrivePathCache::find(const fs::path &path) const {
+    return const_cast<GDrivePathCache *>(this)->find(path, false);
+}
+
+void GDrivePathCache::remove_id(Node &node, const std::string &id) {
+    for (auto child = node.children.begin(); child != node.children.end();) {
+        if (child->second->entry && child->second->entry->id == id) {
+            child = node.children.erase(child);
+        } else {
+            remove_id(*child->second, id);
+            child++;
+        }
+    }
+}
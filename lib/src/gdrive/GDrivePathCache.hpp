@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace CloudSync::gdrive {
+    /**
+     * Maps absolute paths to google drive file ids.
+     *
+     * Google Drive only knows ids, so resolving a path means one `files` query per path component. This cache is
+     * shared by all directory & file handles of a GDriveCloud and remembers every resource that has been seen in a
+     * listing, a query or a create response, so repeated access to deep paths doesn't have to walk the tree again.
+     * The paths are stored as a trie of their components.
+     *
+     * Thread safe.
+     */
+    class GDrivePathCache {
+    public:
+        struct Entry {
+            std::string id;
+            std::string parent_id;
+            bool is_folder = false;
+            std::chrono::system_clock::time_point modified;
+        };
+
+        /// @return the cached resource at the absolute `path`, if there is one.
+        [[nodiscard]] std::optional<Entry> get(const std::filesystem::path &path) const;
+
+        void put(const std::filesystem::path &path, Entry entry);
+
+        /**
+         * Replaces all cached children of the directory at `path` with the result of a complete listing. Cached
+         * descendants of children that are still present are kept.
+         */
+        void put_children(const std::filesystem::path &path, std::vector<std::pair<std::string, Entry>> children);
+
+        /// Forgets the resource at `path` and everything below it.
+        void remove(const std::filesystem::path &path);
+
+        /// Forgets every resource with the given id and everything below it, e.g. when the change feed reports it.
+        void remove_id(const std::string &id);
+
+        void clear();
+
+    private:
+        struct Node {
+            std::optional<Entry> entry;
+            std::unordered_map<std::string, std::unique_ptr<Node>> children;
+        };
+
+        mutable std::mutex m_mutex;
+        Node m_root;
+
+        /// @return the node at `path` or `nullptr`. If `create` is set, missing nodes are created.
+        Node *find(const std::filesystem::path &path, bool create);
+        const Node *find(const std::filesystem::path &path) const;
+
+        static void remove_id(Node &node, const std::string &id);
+    };
+}
@@ -0,0 +1,77 @@
+#include "GDriveUploadSession.hpp"
+#include "CloudSync/exceptions/cloud/CloudException.hpp"
+#include <cstdlib>
+
+using namespace CloudSync;
+using namespace CloudSync::request;
+using namespace CloudSync::gdrive;
+using json = nlohmann::json;
+
+const std::size_t GDriveUploadSession::CHUNK_GRANULARITY = 256 * 1024;
+
+upload::UploadSession::Limits GDriveUploadSession::limits(std::uint64_t) const {
+    return {CHUNK_GRANULARITY, upload::ChunkSizer::MAX_CHUNK_SIZE, CHUNK_GRANULARITY, false};
+}
+
+void GDriveUploadSession::start(std::uint64_t total_size) {
+    m_total_size = total_size;
+    const auto token = m_credentials->get_current_access_token();
+    const auto response = m_request->PATCH(m_upload_url)
+            ->token_auth(token)
+            ->query_param("uploadType", "resumable")
+            ->query_param("fields", m_field_mask)
+            ->header("X-Upload-Content-Length", std::to_string(total_size))
+            ->json_body(json::object())
+            ->request();
+    const auto location = response.headers.find("location");
+    if (location == response.headers.end()) {
+        throw exceptions::cloud::InvalidResponse("resumable upload has been started without a session uri");
+    }
+    m_session_url = location->second;
+}
+
+void GDriveUploadSession::upload_chunk(const std::shared_ptr<request::Request> &request, const upload::Chunk &chunk) {
+    const auto token = m_credentials->get_current_access_token();
+    const auto response = request->PUT(m_session_url)
+            ->token_auth(token)
+            ->header("Content-Range", upload::ChunkedUpload::content_range(chunk.offset, chunk.data.size(), m_total_size))
+            ->binary_body(chunk.data)
+            ->request();
+    take_file(response);
+}
+
+std::optional<std::uint64_t> GDriveUploadSession::received_bytes(const std::shared_ptr<request::Request> &request) {
+    const auto token = m_credentials->get_current_access_token();
+    const auto response = request->PUT(m_session_url)
+            ->token_auth(token)
+            ->header("Content-Range", "bytes */" + std::to_string(m_total_size))
+            ->request();
+    if (take_file(response)) {
+        return m_total_size;
+    }
+    // `Range: bytes=0-26214399` once the first 25 MiB have arrived, no header if nothing has
+    const auto range = response.headers.find("range");
+    if (range == response.headers.end()) {
+        return 0;
+    }
+    const auto end = range->second.find('-');
+    if (end == std::string::npos) {
+        throw exceptions::cloud::InvalidResponse("unexpected range of resumable upload: " + range->second);
+    }
+    return std::strtoull(range->second.c_str() + end + 1, nullptr, 10) + 1;
+}
+
+void GDriveUploadSession::finish(std::uint64_t) {
+    if (m_file.is_null()) {
+        throw exceptions::cloud::InvalidResponse("resumable upload has ended without returning the uploaded file");
+    }
+}
+
+bool GDriveUploadSession::take_file(const request::StringResponse &response) {
+    // 308 Resume Incomplete for all chunks but the last one
+    if (response.code == 200 || response.code == 201) {
+        m_file = response.json();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "upload/ChunkedUpload.hpp"
+#include "credentials/OAuth2CredentialsImpl.hpp"
+#include <nlohmann/json.hpp>
+
+namespace CloudSync::gdrive {
+    /**
+     * Chunked upload with `uploadType=resumable`. Chunks are `PUT` to the session uri in order, the server answers
+     * `308 Resume Incomplete` until the last one has arrived.
+     */
+    class GDriveUploadSession : public upload::UploadSession {
+    public:
+        GDriveUploadSession(
+                std::string upload_url,
+                std::string field_mask,
+                std::shared_ptr<credentials::OAuth2CredentialsImpl> credentials,
+                std::shared_ptr<request::Request> request)
+                : m_upload_url(std::move(upload_url))
+                , m_field_mask(std::move(field_mask))
+                , m_credentials(std::move(credentials))
+                , m_request(std::move(request)) {};
+
+        [[nodiscard]] Limits limits(std::uint64_t total_size) const override;
+
+        void start(std::uint64_t total_size) override;
+
+        void upload_chunk(const std::shared_ptr<request::Request> &request, const upload::Chunk &chunk) override;
+
+        /// asks for the upload status with an empty `PUT` and `Content-Range: bytes */{size}`
+        std::optional<std::uint64_t> received_bytes(const std::shared_ptr<request::Request> &request) override;
+
+        void finish(std::uint64_t total_size) override;
+
+        /// @return the uploaded file resource with the fields of the field mask, once the session has finished.
+        [[nodiscard]] const nlohmann::json &file() const {
+            return m_file;
+        }
+
+    private:
+        /// drive needs chunks to be a multiple of 256 KiB
+        static const std::size_t CHUNK_GRANULARITY;
+
+        const std::string m_upload_url;
+        const std::string m_field_mask;
+        const std::shared_ptr<credentials::OAuth2CredentialsImpl> m_credentials;
+        const std::shared_ptr<request::Request> m_request;
+        std::string m_session_url;
+        std::uint64_t m_total_size = 0;
+        nlohmann::json m_file;
+
+        /// takes the file resource from the response to the last chunk
+        bool take_file(const request::StringResponse &response);
+    };
+}
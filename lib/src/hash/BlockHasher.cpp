@@ -0,0 +1,76 @@
+#include "Hasher.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace CloudSync::hash {
+    void BlockHasher::update(const std::uint8_t *data, std::size_t length) {
+        m_total_length += length;
+        if (m_block_length > 0) {
+            const auto missing = std::min(length, BLOCK_SIZE - m_block_length);
+            std::memcpy(m_block.data() + m_block_length, data, missing);
+            m_block_length += missing;
+            data += missing;
+            length -= missing;
+            if (m_block_length < BLOCK_SIZE) {
+                return;
+            }
+            transform(m_block.data());
+            m_block_length = 0;
+        }
+        for (; length >= BLOCK_SIZE; data += BLOCK_SIZE, length -= BLOCK_SIZE) {
+            transform(data);
+        }
+        std::memcpy(m_block.data(), data, length);
+        m_block_length = length;
+    }
+
+    std::string BlockHasher::finish() {
+        return to_hex(digest());
+    }
+
+    std::vector<std::uint8_t> BlockHasher::digest() {
+        const std::uint64_t bit_length = m_total_length * 8;
+        // a single 1 bit, zeros up to 56 bytes into the last block and the message length in bits
+        static const std::uint8_t PADDING[BLOCK_SIZE] = {0x80};
+        update(PADDING, m_block_length < 56 ? 56 - m_block_length : 120 - m_block_length);
+        std::uint8_t length_bytes[8];
+        for (int i = 0; i < 8; i++) {
+            const auto shift = 8 * (m_big_endian ? 7 - i : i);
+            length_bytes[i] = static_cast<std::uint8_t>(bit_length >> shift);
+        }
+        update(length_bytes, sizeof(length_bytes));
+
+        std::vector<std::uint8_t> result;
+        for (const auto word: state()) {
+            for (int i = 0; i < 4; i++) {
+                const auto shift = 8 * (m_big_endian ? 3 - i : i);
+                result.push_back(static_cast<std::uint8_t>(word >> shift));
+            }
+        }
+        return result;
+    }
+
+    std::uint32_t BlockHasher::read_word(const std::uint8_t *bytes) const {
+        if (m_big_endian) {
+            return static_cast<std::uint32_t>(bytes[0]) << 24
+                   | static_cast<std::uint32_t>(bytes[1]) << 16
+                   | static_cast<std::uint32_t>(bytes[2]) << 8
+                   | static_cast<std::uint32_t>(bytes[3]);
+        }
+        return static_cast<std::uint32_t>(bytes[0])
+               | static_cast<std::uint32_t>(bytes[1]) << 8
+               | static_cast<std::uint32_t>(bytes[2]) << 16
+               | static_cast<std::uint32_t>(bytes[3]) << 24;
+    }
+
+    std::string to_hex(const std::vector<std::uint8_t> &bytes) {
+        static const char DIGITS[] = "0123456789abcdef";
+        std::string hex;
+        hex.reserve(bytes.size() * 2);
+        for (const auto byte: bytes) {
+            hex += DIGITS[byte >> 4];
+            hex += DIGITS[byte & 0x0f];
+        }
+        return hex;
+    }
+}
@@ -0,0 +1,53 @@
+#include "CloudSync/ContentHash.hpp"
+#include "DropboxContentHasher.hpp"
+#include "Md5.hpp"
+#include "QuickXorHash.hpp"
+#include "Sha1.hpp"
+#include "Sha256.hpp"
+#include <fstream>
+#include <memory>
+
+using namespace CloudSync;
+
+namespace {
+    constexpr std::size_t READ_BUFFER_SIZE = 1024 * 1024;
+
+    std::unique_ptr<hash::Hasher> hasher(ContentHash::Algorithm algorithm) {
+        switch (algorithm) {
+            case ContentHash::Algorithm::QUICK_XOR:
+                return std::make_unique<hash::QuickXorHash>();
+            case ContentHash::Algorithm::MD5:
+                return std::make_unique<hash::Md5>();
+            case ContentHash::Algorithm::SHA1:
+                return std::make_unique<hash::Sha1>();
+            case ContentHash::Algorithm::SHA256:
+                return std::make_unique<hash::Sha256>();
+            case ContentHash::Algorithm::DROPBOX:
+                break;
+        }
+        return std::make_unique<hash::DropboxContentHasher>();
+    }
+}
+
+ContentHash ContentHash::of_file(Algorithm algorithm, const std::filesystem::path &path) {
+    if (algorithm == Algorithm::DROPBOX) {
+        // blocks are read & hashed in parallel
+        return {algorithm, hash::DropboxContentHasher::of_file(path)};
+    }
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::filesystem::filesystem_error(
+                "failed to open file", path, std::make_error_code(std::errc::no_such_file_or_directory));
+    }
+    const auto content_hasher = hasher(algorithm);
+    std::vector<std::uint8_t> buffer(READ_BUFFER_SIZE);
+    while (stream) {
+        stream.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        content_hasher->update(buffer.data(), static_cast<std::size_t>(stream.gcount()));
+    }
+    if (stream.bad()) {
+        throw std::filesystem::filesystem_error(
+                "failed to read file", path, std::make_error_code(std::errc::io_error));
+    }
+    return {algorithm, content_hasher->finish()};
+}
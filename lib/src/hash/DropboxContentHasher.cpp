@@ -0,0 +1,89 @@
+#include "DropboxContentHasher.hpp"
+#include "Sha256.hpp"
+#include "util/Parallel.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+    constexpr std::size_t DIGEST_SIZE = 32;
+
+    std::size_t workers_or_cores(std::size_t max_workers) {
+        if (max_workers > 0) {
+            return max_workers;
+        }
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+namespace CloudSync::hash {
+    DropboxContentHasher::DropboxContentHasher(std::size_t max_workers)
+            : m_max_workers(workers_or_cores(max_workers)) {}
+
+    void DropboxContentHasher::update(const std::uint8_t *data, std::size_t length) {
+        if (!m_block.empty()) {
+            const auto missing = std::min(length, BLOCK_SIZE - m_block.size());
+            m_block.insert(m_block.end(), data, data + missing);
+            data += missing;
+            length -= missing;
+            if (m_block.size() < BLOCK_SIZE) {
+                return;
+            }
+            hash_blocks(m_block.data(), 1);
+            m_block.clear();
+        }
+        const auto blocks = length / BLOCK_SIZE;
+        hash_blocks(data, blocks);
+        m_block.assign(data + blocks * BLOCK_SIZE, data + length);
+    }
+
+    void DropboxContentHasher::hash_blocks(const std::uint8_t *data, std::size_t count) {
+        const auto offset = m_block_digests.size();
+        m_block_digests.resize(offset + count * DIGEST_SIZE);
+        util::parallel_for(count, m_max_workers, [&](std::size_t, std::size_t index) {
+            const auto digest = Sha256::digest_of(data + index * BLOCK_SIZE, BLOCK_SIZE);
+            std::memcpy(m_block_digests.data() + offset + index * DIGEST_SIZE, digest.data(), DIGEST_SIZE);
+        });
+    }
+
+    std::string DropboxContentHasher::finish() {
+        if (!m_block.empty()) {
+            const auto digest = Sha256::digest_of(m_block.data(), m_block.size());
+            m_block_digests.insert(m_block_digests.end(), digest.begin(), digest.end());
+            m_block.clear();
+        }
+        return finish(m_block_digests);
+    }
+
+    std::string DropboxContentHasher::of_file(const std::filesystem::path &path, std::size_t max_workers) {
+        const auto size = std::filesystem::file_size(path);
+        const auto blocks = static_cast<std::size_t>((size + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        std::vector<std::uint8_t> block_digests(blocks * DIGEST_SIZE);
+        const auto workers = std::min(workers_or_cores(max_workers), std::max<std::size_t>(blocks, 1));
+        // every worker reads its blocks through its own stream & buffer
+        std::vector<std::vector<std::uint8_t>> buffers(workers);
+        util::parallel_for(blocks, workers, [&](std::size_t worker, std::size_t index) {
+            const auto offset = static_cast<std::uint64_t>(index) * BLOCK_SIZE;
+            const auto length = static_cast<std::size_t>(std::min<std::uint64_t>(BLOCK_SIZE, size - offset));
+            auto &buffer = buffers[worker];
+            buffer.resize(length);
+            std::ifstream stream(path, std::ios::binary);
+            stream.seekg(static_cast<std::streamoff>(offset));
+            stream.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(length));
+            if (!stream) {
+                throw std::filesystem::filesystem_error(
+                        "failed to read file", path, std::make_error_code(std::errc::io_error));
+            }
+            const auto digest = Sha256::digest_of(buffer.data(), length);
+            std::memcpy(block_digests.data() + index * DIGEST_SIZE, digest.data(), DIGEST_SIZE);
+        });
+        return finish(block_digests);
+    }
+
+    std::string DropboxContentHasher::finish(const std::vector<std::uint8_t> &block_digests) {
+        Sha256 sha256;
+        sha256.update(block_digests);
+        return sha256.finish();
+    }
+}
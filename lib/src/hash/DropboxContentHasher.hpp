@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Hasher.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace CloudSync::hash {
+    /**
+     * The [content hash](https://www.dropbox.com/developers/reference/content-hash) of Dropbox: the SHA-256 of the
+     * concatenated SHA-256 digests of every 4 MiB block of the content.
+     *
+     * The blocks don't depend on each other, so whole blocks are hashed on several threads at once.
+     */
+    class DropboxContentHasher : public Hasher {
+    public:
+        static constexpr std::size_t BLOCK_SIZE = 4 * 1024 * 1024;
+
+        /// @param max_workers most threads that hash blocks at the same time. `0` uses one per core.
+        explicit DropboxContentHasher(std::size_t max_workers = 0);
+
+        using Hasher::update;
+
+        void update(const std::uint8_t *data, std::size_t length) override;
+
+        /// finishes the hash. @return the digest as lowercase hex string.
+        [[nodiscard]] std::string finish() override;
+
+        /**
+         * Hashes a local file, reading & hashing its blocks on several threads at once.
+         * @param max_workers most threads that read blocks at the same time. `0` uses one per core.
+         * @throws std::filesystem::filesystem_error if the file can't be read
+         */
+        static std::string of_file(const std::filesystem::path &path, std::size_t max_workers = 0);
+
+    private:
+        const std::size_t m_max_workers;
+        /// start of a block that is still missing data
+        std::vector<std::uint8_t> m_block;
+        /// concatenated digests of all complete blocks
+        std::vector<std::uint8_t> m_block_digests;
+
+        /// hashes `count` whole blocks at `data` & appends their digests
+        void hash_blocks(const std::uint8_t *data, std::size_t count);
+
+        static std::string finish(const std::vector<std::uint8_t> &block_digests);
+    };
+}
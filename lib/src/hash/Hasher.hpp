@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CloudSync::hash {
+    /// A hash function that takes its input in pieces of any size.
+    class Hasher {
+    public:
+        virtual ~Hasher() = default;
+
+        virtual void update(const std::uint8_t *data, std::size_t length) = 0;
+
+        void update(const std::vector<std::uint8_t> &data) {
+            update(data.data(), data.size());
+        }
+
+        /**
+         * Finishes the hash. The hasher can't be updated afterwards.
+         * @return the digest, encoded the way the providers report it.
+         */
+        [[nodiscard]] virtual std::string finish() = 0;
+    };
+
+    /**
+     * Base of the Merkle–Damgård hashes MD5, SHA-1 & SHA-256: Input is split into blocks of 64 bytes, and the
+     * last block is padded with a single `1` bit, zeros and the length of the message.
+     */
+    class BlockHasher : public Hasher {
+    public:
+        static constexpr std::size_t BLOCK_SIZE = 64;
+
+        using Hasher::update;
+
+        void update(const std::uint8_t *data, std::size_t length) override;
+
+        /// finishes the hash. @return the digest as lowercase hex string.
+        [[nodiscard]] std::string finish() override;
+
+        /// finishes the hash. @return the raw digest.
+        [[nodiscard]] std::vector<std::uint8_t> digest();
+
+    protected:
+        /// @param big_endian byte order of the message length and the words of the state
+        explicit BlockHasher(bool big_endian) : m_big_endian(big_endian) {}
+
+        /// processes one block of BLOCK_SIZE bytes
+        virtual void transform(const std::uint8_t *block) = 0;
+
+        /// @return the words of the state that make up the digest
+        [[nodiscard]] virtual std::vector<std::uint32_t> state() const = 0;
+
+        [[nodiscard]] std::uint32_t read_word(const std::uint8_t *bytes) const;
+
+    private:
+        const bool m_big_endian;
+        std::array<std::uint8_t, BLOCK_SIZE> m_block{};
+        std::size_t m_block_length = 0;
+        std::uint64_t m_total_length = 0;
+    };
+
+    /// @return `bytes` as lowercase hex string
+    std::string to_hex(const std::vector<std::uint8_t> &bytes);
+}
@@ -0,0 +1,70 @@
+#include "Md5.hpp"
+
+namespace {
+    constexpr std::uint32_t SINES[64] = {
+            0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+            0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+            0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+            0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+            0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+            0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+            0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+            0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+    constexpr std::uint32_t SHIFTS[64] = {
+            7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+            5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+            4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+            6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21};
+
+    inline std::uint32_t rotate_left(std::uint32_t value, std::uint32_t bits) {
+        return (value << bits) | (value >> (32 - bits));
+    }
+}
+
+namespace CloudSync::hash {
+    Md5::Md5() : BlockHasher(false), m_state{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476} {}
+
+    std::string Md5::hex(const std::vector<std::uint8_t> &data) {
+        Md5 md5;
+        md5.update(data);
+        return md5.finish();
+    }
+
+    void Md5::transform(const std::uint8_t *block) {
+        std::uint32_t words[16];
+        for (std::size_t i = 0; i < 16; i++) {
+            words[i] = read_word(block + i * 4);
+        }
+        auto a = m_state[0];
+        auto b = m_state[1];
+        auto c = m_state[2];
+        auto d = m_state[3];
+        for (std::uint32_t i = 0; i < 64; i++) {
+            std::uint32_t f;
+            std::uint32_t g;
+            if (i < 16) {
+                f = (b & c) | (~b & d);
+                g = i;
+            } else if (i < 32) {
+                f = (d & b) | (~d & c);
+                g = (5 * i + 1) % 16;
+            } else if (i < 48) {
+                f = b ^ c ^ d;
+                g = (3 * i + 5) % 16;
+            } else {
+                f = c ^ (b | ~d);
+                g = (7 * i) % 16;
+            }
+            const auto rotated = rotate_left(a + f + SINES[i] + words[g], SHIFTS[i]);
+            a = d;
+            d = c;
+            c = b;
+            b = b + rotated;
+        }
+        m_state[0] += a;
+        m_state[1] += b;
+        m_state[2] += c;
+        m_state[3] += d;
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Hasher.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CloudSync::hash {
+    /// MD5 ([RFC 1321](https://www.rfc-editor.org/rfc/rfc1321)).
+    class Md5 : public BlockHasher {
+    public:
+        Md5();
+
+        /// @return the lowercase hex MD5 of `data`
+        static std::string hex(const std::vector<std::uint8_t> &data);
+
+    protected:
+        void transform(const std::uint8_t *block) override;
+
+        [[nodiscard]] std::vector<std::uint32_t> state() const override {
+            return {m_state.begin(), m_state.end()};
+        }
+
+    private:
+        std::array<std::uint32_t, 4> m_state;
+    };
+}
@@ -0,0 +1,104 @@
+#include "QuickXorHash.hpp"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLOUDSYNC_QUICKXOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr std::size_t SHIFT = 11;
+    constexpr std::size_t WIDTH_IN_BITS = 160;
+
+    std::string base64(const std::uint8_t *data, std::size_t length) {
+        static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string encoded;
+        encoded.reserve((length + 2) / 3 * 4);
+        for (std::size_t i = 0; i < length; i += 3) {
+            const std::uint32_t group = static_cast<std::uint32_t>(data[i]) << 16
+                                        | (i + 1 < length ? static_cast<std::uint32_t>(data[i + 1]) << 8 : 0)
+                                        | (i + 2 < length ? static_cast<std::uint32_t>(data[i + 2]) : 0);
+            encoded += ALPHABET[(group >> 18) & 0x3f];
+            encoded += ALPHABET[(group >> 12) & 0x3f];
+            encoded += i + 1 < length ? ALPHABET[(group >> 6) & 0x3f] : '=';
+            encoded += i + 2 < length ? ALPHABET[group & 0x3f] : '=';
+        }
+        return encoded;
+    }
+}
+
+namespace CloudSync::hash {
+    void QuickXorHash::update(const std::uint8_t *data, std::size_t length) {
+        m_length += length;
+        // bytes up to the start of the next row
+        while (length > 0 && m_offset != 0) {
+            m_cells[m_offset] ^= *data++;
+            m_offset = (m_offset + 1) % WIDTH_IN_BYTES;
+            length--;
+        }
+        if (length == 0) {
+            return;
+        }
+        const auto rows = length / WIDTH_IN_BYTES;
+        fold_rows(data, rows);
+        data += rows * WIDTH_IN_BYTES;
+        length -= rows * WIDTH_IN_BYTES;
+        for (std::size_t i = 0; i < length; i++) {
+            m_cells[i] ^= data[i];
+        }
+        m_offset = length;
+    }
+
+    void QuickXorHash::fold_rows(const std::uint8_t *data, std::size_t rows) {
+        if (rows == 0) {
+            return;
+        }
+#ifdef CLOUDSYNC_QUICKXOR_SSE2
+        constexpr std::size_t LANES = WIDTH_IN_BYTES / 16;
+        __m128i cells[LANES];
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            cells[lane] = _mm_load_si128(reinterpret_cast<const __m128i *>(m_cells.data()) + lane);
+        }
+        for (std::size_t row = 0; row < rows; row++, data += WIDTH_IN_BYTES) {
+            const auto input = reinterpret_cast<const __m128i *>(data);
+            for (std::size_t lane = 0; lane < LANES; lane++) {
+                cells[lane] = _mm_xor_si128(cells[lane], _mm_loadu_si128(input + lane));
+            }
+        }
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            _mm_store_si128(reinterpret_cast<__m128i *>(m_cells.data()) + lane, cells[lane]);
+        }
+#else
+        constexpr std::size_t WORDS = WIDTH_IN_BYTES / 8;
+        std::uint64_t cells[WORDS];
+        std::memcpy(cells, m_cells.data(), WIDTH_IN_BYTES);
+        for (std::size_t row = 0; row < rows; row++, data += WIDTH_IN_BYTES) {
+            std::uint64_t input[WORDS];
+            std::memcpy(input, data, WIDTH_IN_BYTES);
+            for (std::size_t word = 0; word < WORDS; word++) {
+                cells[word] ^= input[word];
+            }
+        }
+        std::memcpy(m_cells.data(), cells, WIDTH_IN_BYTES);
+#endif
+    }
+
+    std::string QuickXorHash::finish() {
+        // the byte at position p of the content is XORed into the state at bit (11 * p) % 160, wrapping around
+        std::uint8_t state[WIDTH_IN_BITS / 8] = {};
+        for (std::size_t cell = 0; cell < WIDTH_IN_BYTES; cell++) {
+            const auto shift = (cell * SHIFT) % WIDTH_IN_BITS;
+            for (std::size_t bit = 0; bit < 8; bit++) {
+                if (m_cells[cell] & (1u << bit)) {
+                    const auto position = (shift + bit) % WIDTH_IN_BITS;
+                    state[position / 8] ^= static_cast<std::uint8_t>(1u << (position % 8));
+                }
+            }
+        }
+        // the length, in little endian, goes into the last 8 bytes
+        for (std::size_t i = 0; i < 8; i++) {
+            state[sizeof(state) - 8 + i] ^= static_cast<std::uint8_t>(m_length >> (8 * i));
+        }
+        return base64(state, sizeof(state));
+    }
+}
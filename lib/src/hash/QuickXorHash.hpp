@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Hasher.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace CloudSync::hash {
+    /**
+     * The [QuickXorHash](https://learn.microsoft.com/en-us/onedrive/developer/code-snippets/quickxorhash) of
+     * OneDrive: Every byte is XORed into a 160 bit state, shifted by 11 bits more than the byte before it, and the
+     * length of the content is XORed into the last 64 bits.
+     *
+     * Because the shift repeats every 160 bytes, the content is first folded into 160 byte-sized cells with plain,
+     * vectorized XORs, and only the 160 cells are shifted into the state when the hash is finished.
+     */
+    class QuickXorHash : public Hasher {
+    public:
+        static constexpr std::size_t WIDTH_IN_BYTES = 160;
+
+        using Hasher::update;
+
+        void update(const std::uint8_t *data, std::size_t length) override;
+
+        /// finishes the hash. @return the digest in base64, as OneDrive reports it.
+        [[nodiscard]] std::string finish() override;
+
+    private:
+        /// XOR of all bytes whose position in the content has the same remainder when divided by 160
+        alignas(16) std::array<std::uint8_t, WIDTH_IN_BYTES> m_cells{};
+        /// position in `m_cells` the next byte is folded into
+        std::size_t m_offset = 0;
+        std::uint64_t m_length = 0;
+
+        /// folds whole rows of 160 bytes into `m_cells`, using SIMD where available
+        void fold_rows(const std::uint8_t *data, std::size_t rows);
+    };
+}
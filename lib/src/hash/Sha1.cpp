@@ -0,0 +1,54 @@
+#include "Sha1.hpp"
+
+namespace {
+    inline std::uint32_t rotate_left(std::uint32_t value, std::uint32_t bits) {
+        return (value << bits) | (value >> (32 - bits));
+    }
+}
+
+namespace CloudSync::hash {
+    Sha1::Sha1() : BlockHasher(true), m_state{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0} {}
+
+    void Sha1::transform(const std::uint8_t *block) {
+        std::uint32_t words[80];
+        for (std::size_t i = 0; i < 16; i++) {
+            words[i] = read_word(block + i * 4);
+        }
+        for (std::size_t i = 16; i < 80; i++) {
+            words[i] = rotate_left(words[i - 3] ^ words[i - 8] ^ words[i - 14] ^ words[i - 16], 1);
+        }
+        auto a = m_state[0];
+        auto b = m_state[1];
+        auto c = m_state[2];
+        auto d = m_state[3];
+        auto e = m_state[4];
+        for (std::size_t i = 0; i < 80; i++) {
+            std::uint32_t f;
+            std::uint32_t k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5a827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ed9eba1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8f1bbcdc;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xca62c1d6;
+            }
+            const auto temp = rotate_left(a, 5) + f + e + k + words[i];
+            e = d;
+            d = c;
+            c = rotate_left(b, 30);
+            b = a;
+            a = temp;
+        }
+        m_state[0] += a;
+        m_state[1] += b;
+        m_state[2] += c;
+        m_state[3] += d;
+        m_state[4] += e;
+    }
+}
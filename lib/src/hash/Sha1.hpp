@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Hasher.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace CloudSync::hash {
+    /// SHA-1 ([RFC 3174](https://www.rfc-editor.org/rfc/rfc3174)).
+    class Sha1 : public BlockHasher {
+    public:
+        Sha1();
+
+    protected:
+        void transform(const std::uint8_t *block) override;
+
+        [[nodiscard]] std::vector<std::uint32_t> state() const override {
+            return {m_state.begin(), m_state.end()};
+        }
+
+    private:
+        std::array<std::uint32_t, 5> m_state;
+    };
+}
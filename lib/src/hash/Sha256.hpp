@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Hasher.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CloudSync::hash {
+    /// SHA-256 ([FIPS 180-4](https://csrc.nist.gov/publications/detail/fips/180/4/final)).
+    class Sha256 : public BlockHasher {
+    public:
+        Sha256();
+
+        /// @return the raw SHA-256 of `length` bytes at `data`
+        static std::vector<std::uint8_t> digest_of(const std::uint8_t *data, std::size_t length);
+
+    protected:
+        void transform(const std::uint8_t *block) override;
+
+        [[nodiscard]] std::vector<std::uint32_t> state() const override {
+            return {m_state.begin(), m_state.end()};
+        }
+
+    private:
+        std::array<std::uint32_t, 8> m_state;
+    };
+}
@@ -0,0 +1,66 @@
+#include "NextcloudBulkUpload.hpp"
+#include "hash/Md5.hpp"
+#include "request/exceptions/ParseError.hpp"
+#include <nlohmann/json.hpp>
+
+using namespace CloudSync::nextcloud;
+using CloudSync::request::exceptions::ParseError;
+using json = nlohmann::json;
+
+namespace {
+    void append(std::vector<std::uint8_t> &body, const std::string &text) {
+        body.insert(body.end(), text.begin(), text.end());
+    }
+}
+
+const std::size_t NextcloudBulkUpload::MAX_PARTS = 100;
+
+const std::size_t NextcloudBulkUpload::MAX_BYTES = 100 * 1024 * 1024;
+
+std::vector<std::uint8_t> NextcloudBulkUpload::encode(const std::vector<Part> &parts, const std::string &boundary) {
+    std::vector<std::uint8_t> body;
+    for (const auto &part: parts) {
+        // the server rejects files whose md5 doesn't match their content
+        append(body, "--" + boundary + "\r\n"
+                     + "X-File-Path: " + part.path + "\r\n"
+                     + "X-File-MD5: " + hash::Md5::hex(*part.content) + "\r\n");
+        if (part.modified) {
+            append(body, "X-File-Mtime: " + std::to_string(*part.modified) + "\r\n");
+        }
+        append(body, "Content-Length: " + std::to_string(part.content->size()) + "\r\n"
+                     + "\r\n");
+        body.insert(body.end(), part.content->begin(), part.content->end());
+        append(body, "\r\n");
+    }
+    append(body, "--" + boundary + "--\r\n");
+    return body;
+}
+
+std::vector<NextcloudBulkUpload::PartResponse> NextcloudBulkUpload::decode(
+        const std::string &data, const std::vector<Part> &parts) {
+    std::vector<PartResponse> responses;
+    try {
+        const auto written_files = json::parse(data);
+        for (const auto &part: parts) {
+            const auto entry = written_files.find(part.path);
+            if (entry == written_files.end()) {
+                throw ParseError("no result for " + part.path);
+            }
+            PartResponse response;
+            response.error = entry->value("error", false);
+            if (response.error) {
+                response.message = entry->value("message", "");
+            } else {
+                // the etag is reported without the quotes of the ETag header
+                response.etag = entry->at("etag");
+                if (response.etag.empty() || response.etag.front() != '"') {
+                    response.etag = "\"" + response.etag + "\"";
+                }
+            }
+            responses.push_back(response);
+        }
+    } catch (const json::exception &e) {
+        throw ParseError(e.what());
+    }
+    return responses;
+}
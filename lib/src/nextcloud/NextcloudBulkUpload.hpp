@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace CloudSync::nextcloud {
+    /**
+     * Encodes & decodes the bodies of the nextcloud
+     * [bulk upload](https://github.com/nextcloud/server/blob/master/apps/dav/lib/BulkUpload/BulkUploadPlugin.php)
+     * endpoint `/remote.php/dav/bulk`, which writes many files with a single `multipart/related` request.
+     */
+    class NextcloudBulkUpload {
+    public:
+        /// a single file of a bulk upload
+        struct Part {
+            /// path of the file, relative to the users files. E.g. `/folder/file.txt`
+            std::string path;
+            const std::vector<std::uint8_t> *content = nullptr;
+            /// unix time of the last modification of the file. Without one the server uses the time of the upload.
+            std::optional<std::int64_t> modified;
+        };
+
+        /// the outcome for a single file of a bulk upload
+        struct PartResponse {
+            bool error = false;
+            /// etag of the written file, quoted like the `ETag` header of a `PUT`
+            std::string etag;
+            /// reason why the file could not be written
+            std::string message;
+        };
+
+        /// most files the client sends with a single request
+        static const std::size_t MAX_PARTS;
+        /// the client stops adding files to a request once its content exceeds this size
+        static const std::size_t MAX_BYTES;
+
+        /// @return the body of a bulk request. The matching content type is `multipart/related; boundary={boundary}`.
+        static std::vector<std::uint8_t> encode(const std::vector<Part> &parts, const std::string &boundary);
+
+        /**
+         * Reads the json object the server responds with, which has an entry for every path it has received.
+         * @return one response per part, in the order of the parts of the request.
+         * @throws request::exceptions::ParseError if the body is malformed or a response is missing.
+         */
+        static std::vector<PartResponse> decode(const std::string &data, const std::vector<Part> &parts);
+    };
+}
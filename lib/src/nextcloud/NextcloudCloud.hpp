@@ -21,7 +21,9 @@ namespace CloudSync::nextcloud {
             return std::make_shared<webdav::WebdavDirectory>(
                     m_base_url, "/remote.php/webdav", "/",
                     m_credentials,
-                    m_request, "");
+                    m_request, "",
+                    std::chrono::system_clock::time_point(),
+                    m_known_directories);
         }
 
         std::string get_user_display_name() const override;
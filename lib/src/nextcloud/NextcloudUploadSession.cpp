@@ -0,0 +1,87 @@
+#include "NextcloudUploadSession.hpp"
+#include "CloudSync/exceptions/cloud/CloudException.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+using namespace CloudSync;
+using namespace CloudSync::request;
+using namespace CloudSync::nextcloud;
+
+namespace {
+    std::string random_transfer_id() {
+        std::random_device random;
+        std::stringstream id;
+        id << "cloudsync-" << std::hex << std::setfill('0');
+        for (int i = 0; i < 4; i++) {
+            id << std::setw(8) << random();
+        }
+        return id.str();
+    }
+}
+
+const std::string NextcloudUploadSession::WEBDAV_PATH = "/remote.php/webdav";
+
+const std::size_t NextcloudUploadSession::MIN_CHUNK_SIZE = 5 * 1024 * 1024;
+
+const std::size_t NextcloudUploadSession::MAX_CHUNK_COUNT = 10000;
+
+NextcloudUploadSession::NextcloudUploadSession(
+        const std::string &server,
+        const std::string &path,
+        std::string revision,
+        std::shared_ptr<credentials::BasicCredentialsImpl> credentials,
+        std::shared_ptr<request::Request> request)
+        : m_revision(std::move(revision))
+        , m_credentials(std::move(credentials))
+        , m_request(std::move(request))
+        , m_destination(server + "/remote.php/dav/files/" + m_credentials->username() + path)
+        , m_upload_url(server + "/remote.php/dav/uploads/" + m_credentials->username() + "/" + random_transfer_id()) {}
+
+std::optional<std::string> NextcloudUploadSession::server_url(const std::string &webdav_url) {
+    if (webdav_url.size() > WEBDAV_PATH.size()
+        && webdav_url.compare(webdav_url.size() - WEBDAV_PATH.size(), WEBDAV_PATH.size(), WEBDAV_PATH) == 0) {
+        return webdav_url.substr(0, webdav_url.size() - WEBDAV_PATH.size());
+    }
+    return std::nullopt;
+}
+
+upload::UploadSession::Limits NextcloudUploadSession::limits(std::uint64_t total_size) const {
+    // chunks are numbered 1 to 10000
+    const auto min_chunk_size = std::max<std::uint64_t>(MIN_CHUNK_SIZE, (total_size + MAX_CHUNK_COUNT - 1) / MAX_CHUNK_COUNT);
+    return {static_cast<std::size_t>(min_chunk_size), upload::ChunkSizer::MAX_CHUNK_SIZE, 1, true};
+}
+
+void NextcloudUploadSession::start(std::uint64_t total_size) {
+    m_total_size = total_size;
+    m_request->MKCOL(m_upload_url)
+            ->basic_auth(m_credentials->username(), m_credentials->password())
+            ->header("Destination", m_destination)
+            ->request();
+}
+
+void NextcloudUploadSession::upload_chunk(const std::shared_ptr<request::Request> &request, const upload::Chunk &chunk) {
+    request->PUT(m_upload_url + "/" + std::to_string(chunk.index + 1))
+            ->basic_auth(m_credentials->username(), m_credentials->password())
+            ->header("Destination", m_destination)
+            ->header("OC-Total-Length", std::to_string(m_total_size))
+            ->content_type(Request::MIMETYPE_BINARY)
+            ->binary_body(chunk.data)
+            ->request();
+}
+
+void NextcloudUploadSession::finish(std::uint64_t total_size) {
+    const auto response = m_request->resource("MOVE", m_upload_url + "/.file")
+            ->basic_auth(m_credentials->username(), m_credentials->password())
+            ->header("Destination", m_destination)
+            ->header("OC-Total-Length", std::to_string(total_size))
+            // the condition is on the destination, a plain `If-Match` would be checked against the upload
+            ->header("If", "<" + m_destination + "> ([" + m_revision + "])")
+            ->request();
+    const auto etag = response.headers.find("etag");
+    if (etag == response.headers.end()) {
+        throw exceptions::cloud::InvalidResponse("assembled file has no etag");
+    }
+    m_etag = etag->second;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "upload/ChunkedUpload.hpp"
+#include "credentials/BasicCredentialsImpl.hpp"
+#include <optional>
+
+namespace CloudSync::nextcloud {
+    /**
+     * Chunked upload with [chunking v2](https://docs.nextcloud.com/server/latest/developer_manual/client_apis/WebDAV/chunking.html).
+     * Chunks are `PUT` into an upload collection in parallel and assembled with a `MOVE` of its `.file`.
+     */
+    class NextcloudUploadSession : public upload::UploadSession {
+    public:
+        NextcloudUploadSession(
+                const std::string &server,
+                const std::string &path,
+                std::string revision,
+                std::shared_ptr<credentials::BasicCredentialsImpl> credentials,
+                std::shared_ptr<request::Request> request);
+
+        /**
+         * @param webdav_url url of the webdav root of a file
+         * @return the url of the nextcloud server, if `webdav_url` points to a nextcloud webdav root.
+         */
+        static std::optional<std::string> server_url(const std::string &webdav_url);
+
+        [[nodiscard]] Limits limits(std::uint64_t total_size) const override;
+
+        void start(std::uint64_t total_size) override;
+
+        void upload_chunk(const std::shared_ptr<request::Request> &request, const upload::Chunk &chunk) override;
+
+        /// assembles the file, if it still has the revision the upload has started with.
+        void finish(std::uint64_t total_size) override;
+
+        /// @return the etag of the assembled file, once the session has finished.
+        [[nodiscard]] const std::string &etag() const {
+            return m_etag;
+        }
+
+    private:
+        static const std::string WEBDAV_PATH;
+        /// all chunks but the last one have to be at least 5 MiB
+        static const std::size_t MIN_CHUNK_SIZE;
+        static const std::size_t MAX_CHUNK_COUNT;
+
+        const std::string m_revision;
+        const std::shared_ptr<credentials::BasicCredentialsImpl> m_credentials;
+        const std::shared_ptr<request::Request> m_request;
+        const std::string m_destination;
+        const std::string m_upload_url;
+        std::uint64_t m_total_size = 0;
+        std::string m_etag;
+    };
+}
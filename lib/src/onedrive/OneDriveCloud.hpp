@@ -20,11 +20,17 @@ namespace CloudSync::onedrive {
             return std::make_shared<OneDriveDirectory>(
                     m_base_url, "/",
                     m_credentials,
-                    m_request, "");
+                    m_request, "",
+                    std::chrono::system_clock::time_point(),
+                    m_known_directories);
         }
 
         std::string get_user_display_name() const override;
 
         void logout() override;
+
+    private:
+        /// directories that are known to exist, shared by all directories of this cloud
+        const std::shared_ptr<util::KnownDirectories> m_known_directories = std::make_shared<util::KnownDirectories>();
     };
 } // namespace CloudSync::onedrive
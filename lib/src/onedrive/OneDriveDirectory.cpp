@@ -3,7 +3,14 @@
 #include "OneDriveFile.hpp"
 #include "CloudSync/exceptions/resource/ResourceException.hpp"
 #include "OneDriveExceptionTranslator.hpp"
+#include "util/DateTime.hpp"
+#include <algorithm>
+#include <cstdlib>
 #include <filesystem>
+#include <iterator>
+#include <map>
+#include <set>
+#include <thread>
 #include <vector>
 
 using namespace CloudSync;
@@ -12,15 +19,39 @@ using namespace CloudSync::onedrive;
 using json = nlohmann::json;
 namespace fs = std::filesystem;
 
+const std::vector<std::string> OneDriveDirectory::DRIVE_ITEM_FIELDS = {
+        "name", "eTag", "root", "file", "folder", "parentReference/path", "id", "size", "lastModifiedDateTime",
+        "file/mimeType", "file/hashes/quickXorHash", "file/hashes/sha256Hash", "@microsoft.graph.downloadUrl"};
+
+const std::string OneDriveDirectory::DRIVE_ITEM_SELECT =
+        "id,name,eTag,root,file,folder,parentReference,size,lastModifiedDateTime,@microsoft.graph.downloadUrl";
+
+const std::vector<std::string> OneDriveDirectory::SEARCH_ITEM_FIELDS = [] {
+    auto fields = DRIVE_ITEM_FIELDS;
+    fields.insert(fields.end(), {"parentReference/id", "parentReference/driveId", "remoteItem"});
+    return fields;
+}();
+
+const std::string OneDriveDirectory::SEARCH_ITEM_SELECT = DRIVE_ITEM_SELECT + ",remoteItem";
+
+const std::vector<std::string> OneDriveDirectory::PAGE_FIELDS = {"@odata.nextLink"};
+
+const std::string OneDriveDirectory::MAX_PAGE_SIZE = "1000";
+
+const std::string OneDriveDirectory::GRAPH_SERVICE_ROOT = "https://graph.microsoft.com/v1.0";
+
+const std::size_t OneDriveDirectory::MAX_BATCH_REQUESTS = 20;
+
+const std::chrono::milliseconds OneDriveDirectory::COPY_POLL_INTERVAL = 250ms;
+
+const std::chrono::milliseconds OneDriveDirectory::MAX_COPY_POLL_INTERVAL = 2000ms;
+
+const std::chrono::minutes OneDriveDirectory::COPY_TIMEOUT = 30min;
+
 std::vector<std::shared_ptr<Resource>> OneDriveDirectory::list_resources() const {
     std::vector<std::shared_ptr<Resource>> resource_list;
     try {
-        const auto response_json = m_request->GET(this->api_resource_path(m_path.generic_string(), true))
-                ->token_auth(m_credentials->get_current_access_token())
-                ->accept(Request::MIMETYPE_JSON)
-                ->request().json();
-
-        for (const auto &value: response_json.at("value")) {
+        for (const auto &value: this->list_children()) {
             resource_list.push_back(this->parse_drive_item(value));
         }
     } catch (...) {
@@ -29,19 +60,49 @@ std::vector<std::shared_ptr<Resource>> OneDriveDirectory::list_resources() const
     return resource_list;
 }
 
+std::vector<ResourceInfo> OneDriveDirectory::list_resource_info() const {
+    std::vector<ResourceInfo> resource_list;
+    try {
+        const auto children = this->list_children();
+        resource_list.reserve(children.size());
+        for (const auto &value: children) {
+            resource_list.push_back(parse_resource_info(value));
+        }
+    } catch (...) {
+        OneDriveExceptionTranslator::translate(m_path);
+    }
+    return resource_list;
+}
+
+std::shared_ptr<Resource> OneDriveDirectory::get_resource(const ResourceInfo &info) const {
+    const auto resource_path = append_path(info.name).generic_string();
+    if (info.is_file()) {
+        return std::make_shared<OneDriveFile>(
+                m_base_url, resource_path, m_credentials, m_request, info.name, info.revision,
+                info.size, info.modified, info.content_type, info.content_hash);
+    } else {
+        return std::make_shared<OneDriveDirectory>(
+                m_base_url, resource_path, m_credentials, m_request, info.name, info.modified, m_known_directories,
+                info.revision);
+    }
+}
+
 std::shared_ptr<Directory> OneDriveDirectory::get_directory(const std::filesystem::path &path) const {
     std::shared_ptr<OneDriveDirectory> directory;
     const auto resource_path = append_path(path);
     if (resource_path.generic_string() == "/") {
         // if it's the root we don't need to run a query
-        directory = std::make_shared<OneDriveDirectory>(m_base_url, "/", m_credentials, m_request, "");
+        directory = std::make_shared<OneDriveDirectory>(
+                m_base_url, "/", m_credentials, m_request, "", std::chrono::system_clock::time_point(),
+                m_known_directories);
     } else {
         try {
-            const auto response_json = m_request->GET(api_resource_path(resource_path.generic_string(), false))
+            const auto response = m_request->GET(api_resource_path(resource_path.generic_string(), false))
                     ->token_auth(m_credentials->get_current_access_token())
                     ->accept(Request::MIMETYPE_JSON)
-                    ->request().json();
-            directory = std::dynamic_pointer_cast<OneDriveDirectory>(parse_drive_item(response_json, "folder"));
+                    ->query_param("$select", DRIVE_ITEM_SELECT)
+                    ->request().json_records("", DRIVE_ITEM_FIELDS);
+            directory = std::dynamic_pointer_cast<OneDriveDirectory>(parse_drive_item(response.record(), "folder"));
         } catch (...) {
             OneDriveExceptionTranslator::translate(resource_path);
         }
@@ -49,6 +110,24 @@ std::shared_ptr<Directory> OneDriveDirectory::get_directory(const std::filesyste
     return directory;
 }
 
+bool OneDriveDirectory::poll_change() {
+    bool has_changed = false;
+    try {
+        const auto token = m_credentials->get_current_access_token();
+        const auto response_json = m_request->GET(api_resource_path(m_path.generic_string(), false))
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->query_param("$select", "eTag")
+                ->request().json();
+        const std::string new_revision = response_json.at("eTag");
+        has_changed = new_revision != m_revision;
+        m_revision = new_revision;
+    } catch (...) {
+        OneDriveExceptionTranslator::translate(m_path);
+    }
+    return has_changed;
+}
+
 void OneDriveDirectory::remove() {
     if (m_path.generic_string() == "/") {
         throw exceptions::resource::PermissionDenied(m_path);
@@ -58,12 +137,23 @@ void OneDriveDirectory::remove() {
             const auto response = m_request->DELETE(m_base_url + ":" + m_path.generic_string())
                     ->token_auth(token)
                     ->request();
+            m_known_directories->remove(m_path);
         } catch (...) {
             OneDriveExceptionTranslator::translate(m_path);
         }
     }
 }
 
+std::shared_ptr<Resource> OneDriveDirectory::copy_to(const std::filesystem::path &path) const {
+    return this->copy_item(m_path, destination_path(path));
+}
+
+std::shared_ptr<Resource> OneDriveDirectory::move_to(const std::filesystem::path &path) {
+    const auto moved = this->move_item(m_path, destination_path(path));
+    m_known_directories->remove(m_path);
+    return moved;
+}
+
 std::shared_ptr<Directory> OneDriveDirectory::create_directory(const std::filesystem::path &path) const {
     std::shared_ptr<OneDriveDirectory> new_directory;
     const auto resource_path = append_path(path);
@@ -71,7 +161,7 @@ std::shared_ptr<Directory> OneDriveDirectory::create_directory(const std::filesy
         const std::string new_resource_base_path = resource_path.parent_path().generic_string();
         const std::string new_directory_name = resource_path.filename().generic_string();
         const auto token = m_credentials->get_current_access_token();
-        const auto response_json = m_request->POST(this->api_resource_path(new_resource_base_path, true))
+        const auto response = m_request->POST(this->api_resource_path(new_resource_base_path, true))
                 ->token_auth(token)
                 ->accept(Request::MIMETYPE_JSON)
                 ->json_body({
@@ -79,27 +169,82 @@ std::shared_ptr<Directory> OneDriveDirectory::create_directory(const std::filesy
                         {"folder", json::object()},
                         {"@microsoft.graph.conflictBehavior", "fail"}
                 })
-                ->request().json();
-        new_directory = std::dynamic_pointer_cast<OneDriveDirectory>(this->parse_drive_item(response_json, "folder"));
+                ->request().json_records("", DRIVE_ITEM_FIELDS);
+        new_directory = std::dynamic_pointer_cast<OneDriveDirectory>(this->parse_drive_item(response.record(), "folder"));
+        m_known_directories->add(resource_path);
     } catch (...) {
         OneDriveExceptionTranslator::translate(resource_path);
     }
     return new_directory;
 }
 
+std::shared_ptr<Directory> OneDriveDirectory::ensure_directory(const std::filesystem::path &path) const {
+    const auto resource_path = append_path(path);
+    if (m_known_directories->contains(resource_path)) {
+        return std::make_shared<OneDriveDirectory>(
+                m_base_url,
+                resource_path.generic_string(),
+                m_credentials,
+                m_request,
+                resource_path.filename().generic_string(),
+                std::chrono::system_clock::time_point(),
+                m_known_directories);
+    }
+    std::shared_ptr<OneDriveDirectory> directory;
+    try {
+        // addressing a folder by its path creates it along with missing parents, an existing folder is returned
+        const auto token = m_credentials->get_current_access_token();
+        const auto response = m_request->PATCH(m_base_url + ":" + resource_path.generic_string())
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->query_param("$select", DRIVE_ITEM_SELECT)
+                ->json_body({{"folder", json::object()}})
+                ->request().json_records("", DRIVE_ITEM_FIELDS);
+        directory = std::dynamic_pointer_cast<OneDriveDirectory>(this->parse_drive_item(response.record(), "folder"));
+        m_known_directories->add(resource_path);
+    } catch (const exceptions::resource::NoSuchResource &) {
+        // the item at the path is a file
+        throw exceptions::resource::ResourceConflict(resource_path);
+    } catch (...) {
+        OneDriveExceptionTranslator::translate(resource_path);
+    }
+    return directory;
+}
+
 std::shared_ptr<File> OneDriveDirectory::create_file(const std::filesystem::path &path) const {
     std::shared_ptr<File> new_file;
     const auto resource_path = append_path(path);
     try {
         const auto token = m_credentials->get_current_access_token();
-        const auto response_json = m_request->PUT(m_base_url + ":" + resource_path.generic_string() + ":/content")
+        const auto response = m_request->PUT(m_base_url + ":" + resource_path.generic_string() + ":/content")
                 ->token_auth(token)
                 ->content_type(Request::MIMETYPE_BINARY)
                 ->accept(Request::MIMETYPE_JSON)
                 ->query_param("@microsoft.graph.conflictBehavior", "fail")
                 ->body("")
-                ->request().json();
-        new_file = std::dynamic_pointer_cast<OneDriveFile>(this->parse_drive_item(response_json, "file"));
+                ->request().json_records("", DRIVE_ITEM_FIELDS);
+        new_file = std::dynamic_pointer_cast<OneDriveFile>(this->parse_drive_item(response.record(), "file"));
+    } catch (...) {
+        OneDriveExceptionTranslator::translate(resource_path);
+    }
+    return new_file;
+}
+
+std::shared_ptr<File> OneDriveDirectory::create_file(
+        const std::filesystem::path &path, const std::vector<std::uint8_t> &content) const {
+    std::shared_ptr<File> new_file;
+    const auto resource_path = append_path(path);
+    try {
+        // graph creates missing parents of the item on its own
+        const auto token = m_credentials->get_current_access_token();
+        const auto response = m_request->PUT(m_base_url + ":" + resource_path.generic_string() + ":/content")
+                ->token_auth(token)
+                ->content_type(Request::MIMETYPE_BINARY)
+                ->accept(Request::MIMETYPE_JSON)
+                ->query_param("@microsoft.graph.conflictBehavior", "fail")
+                ->binary_body(content)
+                ->request().json_records("", DRIVE_ITEM_FIELDS);
+        new_file = std::dynamic_pointer_cast<OneDriveFile>(this->parse_drive_item(response.record(), "file"));
     } catch (...) {
         OneDriveExceptionTranslator::translate(resource_path);
     }
@@ -111,45 +256,380 @@ std::shared_ptr<File> OneDriveDirectory::get_file(const std::filesystem::path &p
     std::shared_ptr<File> file;
     try {
         const auto token = m_credentials->get_current_access_token();
-        const auto response_json = m_request->GET(m_base_url + ":" + resource_path.generic_string())
+        const auto response = m_request->GET(m_base_url + ":" + resource_path.generic_string())
                 ->token_auth(token)
                 ->accept(Request::MIMETYPE_JSON)
-                ->request().json();
-        file = std::dynamic_pointer_cast<OneDriveFile>(this->parse_drive_item(response_json, "file"));
+                ->query_param("$select", DRIVE_ITEM_SELECT)
+                ->request().json_records("", DRIVE_ITEM_FIELDS);
+        file = std::dynamic_pointer_cast<OneDriveFile>(this->parse_drive_item(response.record(), "file"));
     } catch (...) {
         OneDriveExceptionTranslator::translate(resource_path);
     }
     return file;
 }
 
+std::vector<BulkResult> OneDriveDirectory::remove_many(const std::vector<std::filesystem::path> &paths) const {
+    auto results = bulk_results<BulkResult>(paths);
+    std::vector<std::size_t> batch;
+    std::vector<json> requests;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const auto resource_path = append_path(results[i].path).generic_string();
+        if (resource_path == "/") {
+            results[i].error = std::make_exception_ptr(exceptions::resource::PermissionDenied(resource_path));
+        } else {
+            batch.push_back(i);
+            requests.push_back({{"method", "DELETE"}, {"url", batch_url(m_base_url + ":" + resource_path)}});
+        }
+    }
+    try {
+        const auto responses = this->send_batch(requests);
+        for (std::size_t i = 0; i < batch.size(); i++) {
+            auto &result = results[batch[i]];
+            try {
+                batch_response(responses[i]);
+                m_known_directories->remove(append_path(result.path));
+            } catch (...) {
+                result.error = translated_error([&result, this] {
+                    OneDriveExceptionTranslator::translate(append_path(result.path));
+                });
+            }
+        }
+    } catch (...) {
+        const auto error = translated_error([this] { OneDriveExceptionTranslator::translate(m_path); });
+        for (const auto i: batch) {
+            results[i].error = error;
+        }
+    }
+    return results;
+}
+
+std::vector<BulkValue<std::shared_ptr<Directory>>> OneDriveDirectory::create_directories(
+        const std::vector<std::filesystem::path> &paths) const {
+    auto results = bulk_results<BulkValue<std::shared_ptr<Directory>>>(paths);
+    // A folder is created in its parent, so parents have to be created first. Missing intermediates that haven't
+    // been requested themselves are created along with the other folders of their depth.
+    struct Level {
+        std::set<fs::path> intermediates;
+        std::vector<std::size_t> requested;
+    };
+    std::map<std::ptrdiff_t, Level> levels;
+    const auto depth_of = [](const fs::path &path) {
+        return std::distance(path.begin(), path.end());
+    };
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const auto resource_path = append_path(results[i].path);
+        levels[depth_of(resource_path)].requested.push_back(i);
+        for (auto parent = resource_path.parent_path(); parent != m_path; parent = parent.parent_path()) {
+            const auto relative_parent = parent.lexically_relative(m_path);
+            if (relative_parent.empty() || *relative_parent.begin() == ".." || m_known_directories->contains(parent)) {
+                break;
+            }
+            levels[depth_of(parent)].intermediates.insert(parent);
+        }
+    }
+    for (const auto &result: results) {
+        const auto resource_path = append_path(result.path);
+        levels[depth_of(resource_path)].intermediates.erase(resource_path);
+    }
+    const auto create_request = [this](const fs::path &resource_path) -> json {
+        return {
+                {"method", "POST"},
+                {"url", batch_url(api_resource_path(resource_path.parent_path().generic_string(), true))},
+                {"headers", {{"Content-Type", Request::MIMETYPE_JSON}}},
+                {"body", {
+                        {"name", resource_path.filename().generic_string()},
+                        {"folder", json::object()},
+                        {"@microsoft.graph.conflictBehavior", "fail"}
+                }}
+        };
+    };
+    for (const auto &[depth, level]: levels) {
+        const std::vector<fs::path> intermediates(level.intermediates.begin(), level.intermediates.end());
+        std::vector<json> requests;
+        for (const auto &intermediate: intermediates) {
+            requests.push_back(create_request(intermediate));
+        }
+        for (const auto i: level.requested) {
+            requests.push_back(create_request(append_path(results[i].path)));
+        }
+        try {
+            const auto responses = this->send_batch(requests);
+            for (std::size_t j = 0; j < intermediates.size(); j++) {
+                // An intermediate that exists already fails with a conflict. If it can't be created for another
+                // reason, the folders inside of it fail on their own.
+                try {
+                    batch_response(responses[j]);
+                    m_known_directories->add(intermediates[j]);
+                } catch (...) {
+                }
+            }
+            for (std::size_t j = 0; j < level.requested.size(); j++) {
+                auto &result = results[level.requested[j]];
+                try {
+                    const auto item = batch_response(responses[intermediates.size() + j])
+                            .json_records("", DRIVE_ITEM_FIELDS);
+                    result.value = std::dynamic_pointer_cast<Directory>(parse_drive_item(item.record(), "folder"));
+                    m_known_directories->add(append_path(result.path));
+                } catch (...) {
+                    result.error = translated_error([&result, this] {
+                        OneDriveExceptionTranslator::translate(append_path(result.path));
+                    });
+                }
+            }
+        } catch (...) {
+            const auto error = translated_error([this] { OneDriveExceptionTranslator::translate(m_path); });
+            for (const auto i: level.requested) {
+                results[i].error = error;
+            }
+        }
+    }
+    return results;
+}
+
+std::vector<BulkValue<ResourceInfo>> OneDriveDirectory::stat_many(const std::vector<std::filesystem::path> &paths) const {
+    auto results = bulk_results<BulkValue<ResourceInfo>>(paths);
+    std::vector<json> requests;
+    for (const auto &result: results) {
+        requests.push_back({
+                {"method", "GET"},
+                {"url", batch_url(api_resource_path(append_path(result.path).generic_string(), false))
+                        + "?$select=" + DRIVE_ITEM_SELECT}});
+    }
+    try {
+        const auto responses = this->send_batch(requests);
+        for (std::size_t i = 0; i < results.size(); i++) {
+            auto &result = results[i];
+            try {
+                const auto item = batch_response(responses[i]).json_records("", DRIVE_ITEM_FIELDS);
+                result.value = parse_resource_info(item.record());
+            } catch (...) {
+                result.error = translated_error([&result, this] {
+                    OneDriveExceptionTranslator::translate(append_path(result.path));
+                });
+            }
+        }
+    } catch (...) {
+        const auto error = translated_error([this] { OneDriveExceptionTranslator::translate(m_path); });
+        for (auto &result: results) {
+            result.error = error;
+        }
+    }
+    return results;
+}
+
+std::vector<BulkValue<std::shared_ptr<File>>> OneDriveDirectory::upload_many(const std::vector<FileUpload> &files) const {
+    // json batches can't carry binary bodies, so the files are uploaded a few at a time
+    return upload_parallel(files, [this](const std::shared_ptr<Request> &request, const FileUpload &file) {
+        const auto resource_path = append_path(file.path);
+        std::shared_ptr<File> uploaded_file;
+        try {
+            const auto token = m_credentials->get_current_access_token();
+            const auto response = request->PUT(m_base_url + ":" + resource_path.generic_string() + ":/content")
+                    ->token_auth(token)
+                    ->content_type(Request::MIMETYPE_BINARY)
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->query_param("@microsoft.graph.conflictBehavior", "replace")
+                    ->binary_body(file.content)
+                    ->request().json_records("", DRIVE_ITEM_FIELDS);
+            uploaded_file = std::dynamic_pointer_cast<OneDriveFile>(this->parse_drive_item(response.record(), "file"));
+        } catch (...) {
+            OneDriveExceptionTranslator::translate(resource_path);
+        }
+        return uploaded_file;
+    });
+}
+
+std::shared_ptr<Directory> OneDriveDirectory::with_new_connection() const {
+    return std::make_shared<OneDriveDirectory>(
+            m_base_url, m_path.generic_string(), m_credentials, m_request->clone(), m_name, m_modified,
+            m_known_directories, m_revision);
+}
+
+void OneDriveDirectory::search(const SearchQuery &query, const SearchPageHandler &on_page) const {
+    // the text is passed as parameter alias, so it's encoded like any other query parameter. Quotes are doubled.
+    std::string text = "'";
+    for (const char c: query.name) {
+        text += c == '\'' ? "''" : std::string(1, c);
+    }
+    text += "'";
+    const auto path_string = m_path.generic_string();
+    try {
+        auto response = m_request->GET(
+                        (path_string == "/" ? m_base_url : m_base_url + ":" + path_string + ":") + "/search(q=@q)")
+                ->token_auth(m_credentials->get_current_access_token())
+                ->accept(Request::MIMETYPE_JSON)
+                ->query_param("@q", text)
+                ->query_param("$top", MAX_PAGE_SIZE)
+                ->query_param("$select", SEARCH_ITEM_SELECT)
+                ->request().json_records("value", SEARCH_ITEM_FIELDS, PAGE_FIELDS);
+        std::map<std::string, std::optional<fs::path>> folder_paths;
+        while (true) {
+            this->resolve_parent_paths(response.records, folder_paths);
+            std::vector<SearchResult> results;
+            for (const auto &item: response.records) {
+                if (item.contains("root") || item.contains("remoteItem")) {
+                    // items that have been shared from another drive have no path in this one
+                    continue;
+                }
+                std::optional<fs::path> parent_path;
+                if (item.contains("parentReference/path")) {
+                    parent_path = parent_reference_path(item);
+                } else if (const auto folder = folder_paths.find(item.value("parentReference/id"));
+                        folder != folder_paths.end()) {
+                    parent_path = folder->second;
+                }
+                if (parent_path) {
+                    results.push_back({*parent_path / item.at("name"), parse_resource_info(item)});
+                }
+            }
+            // the next link already carries $top, $select & the skip token
+            const auto next_link = response.page.value("@odata.nextLink");
+            if (!this->deliver_search_page(query, std::move(results), on_page) || next_link.empty()) {
+                break;
+            }
+            response = m_request->GET(next_link)
+                    ->token_auth(m_credentials->get_current_access_token())
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->request().json_records("value", SEARCH_ITEM_FIELDS, PAGE_FIELDS);
+        }
+    } catch (...) {
+        OneDriveExceptionTranslator::translate(m_path);
+    }
+}
+
+std::shared_ptr<Resource> OneDriveDirectory::copy_item(const fs::path &source, const fs::path &destination) const {
+    std::shared_ptr<Resource> copy;
+    try {
+        const auto body = this->item_reference(source, destination);
+        const auto response = m_request->POST(m_base_url + ":" + source.generic_string() + ":/copy")
+                ->token_auth(m_credentials->get_current_access_token())
+                ->query_param("@microsoft.graph.conflictBehavior", "fail")
+                ->json_body(body)
+                ->request();
+        this->await_copy(response.headers.at("location"));
+        const auto item = m_request->GET(m_base_url + ":" + destination.generic_string())
+                ->token_auth(m_credentials->get_current_access_token())
+                ->accept(Request::MIMETYPE_JSON)
+                ->query_param("$select", DRIVE_ITEM_SELECT)
+                ->request().json_records("", DRIVE_ITEM_FIELDS);
+        copy = this->parse_drive_item(item.record());
+    } catch (const request::exceptions::response::Conflict &e) {
+        throw exceptions::resource::ResourceConflict(destination);
+    } catch (...) {
+        OneDriveExceptionTranslator::translate(source);
+    }
+    return copy;
+}
+
+std::shared_ptr<Resource> OneDriveDirectory::move_item(const fs::path &source, const fs::path &destination) const {
+    std::shared_ptr<Resource> moved;
+    try {
+        const auto body = this->item_reference(source, destination);
+        const auto item = m_request->PATCH(m_base_url + ":" + source.generic_string())
+                ->token_auth(m_credentials->get_current_access_token())
+                ->accept(Request::MIMETYPE_JSON)
+                ->query_param("@microsoft.graph.conflictBehavior", "fail")
+                ->query_param("$select", DRIVE_ITEM_SELECT)
+                ->json_body(body)
+                ->request().json_records("", DRIVE_ITEM_FIELDS);
+        moved = this->parse_drive_item(item.record());
+    } catch (const request::exceptions::response::Conflict &e) {
+        throw exceptions::resource::ResourceConflict(destination);
+    } catch (...) {
+        OneDriveExceptionTranslator::translate(source);
+    }
+    return moved;
+}
+
+json OneDriveDirectory::item_reference(const fs::path &source, const fs::path &destination) const {
+    json body = {{"name", destination.filename().generic_string()}};
+    if (source.parent_path() != destination.parent_path()) {
+        // The parent is referenced by its id. A path reference would depend on how the drive is addressed.
+        const auto parent_path = destination.parent_path();
+        try {
+            const auto parent = m_request->GET(api_resource_path(parent_path.generic_string(), false))
+                    ->token_auth(m_credentials->get_current_access_token())
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->query_param("$select", "id")
+                    ->request().json();
+            body["parentReference"] = {{"id", parent.at("id")}};
+        } catch (...) {
+            OneDriveExceptionTranslator::translate(parent_path);
+        }
+    }
+    return body;
+}
+
+void OneDriveDirectory::await_copy(const std::string &monitor_url) const {
+    // Some drives redirect to the new item once the copy is done. Following it would request the item without
+    // a token, so the redirect itself is taken as the completion.
+    const auto request = m_request->clone();
+    request->set_follow_redirects(false);
+    const auto deadline = std::chrono::steady_clock::now() + COPY_TIMEOUT;
+    auto delay = COPY_POLL_INTERVAL;
+    while (true) {
+        // the monitor url is pre-authenticated
+        const auto response = request->GET(monitor_url)
+                ->accept(Request::MIMETYPE_JSON)
+                ->request();
+        if (response.code >= 300 && response.code < 400) {
+            return;
+        }
+        const auto status = response.json();
+        const std::string state = status.at("status");
+        if (state == "completed") {
+            return;
+        } else if (state == "failed") {
+            throw exceptions::cloud::CommunicationError("copy has failed: " + status.dump());
+        }
+        if (std::chrono::steady_clock::now() + delay > deadline) {
+            // a monitor that never leaves `notStarted` or `inProgress` would keep the caller waiting forever
+            throw exceptions::cloud::CommunicationError(
+                    "copy hasn't finished in time, it may still appear later: " + status.dump());
+        }
+        std::this_thread::sleep_for(delay);
+        delay = std::min(delay * 2, MAX_COPY_POLL_INTERVAL);
+    }
+}
+
 std::shared_ptr<Resource>
-OneDriveDirectory::parse_drive_item(const json &value, const std::string &expectedType) const {
+OneDriveDirectory::parse_drive_item(const request::JsonRecord &value, const std::string &expectedType) const {
     std::shared_ptr<Resource> resource;
-    const std::string name = value.at("name");
+    const std::string &name = value.at("name");
     // check if the returned item is the root item
-    if (value.find("root") != value.end()) {
-        resource = std::make_shared<OneDriveDirectory>(m_base_url, "/", m_credentials, m_request, "");
+    if (value.contains("root")) {
+        resource = std::make_shared<OneDriveDirectory>(
+                m_base_url, "/", m_credentials, m_request, "", std::chrono::system_clock::time_point(),
+                m_known_directories, value.value("eTag"));
     } else {
-        const std::string raw_resource_path = value.at("parentReference").at("path");
-        const auto splitPosition = raw_resource_path.find_first_of(':') + 1;
-        const std::string resource_path =
-                raw_resource_path.substr(splitPosition, raw_resource_path.size() - splitPosition) + "/" + name;
-        if (value.find("file") != value.end() && (expectedType.empty() || expectedType == "file")) {
-            const std::string etag = value["eTag"];
+        const std::string resource_path = (parent_reference_path(value) / name).generic_string();
+        const auto modified = util::parse_iso8601(value.value("lastModifiedDateTime"))
+                .value_or(std::chrono::system_clock::time_point());
+        if (value.contains("file") && (expectedType.empty() || expectedType == "file")) {
+            const std::string &etag = value.at("eTag");
             resource = std::make_shared<OneDriveFile>(
                     m_base_url,
                     resource_path,
                     m_credentials,
                     m_request,
                     name,
-                    etag);
-        } else if (value.find("folder") != value.end() && (expectedType.empty() || expectedType == "folder")) {
+                    etag,
+                    std::strtoull(value.value("size", "0").c_str(), nullptr, 10),
+                    modified,
+                    value.value("file/mimeType"),
+                    OneDriveFile::parse_content_hash(
+                            value.value("file/hashes/quickXorHash"), value.value("file/hashes/sha256Hash")),
+                    value.value("@microsoft.graph.downloadUrl"));
+        } else if (value.contains("folder") && (expectedType.empty() || expectedType == "folder")) {
             resource = std::make_shared<OneDriveDirectory>(
                     m_base_url,
                     resource_path,
                     m_credentials,
                     m_request,
-                    name);
+                    name,
+                    modified,
+                    m_known_directories,
+                    value.value("eTag"));
         } else {
             throw exceptions::resource::NoSuchResource(resource_path);
         }
@@ -157,6 +637,90 @@ OneDriveDirectory::parse_drive_item(const json &value, const std::string &expect
     return resource;
 }
 
+ResourceInfo OneDriveDirectory::parse_resource_info(const request::JsonRecord &value) {
+    ResourceInfo info;
+    info.name = value.at("name");
+    info.id = value.value("id");
+    info.revision = value.value("eTag");
+    if (value.contains("file")) {
+        info.kind = ResourceInfo::Kind::FILE;
+        info.size = std::strtoull(value.value("size", "0").c_str(), nullptr, 10);
+        info.content_type = value.value("file/mimeType");
+        info.content_hash = OneDriveFile::parse_content_hash(
+                value.value("file/hashes/quickXorHash"), value.value("file/hashes/sha256Hash"));
+    } else if (value.contains("folder")) {
+        info.kind = ResourceInfo::Kind::DIRECTORY;
+    } else {
+        throw exceptions::resource::NoSuchResource(info.name);
+    }
+    if (const auto modified = util::parse_iso8601(value.value("lastModifiedDateTime"))) {
+        info.modified = *modified;
+    }
+    return info;
+}
+
+std::filesystem::path OneDriveDirectory::parent_reference_path(const request::JsonRecord &value) {
+    // `/drive/root:/some/folder`, or just `/drive/root:` for the children of the root
+    const std::string &raw_path = value.at("parentReference/path");
+    const auto path = raw_path.substr(raw_path.find_first_of(':') + 1);
+    return path.empty() ? "/" : path;
+}
+
+void OneDriveDirectory::resolve_parent_paths(
+        const std::vector<request::JsonRecord> &items,
+        std::map<std::string, std::optional<std::filesystem::path>> &folder_paths) const {
+    std::vector<std::string> ids;
+    std::vector<json> requests;
+    for (const auto &item: items) {
+        const auto id = item.value("parentReference/id");
+        if (item.contains("parentReference/path") || item.contains("remoteItem") || id.empty() || folder_paths.count(id) != 0
+            || std::find(ids.begin(), ids.end(), id) != ids.end()) {
+            continue;
+        }
+        ids.push_back(id);
+        requests.push_back({
+                {"method", "GET"},
+                {"url", batch_url(GRAPH_SERVICE_ROOT + "/drives/" + item.value("parentReference/driveId")
+                                  + "/items/" + id + "?$select=id,name,root,parentReference")}});
+    }
+    const auto responses = this->send_batch(requests);
+    for (std::size_t i = 0; i < ids.size(); i++) {
+        std::optional<fs::path> path;
+        try {
+            const auto folder = batch_response(responses[i]).json_records("", DRIVE_ITEM_FIELDS);
+            if (folder.record().contains("root")) {
+                path = "/";
+            } else if (folder.record().contains("parentReference/path")) {
+                path = parent_reference_path(folder.record()) / folder.record().at("name");
+            }
+        } catch (const request::exceptions::response::NotFound &) {
+            // the folder has been removed since the search has found its content
+        }
+        folder_paths[ids[i]] = path;
+    }
+}
+
+std::vector<request::JsonRecord> OneDriveDirectory::list_children() const {
+    auto response = m_request->GET(this->api_resource_path(m_path.generic_string(), true))
+            ->token_auth(m_credentials->get_current_access_token())
+            ->accept(Request::MIMETYPE_JSON)
+            ->query_param("$top", MAX_PAGE_SIZE)
+            ->query_param("$select", DRIVE_ITEM_SELECT)
+            ->request().json_records("value", DRIVE_ITEM_FIELDS, PAGE_FIELDS);
+    std::vector<request::JsonRecord> children = std::move(response.records);
+    // the next link already carries $top, $select & the skip token
+    auto next_link = response.page.value("@odata.nextLink");
+    while (!next_link.empty()) {
+        auto next_page = m_request->GET(next_link)
+                ->token_auth(m_credentials->get_current_access_token())
+                ->accept(Request::MIMETYPE_JSON)
+                ->request().json_records("value", DRIVE_ITEM_FIELDS, PAGE_FIELDS);
+        std::move(next_page.records.begin(), next_page.records.end(), std::back_inserter(children));
+        next_link = next_page.page.value("@odata.nextLink");
+    }
+    return children;
+}
+
 std::string OneDriveDirectory::api_resource_path(const std::string &path, bool children) const {
     std::string out = m_base_url;
     if (path == "/") {
@@ -170,4 +734,52 @@ std::string OneDriveDirectory::api_resource_path(const std::string &path, bool c
         }
     }
     return out;
-}
\ No newline at end of file
+}
+
+std::vector<json> OneDriveDirectory::send_batch(const std::vector<json> &requests) const {
+    std::vector<json> responses(requests.size());
+    for (std::size_t offset = 0; offset < requests.size(); offset += MAX_BATCH_REQUESTS) {
+        const auto end = std::min(requests.size(), offset + MAX_BATCH_REQUESTS);
+        json batch = json::array();
+        for (auto i = offset; i < end; i++) {
+            auto batch_request = requests[i];
+            batch_request["id"] = std::to_string(i);
+            batch.push_back(std::move(batch_request));
+        }
+        const auto token = m_credentials->get_current_access_token();
+        const auto response_json = m_request->POST(GRAPH_SERVICE_ROOT + "/$batch")
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->json_body({{"requests", batch}})
+                ->request().json();
+        // responses may come in any order
+        for (const auto &response: response_json.at("responses")) {
+            const auto index = std::strtoull(response.at("id").get<std::string>().c_str(), nullptr, 10);
+            if (index < offset || index >= end) {
+                throw exceptions::cloud::InvalidResponse("unexpected batch response id");
+            }
+            responses[index] = response;
+        }
+        for (auto i = offset; i < end; i++) {
+            if (responses[i].is_null()) {
+                throw exceptions::cloud::InvalidResponse("missing batch response");
+            }
+        }
+    }
+    return responses;
+}
+
+std::string OneDriveDirectory::batch_url(const std::string &url) {
+    if (url.compare(0, GRAPH_SERVICE_ROOT.size(), GRAPH_SERVICE_ROOT) == 0) {
+        return url.substr(GRAPH_SERVICE_ROOT.size());
+    }
+    return url;
+}
+
+request::StringResponse OneDriveDirectory::batch_response(const json &response) {
+    const auto body = response.find("body");
+    return request::StringResponse(
+            response.at("status").get<long>(),
+            body != response.end() ? body->dump() : "",
+            Request::MIMETYPE_JSON);
+}
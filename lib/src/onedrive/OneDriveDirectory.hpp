@@ -1,7 +1,11 @@
 #pragma once
 
 #include "OAuthDirectoryImpl.hpp"
+#include "request/JsonRecordReader.hpp"
+#include "util/KnownDirectories.hpp"
 #include <nlohmann/json.hpp>
+#include <map>
+#include <optional>
 
 using json = nlohmann::json;
 
@@ -12,24 +16,134 @@ namespace CloudSync::onedrive {
                 const std::string &baseUrl, const std::string &dir,
                 const std::shared_ptr<credentials::OAuth2CredentialsImpl>& credentials,
                 const std::shared_ptr<request::Request> &request,
-                const std::string &name)
-                : OAuthDirectoryImpl(baseUrl, dir, credentials, request, name) {};
+                const std::string &name,
+                std::chrono::system_clock::time_point modified = {},
+                std::shared_ptr<util::KnownDirectories> knownDirectories = nullptr,
+                std::string revision = "")
+                : OAuthDirectoryImpl(baseUrl, dir, credentials, request, name, modified, std::move(revision))
+                , m_known_directories(knownDirectories ? std::move(knownDirectories) : std::make_shared<util::KnownDirectories>()) {};
 
         [[nodiscard]] std::vector<std::shared_ptr<Resource>> list_resources() const override;
 
+        [[nodiscard]] std::vector<ResourceInfo> list_resource_info() const override;
+
+        [[nodiscard]] std::shared_ptr<Resource> get_resource(const ResourceInfo &info) const override;
+
         [[nodiscard]] std::shared_ptr<Directory> get_directory(const std::filesystem::path &path) const override;
 
+        bool poll_change() override;
+
         void remove() override;
 
+        std::shared_ptr<Resource> copy_to(const std::filesystem::path &path) const override;
+
+        std::shared_ptr<Resource> move_to(const std::filesystem::path &path) override;
+
         std::shared_ptr<Directory> create_directory(const std::filesystem::path &path) const override;
 
         std::shared_ptr<File> create_file(const std::filesystem::path &path) const override;
 
+        std::shared_ptr<File> create_file(
+                const std::filesystem::path &path, const std::vector<std::uint8_t> &content) const override;
+
         std::shared_ptr<File> get_file(const std::filesystem::path &path) const override;
 
+        std::shared_ptr<Directory> ensure_directory(const std::filesystem::path &path) const override;
+
+        std::vector<BulkResult> remove_many(const std::vector<std::filesystem::path> &paths) const override;
+
+        std::vector<BulkValue<std::shared_ptr<Directory>>> create_directories(
+                const std::vector<std::filesystem::path> &paths) const override;
+
+        [[nodiscard]] std::vector<BulkValue<ResourceInfo>> stat_many(
+                const std::vector<std::filesystem::path> &paths) const override;
+
+        std::vector<BulkValue<std::shared_ptr<File>>> upload_many(const std::vector<FileUpload> &files) const override;
+
+        void search(const SearchQuery &query, const SearchPageHandler &on_page) const override;
+
+        [[nodiscard]] std::shared_ptr<Directory> with_new_connection() const override;
+
+        /**
+         * Copies the file or folder at `source` to `destination` and waits for graph to finish the copy.
+         * Used for the `copy_to()` of files & directories of this drive. Both paths are absolute.
+         * @return a handle for the copy
+         */
+        std::shared_ptr<Resource> copy_item(const std::filesystem::path &source, const std::filesystem::path &destination) const;
+
+        /**
+         * Moves or renames the file or folder at `source`. Used for the `move_to()` of files & directories of this
+         * drive. Both paths are absolute.
+         * @return a handle for the resource at `destination`
+         */
+        std::shared_ptr<Resource> move_item(const std::filesystem::path &source, const std::filesystem::path &destination) const;
+
     private:
-        std::shared_ptr<Resource> parse_drive_item(const json &value, const std::string &expectedType = "") const;
+        /// directories of this cloud that are known to exist, shared by all of its directory handles
+        const std::shared_ptr<util::KnownDirectories> m_known_directories;
+
+        /// fields of a driveItem that are needed to describe a resource
+        static const std::vector<std::string> DRIVE_ITEM_FIELDS;
+        /// `$select` query parameter that limits driveItems to DRIVE_ITEM_FIELDS
+        static const std::string DRIVE_ITEM_SELECT;
+        /// DRIVE_ITEM_FIELDS & what is needed to find the path of a search result
+        static const std::vector<std::string> SEARCH_ITEM_FIELDS;
+        /// `$select` query parameter that limits search results to SEARCH_ITEM_FIELDS
+        static const std::string SEARCH_ITEM_SELECT;
+        /// fields of a children page besides the driveItems
+        static const std::vector<std::string> PAGE_FIELDS;
+        /// `$top` query parameter: the most children graph returns per page
+        static const std::string MAX_PAGE_SIZE;
+        /// every graph url starts with this, `$batch` requests are relative to it
+        static const std::string GRAPH_SERVICE_ROOT;
+        /// most requests `$batch` accepts per call
+        static const std::size_t MAX_BATCH_REQUESTS;
+        /// first delay before the monitor of a copy is checked again. Doubles with every check.
+        static const std::chrono::milliseconds COPY_POLL_INTERVAL;
+        static const std::chrono::milliseconds MAX_COPY_POLL_INTERVAL;
+        /// how long the monitor of a copy is checked before the copy is given up on
+        static const std::chrono::minutes COPY_TIMEOUT;
+
+        std::shared_ptr<Resource> parse_drive_item(const request::JsonRecord &value, const std::string &expectedType = "") const;
+
+        static ResourceInfo parse_resource_info(const request::JsonRecord &value);
+
+        /// @return the driveItems of all children of this directory, following `@odata.nextLink` across all pages
+        [[nodiscard]] std::vector<request::JsonRecord> list_children() const;
+
+        /// @return the path of the folder a driveItem is in, which is reported as `parentReference/path`
+        static std::filesystem::path parent_reference_path(const request::JsonRecord &value);
+
+        /**
+         * Search results don't always come with the path of their folder. The folders of `items` that are missing
+         * it & aren't part of `folder_paths` yet are looked up with a single batch and added to `folder_paths`.
+         */
+        void resolve_parent_paths(
+                const std::vector<request::JsonRecord> &items,
+                std::map<std::string, std::optional<std::filesystem::path>> &folder_paths) const;
 
         std::string api_resource_path(const std::string &path, bool children = true) const;
+
+        /**
+         * @return the body of a copy or move request that places an item at `destination`. The new parent is only
+         *         referenced if it differs from the parent of `source`, a rename needs just the name.
+         */
+        [[nodiscard]] json item_reference(const std::filesystem::path &source, const std::filesystem::path &destination) const;
+
+        /// polls the monitor of an asynchronous copy until the copy has completed
+        void await_copy(const std::string &monitor_url) const;
+
+        /**
+         * Sends `requests` to the `$batch` endpoint, MAX_BATCH_REQUESTS at a time.
+         * @param requests batch request objects without an `id`. The `url` must be relative to GRAPH_SERVICE_ROOT.
+         * @return one response object (`status`, `body`) per request, in the order of `requests`.
+         */
+        [[nodiscard]] std::vector<json> send_batch(const std::vector<json> &requests) const;
+
+        /// @return `url` relative to GRAPH_SERVICE_ROOT
+        static std::string batch_url(const std::string &url);
+
+        /// @throws the exception the single request would have thrown, if `response` is an error response.
+        static request::StringResponse batch_response(const json &response);
     };
 } // namespace CloudSync::onedrive
@@ -35,10 +35,16 @@ namespace CloudSync::onedrive {
                 } catch (const nlohmann::json::exception& e) {
                     throw exceptions::cloud::InvalidResponse(e.what());
                 }
+            } catch (request::exceptions::response::TooManyRequests &e) {
+                throw exceptions::cloud::Throttled(e.what(), e.retry_after);
+            } catch (request::exceptions::response::ServiceUnavailable &e) {
+                throw exceptions::cloud::Throttled(e.what(), e.retry_after);
             } catch (request::exceptions::response::ResponseException &e) {
                 throw exceptions::cloud::CommunicationError(e.what());
             } catch (nlohmann::json::exception &e) {
                 throw exceptions::cloud::InvalidResponse(e.what());
+            } catch (request::exceptions::ParseError &e) {
+                throw exceptions::cloud::InvalidResponse(e.what());
             } catch (request::exceptions::RequestException &e) {
                 throw exceptions::cloud::CommunicationError(e.what());
             }
@@ -1,13 +1,25 @@
 #include "OneDriveFile.hpp"
+#include "OneDriveDirectory.hpp"
 #include "request/Request.hpp"
 #include "OneDriveExceptionTranslator.hpp"
+#include "OneDriveUploadSession.hpp"
+#include "util/DateTime.hpp"
+#include "util/EndpointConcurrency.hpp"
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
 
 using json = nlohmann::json;
 using namespace CloudSync;
 using namespace CloudSync::request;
 using namespace CloudSync::onedrive;
 
+const std::string OneDriveFile::METADATA_SELECT =
+        "eTag,size,lastModifiedDateTime,file,@microsoft.graph.downloadUrl";
+
+// graph only promises that download urls stay valid for a few minutes
+const std::chrono::steady_clock::duration OneDriveFile::DOWNLOAD_URL_LIFETIME = std::chrono::minutes(5);
+
 void OneDriveFile::remove() {
     try {
         const auto token = m_credentials->get_current_access_token();
@@ -19,16 +31,26 @@ void OneDriveFile::remove() {
     }
 }
 
+std::shared_ptr<Resource> OneDriveFile::copy_to(const std::filesystem::path &path) const {
+    // copies & moves work the same for files and folders, the drive root knows how
+    return OneDriveDirectory(m_base_url, "/", m_credentials, m_request, "").copy_item(m_path, destination_path(path));
+}
+
+std::shared_ptr<Resource> OneDriveFile::move_to(const std::filesystem::path &path) {
+    return OneDriveDirectory(m_base_url, "/", m_credentials, m_request, "").move_item(m_path, destination_path(path));
+}
+
 bool OneDriveFile::poll_change() {
     bool has_changed = false;
     try {
         const auto token = m_credentials->get_current_access_token();
         const auto response_json = m_request->GET(m_resource_path)
                 ->token_auth(token)
+                ->query_param("$select", METADATA_SELECT)
                 ->request().json();
         const std::string new_revision = response_json.at("eTag");
         has_changed = !(new_revision == m_revision);
-        m_revision = new_revision;
+        update_metadata(response_json);
     } catch (...) {
         OneDriveExceptionTranslator::translate(m_path);
     }
@@ -38,6 +60,14 @@ bool OneDriveFile::poll_change() {
 std::string OneDriveFile::read() const {
     std::string data;
     try {
+        if (const auto download_request = prepare_download_request()) {
+            try {
+                return download_request->request().data;
+            } catch (const request::exceptions::response::ClientError &) {
+                // the url has expired before its time, the content endpoint redirects to a fresh one
+                m_download_url.clear();
+            }
+        }
         data = prepare_read_request()->request().data;
     } catch (...) {
         OneDriveExceptionTranslator::translate(m_path);
@@ -48,6 +78,13 @@ std::string OneDriveFile::read() const {
 std::vector<std::uint8_t> OneDriveFile::read_binary() const {
     std::vector<std::uint8_t> data;
     try {
+        if (const auto download_request = prepare_download_request()) {
+            try {
+                return download_request->request_binary().data;
+            } catch (const request::exceptions::response::ClientError &) {
+                m_download_url.clear();
+            }
+        }
         data = prepare_read_request()->request_binary().data;
     } catch (...) {
         OneDriveExceptionTranslator::translate(m_path);
@@ -55,6 +92,19 @@ std::vector<std::uint8_t> OneDriveFile::read_binary() const {
     return data;
 }
 
+void OneDriveFile::set_download_url(const std::string &download_url) {
+    m_download_url = download_url;
+    m_download_url_expires = std::chrono::steady_clock::now() + DOWNLOAD_URL_LIFETIME;
+}
+
+std::shared_ptr<request::Request> OneDriveFile::prepare_download_request() const {
+    if (m_download_url.empty() || std::chrono::steady_clock::now() >= m_download_url_expires) {
+        return nullptr;
+    }
+    // the url carries its own authorization
+    return m_request->GET(m_download_url);
+}
+
 std::shared_ptr<request::Request> OneDriveFile::prepare_read_request() const {
     const auto token = m_credentials->get_current_access_token();
     return m_request->GET(m_resource_path + ":/content")->token_auth(token);
@@ -62,8 +112,7 @@ std::shared_ptr<request::Request> OneDriveFile::prepare_read_request() const {
 
 void OneDriveFile::write(const std::string& content) {
     try {
-        const json response_json = prepare_write_request()->body(content)->request().json();
-        m_revision = response_json.at("eTag");
+        update_metadata(prepare_write_request()->body(content)->request().json());
     } catch (...) {
         OneDriveExceptionTranslator::translate(m_path);
     }
@@ -71,8 +120,7 @@ void OneDriveFile::write(const std::string& content) {
 
 void OneDriveFile::write_binary(const std::vector<std::uint8_t> &content) {
     try {
-        const auto response_json = prepare_write_request()->binary_body(content)->request().json();
-        m_revision = response_json.at("eTag");
+        update_metadata(prepare_write_request()->binary_body(content)->request().json());
     } catch (...) {
         OneDriveExceptionTranslator::translate(m_path);
     }
@@ -85,3 +133,44 @@ std::shared_ptr<request::Request> OneDriveFile::prepare_write_request() const {
             ->content_type(Request::MIMETYPE_BINARY)
             ->if_match(revision());
 }
+
+void OneDriveFile::upload_chunked(const upload::UploadSource &source) {
+    try {
+        OneDriveUploadSession session(m_resource_path, this->revision(), m_credentials, m_request);
+        // the chunks go to a host that the session is given by the server, which is counted as part of the api
+        upload::ChunkedUpload(m_request, session, source, util::endpoint_controller(m_base_url)).run();
+        update_metadata(session.drive_item());
+    } catch (...) {
+        OneDriveExceptionTranslator::translate(m_path);
+    }
+}
+
+std::optional<ContentHash> OneDriveFile::parse_content_hash(
+        const std::string &quick_xor_hash, std::string sha256_hash) {
+    if (!quick_xor_hash.empty()) {
+        return ContentHash{ContentHash::Algorithm::QUICK_XOR, quick_xor_hash};
+    }
+    if (!sha256_hash.empty()) {
+        // graph reports the SHA-256 in uppercase hex
+        std::transform(sha256_hash.begin(), sha256_hash.end(), sha256_hash.begin(), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+        return ContentHash{ContentHash::Algorithm::SHA256, sha256_hash};
+    }
+    return std::nullopt;
+}
+
+void OneDriveFile::update_metadata(const json &drive_item) {
+    m_revision = drive_item.at("eTag");
+    m_size = drive_item.value("size", std::uint64_t(0));
+    if (const auto modified = util::parse_iso8601(drive_item.value("lastModifiedDateTime", ""))) {
+        m_modified = *modified;
+    }
+    set_download_url(drive_item.value("@microsoft.graph.downloadUrl", ""));
+    const auto file = drive_item.find("file");
+    if (file != drive_item.end()) {
+        m_content_type = file->value("mimeType", "");
+        const auto hashes = file->value("hashes", json::object());
+        m_content_hash = parse_content_hash(hashes.value("quickXorHash", ""), hashes.value("sha256Hash", ""));
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "OAuthFileImpl.hpp"
+#include <nlohmann/json.hpp>
 
 namespace CloudSync::onedrive {
     class OneDriveFile : public OAuthFileImpl {
@@ -11,12 +12,24 @@ namespace CloudSync::onedrive {
                 const std::shared_ptr<credentials::OAuth2CredentialsImpl>& credentials,
                 const std::shared_ptr<request::Request> &request,
                 const std::string &name,
-                const std::string &revision)
-                : OAuthFileImpl(baseUrl, dir, credentials, request, name, revision)
-                , m_resource_path(m_base_url + ":" + m_path.generic_string()){};
+                const std::string &revision,
+                std::uint64_t size = 0,
+                std::chrono::system_clock::time_point modified = {},
+                const std::string &content_type = "",
+                std::optional<ContentHash> content_hash = std::nullopt,
+                const std::string &download_url = "")
+                : OAuthFileImpl(baseUrl, dir, credentials, request, name, revision, size, modified, content_type,
+                                std::move(content_hash))
+                , m_resource_path(m_base_url + ":" + m_path.generic_string()) {
+            set_download_url(download_url);
+        };
 
         void remove() override;
 
+        std::shared_ptr<Resource> copy_to(const std::filesystem::path &path) const override;
+
+        std::shared_ptr<Resource> move_to(const std::filesystem::path &path) override;
+
         bool poll_change() override;
 
         [[nodiscard]] std::string read() const override;
@@ -24,10 +37,38 @@ namespace CloudSync::onedrive {
 
         void write(const std::string& content) override;
         void write_binary(const std::vector<std::uint8_t> & content) override;
+
+        /**
+         * @return the hash from the `file/hashes` facet of a driveItem. The QuickXorHash is reported for all drives,
+         *         the SHA-256 for some business drives only. `std::nullopt` if neither is set.
+         */
+        static std::optional<ContentHash> parse_content_hash(const std::string &quick_xor_hash, std::string sha256_hash);
+
+        /// how long a `@microsoft.graph.downloadUrl` is used after it has been received
+        static const std::chrono::steady_clock::duration DOWNLOAD_URL_LIFETIME;
+    protected:
+        void upload_chunked(const upload::UploadSource &source) override;
+
     private:
         const std::string m_resource_path;
+        /**
+         * Pre-authenticated url of the content, as reported with the driveItem. Reading from it saves the redirect
+         * that `:/content` answers with. Empty if there is none or it has expired.
+         */
+        mutable std::string m_download_url;
+        mutable std::chrono::steady_clock::time_point m_download_url_expires;
+
+        /// `$select` query parameter for everything update_metadata() reads
+        static const std::string METADATA_SELECT;
 
+        void set_download_url(const std::string &download_url);
+
+        /// @return a request on the download url, `nullptr` if there is no download url that is still valid.
+        std::shared_ptr<request::Request> prepare_download_request() const;
         std::shared_ptr<request::Request> prepare_read_request() const;
         std::shared_ptr<request::Request> prepare_write_request() const;
+
+        /// takes revision, size, modification time, mimetype, content hash & download url from a driveItem.
+        void update_metadata(const nlohmann::json &drive_item);
     };
 } // namespace CloudSync::onedrive
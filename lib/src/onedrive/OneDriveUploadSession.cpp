@@ -0,0 +1,60 @@
+#include "OneDriveUploadSession.hpp"
+#include <cstdlib>
+
+using namespace CloudSync;
+using namespace CloudSync::request;
+using namespace CloudSync::onedrive;
+using json = nlohmann::json;
+
+const std::size_t OneDriveUploadSession::CHUNK_GRANULARITY = 320 * 1024;
+
+const std::size_t OneDriveUploadSession::MAX_CHUNK_SIZE = 192 * CHUNK_GRANULARITY;
+
+upload::UploadSession::Limits OneDriveUploadSession::limits(std::uint64_t) const {
+    return {CHUNK_GRANULARITY, MAX_CHUNK_SIZE, CHUNK_GRANULARITY, false};
+}
+
+void OneDriveUploadSession::start(std::uint64_t total_size) {
+    m_total_size = total_size;
+    const auto token = m_credentials->get_current_access_token();
+    m_upload_url = m_request->POST(m_resource_path + ":/createUploadSession")
+            ->token_auth(token)
+            ->accept(Request::MIMETYPE_JSON)
+            ->if_match(m_revision)
+            ->json_body({{"item", {{"@microsoft.graph.conflictBehavior", "replace"}}}})
+            ->request().json().at("uploadUrl");
+}
+
+void OneDriveUploadSession::upload_chunk(const std::shared_ptr<request::Request> &request, const upload::Chunk &chunk) {
+    // the upload url must be called without the access token
+    const auto response = request->PUT(m_upload_url)
+            ->header("Content-Range", upload::ChunkedUpload::content_range(chunk.offset, chunk.data.size(), m_total_size))
+            ->binary_body(chunk.data)
+            ->request();
+    if (response.code == 200 || response.code == 201) {
+        m_drive_item = response.json();
+    }
+}
+
+std::optional<std::uint64_t> OneDriveUploadSession::received_bytes(const std::shared_ptr<request::Request> &request) {
+    const auto session = request->GET(m_upload_url)
+            ->accept(Request::MIMETYPE_JSON)
+            ->request().json();
+    // `["26214400-"]` once the first 25 MiB have arrived
+    const auto &ranges = session.at("nextExpectedRanges");
+    if (ranges.empty()) {
+        return m_total_size;
+    }
+    return std::strtoull(ranges.at(0).get<std::string>().c_str(), nullptr, 10);
+}
+
+void OneDriveUploadSession::finish(std::uint64_t) {
+    if (m_drive_item.is_null()) {
+        // the response to the last chunk got lost, but the session says that everything has arrived
+        const auto token = m_credentials->get_current_access_token();
+        m_drive_item = m_request->GET(m_resource_path)
+                ->token_auth(token)
+                ->accept(Request::MIMETYPE_JSON)
+                ->request().json();
+    }
+}
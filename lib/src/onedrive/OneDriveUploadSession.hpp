@@ -0,0 +1,52 @@
+#pragma once
+
+#include "upload/ChunkedUpload.hpp"
+#include "credentials/OAuth2CredentialsImpl.hpp"
+#include <nlohmann/json.hpp>
+
+namespace CloudSync::onedrive {
+    /**
+     * Chunked upload through `createUploadSession`. Chunks are `PUT` to the pre-authenticated upload url in order.
+     */
+    class OneDriveUploadSession : public upload::UploadSession {
+    public:
+        OneDriveUploadSession(
+                std::string resource_path,
+                std::string revision,
+                std::shared_ptr<credentials::OAuth2CredentialsImpl> credentials,
+                std::shared_ptr<request::Request> request)
+                : m_resource_path(std::move(resource_path))
+                , m_revision(std::move(revision))
+                , m_credentials(std::move(credentials))
+                , m_request(std::move(request)) {};
+
+        [[nodiscard]] Limits limits(std::uint64_t total_size) const override;
+
+        void start(std::uint64_t total_size) override;
+
+        void upload_chunk(const std::shared_ptr<request::Request> &request, const upload::Chunk &chunk) override;
+
+        /// reads `nextExpectedRanges` from the upload session
+        std::optional<std::uint64_t> received_bytes(const std::shared_ptr<request::Request> &request) override;
+
+        void finish(std::uint64_t total_size) override;
+
+        /// @return the uploaded driveItem, once the session has finished.
+        [[nodiscard]] const nlohmann::json &drive_item() const {
+            return m_drive_item;
+        }
+
+    private:
+        /// graph needs chunks to be a multiple of 320 KiB
+        static const std::size_t CHUNK_GRANULARITY;
+        static const std::size_t MAX_CHUNK_SIZE;
+
+        const std::string m_resource_path;
+        const std::string m_revision;
+        const std::shared_ptr<credentials::OAuth2CredentialsImpl> m_credentials;
+        const std::shared_ptr<request::Request> m_request;
+        std::string m_upload_url;
+        std::uint64_t m_total_size = 0;
+        nlohmann::json m_drive_item;
+    };
+}
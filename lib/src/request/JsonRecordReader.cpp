@@ -0,0 +1,277 @@
+#include "JsonRecordReader.hpp"
+#include <cassert>
+#include <cstring>
+
+namespace CloudSync::request {
+
+    bool JsonRecord::contains(const std::string &field) const {
+        return m_values[index_of(field)].has_value();
+    }
+
+    const std::string &JsonRecord::at(const std::string &field) const {
+        const auto &value = m_values[index_of(field)];
+        if (!value) {
+            throw exceptions::ParseError("missing field '" + field + "'");
+        }
+        return *value;
+    }
+
+    std::string JsonRecord::value(const std::string &field, const std::string &fallback) const {
+        const auto &value = m_values[index_of(field)];
+        return value ? *value : fallback;
+    }
+
+    void JsonRecord::set(std::size_t field_index, std::string value) {
+        m_values[field_index] = std::move(value);
+    }
+
+    std::size_t JsonRecord::index_of(const std::string &field) const {
+        for (std::size_t i = 0; i < m_fields->size(); i++) {
+            if ((*m_fields)[i] == field) {
+                return i;
+            }
+        }
+        // only fields that have been requested from the reader can be accessed
+        assert(false);
+        throw exceptions::ParseError("field '" + field + "' has not been requested");
+    }
+
+    const JsonRecord &JsonRecords::record() const {
+        if (records.size() != 1) {
+            throw exceptions::ParseError("expected exactly one object, found " + std::to_string(records.size()));
+        }
+        return records.front();
+    }
+
+    const std::vector<std::string> JsonRecordReader::NO_FIELDS = {};
+
+    JsonRecordReader::JsonRecordReader(
+            const std::string &records_key,
+            const std::vector<std::string> &record_fields,
+            const std::vector<std::string> &page_fields)
+            : m_records_key(records_key)
+            , m_record_fields(record_fields)
+            , m_page_fields(page_fields)
+            , m_result{JsonRecord(page_fields), {}} {}
+
+    JsonRecords JsonRecordReader::read(
+            const std::string &data,
+            const std::string &records_key,
+            const std::vector<std::string> &record_fields,
+            const std::vector<std::string> &page_fields) {
+        JsonRecordReader reader(records_key, record_fields, page_fields);
+        nlohmann::json::sax_parse(data, &reader);
+        return std::move(reader.m_result);
+    }
+
+    bool JsonRecordReader::null() {
+        if (m_skip_depth == 0) {
+            begin_value();
+        }
+        return true;
+    }
+
+    bool JsonRecordReader::boolean(bool value) {
+        if (m_skip_depth == 0) {
+            begin_value();
+            store(value ? "true" : "false");
+        }
+        return true;
+    }
+
+    bool JsonRecordReader::number_integer(number_integer_t value) {
+        if (m_skip_depth == 0) {
+            begin_value();
+            store(std::to_string(value));
+        }
+        return true;
+    }
+
+    bool JsonRecordReader::number_unsigned(number_unsigned_t value) {
+        if (m_skip_depth == 0) {
+            begin_value();
+            store(std::to_string(value));
+        }
+        return true;
+    }
+
+    bool JsonRecordReader::number_float(number_float_t, const string_t &text) {
+        if (m_skip_depth == 0) {
+            begin_value();
+            store(text);
+        }
+        return true;
+    }
+
+    bool JsonRecordReader::string(string_t &value) {
+        if (m_skip_depth == 0) {
+            begin_value();
+            store(std::move(value));
+        }
+        return true;
+    }
+
+    bool JsonRecordReader::binary(binary_t &) {
+        if (m_skip_depth == 0) {
+            begin_value();
+        }
+        return true;
+    }
+
+    bool JsonRecordReader::start_object(std::size_t) {
+        if (m_skip_depth > 0) {
+            m_skip_depth++;
+            return true;
+        }
+        begin_value();
+        if (!m_in_record && is_record_position()) {
+            m_in_record = true;
+            m_record_depth = m_frames.size();
+            m_record_prefix_length = m_path.empty() ? 0 : m_path.size() + 1;
+            m_result.records.emplace_back(m_record_fields);
+        } else if (!enter_container()) {
+            m_skip_depth = 1;
+            return true;
+        }
+        m_frames.push_back({false, 0, m_path.size()});
+        return true;
+    }
+
+    bool JsonRecordReader::key(string_t &value) {
+        if (m_skip_depth == 0) {
+            m_path.resize(m_frames.back().path_length);
+            append_path_component(value);
+        }
+        return true;
+    }
+
+    bool JsonRecordReader::end_object() {
+        if (m_skip_depth > 0) {
+            m_skip_depth--;
+            return true;
+        }
+        m_frames.pop_back();
+        if (m_in_record && m_frames.size() == m_record_depth) {
+            m_in_record = false;
+        }
+        return true;
+    }
+
+    bool JsonRecordReader::start_array(std::size_t) {
+        if (m_skip_depth > 0) {
+            m_skip_depth++;
+            return true;
+        }
+        begin_value();
+        if (!enter_container()) {
+            m_skip_depth = 1;
+            return true;
+        }
+        m_frames.push_back({true, 0, m_path.size()});
+        return true;
+    }
+
+    bool JsonRecordReader::end_array() {
+        if (m_skip_depth > 0) {
+            m_skip_depth--;
+            return true;
+        }
+        m_frames.pop_back();
+        return true;
+    }
+
+    bool JsonRecordReader::parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &ex) {
+        throw exceptions::ParseError(ex.what());
+    }
+
+    void JsonRecordReader::begin_value() {
+        if (!m_frames.empty() && m_frames.back().is_array) {
+            auto &frame = m_frames.back();
+            m_path.resize(frame.path_length);
+            append_path_component(std::to_string(frame.next_index++));
+        }
+    }
+
+    void JsonRecordReader::append_path_component(const std::string &component) {
+        if (!m_path.empty()) {
+            m_path += '/';
+        }
+        m_path += component;
+    }
+
+    bool JsonRecordReader::is_record_position() const {
+        if (m_records_key.empty()) {
+            return m_frames.empty();
+        }
+        // either the object behind the records key, or an object inside the array behind the records key
+        return (m_frames.size() == 1 && m_path == m_records_key)
+               || (m_frames.size() == 2
+                   && m_frames.back().is_array
+                   && m_frames.back().path_length == m_records_key.size()
+                   && m_path.compare(0, m_records_key.size(), m_records_key) == 0);
+    }
+
+    bool JsonRecordReader::enter_container() {
+        if (m_in_record) {
+            const char *relative_path = m_path.c_str() + m_record_prefix_length;
+            const std::size_t relative_length = m_path.size() - m_record_prefix_length;
+            const auto index = find_field(m_record_fields, relative_path, relative_length);
+            if (index >= 0) {
+                // requested containers are marked as present
+                m_result.records.back().set(index, "");
+            }
+            return is_field_prefix(m_record_fields, relative_path, relative_length);
+        } else {
+            if (m_frames.empty()) {
+                // document root
+                return true;
+            }
+            if (m_frames.size() == 1 && m_path == m_records_key) {
+                // array of records
+                return true;
+            }
+            const auto index = find_field(m_page_fields, m_path.c_str(), m_path.size());
+            if (index >= 0) {
+                m_result.page.set(index, "");
+            }
+            return is_field_prefix(m_page_fields, m_path.c_str(), m_path.size());
+        }
+    }
+
+    void JsonRecordReader::store(std::string value) {
+        if (m_in_record) {
+            const auto index = find_field(
+                    m_record_fields,
+                    m_path.c_str() + m_record_prefix_length,
+                    m_path.size() - m_record_prefix_length);
+            if (index >= 0) {
+                m_result.records.back().set(index, std::move(value));
+            }
+        } else {
+            const auto index = find_field(m_page_fields, m_path.c_str(), m_path.size());
+            if (index >= 0) {
+                m_result.page.set(index, std::move(value));
+            }
+        }
+    }
+
+    std::ptrdiff_t JsonRecordReader::find_field(const std::vector<std::string> &fields, const char *path, std::size_t length) {
+        for (std::size_t i = 0; i < fields.size(); i++) {
+            if (fields[i].size() == length && std::memcmp(fields[i].data(), path, length) == 0) {
+                return static_cast<std::ptrdiff_t>(i);
+            }
+        }
+        return -1;
+    }
+
+    bool JsonRecordReader::is_field_prefix(const std::vector<std::string> &fields, const char *path, std::size_t length) {
+        for (const auto &field: fields) {
+            if (field.size() > length
+                && std::memcmp(field.data(), path, length) == 0
+                && field[length] == '/') {
+                return true;
+            }
+        }
+        return false;
+    }
+}
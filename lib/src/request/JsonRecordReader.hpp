@@ -0,0 +1,128 @@
+#pragma once
+
+#include "request/exceptions/ParseError.hpp"
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace CloudSync::request {
+    /**
+     * Flat representation of a single json object, holding only the fields that have been asked for.
+     *
+     * Fields are addressed by their path relative to the object, separated by slashes
+     * (e.g. `name`, `parentReference/path`, `parents/0/id`). Scalars are stored as their textual
+     * representation (`true`, `11048`, ...). Objects and arrays that are requested directly are only
+     * recorded as being present, with an empty value.
+     */
+    class JsonRecord {
+    public:
+        /// @param fields list of requested fields. Must outlive the record.
+        explicit JsonRecord(const std::vector<std::string> &fields)
+                : m_fields(&fields)
+                , m_values(fields.size()) {};
+
+        [[nodiscard]] bool contains(const std::string &field) const;
+
+        /// @throws ParseError if the field was not part of the parsed object.
+        [[nodiscard]] const std::string &at(const std::string &field) const;
+
+        /// @return the fields value or `fallback` if the field was not part of the parsed object.
+        [[nodiscard]] std::string value(const std::string &field, const std::string &fallback = "") const;
+
+        void set(std::size_t field_index, std::string value);
+
+    private:
+        const std::vector<std::string> *m_fields;
+        std::vector<std::optional<std::string>> m_values;
+
+        [[nodiscard]] std::size_t index_of(const std::string &field) const;
+    };
+
+    /// Result of JsonRecordReader::read(): the extracted records and the requested top-level fields.
+    struct JsonRecords {
+        JsonRecord page;
+        std::vector<JsonRecord> records;
+
+        /// @throws ParseError if not exactly one record has been found.
+        [[nodiscard]] const JsonRecord &record() const;
+    };
+
+    /**
+     * Event based (SAX) json reader that decodes a response straight into JsonRecords, without building a
+     * `nlohmann::json` tree of the whole document first. Any subtree that doesn't contain a requested field
+     * is skipped.
+     */
+    class JsonRecordReader : public nlohmann::json_sax<nlohmann::json> {
+    public:
+        static const std::vector<std::string> NO_FIELDS;
+
+        /**
+         * @param data json document.
+         * @param records_key top-level key that holds the records. If it points to an array, every object in it
+         *        becomes a record. If it points to an object, that object is the only record. If it is empty, the
+         *        document itself is the only record.
+         * @param record_fields fields to extract from every record. Must outlive the result.
+         * @param page_fields top-level fields to extract from the document, e.g. paging cursors. Must outlive
+         *        the result.
+         * @throws ParseError if the document is not valid json.
+         */
+        static JsonRecords read(
+                const std::string &data,
+                const std::string &records_key,
+                const std::vector<std::string> &record_fields,
+                const std::vector<std::string> &page_fields = NO_FIELDS);
+
+        bool null() override;
+        bool boolean(bool value) override;
+        bool number_integer(number_integer_t value) override;
+        bool number_unsigned(number_unsigned_t value) override;
+        bool number_float(number_float_t value, const string_t &text) override;
+        bool string(string_t &value) override;
+        bool binary(binary_t &value) override;
+        bool start_object(std::size_t elements) override;
+        bool key(string_t &value) override;
+        bool end_object() override;
+        bool start_array(std::size_t elements) override;
+        bool end_array() override;
+        bool parse_error(std::size_t position, const std::string &last_token,
+                         const nlohmann::detail::exception &ex) override;
+
+    private:
+        JsonRecordReader(
+                const std::string &records_key,
+                const std::vector<std::string> &record_fields,
+                const std::vector<std::string> &page_fields);
+
+        struct Frame {
+            bool is_array;
+            std::size_t next_index;
+            std::size_t path_length;
+        };
+
+        const std::string &m_records_key;
+        const std::vector<std::string> &m_record_fields;
+        const std::vector<std::string> &m_page_fields;
+        JsonRecords m_result;
+
+        std::vector<Frame> m_frames;
+        /// path of the value that is currently parsed, relative to the document root.
+        std::string m_path;
+        /// number of nested containers that are currently skipped.
+        std::size_t m_skip_depth = 0;
+        bool m_in_record = false;
+        /// frame depth of the current record object.
+        std::size_t m_record_depth = 0;
+        /// length of the path prefix that leads to the current record, including the trailing separator.
+        std::size_t m_record_prefix_length = 0;
+
+        void begin_value();
+        void append_path_component(const std::string &component);
+        bool is_record_position() const;
+        bool enter_container();
+        void store(std::string value);
+
+        static std::ptrdiff_t find_field(const std::vector<std::string> &fields, const char *path, std::size_t length);
+        static bool is_field_prefix(const std::vector<std::string> &fields, const char *path, std::size_t length);
+    };
+}
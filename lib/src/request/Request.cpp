@@ -35,4 +35,8 @@ namespace CloudSync::request {
         return header("If-Match", etag);
     }
 
+    std::shared_ptr<Request> Request::if_none_match(const std::string &etag) {
+        return header("If-None-Match", etag);
+    }
+
 } // namespace CloudSync::request
@@ -4,6 +4,7 @@
 #include "StringResponse.hpp"
 #include "CloudSync/OAuth2Credentials.hpp"
 #include <chrono>
+#include <filesystem>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -20,6 +21,13 @@ namespace CloudSync::request {
     public:
         virtual ~Request() = default;
 
+        /**
+         * A request is not thread-safe. Use this to get another one with the same options (proxy, redirects,
+         * verbosity) that can be used from a different thread.
+         * @return a new, independent request.
+         */
+        [[nodiscard]] virtual std::shared_ptr<Request> clone() const = 0;
+
         virtual std::shared_ptr<Request> resource(const std::string &verb, const std::string &url) = 0;
 
         // MARK: - some aliases for known verbs
@@ -39,6 +47,10 @@ namespace CloudSync::request {
             return this->resource("PUT", url);
         }
 
+        std::shared_ptr<Request> PATCH(const std::string &url) {
+            return this->resource("PATCH", url);
+        }
+
         std::shared_ptr<Request> DELETE(const std::string &url) {
             return this->resource("DELETE", url);
         }
@@ -51,10 +63,23 @@ namespace CloudSync::request {
             return this->resource("PROPFIND", url);
         }
 
+        std::shared_ptr<Request> SEARCH(const std::string &url) {
+            return this->resource("SEARCH", url);
+        }
+
+        std::shared_ptr<Request> COPY(const std::string &url) {
+            return this->resource("COPY", url);
+        }
+
+        std::shared_ptr<Request> MOVE(const std::string &url) {
+            return this->resource("MOVE", url);
+        }
+
         virtual std::shared_ptr<Request> header(const std::string& key, const std::string& value) = 0;
         std::shared_ptr<Request> accept(const std::string& mimetype);
         std::shared_ptr<Request> content_type(const std::string& mimetype);
         std::shared_ptr<Request> if_match(const std::string& etag);
+        std::shared_ptr<Request> if_none_match(const std::string& etag);
         virtual std::shared_ptr<Request> query_param(const std::string& key, const std::string& value) = 0;
         virtual std::shared_ptr<Request> postfield(const std::string& key, const std::string& value) = 0;
         virtual std::shared_ptr<Request> mime_postfield(const std::string& key, const std::string& value) = 0;
@@ -63,6 +88,8 @@ namespace CloudSync::request {
 
         virtual std::shared_ptr<Request> body(const std::string& body) = 0;
         virtual std::shared_ptr<Request> binary_body(const std::vector<std::uint8_t> &body) = 0;
+        /// sends the content of a local file as the body, read in pieces while the request is sent
+        virtual std::shared_ptr<Request> file_body(const std::filesystem::path &path) = 0;
         std::shared_ptr<Request> json_body(const nlohmann::json& json_data);
 
         virtual StringResponse request() = 0;
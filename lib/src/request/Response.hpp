@@ -1,10 +1,15 @@
 #pragma once
 
 #include "request/exceptions/response/ResponseException.hpp"
+#include "util/DateTime.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <nlohmann/json.hpp>
 #include <pugixml.hpp>
 #include <stdexcept>
 #include <string>
+#include <optional>
 #include <unordered_map>
 #include <sstream>
 #include <utility>
@@ -20,8 +25,33 @@ namespace CloudSync::request {
         const std::string content_type;
         const std::unordered_map<std::string, std::string> headers;
 
+        /**
+         * @return how long the server wants the client to wait before the next request, from the `Retry-After`
+         * header in seconds or as a date. Nothing if there is no valid header.
+         */
+        [[nodiscard]] std::optional<std::chrono::seconds> retry_after() const {
+            const auto header = headers.find("retry-after");
+            if (header == headers.end() || header->second.empty()) {
+                return std::nullopt;
+            }
+            const auto &value = header->second;
+            if (std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isdigit(c); })) {
+                try {
+                    return std::chrono::seconds(std::stoll(value));
+                } catch (const std::out_of_range &) {
+                    return std::nullopt;
+                }
+            }
+            const auto date = util::parse_rfc1123(value);
+            if (!date) {
+                return std::nullopt;
+            }
+            const auto delay = std::chrono::ceil<std::chrono::seconds>(*date - std::chrono::system_clock::now());
+            return std::max(delay, std::chrono::seconds(0));
+        }
+
     protected:
-        static void handle_error_code(long code, const std::function<std::string()>& data) {
+        void handle_error_code(long code, const std::function<std::string()>& data) const {
             if (code >= 400) {                                                                                                 \
                 switch (code) {
                     case 400:
@@ -40,8 +70,10 @@ namespace CloudSync::request {
                         throw exceptions::response::PreconditionFailed(data());
                     case 500:
                         throw exceptions::response::InternalServerError(data());
+                    case 429:
+                        throw exceptions::response::TooManyRequests(data(), retry_after());
                     case 503:
-                        throw exceptions::response::ServiceUnavailable(data());
+                        throw exceptions::response::ServiceUnavailable(data(), retry_after());
                     default:
                         if (code >= 500) {
                             throw exceptions::response::ServerError(code, data());
@@ -2,6 +2,7 @@
 
 #include "Response.hpp"
 #include "request/exceptions/ParseError.hpp"
+#include "JsonRecordReader.hpp"
 #include <string>
 #include <utility>
 
@@ -29,6 +30,17 @@ namespace CloudSync::request {
             }
         }
 
+        /**
+         * Decodes only the requested fields of the json body, without building a json tree of the whole response.
+         * @see JsonRecordReader::read()
+         */
+        [[nodiscard]] JsonRecords json_records(
+                const std::string &records_key,
+                const std::vector<std::string> &record_fields,
+                const std::vector<std::string> &page_fields = JsonRecordReader::NO_FIELDS) const {
+            return JsonRecordReader::read(data, records_key, record_fields, page_fields);
+        }
+
         [[nodiscard]] std::shared_ptr<pugi::xml_document> xml() const {
             const auto doc = std::make_shared<pugi::xml_document>();
             pugi::xml_parse_result result = doc->load_string(data.data());
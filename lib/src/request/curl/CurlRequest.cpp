@@ -1,6 +1,7 @@
 #include "CurlRequest.hpp"
 #include "credentials/OAuth2CredentialsImpl.hpp"
 #include "request/exceptions/RequestException.hpp"
+#include <cerrno>
 
 namespace CloudSync::request::curl {
     CurlRequest::CurlRequest() {
@@ -8,9 +9,20 @@ namespace CloudSync::request::curl {
     }
 
     CurlRequest::~CurlRequest() {
+        if (m_file_body != nullptr) {
+            std::fclose(m_file_body);
+        }
         curl_easy_cleanup(m_curl);
     }
 
+    std::shared_ptr<Request> CurlRequest::clone() const {
+        const auto request = std::make_shared<CurlRequest>();
+        request->set_proxy(m_proxy_url, m_proxy_user, m_proxy_password);
+        request->set_follow_redirects(m_option_follow_redirects);
+        request->set_verbose(m_option_verbose);
+        return request;
+    }
+
     static size_t BinaryWriteCallback(void *contents, size_t size, size_t nmemb, void *userp) {
         std::vector<std::uint8_t> new_contents(
                 (std::uint8_t *) contents,
@@ -192,6 +204,10 @@ namespace CloudSync::request::curl {
         m_url.clear();
         m_body.clear();
         m_binary_body.clear();
+        if (m_file_body != nullptr) {
+            std::fclose(m_file_body);
+            m_file_body = nullptr;
+        }
         curl_easy_reset(m_curl);
     }
 
@@ -237,6 +253,19 @@ namespace CloudSync::request::curl {
         return this->shared_from_this();
     }
 
+    std::shared_ptr<Request> CurlRequest::file_body(const std::filesystem::path &path) {
+        m_file_body = std::fopen(path.c_str(), "rb");
+        if (m_file_body == nullptr) {
+            throw std::filesystem::filesystem_error(
+                    "cannot open file to upload", path, std::error_code(errno, std::generic_category()));
+        }
+        // curl reads the file with fread() while it sends the request
+        curl_easy_setopt(m_curl, CURLOPT_UPLOAD, 1L);
+        curl_easy_setopt(m_curl, CURLOPT_READDATA, m_file_body);
+        curl_easy_setopt(m_curl, CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(std::filesystem::file_size(path)));
+        return this->shared_from_this();
+    }
+
     void CurlRequest::set_char_body(const char *body, const size_t size) {
         curl_easy_setopt(m_curl, CURLOPT_POSTFIELDS, body);
         curl_easy_setopt(m_curl, CURLOPT_POSTFIELDSIZE, size);
@@ -2,6 +2,7 @@
 
 #include "request/Request.hpp"
 #include "credentials/OAuth2CredentialsImpl.hpp"
+#include <cstdio>
 
 namespace CloudSync::request::curl {
 
@@ -9,6 +10,7 @@ class CurlRequest : public Request, public std::enable_shared_from_this<CurlRequ
 public:
     CurlRequest();
     ~CurlRequest() override;
+    std::shared_ptr<Request> clone() const override;
     std::shared_ptr<Request> resource(const std::string &verb, const std::string &url) override;
     std::shared_ptr<Request> header(const std::string& key, const std::string& value) override;
     std::shared_ptr<Request> query_param(const std::string& key, const std::string& value) override;
@@ -18,6 +20,7 @@ public:
     std::shared_ptr<Request> token_auth(const std::string& token) override;
     std::shared_ptr<Request> body(const std::string & body) override;
     std::shared_ptr<Request> binary_body(const std::vector<std::uint8_t> &body) override;
+    std::shared_ptr<Request> file_body(const std::filesystem::path &path) override;
 
     StringResponse request() override;
     BinaryResponse request_binary() override;
@@ -48,6 +51,7 @@ private:
 
     std::string m_body;
     std::vector<std::uint8_t> m_binary_body;
+    std::FILE *m_file_body = nullptr;
 
 };
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "request/exceptions/ParseError.hpp"
+#include <chrono>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <nlohmann/json.hpp>
@@ -86,6 +88,16 @@ namespace CloudSync::request::exceptions::response {
         explicit Conflict(const std::string &data = "") : ClientError(409, data, "Conflict\n" + data) {};
     };
 
+    /// 429 Too Many Requests
+    class TooManyRequests : public ClientError {
+    public:
+        explicit TooManyRequests(const std::string &data = "", std::optional<std::chrono::seconds> retry_after = std::nullopt)
+                : ClientError(429, data, "Too Many Requests\n" + data), retry_after(retry_after) {};
+
+        /// how long to wait before the next request, if the server has sent a `Retry-After` header
+        const std::optional<std::chrono::seconds> retry_after;
+    };
+
     class InternalServerError : public ServerError {
     public:
         explicit InternalServerError(const std::string &data = "") : ServerError(500, data, "Internal Server Error\n" + data) {};
@@ -93,6 +105,10 @@ namespace CloudSync::request::exceptions::response {
 
     class ServiceUnavailable : public ServerError {
     public:
-        explicit ServiceUnavailable(const std::string &data = "") : ServerError(503, data, "Service Unavailable\n" + data) {};
+        explicit ServiceUnavailable(const std::string &data = "", std::optional<std::chrono::seconds> retry_after = std::nullopt)
+                : ServerError(503, data, "Service Unavailable\n" + data), retry_after(retry_after) {};
+
+        /// how long to wait before the next request, if the server has sent a `Retry-After` header
+        const std::optional<std::chrono::seconds> retry_after;
     };
 }
\ No newline at end of file
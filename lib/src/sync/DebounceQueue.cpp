@@ -0,0 +1,47 @@
+#include "DebounceQueue.hpp"
+#include <algorithm>
+
+using namespace CloudSync::sync;
+
+DebounceQueue::DebounceQueue(Clock::duration quiet_period, Clock::duration max_delay)
+        : m_quiet_period(quiet_period)
+        , m_max_delay(std::max(quiet_period, max_delay)) {}
+
+void DebounceQueue::push(const std::string &path, Clock::time_point now) {
+    const auto [pending, is_new] = m_pending.try_emplace(path, Pending{now, now});
+    if (is_new) {
+        m_deadlines.push({ready_at(pending->second), path});
+    } else {
+        pending->second.last_push = now;
+    }
+}
+
+std::vector<std::string> DebounceQueue::pop_ready(Clock::time_point now) {
+    std::vector<std::string> ready;
+    while (!m_deadlines.empty() && m_deadlines.top().ready <= now) {
+        auto deadline = m_deadlines.top();
+        m_deadlines.pop();
+        const auto pending = m_pending.find(deadline.path);
+        const auto ready_time = ready_at(pending->second);
+        if (ready_time <= now) {
+            m_pending.erase(pending);
+            ready.push_back(std::move(deadline.path));
+        } else {
+            // pushed again since the deadline has been set
+            deadline.ready = ready_time;
+            m_deadlines.push(std::move(deadline));
+        }
+    }
+    return ready;
+}
+
+std::optional<DebounceQueue::Clock::time_point> DebounceQueue::next_ready() const {
+    if (m_deadlines.empty()) {
+        return std::nullopt;
+    }
+    return m_deadlines.top().ready;
+}
+
+DebounceQueue::Clock::time_point DebounceQueue::ready_at(const Pending &pending) const {
+    return std::min(pending.last_push + m_quiet_period, pending.first_push + m_max_delay);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CloudSync::sync {
+    /**
+     * Collects changed paths and hands each one out once it has been quiet for a while, so a burst of events for the
+     * same path leads to a single upload. A path that keeps changing is handed out at the latest `max_delay` after
+     * its first change, so files that are written to all the time are uploaded as well.
+     * @note Not thread-safe.
+     */
+    class DebounceQueue {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @param quiet_period a path is ready once it hasn't been pushed for this long
+         * @param max_delay a path is ready at the latest this long after its first push
+         */
+        DebounceQueue(Clock::duration quiet_period, Clock::duration max_delay);
+
+        /// Adds `path` to the queue, or restarts its quiet period if it is already queued.
+        void push(const std::string &path, Clock::time_point now);
+
+        /**
+         * Removes the paths that are ready at `now` from the queue.
+         * @return the paths in the order they have become ready. Pass `Clock::time_point::max()` to get all of them.
+         */
+        std::vector<std::string> pop_ready(Clock::time_point now);
+
+        /**
+         * @return the earliest time at which a path may be ready. A path that has been pushed again in the
+         * meantime is ready later than that. Nothing if the queue is empty.
+         */
+        [[nodiscard]] std::optional<Clock::time_point> next_ready() const;
+
+        [[nodiscard]] std::size_t size() const {
+            return m_pending.size();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return m_pending.empty();
+        }
+
+    private:
+        struct Pending {
+            Clock::time_point first_push;
+            Clock::time_point last_push;
+        };
+
+        struct Deadline {
+            Clock::time_point ready;
+            std::string path;
+
+            bool operator>(const Deadline &other) const {
+                return ready > other.ready;
+            }
+        };
+
+        const Clock::duration m_quiet_period;
+        const Clock::duration m_max_delay;
+        std::unordered_map<std::string, Pending> m_pending;
+        /**
+         * one deadline per queued path. A push doesn't update it, so it may be earlier than the time the path is
+         * actually ready. It is moved back when it comes up.
+         */
+        std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>> m_deadlines;
+
+        [[nodiscard]] Clock::time_point ready_at(const Pending &pending) const;
+    };
+}
@@ -0,0 +1,196 @@
+#include "InotifyWatcher.hpp"
+#include <system_error>
+
+#ifdef __linux__
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace CloudSync::sync;
+namespace fs = std::filesystem;
+
+#ifdef __linux__
+
+namespace {
+    /// writes that are still going on are reported through IN_MODIFY, so files that are kept open are seen as well
+    constexpr std::uint32_t WATCHED_EVENTS = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE
+                                             | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+    std::string child_of(const std::string &directory, const std::string &name) {
+        return directory.empty() ? name : directory + "/" + name;
+    }
+
+    bool is_in_tree(const std::string &path, const std::string &directory) {
+        return path == directory || path.compare(0, directory.size() + 1, directory + "/") == 0;
+    }
+}
+
+InotifyWatcher::InotifyWatcher(fs::path root, std::size_t max_watches)
+        : m_root(std::move(root))
+        , m_max_watches(max_watches) {
+    m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify_fd < 0) {
+        // EMFILE if the user has reached fs.inotify.max_user_instances
+        throw std::system_error(errno, std::generic_category(), "inotify_init1");
+    }
+    m_interrupt_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_interrupt_fd < 0) {
+        const int error = errno;
+        close(m_inotify_fd);
+        throw std::system_error(error, std::generic_category(), "eventfd");
+    }
+}
+
+InotifyWatcher::~InotifyWatcher() {
+    close(m_interrupt_fd);
+    close(m_inotify_fd);
+}
+
+bool InotifyWatcher::watch_tree(const std::string &directory) {
+    bool is_complete = true;
+    std::vector<std::string> pending = {directory};
+    while (!pending.empty()) {
+        const auto current = std::move(pending.back());
+        pending.pop_back();
+        if (!add_watch(current)) {
+            is_complete = false;
+            continue;
+        }
+        std::error_code error;
+        fs::directory_iterator entry(m_root / current, fs::directory_options::skip_permission_denied, error);
+        for (; !error && entry != fs::directory_iterator(); entry.increment(error)) {
+            // symlinks to directories are not followed
+            if (fs::is_directory(entry->symlink_status(error))) {
+                pending.push_back(child_of(current, entry->path().filename().generic_string()));
+            }
+        }
+    }
+    return is_complete;
+}
+
+std::vector<WatchEvent> InotifyWatcher::read_events(std::chrono::milliseconds timeout) {
+    pollfd descriptors[] = {{m_inotify_fd, POLLIN, 0}, {m_interrupt_fd, POLLIN, 0}};
+    const auto timeout_ms = static_cast<int>(std::clamp<std::chrono::milliseconds::rep>(timeout.count(), 0, INT_MAX));
+    if (poll(descriptors, 2, timeout_ms) < 0) {
+        if (errno == EINTR) {
+            return {};
+        }
+        throw std::system_error(errno, std::generic_category(), "poll");
+    }
+    if (descriptors[1].revents & POLLIN) {
+        std::uint64_t interrupts;
+        [[maybe_unused]] const auto length = read(m_interrupt_fd, &interrupts, sizeof(interrupts));
+    }
+    std::vector<WatchEvent> events;
+    if (!(descriptors[0].revents & POLLIN)) {
+        return events;
+    }
+    alignas(inotify_event) char buffer[64 * 1024];
+    const auto length = read(m_inotify_fd, buffer, sizeof(buffer));
+    for (auto position = buffer; length > 0 && position < buffer + length;) {
+        const auto &event = *reinterpret_cast<const inotify_event *>(position);
+        position += sizeof(inotify_event) + event.len;
+        if (event.mask & IN_Q_OVERFLOW) {
+            events.push_back({WatchEvent::Type::OVERFLOW, ""});
+            continue;
+        }
+        const auto directory = m_directories.find(event.wd);
+        if (directory == m_directories.end()) {
+            // the watch has been removed already
+            continue;
+        }
+        if (event.mask & IN_IGNORED) {
+            m_directories.erase(directory);
+            continue;
+        }
+        if (event.len == 0) {
+            continue;
+        }
+        const auto path = child_of(directory->second, event.name);
+        if (!(event.mask & IN_ISDIR)) {
+            events.push_back({WatchEvent::Type::CHANGED, path});
+        } else if (event.mask & IN_MOVED_FROM) {
+            unwatch_tree(path);
+        } else if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+            watch_tree(path);
+            events.push_back({WatchEvent::Type::DIRECTORY_ADDED, path});
+        }
+    }
+    return events;
+}
+
+void InotifyWatcher::interrupt() {
+    const std::uint64_t interrupts = 1;
+    [[maybe_unused]] const auto length = write(m_interrupt_fd, &interrupts, sizeof(interrupts));
+}
+
+bool InotifyWatcher::add_watch(const std::string &directory) {
+    const int descriptor = inotify_add_watch(m_inotify_fd, (m_root / directory).c_str(), WATCHED_EVENTS);
+    if (descriptor < 0) {
+        if (errno == ENOSPC) {
+            m_unwatched.insert(directory);
+            return false;
+        }
+        // removed in the meantime, not readable or not a directory: nothing to watch
+        m_unwatched.erase(directory);
+        return true;
+    }
+    // a directory that is already watched keeps its descriptor, only its path is updated
+    const auto [entry, is_new] = m_directories.insert_or_assign(descriptor, directory);
+    if (is_new && m_max_watches != 0 && m_directories.size() > m_max_watches) {
+        inotify_rm_watch(m_inotify_fd, descriptor);
+        m_directories.erase(entry);
+        m_unwatched.insert(directory);
+        return false;
+    }
+    m_unwatched.erase(directory);
+    return true;
+}
+
+void InotifyWatcher::unwatch_tree(const std::string &directory) {
+    for (auto entry = m_directories.begin(); entry != m_directories.end();) {
+        if (is_in_tree(entry->second, directory)) {
+            inotify_rm_watch(m_inotify_fd, entry->first);
+            entry = m_directories.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+    for (auto entry = m_unwatched.begin(); entry != m_unwatched.end();) {
+        entry = is_in_tree(*entry, directory) ? m_unwatched.erase(entry) : std::next(entry);
+    }
+}
+
+#else
+
+InotifyWatcher::InotifyWatcher(fs::path root, std::size_t max_watches)
+        : m_root(std::move(root))
+        , m_max_watches(max_watches) {
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported), "inotify is only available on linux");
+}
+
+InotifyWatcher::~InotifyWatcher() = default;
+
+bool InotifyWatcher::watch_tree(const std::string &) {
+    return false;
+}
+
+std::vector<WatchEvent> InotifyWatcher::read_events(std::chrono::milliseconds) {
+    return {};
+}
+
+void InotifyWatcher::interrupt() {}
+
+bool InotifyWatcher::add_watch(const std::string &) {
+    return false;
+}
+
+void InotifyWatcher::unwatch_tree(const std::string &) {}
+
+#endif
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CloudSync::sync {
+    /// @brief A change that has been seen by the `InotifyWatcher`.
+    struct WatchEvent {
+        enum class Type {
+            /// a file has been written to or moved into place
+            CHANGED,
+            /// a directory has been created or moved into the tree. It is watched already, but files may have been
+            /// added to it before that.
+            DIRECTORY_ADDED,
+            /// the kernel has dropped events, any file may have changed
+            OVERFLOW,
+        };
+
+        Type type;
+
+        /// generic path relative to the root. Empty for `OVERFLOW`.
+        std::string path;
+    };
+
+    /**
+     * Watches all directories of a local tree with inotify. Only available on linux.
+     *
+     * Every directory needs a watch of its own, and the number of watches is limited per user by
+     * `fs.inotify.max_user_watches`. Directories that can't be watched once the limit is reached are kept in
+     * `unwatched()`, along with everything below them, and can be retried later with `watch_tree()`.
+     */
+    class InotifyWatcher {
+    public:
+        /**
+         * @param root the directory to watch. Call `watch_tree("")` to start watching it.
+         * @param max_watches at most this many directories are watched, `0` for as many as the kernel allows.
+         * @throws std::system_error if no inotify instance can be created, or on systems other than linux.
+         */
+        explicit InotifyWatcher(std::filesystem::path root, std::size_t max_watches = 0);
+
+        ~InotifyWatcher();
+
+        InotifyWatcher(const InotifyWatcher &) = delete;
+
+        InotifyWatcher &operator=(const InotifyWatcher &) = delete;
+
+        /**
+         * Watches `directory` and all directories below it. Directories that have been moved are watched under
+         * their new path.
+         * @param directory generic path relative to the root. Empty for the root itself.
+         * @return `false` if the watch limit has been reached and some directories are left in `unwatched()`.
+         */
+        bool watch_tree(const std::string &directory);
+
+        /**
+         * Waits up to `timeout` for changes. Events of new directories are only reported once the directories are
+         * watched.
+         * @return the changes, empty if there have been none or `interrupt()` has been called.
+         */
+        std::vector<WatchEvent> read_events(std::chrono::milliseconds timeout);
+
+        /// Makes a running or the next call to `read_events()` return immediately. Can be called from any thread.
+        void interrupt();
+
+        /// @return the roots of the subtrees that aren't watched because the watch limit has been reached
+        [[nodiscard]] const std::set<std::string> &unwatched() const {
+            return m_unwatched;
+        }
+
+        [[nodiscard]] std::size_t watch_count() const {
+            return m_directories.size();
+        }
+
+    private:
+        const std::filesystem::path m_root;
+        const std::size_t m_max_watches;
+        int m_inotify_fd = -1;
+        /// eventfd that wakes up `read_events()`
+        int m_interrupt_fd = -1;
+        /// path of the directory behind each watch descriptor
+        std::unordered_map<int, std::string> m_directories;
+        std::set<std::string> m_unwatched;
+
+        /// @return `false` if the watch limit has been reached
+        bool add_watch(const std::string &directory);
+
+        /// Stops watching `directory` and everything below it, because it has been moved away.
+        void unwatch_tree(const std::string &directory);
+    };
+}
@@ -0,0 +1,343 @@
+#include "CloudSync/LocalWatcher.hpp"
+#include "CloudSync/exceptions/resource/ResourceException.hpp"
+#include "DebounceQueue.hpp"
+#include "InotifyWatcher.hpp"
+#include "UploadLog.hpp"
+#include "upload/ChunkedUpload.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <utility>
+
+using namespace CloudSync;
+using namespace CloudSync::sync;
+namespace fs = std::filesystem;
+
+namespace {
+    using Clock = DebounceQueue::Clock;
+
+    /// modification times may lag behind the clock a little, so scans look back this much further
+    constexpr auto MODIFICATION_TIME_SLACK = std::chrono::seconds(1);
+
+    /// @return what belongs to the sync with `state_file`, nothing if there is none
+    template<typename T>
+    std::optional<T> optional_for(const fs::path &state_file) {
+        if (state_file.empty()) {
+            return std::nullopt;
+        }
+        return T(state_file);
+    }
+}
+
+class LocalWatcher::Worker {
+public:
+    Worker(fs::path local_root, const std::shared_ptr<Directory> &remote_root, const LocalWatcherOptions &options,
+           UploadHandler on_upload)
+            : m_local_root(std::move(local_root))
+            // the caller may keep using its handle while the upload thread is running
+            , m_remote_root(remote_root->with_new_connection())
+            , m_rescan_interval(options.rescan_interval)
+            , m_on_upload(std::move(on_upload))
+            , m_state_file(options.state_file)
+            , m_state_files(optional_for<StateFiles>(options.state_file))
+            , m_upload_log(optional_for<UploadLog>(options.state_file))
+            , m_watcher(m_local_root, options.max_watches)
+            , m_scanned_since(fs::file_time_type::clock::now())
+            , m_queue(options.quiet_period, options.max_delay) {
+        m_watcher.watch_tree("");
+        m_unwatched = m_watcher.unwatched();
+        m_watch_thread = std::thread(&Worker::watch, this);
+        m_upload_thread = std::thread(&Worker::upload_queued, this);
+    }
+
+    ~Worker() {
+        stop();
+    }
+
+    void stop() {
+        if (!m_watch_thread.joinable()) {
+            return;
+        }
+        m_stopping = true;
+        m_watcher.interrupt();
+        m_watch_thread.join();
+        {
+            // the watch thread has pushed its last changes, the upload thread can empty the queue and finish
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_flushing = true;
+        }
+        m_queue_changed.notify_all();
+        m_upload_thread.join();
+    }
+
+    std::vector<fs::path> unwatched_directories() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return {m_unwatched.begin(), m_unwatched.end()};
+    }
+
+private:
+    const fs::path m_local_root;
+    const std::shared_ptr<Directory> m_remote_root;
+    const std::chrono::milliseconds m_rescan_interval;
+    const UploadHandler m_on_upload;
+    /// the files of the sync that uploads are recorded for, they aren't uploaded themselves
+    const fs::path m_state_file;
+    const std::optional<StateFiles> m_state_files;
+    const std::optional<UploadLog> m_upload_log;
+    /// the state as of its modification time, only loaded for files that haven't been uploaded since the start
+    SyncState m_state;
+    fs::file_time_type m_state_modified = fs::file_time_type::min();
+
+    /// only used by the watch thread, apart from `interrupt()`
+    InotifyWatcher m_watcher;
+    /// files that have been modified since this time are picked up by scans
+    fs::file_time_type m_scanned_since;
+    std::atomic<bool> m_stopping = false;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_queue_changed;
+    DebounceQueue m_queue;
+    bool m_flushing = false;
+    std::set<std::string> m_unwatched;
+
+    /// handles of the files that have been uploaded, only used by the upload thread
+    std::map<std::string, std::shared_ptr<File>> m_files;
+
+    std::thread m_watch_thread;
+    std::thread m_upload_thread;
+
+    void watch() {
+        auto next_rescan = Clock::now() + m_rescan_interval;
+        while (!m_stopping) {
+            const auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(next_rescan - Clock::now());
+            try {
+                std::vector<std::string> changed;
+                for (auto &event: m_watcher.read_events(timeout)) {
+                    switch (event.type) {
+                        case WatchEvent::Type::CHANGED:
+                            changed.push_back(std::move(event.path));
+                            break;
+                        case WatchEvent::Type::DIRECTORY_ADDED:
+                            // files may have been added before the directory was watched
+                            scan(event.path, fs::file_time_type::min(), changed);
+                            break;
+                        case WatchEvent::Type::OVERFLOW:
+                            scan("", m_scanned_since - MODIFICATION_TIME_SLACK, changed);
+                            break;
+                    }
+                }
+                if (Clock::now() >= next_rescan) {
+                    rescan(changed);
+                    next_rescan = Clock::now() + m_rescan_interval;
+                }
+                push(changed);
+            } catch (...) {
+                // nothing is seen anymore, changes are left to the next sync
+                report("", std::current_exception());
+                return;
+            }
+        }
+    }
+
+    /// Scans the directories that aren't watched and retries watching them.
+    void rescan(std::vector<std::string> &changed) {
+        const auto scan_start = fs::file_time_type::clock::now();
+        const auto since = m_scanned_since - MODIFICATION_TIME_SLACK;
+        const std::vector<std::string> unwatched(m_watcher.unwatched().begin(), m_watcher.unwatched().end());
+        for (const auto &directory: unwatched) {
+            m_watcher.watch_tree(directory);
+            scan(directory, since, changed);
+        }
+        m_scanned_since = scan_start;
+    }
+
+    /// Adds `directory` and everything below it that has been modified since `since` to `changed`.
+    void scan(const std::string &directory, fs::file_time_type since, std::vector<std::string> &changed) const {
+        const auto root = m_local_root / directory;
+        std::error_code error;
+        if (fs::last_write_time(root, error) >= since && !error) {
+            changed.push_back(directory);
+        }
+        fs::recursive_directory_iterator entry(root, fs::directory_options::skip_permission_denied, error);
+        for (; !error && entry != fs::recursive_directory_iterator(); entry.increment(error)) {
+            const auto status = entry->symlink_status(error);
+            if ((fs::is_regular_file(status) || fs::is_directory(status)) && entry->last_write_time(error) >= since) {
+                changed.push_back(entry->path().lexically_relative(m_local_root).generic_string());
+            }
+        }
+    }
+
+    void push(const std::vector<std::string> &changed) {
+        if (changed.empty() && m_watcher.unwatched() == m_unwatched) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto now = Clock::now();
+            for (const auto &path: changed) {
+                // the root itself is there already
+                if (!path.empty()) {
+                    m_queue.push(path, now);
+                }
+            }
+            m_unwatched = m_watcher.unwatched();
+        }
+        m_queue_changed.notify_one();
+    }
+
+    void upload_queued() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            const auto ready = m_queue.pop_ready(m_flushing ? Clock::time_point::max() : Clock::now());
+            if (ready.empty()) {
+                if (m_flushing) {
+                    return;
+                }
+                if (const auto next_ready = m_queue.next_ready()) {
+                    m_queue_changed.wait_until(lock, *next_ready);
+                } else {
+                    m_queue_changed.wait(lock);
+                }
+                continue;
+            }
+            lock.unlock();
+            for (const auto &path: ready) {
+                upload(path);
+            }
+            lock.lock();
+        }
+    }
+
+    void upload(const std::string &path) {
+        try {
+            const auto local_path = m_local_root / path;
+            std::error_code error;
+            const auto status = fs::symlink_status(local_path, error);
+            if (fs::is_directory(status)) {
+                m_remote_root->ensure_directory(path);
+            } else if (fs::is_regular_file(status)) {
+                if (m_state_files && m_state_files->contains(local_path)) {
+                    return;
+                }
+                const auto before = stat_file(local_path);
+                const auto file = upload_file(path, local_path);
+                // a file that has been written to during the upload is uploaded again once it is quiet
+                if (m_upload_log && before == stat_file(local_path)) {
+                    const auto &[size, modified] = before;
+                    m_upload_log->append(path, {ResourceInfo::Kind::FILE, "", file->revision(), size, modified});
+                }
+            } else {
+                // removed again before it has been uploaded, or a symlink or special file
+                return;
+            }
+            report(path, nullptr);
+        } catch (...) {
+            m_files.erase(path);
+            report(path, std::current_exception());
+        }
+    }
+
+    /// @return size & modification time of a local file, as recorded in the sync state
+    static std::pair<std::uint64_t, std::int64_t> stat_file(const fs::path &local_path) {
+        return {fs::file_size(local_path),
+                static_cast<std::int64_t>(fs::last_write_time(local_path).time_since_epoch().count())};
+    }
+
+    /// @return the handle of the uploaded file
+    std::shared_ptr<File> upload_file(const std::string &path, const fs::path &local_path) {
+        if (const auto known = m_files.find(path); known != m_files.end()) {
+            // fails with ResourceHasChanged if the file has been changed in the cloud since the last upload
+            known->second->upload(local_path);
+            return known->second;
+        }
+        std::shared_ptr<File> file;
+        try {
+            const upload::UploadSource source(local_path);
+            if (source.size() <= upload::ChunkedUpload::SINGLE_REQUEST_SIZE) {
+                file = m_remote_root->create_file(path, source.read(0, source.size()));
+            } else {
+                file = m_remote_root->create_file(path);
+                file->upload(local_path);
+            }
+        } catch (const exceptions::resource::ResourceConflict &) {
+            // there since before the watcher has been started, only replaced if it hasn't changed since the last sync
+            file = m_remote_root->get_file(path);
+            const auto synced = synced_revision(path);
+            if (synced.empty() || file->revision() != synced) {
+                throw;
+            }
+            file->upload(local_path);
+        }
+        m_files[path] = file;
+        return file;
+    }
+
+    /// @return the revision of the file in the cloud as of the last sync or upload, empty if it isn't known
+    std::string synced_revision(const std::string &path) {
+        if (!m_upload_log) {
+            return "";
+        }
+        const auto uploads = m_upload_log->records();
+        for (auto upload = uploads.rbegin(); upload != uploads.rend(); ++upload) {
+            if (upload->first == path) {
+                return upload->second.revision;
+            }
+        }
+        std::error_code error;
+        const auto modified = fs::last_write_time(m_state_file, error);
+        if (error) {
+            return "";
+        }
+        if (modified != m_state_modified) {
+            m_state = SyncState::load(m_state_file);
+            m_state_modified = modified;
+        }
+        const auto synced = m_state.entries.find(path);
+        if (synced == m_state.entries.end() || synced->second.kind != ResourceInfo::Kind::FILE) {
+            return "";
+        }
+        return synced->second.revision;
+    }
+
+    void report(const std::string &path, std::exception_ptr error) const {
+        if (m_on_upload) {
+            m_on_upload(path, std::move(error));
+        }
+    }
+};
+
+LocalWatcher::LocalWatcher(
+        fs::path local_root, std::shared_ptr<Directory> remote_root, LocalWatcherOptions options, UploadHandler on_upload)
+        : m_local_root(std::move(local_root))
+        , m_remote_root(std::move(remote_root))
+        , m_options(options)
+        , m_on_upload(std::move(on_upload)) {}
+
+LocalWatcher::~LocalWatcher() {
+    stop();
+}
+
+void LocalWatcher::start() {
+    if (!m_worker) {
+        m_worker = std::make_unique<Worker>(m_local_root, m_remote_root, m_options, m_on_upload);
+    }
+}
+
+void LocalWatcher::stop() {
+    if (m_worker) {
+        m_worker->stop();
+        m_worker.reset();
+    }
+}
+
+std::vector<fs::path> LocalWatcher::unwatched_directories() const {
+    if (!m_worker) {
+        return {};
+    }
+    return m_worker->unwatched_directories();
+}
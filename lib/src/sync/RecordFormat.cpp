@@ -0,0 +1,87 @@
+#include "RecordFormat.hpp"
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+std::string CloudSync::sync::escape_field(const std::string &value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (const char c: value) {
+        switch (c) {
+            case '\\': escaped += "\\\\"; break;
+            case '\t': escaped += "\\t"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            default: escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::string CloudSync::sync::unescape_field(const std::string &value) {
+    std::string unescaped;
+    unescaped.reserve(value.size());
+    for (std::size_t i = 0; i < value.size(); i++) {
+        if (value[i] != '\\' || i + 1 == value.size()) {
+            unescaped += value[i];
+            continue;
+        }
+        switch (value[++i]) {
+            case 't': unescaped += '\t'; break;
+            case 'n': unescaped += '\n'; break;
+            case 'r': unescaped += '\r'; break;
+            default: unescaped += value[i];
+        }
+    }
+    return unescaped;
+}
+
+std::vector<std::string> CloudSync::sync::split_fields(const std::string &record) {
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    while (true) {
+        const auto end = record.find('\t', start);
+        fields.push_back(record.substr(start, end == std::string::npos ? std::string::npos : end - start));
+        if (end == std::string::npos) {
+            return fields;
+        }
+        start = end + 1;
+    }
+}
+
+void CloudSync::sync::read_records(
+        const std::filesystem::path &file,
+        const std::string &header,
+        const std::string &kind,
+        const std::function<bool(const std::vector<std::string> &fields)> &apply) {
+    if (!std::filesystem::exists(file)) {
+        return;
+    }
+    std::ifstream input(file, std::ios::binary);
+    const std::string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    if (!input.eof() && input.fail()) {
+        throw std::runtime_error("reading the " + kind + " has failed: " + file.generic_string());
+    }
+    std::size_t start = 0;
+    bool is_header = true;
+    // a record without its line break has been cut off by a crash and is ignored
+    for (auto end = data.find('\n'); end != std::string::npos; start = end + 1, end = data.find('\n', start)) {
+        const auto line = data.substr(start, end - start);
+        if (is_header) {
+            if (line != header) {
+                throw std::runtime_error("missing header of the " + kind + ": " + file.generic_string());
+            }
+            is_header = false;
+            continue;
+        }
+        bool is_valid;
+        try {
+            is_valid = apply(split_fields(line));
+        } catch (const std::logic_error &) {
+            is_valid = false;
+        }
+        if (!is_valid) {
+            throw std::runtime_error("invalid record in " + kind + ": " + file.generic_string());
+        }
+    }
+}
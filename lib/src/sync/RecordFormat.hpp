@@ -0,0 +1,34 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * The state & the journal of a sync are text files with one record per line and tab separated fields.
+ */
+namespace CloudSync::sync {
+    /// Escapes the tabs & line breaks that separate fields & records, and the backslashes that escape them.
+    std::string escape_field(const std::string &value);
+
+    std::string unescape_field(const std::string &value);
+
+    /// @return the tab separated fields of a record, still escaped
+    std::vector<std::string> split_fields(const std::string &record);
+
+    /**
+     * Reads a file of records that starts with a `header` line. A last record without its line break has been cut off
+     * by a crash and is ignored.
+     * @param kind what the file is, for the error messages
+     * @param apply called with the fields of every record, still escaped. Returns false or throws std::logic_error if
+     *        the record is invalid.
+     * @throws std::runtime_error if the file can't be read, doesn't start with `header` or has an invalid record.
+     *         Nothing is read if the file doesn't exist.
+     */
+    void read_records(
+            const std::filesystem::path &file,
+            const std::string &header,
+            const std::string &kind,
+            const std::function<bool(const std::vector<std::string> &fields)> &apply);
+}
@@ -0,0 +1,747 @@
+#include "CloudSync/SyncEngine.hpp"
+#include "CloudSync/exceptions/resource/ResourceException.hpp"
+#include "FileImpl.hpp"
+#include "SyncPlanner.hpp"
+#include "SyncState.hpp"
+#include "TransferJournal.hpp"
+#include "UploadLog.hpp"
+#include "upload/ChunkedUpload.hpp"
+#include "util/Parallel.hpp"
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <utility>
+
+using namespace CloudSync;
+using namespace CloudSync::sync;
+namespace fs = std::filesystem;
+
+namespace {
+    using Kind = ResourceInfo::Kind;
+
+    /// downloads are written next to their file with this suffix and renamed once they are complete
+    const std::string PARTIAL_DOWNLOAD_SUFFIX = ".cloudsync.part";
+
+    std::int64_t ticks(fs::file_time_type time) {
+        return static_cast<std::int64_t>(time.time_since_epoch().count());
+    }
+
+    std::string parent_of(const std::string &path) {
+        const auto separator = path.rfind('/');
+        return separator == std::string::npos ? "" : path.substr(0, separator);
+    }
+
+    std::string child_of(const std::string &directory, const std::string &name) {
+        return directory.empty() ? name : directory + "/" + name;
+    }
+
+    bool ends_with(const std::string &value, const std::string &suffix) {
+        return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    fs::path with_suffix(fs::path path, const std::string &suffix) {
+        path += suffix;
+        return path;
+    }
+
+    fs::path journal_file(const fs::path &state_file) {
+        return with_suffix(state_file, ".journal");
+    }
+
+    /// @return the size & modification time of a local file, nothing if there is no regular file at `path`
+    std::optional<LocalEntry> stat_local_file(const fs::path &path) {
+        std::error_code error;
+        if (!fs::is_regular_file(fs::symlink_status(path, error))) {
+            return std::nullopt;
+        }
+        const auto size = fs::file_size(path, error);
+        const auto modified = fs::last_write_time(path, error);
+        if (error) {
+            return std::nullopt;
+        }
+        return LocalEntry{Kind::FILE, size, ticks(modified)};
+    }
+
+    /// @return the id of a file that has been created by a sync, as a listing would have reported it
+    std::string id_of(const std::shared_ptr<File> &file) {
+        const auto impl = std::dynamic_pointer_cast<FileImpl>(file);
+        return impl ? impl->id() : "";
+    }
+
+    bool same_file(const std::optional<LocalEntry> &first, const std::optional<LocalEntry> &second) {
+        if (!first || !second) {
+            return !first && !second;
+        }
+        return first->size == second->size && first->modified == second->modified;
+    }
+
+    /// Clears the revisions of the directories above `path`, so the next sync doesn't skip them.
+    void invalidate_parents(SyncState &state, const std::string &path) {
+        auto directory = path;
+        do {
+            directory = parent_of(directory);
+            if (const auto synced = state.entries.find(directory); synced != state.entries.end()) {
+                synced->second.revision.clear();
+            }
+        } while (!directory.empty());
+    }
+
+    LocalSnapshot scan_local(const fs::path &root, const fs::path &state_file) {
+        LocalSnapshot local;
+        const StateFiles state_files(state_file);
+        // symlinks to directories are not followed
+        for (const auto &entry: fs::recursive_directory_iterator(root)) {
+            const auto status = entry.symlink_status();
+            const auto path = entry.path().lexically_relative(root).generic_string();
+            if (fs::is_directory(status)) {
+                local[path] = {Kind::DIRECTORY};
+            } else if (fs::is_regular_file(status)) {
+                if (ends_with(path, PARTIAL_DOWNLOAD_SUFFIX) || state_files.contains(entry.path())) {
+                    continue;
+                }
+                local[path] = {Kind::FILE, entry.file_size(), ticks(entry.last_write_time())};
+            }
+        }
+        return local;
+    }
+
+    /// adds everything below `directory` as it has been after the last sync
+    void copy_state_tree(const SyncState &state, const std::string &directory, RemoteSnapshot &remote) {
+        const auto prefix = directory.empty() ? "" : directory + "/";
+        for (auto it = state.entries.lower_bound(prefix);
+             it != state.entries.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+            if (it->first.empty()) {
+                continue;
+            }
+            ResourceInfo info;
+            info.name = fs::path(it->first).filename().generic_string();
+            info.id = it->second.id;
+            info.revision = it->second.revision;
+            info.size = it->second.size;
+            info.kind = it->second.kind;
+            remote.emplace(it->first, std::move(info));
+        }
+    }
+
+    bool unchanged_revision(const SyncState &state, const std::string &directory, const std::string &revision) {
+        const auto synced = state.entries.find(directory);
+        return !revision.empty() && synced != state.entries.end() && synced->second.kind == Kind::DIRECTORY
+               && synced->second.revision == revision;
+    }
+
+    /**
+     * Lists the directory in the cloud breadth first.
+     * @param root_revision is set to the revision of the root if `prune` is set.
+     */
+    RemoteSnapshot scan_remote(
+            const std::shared_ptr<Directory> &root, const SyncState &state, bool prune, std::string &root_revision) {
+        RemoteSnapshot remote;
+        if (prune) {
+            // the handle may have been created without a network call and doesn't know its revision yet
+            root->poll_change();
+            root_revision = root->revision();
+            if (unchanged_revision(state, "", root_revision)) {
+                copy_state_tree(state, "", remote);
+                return remote;
+            }
+        }
+        std::deque<std::pair<std::string, std::shared_ptr<Directory>>> pending = {{"", root}};
+        while (!pending.empty()) {
+            const auto [path, directory] = pending.front();
+            pending.pop_front();
+            for (auto &info: directory->list_resource_info()) {
+                const auto child = child_of(path, info.name);
+                if (!info.is_file()) {
+                    if (prune && unchanged_revision(state, child, info.revision)) {
+                        copy_state_tree(state, child, remote);
+                    } else {
+                        pending.emplace_back(child, std::dynamic_pointer_cast<Directory>(directory->get_resource(info)));
+                    }
+                }
+                remote.emplace(child, std::move(info));
+            }
+        }
+        return remote;
+    }
+
+    /// handles for the resources in the cloud, created from the remote snapshot without network calls
+    class RemoteHandles {
+    public:
+        RemoteHandles(std::shared_ptr<Directory> root, const RemoteSnapshot &remote)
+                : m_root(std::move(root))
+                , m_remote(remote) {}
+
+        [[nodiscard]] const std::shared_ptr<Directory> &root() const {
+            return m_root;
+        }
+
+        std::shared_ptr<Directory> directory(const std::string &path) {
+            if (path.empty()) {
+                return m_root;
+            }
+            if (const auto known = m_directories.find(path); known != m_directories.end()) {
+                return known->second;
+            }
+            const auto parent = directory(parent_of(path));
+            std::shared_ptr<Directory> handle;
+            if (const auto info = m_remote.find(path); info != m_remote.end() && !info->second.is_file()) {
+                handle = std::dynamic_pointer_cast<Directory>(parent->get_resource(info->second));
+            } else {
+                // created by this sync, so it hasn't been listed
+                handle = parent->get_directory(fs::path(path).filename());
+            }
+            m_directories[path] = handle;
+            return handle;
+        }
+
+        std::shared_ptr<File> file(const std::string &path) {
+            return std::dynamic_pointer_cast<File>(directory(parent_of(path))->get_resource(m_remote.at(path)));
+        }
+
+    private:
+        const std::shared_ptr<Directory> m_root;
+        const RemoteSnapshot &m_remote;
+        std::map<std::string, std::shared_ptr<Directory>> m_directories;
+    };
+
+    /// Carries out the actions of a single sync and keeps the state up to date with what has been done.
+    class SyncRun {
+    public:
+        SyncRun(const fs::path &local_root,
+                const std::shared_ptr<Directory> &remote_root,
+                const LocalSnapshot &local,
+                const RemoteSnapshot &remote,
+                SyncState &state,
+                const fs::path &state_file,
+                TransferJournal &journal,
+                SyncResult &result)
+                : m_local_root(local_root)
+                , m_remote_root(remote_root)
+                , m_local(local)
+                , m_remote(remote)
+                , m_state(state)
+                , m_state_file(state_file)
+                , m_journal(journal)
+                , m_result(result) {}
+
+        void run(const std::vector<SyncAction> &actions, const SyncOptions &options) {
+            std::vector<std::string> remote_directories;
+            std::vector<std::string> remote_removals;
+            std::vector<std::string> local_removals;
+            std::vector<const SyncAction *> transfers;
+            // actions that only touch the state come first, so a failure later on can still invalidate it
+            for (const auto &action: actions) {
+                switch (action.type) {
+                    case SyncAction::Type::RECORD: record(action.path); break;
+                    case SyncAction::Type::FORGET: m_state.remove_tree(action.path); break;
+                    case SyncAction::Type::CONFLICT: conflict(action.path); break;
+                    case SyncAction::Type::CREATE_LOCAL_DIRECTORY: create_local_directory(action.path); break;
+                    case SyncAction::Type::CREATE_REMOTE_DIRECTORY: remote_directories.push_back(action.path); break;
+                    case SyncAction::Type::REMOVE_REMOTE: remote_removals.push_back(action.path); break;
+                    case SyncAction::Type::REMOVE_LOCAL: local_removals.push_back(action.path); break;
+                    case SyncAction::Type::UPLOAD:
+                    case SyncAction::Type::DOWNLOAD: transfers.push_back(&action); break;
+                }
+            }
+            create_remote_directories(remote_directories);
+            run_transfers(transfers, options);
+            // new files are in place before old ones are removed, so a moved file is never missing on both sides
+            remove_remote(remote_removals);
+            for (const auto &path: local_removals) {
+                remove_local(path);
+            }
+        }
+
+    private:
+        const fs::path &m_local_root;
+        const std::shared_ptr<Directory> &m_remote_root;
+        const LocalSnapshot &m_local;
+        const RemoteSnapshot &m_remote;
+        SyncState &m_state;
+        const fs::path &m_state_file;
+        TransferJournal &m_journal;
+        SyncResult &m_result;
+        /// guards the state & the result while transfers are running
+        std::mutex m_mutex;
+
+        [[nodiscard]] fs::path local_path(const std::string &path) const {
+            return m_local_root / fs::path(path);
+        }
+
+        /// @return true if the local file still looks like it did when it was scanned, or is still missing
+        [[nodiscard]] bool unchanged_since_scan(const std::string &path) const {
+            const auto file = local_path(path);
+            const auto scanned = m_local.find(path);
+            std::error_code error;
+            const auto status = fs::symlink_status(file, error);
+            if (scanned == m_local.end()) {
+                return !fs::exists(status);
+            }
+            return fs::is_regular_file(status)
+                   && fs::file_size(file) == scanned->second.size
+                   && ticks(fs::last_write_time(file)) == scanned->second.modified;
+        }
+
+        void record(const std::string &path) {
+            const auto &info = m_remote.at(path);
+            if (info.is_file()) {
+                m_state.entries[path] = {Kind::FILE, info.id, info.revision, info.size, m_local.at(path).modified};
+            } else {
+                m_state.entries[path] = {Kind::DIRECTORY, info.id, info.revision};
+            }
+        }
+
+        void conflict(const std::string &path) {
+            m_result.conflicts.emplace_back(path);
+            invalidate_parents(m_state, path);
+        }
+
+        void fail(const std::string &path, std::exception_ptr error) {
+            m_result.errors.push_back({path, std::move(error)});
+            invalidate_parents(m_state, path);
+        }
+
+        /// Records a transfer that has succeeded in the state & the journal. Needs the lock.
+        void commit(std::uint64_t transfer, const std::string &path, const SyncStateEntry &entry) {
+            m_state.entries[path] = entry;
+            m_journal.commit(transfer, entry);
+            compact_if_needed();
+        }
+
+        void abort(std::uint64_t transfer) {
+            try {
+                m_journal.abort(transfer);
+            } catch (const std::runtime_error &) {
+                // a transfer that is still pending in the journal is looked at again when the sync is resumed
+            }
+        }
+
+        /// Folds the finished transfers into the state file, so the journal doesn't grow with the size of a sync.
+        void compact_if_needed() {
+            if (m_journal.needs_compaction(m_state.entries.size())) {
+                m_state.save(m_state_file);
+                m_journal.compact();
+            }
+        }
+
+        [[nodiscard]] TransferIntent intent(const SyncAction &action) const {
+            TransferIntent intent;
+            intent.type = action.type == SyncAction::Type::UPLOAD ? TransferIntent::Type::UPLOAD
+                                                                   : TransferIntent::Type::DOWNLOAD;
+            intent.path = action.path;
+            if (const auto remote = m_remote.find(action.path); remote != m_remote.end()) {
+                intent.revision = remote->second.revision;
+            }
+            if (const auto local = m_local.find(action.path); local != m_local.end()) {
+                intent.local = local->second;
+            }
+            return intent;
+        }
+
+        void create_local_directory(const std::string &path) {
+            try {
+                fs::create_directories(local_path(path));
+                record(path);
+                m_result.created_directories++;
+            } catch (...) {
+                fail(path, std::current_exception());
+            }
+        }
+
+        void create_remote_directories(const std::vector<std::string> &paths) {
+            // every missing level has an action of its own, so no provider has to create intermediates
+            if (paths.empty()) {
+                return;
+            }
+            const auto results = m_remote_root->create_directories({paths.begin(), paths.end()});
+            for (const auto &result: results) {
+                const auto path = result.path.generic_string();
+                if (result.ok()) {
+                    m_state.entries[path] = {Kind::DIRECTORY, "", result.value->revision()};
+                    m_result.created_directories++;
+                } else {
+                    try {
+                        result.rethrow_if_failed();
+                    } catch (const exceptions::resource::ResourceConflict &) {
+                        conflict(path);
+                    } catch (...) {
+                        fail(path, std::current_exception());
+                    }
+                }
+            }
+        }
+
+        void run_transfers(const std::vector<const SyncAction *> &transfers, const SyncOptions &options) {
+            // every transfer is in the journal before the first one starts, so an interrupted sync knows all of them
+            std::vector<std::uint64_t> ids;
+            ids.reserve(transfers.size());
+            for (const auto *action: transfers) {
+                ids.push_back(m_journal.begin(intent(*action)));
+            }
+            m_journal.replace_previous();
+            if (options.scheduler) {
+                schedule_transfers(transfers, ids, options);
+                return;
+            }
+            const auto workers = std::min(transfers.size(), std::max<std::size_t>(options.max_parallel_transfers, 1));
+            std::vector<RemoteHandles> handles;
+            handles.reserve(workers);
+            for (std::size_t i = 0; i < workers; i++) {
+                handles.emplace_back(workers == 1 ? m_remote_root : m_remote_root->with_new_connection(), m_remote);
+            }
+            util::parallel_for(transfers.size(), workers, [&](std::size_t worker, std::size_t index) {
+                transfer(handles[worker], *transfers[index], ids[index]);
+            });
+        }
+
+        /**
+         * Runs the transfers in the background lane of the scheduler, at most `max_parallel_transfers` of them queued
+         * at once. Handles are taken from a pool, so connections are reused by later transfers.
+         */
+        void schedule_transfers(const std::vector<const SyncAction *> &transfers, const std::vector<std::uint64_t> &ids,
+                                const SyncOptions &options) {
+            const auto max_queued = std::max<std::size_t>(options.max_parallel_transfers, 1);
+            std::mutex pool_mutex;
+            std::vector<std::unique_ptr<RemoteHandles>> pool;
+            std::deque<std::pair<std::size_t, std::future<void>>> queued;
+            const auto rejected = [this, &transfers, &ids](std::size_t index) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                abort(ids[index]);
+                fail(transfers[index]->path, std::current_exception());
+            };
+            const auto wait_for_oldest = [&queued, &rejected] {
+                auto [index, done] = std::move(queued.front());
+                queued.pop_front();
+                try {
+                    done.get();
+                } catch (const exceptions::TransferRejected &) {
+                    rejected(index);
+                } catch (...) {
+                    // the transfer has recorded the failure itself, it is only rethrown for the scheduler
+                }
+            };
+            for (std::size_t index = 0; index < transfers.size(); index++) {
+                if (queued.size() >= max_queued) {
+                    wait_for_oldest();
+                }
+                try {
+                    queued.emplace_back(index, options.scheduler->submit(
+                            TransferLane::BACKGROUND, options.scheduler_host, [&, index] {
+                                std::unique_ptr<RemoteHandles> handles;
+                                {
+                                    std::lock_guard<std::mutex> lock(pool_mutex);
+                                    if (!pool.empty()) {
+                                        handles = std::move(pool.back());
+                                        pool.pop_back();
+                                    }
+                                }
+                                if (!handles) {
+                                    handles = std::make_unique<RemoteHandles>(
+                                            m_remote_root->with_new_connection(), m_remote);
+                                }
+                                const auto error = transfer(*handles, *transfers[index], ids[index]);
+                                {
+                                    std::lock_guard<std::mutex> lock(pool_mutex);
+                                    pool.push_back(std::move(handles));
+                                }
+                                // lets an adaptive scheduler see that the provider is throttling
+                                if (error) {
+                                    std::rethrow_exception(error);
+                                }
+                            }));
+                } catch (const exceptions::TransferRejected &) {
+                    rejected(index);
+                }
+            }
+            while (!queued.empty()) {
+                wait_for_oldest();
+            }
+        }
+
+        /**
+         * runs a single transfer and records how it has ended
+         * @return the exception the transfer has failed with, nothing if it has succeeded or ended in a conflict
+         */
+        std::exception_ptr transfer(RemoteHandles &handles, const SyncAction &action, std::uint64_t id) {
+            try {
+                if (action.type == SyncAction::Type::UPLOAD) {
+                    upload(handles, action.path, id);
+                } else {
+                    download(handles, action.path, id);
+                }
+            } catch (const exceptions::resource::ResourceHasChanged &) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                abort(id);
+                conflict(action.path);
+            } catch (const exceptions::resource::ResourceConflict &) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                abort(id);
+                conflict(action.path);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                abort(id);
+                fail(action.path, std::current_exception());
+                return std::current_exception();
+            }
+            return nullptr;
+        }
+
+        void upload(RemoteHandles &handles, const std::string &path, std::uint64_t transfer) {
+            const auto &scanned = m_local.at(path);
+            const auto file_path = local_path(path);
+            const auto remote_entry = m_remote.find(path);
+            std::shared_ptr<File> file;
+            if (remote_entry == m_remote.end()) {
+                // `create_file()` doesn't overwrite a file that has been added in the cloud in the meantime
+                const upload::UploadSource source(file_path);
+                if (source.size() <= upload::ChunkedUpload::SINGLE_REQUEST_SIZE) {
+                    file = handles.root()->create_file(path, source.read(0, source.size()));
+                } else {
+                    file = handles.root()->create_file(path);
+                    file->upload(file_path);
+                }
+            } else {
+                // the handle carries the revision of the listing, so the upload fails if the file has changed since
+                file = handles.file(path);
+                file->upload(file_path);
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            commit(transfer, path, {
+                    Kind::FILE,
+                    remote_entry == m_remote.end() ? id_of(file) : remote_entry->second.id,
+                    file->revision(),
+                    scanned.size,
+                    scanned.modified});
+            m_result.uploads++;
+            m_result.bytes_uploaded += scanned.size;
+        }
+
+        void download(RemoteHandles &handles, const std::string &path, std::uint64_t transfer) {
+            const auto &info = m_remote.at(path);
+            const auto data = handles.file(path)->read_binary();
+            const auto file_path = local_path(path);
+            const auto partial_path = with_suffix(file_path, PARTIAL_DOWNLOAD_SUFFIX);
+            fs::create_directories(file_path.parent_path());
+            {
+                std::ofstream output(partial_path, std::ios::binary | std::ios::trunc);
+                output.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+                if (!output) {
+                    throw fs::filesystem_error(
+                            "writing the download has failed", partial_path, std::make_error_code(std::errc::io_error));
+                }
+            }
+            if (!unchanged_since_scan(path)) {
+                // the local file has been changed while the download was running
+                fs::remove(partial_path);
+                throw exceptions::resource::ResourceHasChanged(path);
+            }
+            // the rename keeps the modification time, so a resumed sync can tell whether it has happened
+            const auto modified = ticks(fs::last_write_time(partial_path));
+            m_journal.written(transfer, {Kind::FILE, data.size(), modified});
+            fs::rename(partial_path, file_path);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            commit(transfer, path, {Kind::FILE, info.id, info.revision, data.size(), modified});
+            m_result.downloads++;
+            m_result.bytes_downloaded += data.size();
+        }
+
+        void remove_remote(const std::vector<std::string> &paths) {
+            if (paths.empty()) {
+                return;
+            }
+            const auto results = m_remote_root->remove_many({paths.begin(), paths.end()});
+            for (const auto &result: results) {
+                const auto path = result.path.generic_string();
+                try {
+                    result.rethrow_if_failed();
+                } catch (const exceptions::resource::NoSuchResource &) {
+                    // removed by someone else in the meantime
+                } catch (...) {
+                    fail(path, std::current_exception());
+                    continue;
+                }
+                m_state.remove_tree(path);
+                m_result.remote_removals++;
+            }
+        }
+
+        void remove_local(const std::string &path) {
+            try {
+                if (m_local.at(path).kind == Kind::FILE) {
+                    if (!unchanged_since_scan(path)) {
+                        conflict(path);
+                        return;
+                    }
+                    fs::remove(local_path(path));
+                } else {
+                    fs::remove_all(local_path(path));
+                }
+                m_state.remove_tree(path);
+                m_result.local_removals++;
+            } catch (...) {
+                fail(path, std::current_exception());
+            }
+        }
+    };
+}
+
+SyncEngine::SyncEngine(
+        std::filesystem::path local_root,
+        std::shared_ptr<Directory> remote_root,
+        std::filesystem::path state_file,
+        SyncOptions options)
+        : m_local_root(std::move(local_root))
+        , m_remote_root(std::move(remote_root))
+        , m_state_file(std::move(state_file))
+        , m_options(options) {}
+
+SyncResult SyncEngine::resume() {
+    SyncResult result;
+    const auto journal_path = journal_file(m_state_file);
+    if (!fs::exists(journal_path)) {
+        return result;
+    }
+    auto journal = TransferJournal::read(journal_path);
+    auto state = SyncState::load(m_state_file);
+    for (auto &[path, entry]: journal.committed) {
+        state.entries[path] = std::move(entry);
+    }
+    for (const auto &path: journal.aborted) {
+        invalidate_parents(state, path);
+    }
+
+    // the transfers that have been interrupted are looked up in the cloud all at once, nothing else is listed
+    RemoteSnapshot remote;
+    if (!journal.pending.empty()) {
+        std::vector<fs::path> paths;
+        for (const auto &[id, intent]: journal.pending) {
+            paths.emplace_back(intent.path);
+        }
+        for (auto &found: m_remote_root->stat_many(paths)) {
+            try {
+                found.rethrow_if_failed();
+            } catch (const exceptions::resource::NoSuchResource &) {
+                continue;
+            }
+            found.value.name = found.path.filename().generic_string();
+            remote.emplace(found.path.generic_string(), std::move(found.value));
+        }
+    }
+
+    LocalSnapshot local;
+    std::vector<SyncAction> actions;
+    for (const auto &pending: journal.pending) {
+        const auto &intent = pending.second;
+        const auto &path = intent.path;
+        const auto file_path = m_local_root / fs::path(path);
+        const auto current = stat_local_file(file_path);
+        const auto info = remote.find(path);
+        if (current) {
+            local[path] = *current;
+        }
+        if (intent.type == TransferIntent::Type::DOWNLOAD) {
+            const auto partial_path = with_suffix(file_path, PARTIAL_DOWNLOAD_SUFFIX);
+            const auto record_download = [&state, &path, &intent, &info, &remote] {
+                const auto &written = *intent.written;
+                const auto id = info != remote.end() ? info->second.id : "";
+                state.entries[path] = {Kind::FILE, id, intent.revision, written.size, written.modified};
+            };
+            if (intent.written && same_file(current, intent.written)) {
+                // interrupted after the download has been moved in place
+                record_download();
+                continue;
+            }
+            if (intent.written && same_file(stat_local_file(partial_path), intent.written)
+                && same_file(current, intent.local)) {
+                // interrupted before the download has been moved in place, and nothing has been changed since
+                fs::rename(partial_path, file_path);
+                local[path] = *intent.written;
+                record_download();
+                result.downloads++;
+                result.bytes_downloaded += intent.written->size;
+                continue;
+            }
+            std::error_code error;
+            fs::remove(partial_path, error);
+            if (same_file(current, intent.local) && info != remote.end() && info->second.revision == intent.revision) {
+                actions.push_back({SyncAction::Type::DOWNLOAD, path});
+                continue;
+            }
+        } else if (same_file(current, intent.local)) {
+            if (info == remote.end() ? intent.revision.empty() : info->second.revision == intent.revision) {
+                actions.push_back({SyncAction::Type::UPLOAD, path});
+                continue;
+            }
+            if (info != remote.end() && info->second.content_hash) {
+                // the upload may have finished without having been recorded
+                const auto &uploaded = info->second;
+                try {
+                    if (ContentHash::of_file(uploaded.content_hash->algorithm, file_path) == *uploaded.content_hash) {
+                        state.entries[path] = {
+                                Kind::FILE, uploaded.id, uploaded.revision, current->size, current->modified};
+                        continue;
+                    }
+                } catch (const fs::filesystem_error &) {
+                    // looked at again by the next sync
+                }
+            }
+        }
+        // either side has been changed since, which the next sync has to find out by listing the parents
+        invalidate_parents(state, path);
+    }
+
+    state.save(m_state_file);
+    if (!actions.empty()) {
+        // the interrupted journal stays until the resumed transfers have been begun in the new one
+        TransferJournal resumed(journal_path, true);
+        SyncRun(m_local_root, m_remote_root, local, remote, state, m_state_file, resumed, result)
+                .run(actions, m_options);
+        state.save(m_state_file);
+        resumed.remove();
+    }
+    fs::remove(journal_path);
+    return result;
+}
+
+SyncResult SyncEngine::sync() {
+    fs::create_directories(m_local_root);
+    auto result = resume();
+    auto state = SyncState::load(m_state_file);
+    const UploadLog upload_log(m_state_file);
+    if (auto uploads = upload_log.take(); !uploads.empty()) {
+        // files that a LocalWatcher has uploaded since the last sync are the same on both sides
+        for (auto &[path, entry]: uploads) {
+            state.entries[path] = std::move(entry);
+        }
+        state.save(m_state_file);
+        upload_log.release();
+    }
+    std::string root_revision;
+    const auto remote = scan_remote(m_remote_root, state, m_options.prune_unchanged_directories, root_revision);
+    const auto local = scan_local(m_local_root, m_state_file);
+    const auto actions = plan_sync(local, remote, state, [this, &remote](const std::string &path) {
+        // files that are the same on both sides don't need a transfer, if the provider reports a hash to compare
+        const auto &info = remote.at(path);
+        if (!info.content_hash) {
+            return false;
+        }
+        try {
+            return ContentHash::of_file(info.content_hash->algorithm, m_local_root / fs::path(path)) == *info.content_hash;
+        } catch (const fs::filesystem_error &) {
+            return false;
+        }
+    });
+    // cleared again if anything fails, so the next sync doesn't skip the whole tree
+    state.entries[""] = {Kind::DIRECTORY, "", root_revision};
+    TransferJournal journal(journal_file(m_state_file));
+    SyncRun(m_local_root, m_remote_root, local, remote, state, m_state_file, journal, result)
+            .run(actions, m_options);
+    state.save(m_state_file);
+    journal.remove();
+    return result;
+}
@@ -0,0 +1,179 @@
+#include "SyncPlanner.hpp"
+#include <set>
+
+using namespace CloudSync;
+using namespace CloudSync::sync;
+
+namespace {
+    using Kind = ResourceInfo::Kind;
+
+    template<typename MAP_T>
+    const typename MAP_T::mapped_type *find(const MAP_T &map, const std::string &path) {
+        const auto it = map.find(path);
+        return it == map.end() ? nullptr : &it->second;
+    }
+
+    bool has_prefix(const std::string &path, const std::string &prefix) {
+        return path.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    /// calls `operation` for every path below `directory` that is a key of `map`
+    template<typename MAP_T>
+    void for_each_below(const MAP_T &map, const std::string &directory, const std::function<void(const std::string &)> &operation) {
+        const auto prefix = directory + "/";
+        for (auto it = map.lower_bound(prefix); it != map.end() && has_prefix(it->first, prefix); ++it) {
+            operation(it->first);
+        }
+    }
+
+    class Planner {
+    public:
+        Planner(const LocalSnapshot &local, const RemoteSnapshot &remote, const SyncState &state)
+                : m_local(local)
+                , m_remote(remote)
+                , m_state(state.entries) {}
+
+        bool local_changed(const std::string &path) const {
+            const auto *local = find(m_local, path);
+            const auto *synced = find(m_state, path);
+            if (!local) {
+                return synced != nullptr;
+            }
+            if (!synced || synced->kind != local->kind) {
+                return true;
+            }
+            return local->kind == Kind::FILE
+                   && (local->size != synced->size || local->modified != synced->local_modified);
+        }
+
+        bool remote_changed(const std::string &path) const {
+            const auto *remote = find(m_remote, path);
+            const auto *synced = find(m_state, path);
+            if (!remote) {
+                return synced != nullptr;
+            }
+            if (!synced || synced->kind != remote->kind) {
+                return true;
+            }
+            // the revision of a directory changes with its content, which gets actions of its own
+            return remote->kind == Kind::FILE && remote->revision != synced->revision;
+        }
+
+        /// @return true if nothing at or below `directory` has been changed locally
+        bool local_tree_unchanged(const std::string &directory) const {
+            bool unchanged = !local_changed(directory);
+            const auto check = [this, &unchanged](const std::string &path) {
+                unchanged = unchanged && !local_changed(path);
+            };
+            for_each_below(m_local, directory, check);
+            for_each_below(m_state, directory, check);
+            return unchanged;
+        }
+
+        /// @return true if nothing at or below `directory` has been changed in the cloud
+        bool remote_tree_unchanged(const std::string &directory) const {
+            bool unchanged = !remote_changed(directory);
+            const auto check = [this, &unchanged](const std::string &path) {
+                unchanged = unchanged && !remote_changed(path);
+            };
+            for_each_below(m_remote, directory, check);
+            for_each_below(m_state, directory, check);
+            return unchanged;
+        }
+
+    private:
+        const LocalSnapshot &m_local;
+        const RemoteSnapshot &m_remote;
+        const std::map<std::string, SyncStateEntry> &m_state;
+    };
+}
+
+std::vector<SyncAction> CloudSync::sync::plan_sync(
+        const LocalSnapshot &local,
+        const RemoteSnapshot &remote,
+        const SyncState &state,
+        const std::function<bool(const std::string &path)> &same_content) {
+    std::set<std::string> paths;
+    for (const auto &entry: local) {
+        paths.insert(entry.first);
+    }
+    for (const auto &entry: remote) {
+        paths.insert(entry.first);
+    }
+    for (const auto &entry: state.entries) {
+        paths.insert(entry.first);
+    }
+    // the roots are always there
+    paths.erase("");
+
+    const Planner planner(local, remote, state);
+    std::vector<SyncAction> actions;
+    // Paths below these directories are covered by the action of the directory. Paths are ordered bytewise, so a
+    // sibling like `photos.old` may come between `photos` and its content. All ancestors of a path are checked.
+    std::set<std::string> covered_directories;
+    const auto add_tree_action = [&actions, &covered_directories](SyncAction::Type type, const std::string &path) {
+        actions.push_back({type, path});
+        covered_directories.insert(path);
+    };
+    const auto is_covered = [&covered_directories](const std::string &path) {
+        for (auto slash = path.find('/'); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+            if (covered_directories.count(path.substr(0, slash)) != 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+    for (const auto &path: paths) {
+        if (!covered_directories.empty() && is_covered(path)) {
+            continue;
+        }
+        const auto *local_entry = find(local, path);
+        const auto *remote_entry = find(remote, path);
+        const auto *synced = find(state.entries, path);
+        if (local_entry && remote_entry && local_entry->kind != remote_entry->kind) {
+            add_tree_action(SyncAction::Type::CONFLICT, path);
+            continue;
+        }
+        const auto kind = local_entry ? local_entry->kind : remote_entry ? remote_entry->kind : synced->kind;
+        const bool local_changed = planner.local_changed(path);
+        const bool remote_changed = planner.remote_changed(path);
+        if (kind == Kind::DIRECTORY) {
+            if (local_entry && remote_entry) {
+                if (!synced || synced->kind != Kind::DIRECTORY || synced->revision != remote_entry->revision) {
+                    actions.push_back({SyncAction::Type::RECORD, path});
+                }
+            } else if (local_entry) {
+                if (!synced || synced->kind != Kind::DIRECTORY) {
+                    actions.push_back({SyncAction::Type::CREATE_REMOTE_DIRECTORY, path});
+                } else if (planner.local_tree_unchanged(path)) {
+                    add_tree_action(SyncAction::Type::REMOVE_LOCAL, path);
+                } else {
+                    add_tree_action(SyncAction::Type::CONFLICT, path);
+                }
+            } else if (remote_entry) {
+                if (!synced || synced->kind != Kind::DIRECTORY) {
+                    actions.push_back({SyncAction::Type::CREATE_LOCAL_DIRECTORY, path});
+                } else if (planner.remote_tree_unchanged(path)) {
+                    add_tree_action(SyncAction::Type::REMOVE_REMOTE, path);
+                } else {
+                    add_tree_action(SyncAction::Type::CONFLICT, path);
+                }
+            } else {
+                add_tree_action(SyncAction::Type::FORGET, path);
+            }
+        } else if (local_changed && remote_changed) {
+            if (!local_entry && !remote_entry) {
+                actions.push_back({SyncAction::Type::FORGET, path});
+            } else if (local_entry && remote_entry && local_entry->size == remote_entry->size && same_content(path)) {
+                actions.push_back({SyncAction::Type::RECORD, path});
+            } else {
+                actions.push_back({SyncAction::Type::CONFLICT, path});
+            }
+        } else if (local_changed) {
+            actions.push_back({local_entry ? SyncAction::Type::UPLOAD : SyncAction::Type::REMOVE_REMOTE, path});
+        } else if (remote_changed) {
+            actions.push_back({remote_entry ? SyncAction::Type::DOWNLOAD : SyncAction::Type::REMOVE_LOCAL, path});
+        }
+    }
+    return actions;
+}
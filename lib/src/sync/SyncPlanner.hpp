@@ -0,0 +1,68 @@
+#pragma once
+
+#include "SyncState.hpp"
+#include "CloudSync/ResourceInfo.hpp"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace CloudSync::sync {
+    /// @brief A file or directory of the local tree, as found before a sync.
+    struct LocalEntry {
+        ResourceInfo::Kind kind = ResourceInfo::Kind::FILE;
+
+        /// size in bytes. Always `0` for directories.
+        std::uint64_t size = 0;
+
+        /// modification time, as a count of `std::filesystem::file_time_type` ticks
+        std::int64_t modified = 0;
+    };
+
+    /// local files & directories by their path relative to the local root, like the keys of SyncState
+    using LocalSnapshot = std::map<std::string, LocalEntry>;
+
+    /// resources in the cloud by their path relative to the remote root, like the keys of SyncState
+    using RemoteSnapshot = std::map<std::string, ResourceInfo>;
+
+    /// @brief A single step that brings a path in sync.
+    struct SyncAction {
+        enum class Type : std::uint8_t {
+            UPLOAD,
+            DOWNLOAD,
+            /// remove the resource in the cloud, including everything below it
+            REMOVE_REMOTE,
+            /// remove the local file or directory, including everything below it
+            REMOVE_LOCAL,
+            CREATE_REMOTE_DIRECTORY,
+            CREATE_LOCAL_DIRECTORY,
+            /// both sides are the same already, only the state has to be updated
+            RECORD,
+            /// the path is gone on both sides, only the state has to forget it
+            FORGET,
+            /// the path has been changed on both sides. Nothing is done and the state is kept.
+            CONFLICT
+        };
+
+        Type type;
+
+        std::string path;
+    };
+
+    /**
+     * Compares both sides with the state of the last sync. A file has been changed locally if its size or
+     * modification time differ from the state, and in the cloud if its revision differs. Only changed paths get an
+     * action, so unchanged trees cost nothing. Removing a directory is a single action if nothing below it has been
+     * changed on the other side, otherwise the whole directory is a conflict.
+     * @param same_content is asked for files that have been added or changed on both sides and have the same size.
+     *        If it returns `true` the files are recorded as synced instead of being reported as a conflict.
+     * @return the actions in the order of their paths, so the action for a directory comes before those of its
+     *         content.
+     */
+    std::vector<SyncAction> plan_sync(
+            const LocalSnapshot &local,
+            const RemoteSnapshot &remote,
+            const SyncState &state,
+            const std::function<bool(const std::string &path)> &same_content);
+}
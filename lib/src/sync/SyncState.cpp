@@ -0,0 +1,101 @@
+#include "SyncState.hpp"
+#include "RecordFormat.hpp"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace CloudSync;
+using namespace CloudSync::sync;
+
+namespace {
+    const std::string HEADER = "cloudsync-state 1";
+}
+
+SyncState SyncState::load(const std::filesystem::path &file) {
+    SyncState state;
+    if (!std::filesystem::exists(file)) {
+        return state;
+    }
+    std::ifstream input(file, std::ios::binary);
+    std::string line;
+    if (!input || !std::getline(input, line) || line != HEADER) {
+        throw std::runtime_error("not a sync state: " + file.generic_string());
+    }
+    while (std::getline(input, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        // kind, path, id, revision, size, local modification time
+        const auto fields = split_fields(line);
+        if (fields.size() != 6 || (fields[0] != "f" && fields[0] != "d")) {
+            throw std::runtime_error("invalid entry in sync state: " + file.generic_string());
+        }
+        SyncStateEntry entry;
+        entry.kind = fields[0] == "d" ? ResourceInfo::Kind::DIRECTORY : ResourceInfo::Kind::FILE;
+        entry.id = unescape_field(fields[2]);
+        entry.revision = unescape_field(fields[3]);
+        try {
+            entry.size = std::stoull(fields[4]);
+            entry.local_modified = std::stoll(fields[5]);
+        } catch (const std::logic_error &) {
+            throw std::runtime_error("invalid entry in sync state: " + file.generic_string());
+        }
+        state.entries[unescape_field(fields[1])] = std::move(entry);
+    }
+    return state;
+}
+
+void SyncState::save(const std::filesystem::path &file) const {
+    auto temporary_file = file;
+    temporary_file += ".tmp";
+    {
+        std::ofstream output(temporary_file, std::ios::binary | std::ios::trunc);
+        output << HEADER << '\n';
+        for (const auto &[path, entry]: entries) {
+            output << (entry.kind == ResourceInfo::Kind::DIRECTORY ? 'd' : 'f') << '\t'
+                   << escape_field(path) << '\t'
+                   << escape_field(entry.id) << '\t'
+                   << escape_field(entry.revision) << '\t'
+                   << entry.size << '\t'
+                   << entry.local_modified << '\n';
+        }
+        output.flush();
+        if (!output) {
+            throw std::runtime_error("writing the sync state has failed: " + temporary_file.generic_string());
+        }
+    }
+    std::filesystem::rename(temporary_file, file);
+}
+
+void SyncState::remove_tree(const std::string &path) {
+    if (path.empty()) {
+        entries.clear();
+        return;
+    }
+    entries.erase(path);
+    const auto prefix = path + "/";
+    // all keys that start with the prefix are next to each other in the map
+    auto it = entries.lower_bound(prefix);
+    while (it != entries.end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+        it = entries.erase(it);
+    }
+}
+
+StateFiles::StateFiles(const std::filesystem::path &state_file) {
+    const auto state_path = std::filesystem::weakly_canonical(state_file);
+    for (const auto *suffix: {"", ".tmp", ".journal", ".journal.tmp", ".uploads", ".uploads.taken"}) {
+        m_files.push_back(state_path.string() + suffix);
+    }
+}
+
+bool StateFiles::contains(const std::filesystem::path &file) const {
+    // only files with the same name need to be resolved
+    const auto has_name = [&file](const std::filesystem::path &state_file) {
+        return file.filename() == state_file.filename();
+    };
+    if (std::none_of(m_files.begin(), m_files.end(), has_name)) {
+        return false;
+    }
+    return std::find(m_files.begin(), m_files.end(), std::filesystem::weakly_canonical(file)) != m_files.end();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CloudSync/ResourceInfo.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace CloudSync::sync {
+    /// @brief What is known about a path since it has last been synced.
+    struct SyncStateEntry {
+        ResourceInfo::Kind kind = ResourceInfo::Kind::FILE;
+
+        /// provider specific id of the resource in the cloud, see `ResourceInfo::id`
+        std::string id;
+
+        /// revision of the resource in the cloud. May be empty for directories.
+        std::string revision;
+
+        /// size of the file, which has been the same locally and in the cloud. Always `0` for directories.
+        std::uint64_t size = 0;
+
+        /// modification time of the local file, as a count of `std::filesystem::file_time_type` ticks
+        std::int64_t local_modified = 0;
+
+        bool operator==(const SyncStateEntry &other) const {
+            return kind == other.kind && id == other.id && revision == other.revision && size == other.size
+                   && local_modified == other.local_modified;
+        }
+    };
+
+    /**
+     * The state of a local directory and the directory in the cloud it is synced with, as of the last sync.
+     *
+     * Keys are generic paths relative to both roots, without leading or trailing slashes. The roots themselves are
+     * kept under the empty path.
+     */
+    class SyncState {
+    public:
+        std::map<std::string, SyncStateEntry> entries;
+
+        /**
+         * Reads a state that has been written with `save()`.
+         * @return an empty state if `file` doesn't exist, as before the first sync.
+         * @throws std::runtime_error if the file can't be read or hasn't been written by `save()`.
+         */
+        static SyncState load(const std::filesystem::path &file);
+
+        /**
+         * Writes the state to a temporary file next to `file` and renames it, so an interrupted write leaves the
+         * previous state intact.
+         * @throws std::runtime_error if the file can't be written.
+         */
+        void save(const std::filesystem::path &file) const;
+
+        /// Removes the entry at `path` and all entries below it.
+        void remove_tree(const std::string &path);
+    };
+
+    /**
+     * The state file of a sync and the files that are kept next to it: the temporary file of `SyncState::save()`, the
+     * TransferJournal and the UploadLog. None of them is synced when the state is kept inside the synced directory.
+     */
+    class StateFiles {
+    public:
+        explicit StateFiles(const std::filesystem::path &state_file);
+
+        /// @return true if `file` is one of the files, also if it is reached through another path
+        [[nodiscard]] bool contains(const std::filesystem::path &file) const;
+
+    private:
+        std::vector<std::filesystem::path> m_files;
+    };
+}
@@ -0,0 +1,204 @@
+#include "TransferJournal.hpp"
+#include "RecordFormat.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+using namespace CloudSync;
+using namespace CloudSync::sync;
+namespace fs = std::filesystem;
+
+namespace {
+    const std::string HEADER = "cloudsync-journal 1";
+
+    // record types
+    const std::string BEGIN = "B";
+    const std::string WRITTEN = "W";
+    const std::string COMMIT = "C";
+    const std::string ABORT = "A";
+
+    std::string begin_record(std::uint64_t id, const TransferIntent &intent) {
+        std::ostringstream record;
+        record << BEGIN << '\t' << id << '\t'
+               << (intent.type == TransferIntent::Type::UPLOAD ? 'U' : 'D') << '\t'
+               << escape_field(intent.path) << '\t'
+               << escape_field(intent.revision) << '\t'
+               << (intent.local ? 1 : 0) << '\t'
+               << (intent.local ? intent.local->size : 0) << '\t'
+               << (intent.local ? intent.local->modified : 0);
+        return record.str();
+    }
+
+    std::string written_record(std::uint64_t id, const LocalEntry &written) {
+        std::ostringstream record;
+        record << WRITTEN << '\t' << id << '\t' << written.size << '\t' << written.modified;
+        return record.str();
+    }
+
+    std::string commit_record(std::uint64_t id, const std::string &path, const SyncStateEntry &entry) {
+        std::ostringstream record;
+        record << COMMIT << '\t' << id << '\t'
+               << escape_field(path) << '\t'
+               << escape_field(entry.id) << '\t'
+               << escape_field(entry.revision) << '\t'
+               << entry.size << '\t'
+               << entry.local_modified;
+        return record.str();
+    }
+
+    /// applies a single record to `contents`. @return false if the record is invalid
+    bool apply_record(const std::vector<std::string> &fields, TransferJournal::Contents &contents) {
+        const auto id = std::stoull(fields.at(1));
+        const auto &type = fields[0];
+        if (type == BEGIN && fields.size() == 8 && (fields[2] == "U" || fields[2] == "D")) {
+            TransferIntent intent;
+            intent.type = fields[2] == "U" ? TransferIntent::Type::UPLOAD : TransferIntent::Type::DOWNLOAD;
+            intent.path = unescape_field(fields[3]);
+            intent.revision = unescape_field(fields[4]);
+            if (fields[5] == "1") {
+                intent.local = LocalEntry{ResourceInfo::Kind::FILE, std::stoull(fields[6]), std::stoll(fields[7])};
+            }
+            contents.pending[id] = std::move(intent);
+        } else if (type == WRITTEN && fields.size() == 4) {
+            if (const auto pending = contents.pending.find(id); pending != contents.pending.end()) {
+                pending->second.written =
+                        LocalEntry{ResourceInfo::Kind::FILE, std::stoull(fields[2]), std::stoll(fields[3])};
+            }
+        } else if (type == COMMIT && fields.size() == 7) {
+            SyncStateEntry entry{ResourceInfo::Kind::FILE, unescape_field(fields[3]), unescape_field(fields[4]),
+                                 std::stoull(fields[5]), std::stoll(fields[6])};
+            contents.committed.emplace_back(unescape_field(fields[2]), std::move(entry));
+            contents.pending.erase(id);
+        } else if (type == ABORT && fields.size() == 2) {
+            if (const auto pending = contents.pending.find(id); pending != contents.pending.end()) {
+                contents.aborted.push_back(pending->second.path);
+                contents.pending.erase(pending);
+            }
+        } else {
+            return false;
+        }
+        return true;
+    }
+}
+
+TransferJournal::Contents TransferJournal::read(const fs::path &file) {
+    Contents contents;
+    read_records(file, HEADER, "transfer journal", [&contents](const std::vector<std::string> &fields) {
+        return apply_record(fields, contents);
+    });
+    return contents;
+}
+
+TransferJournal::TransferJournal(fs::path file, bool keep_previous)
+        : m_file(std::move(file))
+        , m_keeps_previous(keep_previous) {
+    m_output.open(m_keeps_previous ? staged_file() : m_file, std::ios::binary | std::ios::trunc);
+    append(HEADER);
+    m_records = 0;
+}
+
+void TransferJournal::replace_previous() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_keeps_previous) {
+        return;
+    }
+    m_output.close();
+    try {
+        fs::rename(staged_file(), m_file);
+    } catch (const fs::filesystem_error &e) {
+        throw std::runtime_error("replacing the transfer journal has failed: " + std::string(e.what()));
+    }
+    m_output.open(m_file, std::ios::binary | std::ios::app);
+    m_keeps_previous = false;
+}
+
+std::uint64_t TransferJournal::begin(const TransferIntent &intent) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto id = m_next_id++;
+    append(begin_record(id, intent));
+    m_pending[id] = intent;
+    return id;
+}
+
+void TransferJournal::written(std::uint64_t id, const LocalEntry &written) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    append(written_record(id, written));
+    m_pending.at(id).written = written;
+}
+
+void TransferJournal::commit(std::uint64_t id, const SyncStateEntry &entry) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto pending = m_pending.find(id);
+    append(commit_record(id, pending->second.path, entry));
+    m_pending.erase(pending);
+}
+
+void TransferJournal::abort(std::uint64_t id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    append(ABORT + '\t' + std::to_string(id));
+    m_pending.erase(id);
+}
+
+std::size_t TransferJournal::records() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_records;
+}
+
+std::size_t TransferJournal::pending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.size();
+}
+
+bool TransferJournal::needs_compaction(std::size_t state_entries) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_records >= std::max(MIN_COMPACTION_RECORDS, state_entries + m_pending.size());
+}
+
+void TransferJournal::compact() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_keeps_previous) {
+        // only a journal that has replaced the previous one is compacted, the previous one is still needed
+        return;
+    }
+    const auto temporary_file = staged_file();
+    {
+        std::ofstream output(temporary_file, std::ios::binary | std::ios::trunc);
+        output << HEADER << '\n';
+        for (const auto &[id, intent]: m_pending) {
+            output << begin_record(id, intent) << '\n';
+            if (intent.written) {
+                output << written_record(id, *intent.written) << '\n';
+            }
+        }
+        output.flush();
+        if (!output) {
+            throw std::runtime_error("writing the transfer journal has failed: " + temporary_file.generic_string());
+        }
+    }
+    m_output.close();
+    fs::rename(temporary_file, m_file);
+    m_output.open(m_file, std::ios::binary | std::ios::app);
+    // the pending transfers that have been written again don't count, they would be written by every compaction
+    m_records = 0;
+}
+
+void TransferJournal::remove() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_output.close();
+    fs::remove(m_keeps_previous ? staged_file() : m_file);
+}
+
+fs::path TransferJournal::staged_file() const {
+    auto staged = m_file;
+    staged += ".tmp";
+    return staged;
+}
+
+void TransferJournal::append(const std::string &record) {
+    m_output << record << '\n';
+    m_output.flush();
+    if (!m_output) {
+        throw std::runtime_error("writing the transfer journal has failed: " + m_file.generic_string());
+    }
+    m_records++;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "SyncPlanner.hpp"
+#include "SyncState.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CloudSync::sync {
+    /// @brief A transfer that has been started, as recorded in the TransferJournal.
+    struct TransferIntent {
+        enum class Type : std::uint8_t {
+            UPLOAD,
+            DOWNLOAD
+        };
+
+        Type type = Type::UPLOAD;
+
+        std::string path;
+
+        /// revision in the cloud that an upload replaces, empty for a new file, or that a download fetches
+        std::string revision;
+
+        /// the local file before the transfer, nothing if there hasn't been one
+        std::optional<LocalEntry> local;
+
+        /// the content of a download that has been written next to the file and is about to be moved in place
+        std::optional<LocalEntry> written;
+    };
+
+    /**
+     * Write-ahead log of the transfers of a sync. Transfers are recorded before they start and again once they have
+     * succeeded or failed, so a sync that has been interrupted can be resumed from the journal alone, without scanning
+     * either side.
+     *
+     * Records are appended as lines and flushed one by one, so they survive the process being killed. A line that
+     * has only been written in part is ignored. Once the journal has grown enough, see `needs_compaction()`, it should
+     * be compacted: the state is saved and the journal rewritten with the pending transfers only.
+     * @note All methods are thread-safe.
+     */
+    class TransferJournal {
+    public:
+        /// the journal isn't compacted before this many records have been appended
+        static constexpr std::size_t MIN_COMPACTION_RECORDS = 1024;
+
+        /// @brief What a journal tells about an interrupted sync.
+        struct Contents {
+            /// transfers that have neither succeeded nor failed, by their id
+            std::map<std::uint64_t, TransferIntent> pending;
+
+            /// state entries of the transfers that have succeeded, in the order they have been recorded
+            std::vector<std::pair<std::string, SyncStateEntry>> committed;
+
+            /// paths of the transfers that have failed
+            std::vector<std::string> aborted;
+        };
+
+        /**
+         * @return the contents of the journal at `file`, empty if there is none.
+         * @throws std::runtime_error if the file can't be read or hasn't been written by a TransferJournal.
+         */
+        static Contents read(const std::filesystem::path &file);
+
+        /**
+         * Starts a new journal at `file`, replacing a previous one.
+         * @param keep_previous if true, the records are written to a temporary file next to `file` and a previous
+         * journal stays in place until `replace_previous()`, so its transfers aren't lost before they have been begun
+         * again.
+         * @throws std::runtime_error if the file can't be written.
+         */
+        explicit TransferJournal(std::filesystem::path file, bool keep_previous = false);
+
+        /// @return the id of the transfer, to record its progress with
+        std::uint64_t begin(const TransferIntent &intent);
+
+        /**
+         * Moves a journal that has kept the previous one in its place, atomically. Does nothing for any other journal.
+         * @throws std::runtime_error if the file can't be moved.
+         */
+        void replace_previous();
+
+        /// Records that a download has been written to a temporary file of `written` size & modification time.
+        void written(std::uint64_t id, const LocalEntry &written);
+
+        /// Records that a transfer has succeeded and the state of its path is `entry` now.
+        void commit(std::uint64_t id, const SyncStateEntry &entry);
+
+        /// Records that a transfer has failed and its path has to be looked at by the next sync.
+        void abort(std::uint64_t id);
+
+        /// @return number of records that have been appended since the journal has been started or compacted
+        [[nodiscard]] std::size_t records() const;
+
+        /// @return number of transfers that have neither succeeded nor failed
+        [[nodiscard]] std::size_t pending() const;
+
+        /**
+         * A compaction writes the whole state and all pending transfers, so it is only worth it once at least as many
+         * records have been appended since the last one. That keeps the cost of the compactions of a sync linear in
+         * the number of its transfers.
+         * @param state_entries number of entries of the state that would be saved
+         * @return true if the journal should be compacted now
+         */
+        [[nodiscard]] bool needs_compaction(std::size_t state_entries) const;
+
+        /**
+         * Rewrites the journal with the pending transfers only, once the state that the other records have been
+         * applied to has been saved. The new journal replaces the old one atomically.
+         * @throws std::runtime_error if the file can't be written.
+         */
+        void compact();
+
+        /// Removes the journal once the state of a finished sync has been saved. A kept previous journal stays.
+        void remove();
+
+    private:
+        const std::filesystem::path m_file;
+        mutable std::mutex m_mutex;
+        std::ofstream m_output;
+        std::map<std::uint64_t, TransferIntent> m_pending;
+        std::uint64_t m_next_id = 1;
+        std::size_t m_records = 0;
+        bool m_keeps_previous;
+
+        /// @return the file that records are written to until the journal replaces the previous one
+        [[nodiscard]] std::filesystem::path staged_file() const;
+
+        /// writes & flushes a single line
+        void append(const std::string &record);
+    };
+}
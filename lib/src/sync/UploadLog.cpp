@@ -0,0 +1,98 @@
+#include "UploadLog.hpp"
+#include "RecordFormat.hpp"
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+using namespace CloudSync;
+using namespace CloudSync::sync;
+namespace fs = std::filesystem;
+
+namespace {
+    const std::string HEADER = "cloudsync-uploads 1";
+
+    /// the watcher & the engine of a sync have a log object each, so appending & taking is serialized for all of them
+    std::mutex log_mutex;
+
+    using Records = std::vector<std::pair<std::string, SyncStateEntry>>;
+
+    std::string record(const std::string &path, const SyncStateEntry &entry) {
+        std::ostringstream record;
+        record << escape_field(path) << '\t'
+               << escape_field(entry.id) << '\t'
+               << escape_field(entry.revision) << '\t'
+               << entry.size << '\t'
+               << entry.local_modified;
+        return record.str();
+    }
+
+    void append_records(const fs::path &file, const Records &records) {
+        std::ofstream output(file, std::ios::binary | std::ios::app);
+        if (output.tellp() == 0) {
+            output << HEADER << '\n';
+        }
+        for (const auto &[path, entry]: records) {
+            output << record(path, entry) << '\n';
+        }
+        output.flush();
+        if (!output) {
+            throw std::runtime_error("writing the upload log has failed: " + file.generic_string());
+        }
+    }
+
+    Records read_uploads(const fs::path &file) {
+        Records records;
+        read_records(file, HEADER, "upload log", [&records](const std::vector<std::string> &fields) {
+            // path, id, revision, size, local modification time
+            if (fields.size() != 5) {
+                return false;
+            }
+            SyncStateEntry entry;
+            entry.id = unescape_field(fields[1]);
+            entry.revision = unescape_field(fields[2]);
+            entry.size = std::stoull(fields[3]);
+            entry.local_modified = std::stoll(fields[4]);
+            records.emplace_back(unescape_field(fields[0]), std::move(entry));
+            return true;
+        });
+        return records;
+    }
+}
+
+UploadLog::UploadLog(const fs::path &state_file)
+        : m_file(fs::path(state_file) += ".uploads")
+        , m_taken_file(fs::path(state_file) += ".uploads.taken") {}
+
+void UploadLog::append(const std::string &path, const SyncStateEntry &entry) const {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    append_records(m_file, {{path, entry}});
+}
+
+std::vector<std::pair<std::string, SyncStateEntry>> UploadLog::take() const {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (fs::exists(m_file)) {
+        if (fs::exists(m_taken_file)) {
+            // a sync has been interrupted before it has released the records it has taken
+            append_records(m_taken_file, read_uploads(m_file));
+            fs::remove(m_file);
+        } else {
+            fs::rename(m_file, m_taken_file);
+        }
+    }
+    return read_uploads(m_taken_file);
+}
+
+std::vector<std::pair<std::string, SyncStateEntry>> UploadLog::records() const {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    auto records = read_uploads(m_taken_file);
+    auto appended = read_uploads(m_file);
+    records.insert(records.end(), std::make_move_iterator(appended.begin()), std::make_move_iterator(appended.end()));
+    return records;
+}
+
+void UploadLog::release() const {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    fs::remove(m_taken_file);
+}
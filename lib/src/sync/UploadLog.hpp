@@ -0,0 +1,53 @@
+#pragma once
+
+#include "SyncState.hpp"
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CloudSync::sync {
+    /**
+     * Uploads that have been made in between syncs, by a LocalWatcher. They are recorded next to the sync state, so
+     * the next sync takes the files as synced instead of as changed on both sides.
+     *
+     * The watcher appends records while the state is owned by the SyncEngine. The engine takes the records over with
+     * `take()` before it plans a sync and calls `release()` once the state they have been applied to has been saved,
+     * so an interrupted sync takes them again.
+     * @note All methods are thread-safe within a process. Records that are appended by another process while they
+     * are taken over may be lost, which leaves their files to be resolved as conflicts by the next sync.
+     */
+    class UploadLog {
+    public:
+        /// @param state_file the state of the sync that the uploads belong to
+        explicit UploadLog(const std::filesystem::path &state_file);
+
+        /**
+         * Records that the local file at `path` has been uploaded and the state of `path` is `entry` now.
+         * @throws std::runtime_error if the log can't be written.
+         */
+        void append(const std::string &path, const SyncStateEntry &entry) const;
+
+        /**
+         * @return the records that have been appended since the last `release()`, in the order of their uploads.
+         * @throws std::runtime_error if the log can't be read or hasn't been written by an UploadLog.
+         */
+        [[nodiscard]] std::vector<std::pair<std::string, SyncStateEntry>> take() const;
+
+        /**
+         * @return all records that haven't been released yet, taken or not, in the order of their uploads. Unlike
+         * `take()` this leaves them where they are.
+         * @throws std::runtime_error if the log can't be read or hasn't been written by an UploadLog.
+         */
+        [[nodiscard]] std::vector<std::pair<std::string, SyncStateEntry>> records() const;
+
+        /// Removes the records that have been taken, once the state they have been applied to has been saved.
+        void release() const;
+
+    private:
+        /// records are appended to this file
+        const std::filesystem::path m_file;
+        /// and moved to this one when they are taken
+        const std::filesystem::path m_taken_file;
+    };
+}
@@ -0,0 +1,227 @@
+#include "ChunkedUpload.hpp"
+#include "CloudSync/exceptions/cloud/CloudException.hpp"
+#include "request/exceptions/RequestException.hpp"
+#include "util/Parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+using namespace CloudSync;
+using namespace CloudSync::upload;
+
+UploadSource::UploadSource(std::filesystem::path path)
+        : m_path(std::move(path))
+        , m_size(std::filesystem::file_size(m_path)) {}
+
+std::vector<std::uint8_t> UploadSource::read(std::uint64_t offset, std::size_t length) const {
+    std::vector<std::uint8_t> data(length);
+    std::ifstream stream(m_path, std::ios::binary);
+    stream.seekg(static_cast<std::streamoff>(offset));
+    stream.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(length));
+    if (!stream || static_cast<std::size_t>(stream.gcount()) != length) {
+        throw std::filesystem::filesystem_error(
+                "cannot read chunk of file to upload", m_path, std::make_error_code(std::errc::io_error));
+    }
+    return data;
+}
+
+const std::size_t ChunkSizer::INITIAL_CHUNK_SIZE = 8 * 1024 * 1024;
+
+const std::size_t ChunkSizer::MAX_CHUNK_SIZE = 64 * 1024 * 1024;
+
+const std::chrono::steady_clock::duration ChunkSizer::TARGET_CHUNK_DURATION = std::chrono::seconds(4);
+
+ChunkSizer::ChunkSizer(const UploadSession::Limits &limits)
+        : m_min_size(std::max<std::size_t>(limits.min_chunk_size, 1))
+        , m_max_size(std::max(std::min(limits.max_chunk_size, MAX_CHUNK_SIZE), m_min_size))
+        , m_granularity(std::max<std::size_t>(limits.chunk_granularity, 1))
+        , m_current(clamp(INITIAL_CHUNK_SIZE)) {}
+
+std::size_t ChunkSizer::next(std::uint64_t remaining) const {
+    return static_cast<std::size_t>(std::min<std::uint64_t>(m_current, remaining));
+}
+
+void ChunkSizer::succeeded(std::size_t chunk_size, std::chrono::steady_clock::duration duration) {
+    if (chunk_size < m_current) {
+        // the last chunk says little about the throughput
+        return;
+    }
+    if (duration < TARGET_CHUNK_DURATION / 2) {
+        m_current = clamp(m_current * 2);
+    } else if (duration > TARGET_CHUNK_DURATION * 2) {
+        m_current = clamp(m_current / 2);
+    }
+}
+
+void ChunkSizer::failed() {
+    m_current = clamp(m_current / 2);
+}
+
+std::size_t ChunkSizer::clamp(std::size_t size) const {
+    size = std::min(std::max(size, m_min_size), m_max_size);
+    // rounding down must not go below the minimum, which isn't necessarily a multiple of the granularity
+    const auto rounded = size - size % m_granularity;
+    return rounded >= m_min_size ? rounded : rounded + m_granularity;
+}
+
+const std::size_t ChunkedUpload::SINGLE_REQUEST_SIZE = 4 * 1024 * 1024;
+
+const std::size_t ChunkedUpload::MAX_CHUNK_RETRIES = 3;
+
+const std::chrono::milliseconds ChunkedUpload::RETRY_DELAY = std::chrono::milliseconds(500);
+
+void ChunkedUpload::run() {
+    const auto limits = m_session.limits(m_source.size());
+    m_session.start(m_source.size());
+    if (limits.parallel_chunks) {
+        this->run_parallel(limits);
+    } else {
+        this->run_sequential(limits);
+    }
+    m_session.finish(m_source.size());
+}
+
+void ChunkedUpload::run_sequential(const UploadSession::Limits &limits) {
+    ChunkSizer sizer(limits);
+    const auto total_size = m_source.size();
+    std::uint64_t offset = 0;
+    std::size_t index = 0;
+    std::size_t retries = 0;
+    while (offset < total_size) {
+        const auto length = sizer.next(total_size - offset);
+        const Chunk chunk{index, offset, m_source.read(offset, length), offset + length == total_size};
+        std::this_thread::sleep_until(m_controller.paused_until());
+        const auto started = std::chrono::steady_clock::now();
+        try {
+            m_session.upload_chunk(m_request, chunk);
+            const auto duration = std::chrono::steady_clock::now() - started;
+            m_controller.succeeded(duration);
+            sizer.succeeded(length, duration);
+            offset += length;
+            index++;
+            retries = 0;
+        } catch (...) {
+            m_controller.report(std::chrono::steady_clock::now() - started, std::current_exception());
+            if (!is_retryable() || ++retries > MAX_CHUNK_RETRIES) {
+                throw;
+            }
+            sizer.failed();
+            std::this_thread::sleep_for(retry_delay(retries));
+            // the server may have stored part of the chunk, or none of it
+            if (const auto received = m_session.received_bytes(m_request)) {
+                offset = *received;
+            }
+        }
+    }
+}
+
+void ChunkedUpload::run_parallel(const UploadSession::Limits &limits) {
+    ChunkSizer sizer(limits);
+    const auto total_size = m_source.size();
+    std::mutex mutex;
+    std::uint64_t next_offset = 0;
+    std::size_t next_index = 0;
+    std::atomic<bool> failed{false};
+    // no more workers than there are chunks of the initial size
+    const auto initial_chunk_size = std::max<std::uint64_t>(sizer.next(total_size), 1);
+    const auto workers = static_cast<std::size_t>(std::min<std::uint64_t>(
+            m_controller.limit(), (total_size + initial_chunk_size - 1) / initial_chunk_size));
+    // every worker gets a request of its own, the credentials refresh their token on the shared one
+    std::vector<std::shared_ptr<request::Request>> requests;
+    for (std::size_t i = 0; i < workers; i++) {
+        requests.push_back(m_request->clone());
+    }
+    util::parallel_for(workers, workers, [&](std::size_t worker, std::size_t) {
+        while (!failed && may_send(worker)) {
+            Chunk chunk;
+            std::size_t length;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (next_offset >= total_size) {
+                    return;
+                }
+                length = sizer.next(total_size - next_offset);
+                chunk.index = next_index++;
+                chunk.offset = next_offset;
+                chunk.last = next_offset + length == total_size;
+                next_offset += length;
+            }
+            chunk.data = m_source.read(chunk.offset, length);
+            for (std::size_t retries = 0;; retries++) {
+                if (retries != 0) {
+                    // retries go on regardless of the limit, the chunk has been taken already
+                    std::this_thread::sleep_until(m_controller.paused_until());
+                }
+                const auto started = std::chrono::steady_clock::now();
+                try {
+                    m_session.upload_chunk(requests[worker], chunk);
+                    const auto duration = std::chrono::steady_clock::now() - started;
+                    m_controller.succeeded(duration);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    sizer.succeeded(length, duration);
+                    break;
+                } catch (...) {
+                    m_controller.report(std::chrono::steady_clock::now() - started, std::current_exception());
+                    if (failed || !is_retryable() || retries >= MAX_CHUNK_RETRIES) {
+                        failed = true;
+                        throw;
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        sizer.failed();
+                    }
+                    std::this_thread::sleep_for(retry_delay(retries + 1));
+                }
+            }
+        }
+    });
+}
+
+bool ChunkedUpload::may_send(std::size_t worker) const {
+    if (worker != 0 && worker >= m_controller.limit()) {
+        return false;
+    }
+    std::this_thread::sleep_until(m_controller.paused_until());
+    return true;
+}
+
+std::string ChunkedUpload::content_range(std::uint64_t offset, std::size_t length, std::uint64_t total_size) {
+    return "bytes " + std::to_string(offset) + "-" + std::to_string(offset + length - 1) + "/"
+           + std::to_string(total_size);
+}
+
+bool ChunkedUpload::is_retryable() {
+    try {
+        std::rethrow_exception(std::current_exception());
+    } catch (const request::exceptions::RequestException &) {
+        return true;
+    } catch (const request::exceptions::response::ServerError &) {
+        return true;
+    } catch (const request::exceptions::response::ClientError &e) {
+        // 408 Request Timeout, 429 Too Many Requests
+        return e.code == 408 || e.code == 429;
+    } catch (...) {
+        return false;
+    }
+}
+
+std::chrono::steady_clock::duration ChunkedUpload::retry_delay(std::size_t retry) {
+    std::chrono::steady_clock::duration delay = RETRY_DELAY * retry;
+    std::optional<std::chrono::seconds> retry_after;
+    try {
+        std::rethrow_exception(std::current_exception());
+    } catch (const request::exceptions::response::TooManyRequests &e) {
+        retry_after = e.retry_after;
+    } catch (const request::exceptions::response::ServiceUnavailable &e) {
+        retry_after = e.retry_after;
+    } catch (const exceptions::cloud::Throttled &e) {
+        retry_after = e.retry_after;
+    } catch (...) {
+        // the server hasn't said how long to wait
+    }
+    // sending the chunk earlier than the server has asked for would only be throttled again
+    return retry_after ? std::max(delay, std::chrono::steady_clock::duration(*retry_after)) : delay;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "CloudSync/ConcurrencyController.hpp"
+#include "request/Request.hpp"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace CloudSync::upload {
+    /// Reads ranges of a local file. Every read opens the file on its own, so reads may happen on several threads.
+    class UploadSource {
+    public:
+        /// @throws std::filesystem::filesystem_error if the size of the file can't be read
+        explicit UploadSource(std::filesystem::path path);
+
+        [[nodiscard]] std::uint64_t size() const {
+            return m_size;
+        }
+
+        [[nodiscard]] const std::filesystem::path &path() const {
+            return m_path;
+        }
+
+        /// @throws std::filesystem::filesystem_error if the range can't be read
+        [[nodiscard]] std::vector<std::uint8_t> read(std::uint64_t offset, std::size_t length) const;
+
+    private:
+        const std::filesystem::path m_path;
+        const std::uint64_t m_size;
+    };
+
+    /// a part of the file that is sent with a single request
+    struct Chunk {
+        /// position of the chunk in the file, starting at `0`
+        std::size_t index = 0;
+        std::uint64_t offset = 0;
+        std::vector<std::uint8_t> data;
+        /// `true` for the chunk that ends at the end of the file
+        bool last = false;
+    };
+
+    /**
+     * The provider specific part of a chunked upload. Sessions are used for a single upload only.
+     */
+    class UploadSession {
+    public:
+        virtual ~UploadSession() = default;
+
+        /// what the provider accepts for chunks
+        struct Limits {
+            /// smallest size of a chunk, except for the last one
+            std::size_t min_chunk_size;
+            std::size_t max_chunk_size;
+            /// all chunks except for the last one have to be a multiple of this
+            std::size_t chunk_granularity;
+            /// `false` if chunks must arrive in order, otherwise chunks are sent at once as far as the endpoint allows
+            bool parallel_chunks;
+        };
+
+        [[nodiscard]] virtual Limits limits(std::uint64_t total_size) const = 0;
+
+        /// opens the session on the server
+        virtual void start(std::uint64_t total_size) = 0;
+
+        /**
+         * Sends a single chunk. If the session allows parallel chunks, this is called from several threads at once,
+         * each with its own request.
+         */
+        virtual void upload_chunk(const std::shared_ptr<request::Request> &request, const Chunk &chunk) = 0;
+
+        /**
+         * Asks the server how much of the file it has, after a chunk has failed.
+         * @return the offset to continue at, or `std::nullopt` if the failed chunk can be sent again as it is.
+         */
+        virtual std::optional<std::uint64_t> received_bytes(const std::shared_ptr<request::Request> &/*request*/) {
+            return std::nullopt;
+        }
+
+        /// commits the upload, once all chunks have been sent
+        virtual void finish(std::uint64_t total_size) = 0;
+    };
+
+    /**
+     * Picks the size of the next chunk so that a chunk takes about TARGET_CHUNK_DURATION to upload. Starts at
+     * INITIAL_CHUNK_SIZE, doubles while chunks are fast and halves after slow or failed ones.
+     */
+    class ChunkSizer {
+    public:
+        explicit ChunkSizer(const UploadSession::Limits &limits);
+
+        /// @return size of the next chunk, which is at most `remaining`
+        [[nodiscard]] std::size_t next(std::uint64_t remaining) const;
+
+        void succeeded(std::size_t chunk_size, std::chrono::steady_clock::duration duration);
+
+        void failed();
+
+        static const std::size_t INITIAL_CHUNK_SIZE;
+        /// upper bound for all providers, as chunks are held in memory
+        static const std::size_t MAX_CHUNK_SIZE;
+        static const std::chrono::steady_clock::duration TARGET_CHUNK_DURATION;
+
+    private:
+        const std::size_t m_min_size;
+        const std::size_t m_max_size;
+        const std::size_t m_granularity;
+        std::size_t m_current;
+
+        [[nodiscard]] std::size_t clamp(std::size_t size) const;
+    };
+
+    /**
+     * Uploads a local file through an UploadSession. A chunk that fails with a network error, a server error or a
+     * 429 is sent again, up to MAX_CHUNK_RETRIES times, after RETRY_DELAY times the number of the retry or the
+     * `Retry-After` of the response, whichever is longer. For sessions that need chunks in order, the upload continues
+     * at whatever the server reports to have received.
+     *
+     * Every chunk is reported to a ConcurrencyController, which decides how many chunks of a session that allows
+     * parallel chunks are sent at once. No chunk is sent while the controller is paused.
+     */
+    class ChunkedUpload {
+    public:
+        /// @param controller usually the one of the endpoint, from `util::endpoint_controller()`
+        ChunkedUpload(std::shared_ptr<request::Request> request, UploadSession &session, const UploadSource &source,
+                      ConcurrencyController &controller)
+                : m_request(std::move(request))
+                , m_session(session)
+                , m_source(source)
+                , m_controller(controller) {};
+
+        void run();
+
+        /// files up to this size are sent with a single request instead of a session
+        static const std::size_t SINGLE_REQUEST_SIZE;
+        static const std::size_t MAX_CHUNK_RETRIES;
+        static const std::chrono::milliseconds RETRY_DELAY;
+
+        /// @return a `Content-Range` header value like `bytes 0-99/1000`
+        static std::string content_range(std::uint64_t offset, std::size_t length, std::uint64_t total_size);
+
+    private:
+        const std::shared_ptr<request::Request> m_request;
+        UploadSession &m_session;
+        const UploadSource &m_source;
+        ConcurrencyController &m_controller;
+
+        void run_sequential(const UploadSession::Limits &limits);
+
+        void run_parallel(const UploadSession::Limits &limits);
+
+        /**
+         * Waits while the controller is paused.
+         * @return `false` if `worker` should stop, because the limit of the controller has dropped to its number.
+         */
+        bool may_send(std::size_t worker) const;
+
+        /// Must be called from within a `catch` block. @return `true` if the current exception is worth a retry.
+        static bool is_retryable();
+
+        /**
+         * Must be called from within a `catch` block.
+         * @param retry number of the retry, starting at `1`
+         * @return how long to wait before the retry of a chunk that has failed with the current exception
+         */
+        static std::chrono::steady_clock::duration retry_delay(std::size_t retry);
+    };
+}
@@ -0,0 +1,175 @@
+#include "DateTime.hpp"
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+using namespace std::chrono;
+
+namespace {
+    /// days since 1970-01-01 for a date in the proleptic gregorian calendar
+    std::int64_t days_from_civil(std::int64_t year, unsigned month, unsigned day) {
+        year -= month <= 2;
+        const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const auto year_of_era = static_cast<unsigned>(year - era * 400);
+        const unsigned day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + static_cast<std::int64_t>(day_of_era) - 719468;
+    }
+
+    /// inverse of days_from_civil
+    void civil_from_days(std::int64_t days, std::int64_t &year, unsigned &month, unsigned &day) {
+        days += 719468;
+        const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const auto day_of_era = static_cast<unsigned>(days - era * 146097);
+        const unsigned year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+        const unsigned day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+        const unsigned mp = (5 * day_of_year + 2) / 153;
+        day = day_of_year - (153 * mp + 2) / 5 + 1;
+        month = mp < 10 ? mp + 3 : mp - 9;
+        year = static_cast<std::int64_t>(year_of_era) + era * 400 + (month <= 2);
+    }
+
+    /// reads exactly `digits` decimal digits starting at `pos`
+    bool read_number(const std::string &value, std::size_t &pos, std::size_t digits, int &out) {
+        if (pos + digits > value.size()) {
+            return false;
+        }
+        out = 0;
+        for (std::size_t i = 0; i < digits; i++) {
+            const char c = value[pos + i];
+            if (!std::isdigit(static_cast<unsigned char>(c))) {
+                return false;
+            }
+            out = out * 10 + (c - '0');
+        }
+        pos += digits;
+        return true;
+    }
+
+    bool expect(const std::string &value, std::size_t &pos, char c) {
+        if (pos < value.size() && value[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    std::optional<system_clock::time_point> to_time_point(
+            int year, int month, int day, int hour, int minute, int second, int millis, int offset_minutes) {
+        if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+            return std::nullopt;
+        }
+        const auto days = days_from_civil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+        const auto seconds_since_epoch = days * 86400 + hour * 3600 + minute * 60 + second - offset_minutes * 60;
+        return system_clock::time_point(
+                duration_cast<system_clock::duration>(seconds(seconds_since_epoch) + milliseconds(millis)));
+    }
+}
+
+namespace CloudSync::util {
+    std::optional<system_clock::time_point> parse_iso8601(const std::string &value) {
+        std::size_t pos = 0;
+        int year, month, day, hour, minute, second;
+        if (!(read_number(value, pos, 4, year) && expect(value, pos, '-')
+              && read_number(value, pos, 2, month) && expect(value, pos, '-')
+              && read_number(value, pos, 2, day)
+              && (expect(value, pos, 'T') || expect(value, pos, 't') || expect(value, pos, ' '))
+              && read_number(value, pos, 2, hour) && expect(value, pos, ':')
+              && read_number(value, pos, 2, minute) && expect(value, pos, ':')
+              && read_number(value, pos, 2, second))) {
+            return std::nullopt;
+        }
+        int millis = 0;
+        if (expect(value, pos, '.')) {
+            int digits = 0;
+            while (pos < value.size() && std::isdigit(static_cast<unsigned char>(value[pos]))) {
+                if (digits < 3) {
+                    millis = millis * 10 + (value[pos] - '0');
+                }
+                digits++;
+                pos++;
+            }
+            if (digits == 0) {
+                return std::nullopt;
+            }
+            for (; digits < 3; digits++) {
+                millis *= 10;
+            }
+        }
+        int offset_minutes = 0;
+        if (expect(value, pos, 'Z') || expect(value, pos, 'z')) {
+            // UTC
+        } else if (pos < value.size() && (value[pos] == '+' || value[pos] == '-')) {
+            const int sign = value[pos++] == '-' ? -1 : 1;
+            int offset_hours, offset_mins;
+            if (!(read_number(value, pos, 2, offset_hours) && expect(value, pos, ':')
+                  && read_number(value, pos, 2, offset_mins))) {
+                return std::nullopt;
+            }
+            offset_minutes = sign * (offset_hours * 60 + offset_mins);
+        } else if (pos != value.size()) {
+            return std::nullopt;
+        }
+        if (pos != value.size()) {
+            return std::nullopt;
+        }
+        return to_time_point(year, month, day, hour, minute, second, millis, offset_minutes);
+    }
+
+    std::string format_iso8601(system_clock::time_point time) {
+        const auto total_seconds = floor<seconds>(time).time_since_epoch().count();
+        auto days = total_seconds / 86400;
+        auto second_of_day = total_seconds % 86400;
+        if (second_of_day < 0) {
+            second_of_day += 86400;
+            days--;
+        }
+        std::int64_t year;
+        unsigned month, day;
+        civil_from_days(days, year, month, day);
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02uT%02lld:%02lld:%02lldZ",
+                      static_cast<long long>(year), month, day,
+                      static_cast<long long>(second_of_day / 3600),
+                      static_cast<long long>(second_of_day / 60 % 60),
+                      static_cast<long long>(second_of_day % 60));
+        return buffer;
+    }
+
+    std::optional<system_clock::time_point> parse_rfc1123(const std::string &value) {
+        static const std::array<const char *, 12> MONTHS = {
+                "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+        // skip the day name: "Fri, "
+        std::size_t pos = value.find(", ");
+        if (pos == std::string::npos) {
+            return std::nullopt;
+        }
+        pos += 2;
+        int day, year, hour, minute, second;
+        if (!(read_number(value, pos, 2, day) && expect(value, pos, ' '))) {
+            return std::nullopt;
+        }
+        if (pos + 4 > value.size()) {
+            return std::nullopt;
+        }
+        int month = 0;
+        for (std::size_t i = 0; i < MONTHS.size(); i++) {
+            if (value.compare(pos, 3, MONTHS[i]) == 0) {
+                month = static_cast<int>(i) + 1;
+                break;
+            }
+        }
+        pos += 3;
+        if (month == 0 || !(expect(value, pos, ' ')
+              && read_number(value, pos, 4, year) && expect(value, pos, ' ')
+              && read_number(value, pos, 2, hour) && expect(value, pos, ':')
+              && read_number(value, pos, 2, minute) && expect(value, pos, ':')
+              && read_number(value, pos, 2, second) && expect(value, pos, ' '))
+            || value.compare(pos, std::string::npos, "GMT") != 0) {
+            return std::nullopt;
+        }
+        return to_time_point(year, month, day, hour, minute, second, 0, 0);
+    }
+}
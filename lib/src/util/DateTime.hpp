@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+
+namespace CloudSync::util {
+    /**
+     * Parses an ISO 8601 / RFC 3339 timestamp like `2020-01-29T21:00:50Z` or `2020-01-29T21:00:50.123+01:00`,
+     * as returned by Dropbox, OneDrive & Google Drive. Fractional seconds are truncated to milliseconds.
+     * @return the point in time, or nothing if `value` is not a valid timestamp.
+     */
+    std::optional<std::chrono::system_clock::time_point> parse_iso8601(const std::string &value);
+
+    /// @return `time` as ISO 8601 timestamp in UTC, with whole seconds: `2020-01-29T21:00:50Z`
+    std::string format_iso8601(std::chrono::system_clock::time_point time);
+
+    /**
+     * Parses an RFC 1123 HTTP date like `Fri, 10 Jan 2020 20:42:38 GMT`, as returned for the webdav
+     * `getlastmodified` property.
+     * @return the point in time, or nothing if `value` is not a valid date.
+     */
+    std::optional<std::chrono::system_clock::time_point> parse_rfc1123(const std::string &value);
+}
@@ -0,0 +1,22 @@
+#include "EndpointConcurrency.hpp"
+#include "CloudSync/TransferScheduler.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace CloudSync::util {
+    // starts where the fixed limit of the bulk operations has been, threads & connections are created per call
+    const ConcurrencyLimits ENDPOINT_LIMITS = {4, 1, 16};
+
+    ConcurrencyController &endpoint_controller(const std::string &url) {
+        static std::mutex mutex;
+        static std::map<std::string, std::unique_ptr<ConcurrencyController>> controllers;
+        const auto host = TransferScheduler::host_of(url);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &controller = controllers[host];
+        if (!controller) {
+            controller = std::make_unique<ConcurrencyController>(ENDPOINT_LIMITS);
+        }
+        return *controller;
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "CloudSync/ConcurrencyController.hpp"
+#include <string>
+
+namespace CloudSync::util {
+    /// settings of the controllers of `endpoint_controller()`
+    extern const ConcurrencyLimits ENDPOINT_LIMITS;
+
+    /**
+     * @return the controller that all parallel requests of the library to the host of `url` share, like the requests
+     * of `Directory::stat_many()` or the chunks of an upload. So a host that throttles one of them gets fewer
+     * requests from all of them. Controllers are kept for the lifetime of the process.
+     *
+     * Thread safe.
+     */
+    ConcurrencyController &endpoint_controller(const std::string &url);
+}
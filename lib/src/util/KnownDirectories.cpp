@@ -0,0 +1,41 @@
+#include "KnownDirectories.hpp"
+
+namespace CloudSync::util {
+    bool KnownDirectories::contains(const std::filesystem::path &path) const {
+        const auto key = path.generic_string();
+        if (key == "/") {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_paths.count(key) != 0) {
+            return true;
+        }
+        // descendants of `key` sort right after `key/`
+        const auto descendant = m_paths.lower_bound(key + "/");
+        return descendant != m_paths.end() && descendant->compare(0, key.size() + 1, key + "/") == 0;
+    }
+
+    void KnownDirectories::add(const std::filesystem::path &path) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paths.insert(path.generic_string());
+    }
+
+    void KnownDirectories::remove(const std::filesystem::path &path) {
+        const auto key = path.generic_string();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (key == "/") {
+            m_paths.clear();
+            return;
+        }
+        m_paths.erase(key);
+        auto descendant = m_paths.lower_bound(key + "/");
+        while (descendant != m_paths.end() && descendant->compare(0, key.size() + 1, key + "/") == 0) {
+            descendant = m_paths.erase(descendant);
+        }
+    }
+
+    void KnownDirectories::clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paths.clear();
+    }
+}
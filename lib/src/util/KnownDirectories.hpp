@@ -0,0 +1,34 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace CloudSync::util {
+    /**
+     * Absolute paths of directories that are known to exist.
+     *
+     * Shared by all directory handles of a cloud, so `ensure_directory()` doesn't have to ask the server again for
+     * folders it has already created or found. A directory counts as known if it has been added itself or if any
+     * directory below it has been added. Changes made by other clients are not noticed.
+     *
+     * Thread safe.
+     */
+    class KnownDirectories {
+    public:
+        [[nodiscard]] bool contains(const std::filesystem::path &path) const;
+
+        void add(const std::filesystem::path &path);
+
+        /// Forgets the directory at `path` and everything below it.
+        void remove(const std::filesystem::path &path);
+
+        void clear();
+
+    private:
+        mutable std::mutex m_mutex;
+        /// generic paths without trailing slashes
+        std::set<std::string> m_paths;
+    };
+}
@@ -0,0 +1,83 @@
+#include "Parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CloudSync::util {
+    namespace {
+        /// @param may_continue is asked by a worker before it takes the next index, it stops once this is `false`
+        void run_workers(
+                std::size_t count,
+                std::size_t workers,
+                const std::function<bool(std::size_t worker)> &may_continue,
+                const std::function<void(std::size_t worker, std::size_t index)> &operation) {
+            if (workers <= 1) {
+                // no need to spawn a thread for a single worker
+                for (std::size_t i = 0; i < count && may_continue(0); i++) {
+                    operation(0, i);
+                }
+                return;
+            }
+            std::atomic<std::size_t> next_index{0};
+            std::atomic<bool> failed{false};
+            std::exception_ptr first_error;
+            std::mutex error_mutex;
+            const auto work = [&](std::size_t worker) {
+                try {
+                    while (!failed && may_continue(worker)) {
+                        const auto i = next_index++;
+                        if (i >= count) {
+                            return;
+                        }
+                        operation(worker, i);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!first_error) {
+                        first_error = std::current_exception();
+                    }
+                    failed = true;
+                }
+            };
+            std::vector<std::thread> threads;
+            threads.reserve(workers - 1);
+            for (std::size_t worker = 1; worker < workers; worker++) {
+                threads.emplace_back(work, worker);
+            }
+            // the calling thread is a worker as well
+            work(0);
+            for (auto &thread: threads) {
+                thread.join();
+            }
+            if (first_error) {
+                std::rethrow_exception(first_error);
+            }
+        }
+    }
+
+    void parallel_for(
+            std::size_t count,
+            std::size_t max_workers,
+            const std::function<void(std::size_t worker, std::size_t index)> &operation) {
+        const auto workers = std::min(count, std::max<std::size_t>(max_workers, 1));
+        run_workers(count, workers, [](std::size_t) { return true; }, operation);
+    }
+
+    void parallel_for(
+            std::size_t count,
+            std::size_t max_workers,
+            const ConcurrencyController &controller,
+            const std::function<void(std::size_t worker, std::size_t index)> &operation) {
+        const auto workers = std::min(count, std::max<std::size_t>(max_workers, 1));
+        run_workers(count, workers, [&controller](std::size_t worker) {
+            if (worker != 0 && worker >= controller.limit()) {
+                return false;
+            }
+            std::this_thread::sleep_until(controller.paused_until());
+            return true;
+        }, operation);
+    }
+}
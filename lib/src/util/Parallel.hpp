@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CloudSync/ConcurrencyController.hpp"
+#include <cstddef>
+#include <functional>
+
+namespace CloudSync::util {
+    /**
+     * Calls `operation(worker, index)` once for every index in `[0, count)`, using at most `max_workers` threads.
+     * Indices are handed out in ascending order to whichever worker is free. `worker` is in
+     * `[0, min(count, max_workers))` and stays the same for all calls made from one thread, so it can be used to
+     * look up per-thread state like a request.
+     *
+     * If `operation` throws, no further indices are handed out and the first exception is rethrown once all
+     * workers have stopped.
+     */
+    void parallel_for(
+            std::size_t count,
+            std::size_t max_workers,
+            const std::function<void(std::size_t worker, std::size_t index)> &operation);
+
+    /**
+     * Like the above, for requests to an endpoint whose load is found out by `controller`, e.g. with the current
+     * limit of the controller as `max_workers`. No index is handed out while the controller is paused, and a worker
+     * stops once the limit has dropped to its number, so the endpoint gets fewer requests as soon as it throttles
+     * them. Worker `0` never stops early. Reporting the outcome of each request to `controller` is left to
+     * `operation`.
+     */
+    void parallel_for(
+            std::size_t count,
+            std::size_t max_workers,
+            const ConcurrencyController &controller,
+            const std::function<void(std::size_t worker, std::size_t index)> &operation);
+}
@@ -16,5 +16,7 @@ std::shared_ptr<Directory> WebdavCloud::root() const {
     return std::make_shared<WebdavDirectory>(
             m_base_url, "", "/",
             m_credentials,
-            m_request, "");
+            m_request, "",
+            std::chrono::system_clock::time_point(),
+            m_known_directories);
 }
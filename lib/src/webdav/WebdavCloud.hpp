@@ -4,6 +4,7 @@
 #include "request/Request.hpp"
 #include "WebdavDirectory.hpp"
 #include "credentials/BasicCredentialsImpl.hpp"
+#include "util/KnownDirectories.hpp"
 #include <algorithm>
 #include <utility>
 
@@ -24,5 +25,7 @@ namespace CloudSync::webdav {
 
     protected:
         const std::shared_ptr<credentials::BasicCredentialsImpl> m_credentials;
+        /// directories that are known to exist, shared by all directories of this cloud
+        const std::shared_ptr<util::KnownDirectories> m_known_directories = std::make_shared<util::KnownDirectories>();
     };
 } // namespace CloudSync::webdav
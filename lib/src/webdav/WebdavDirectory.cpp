@@ -3,10 +3,21 @@
 #include "request/Response.hpp"
 #include "WebdavFile.hpp"
 #include "WebdavExceptionTranslator.hpp"
+#include "nextcloud/NextcloudBulkUpload.hpp"
+#include "nextcloud/NextcloudUploadSession.hpp"
 #include "CloudSync/exceptions/resource/ResourceException.hpp"
 #include "CloudSync/exceptions/cloud/CloudException.hpp"
+#include "util/DateTime.hpp"
 #include <pugixml.hpp>
+#include <cctype>
+#include <chrono>
+#include <deque>
+#include <cstdlib>
 #include <filesystem>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <set>
 #include <vector>
 
 using namespace CloudSync;
@@ -16,27 +27,72 @@ using namespace pugi;
 namespace fs = std::filesystem;
 
 
+namespace {
+    const std::string BULK_BOUNDARY = "cloudsync_bulk";
+
+    std::string xml_escape(const std::string &value) {
+        std::string escaped;
+        for (const char c: value) {
+            switch (c) {
+                case '&': escaped += "&amp;"; break;
+                case '<': escaped += "&lt;"; break;
+                case '>': escaped += "&gt;"; break;
+                case '"': escaped += "&quot;"; break;
+                default: escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    /// escapes the wildcards of a `like` pattern, so `value` is matched literally
+    std::string like_escape(const std::string &value) {
+        std::string escaped;
+        for (const char c: value) {
+            if (c == '%' || c == '_' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    /// percent-encodes everything but unreserved characters, so `value` can be used as a single path segment
+    std::string url_encode_segment(const std::string &value) {
+        static const char HEX[] = "0123456789ABCDEF";
+        std::string encoded;
+        encoded.reserve(value.size());
+        for (const unsigned char c: value) {
+            if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+                encoded += static_cast<char>(c);
+            } else {
+                encoded += '%';
+                encoded += HEX[c >> 4];
+                encoded += HEX[c & 0x0F];
+            }
+        }
+        return encoded;
+    }
+}
+
+const std::size_t WebdavDirectory::SEARCH_PAGE_SIZE = 500;
+
 const std::string WebdavDirectory::XML_QUERY =
     "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
-    "<d:propfind  xmlns:d=\"DAV:\">"
+    "<d:propfind  xmlns:d=\"DAV:\" xmlns:oc=\"http://owncloud.org/ns\">"
         "<d:prop>"
             "<d:getlastmodified/>"
             "<d:getetag/>"
             "<d:getcontenttype/>"
             "<d:resourcetype/>"
             "<d:getcontentlength/>"
+            "<oc:checksums/>"
         "</d:prop>"
     "</d:propfind>";
 
 std::vector<std::shared_ptr<Resource>> WebdavDirectory::list_resources() const {
     std::vector<std::shared_ptr<Resource>> resource_list;
     try {
-        const auto response_xml = m_request->PROPFIND(m_base_url + m_dir_offset + m_path.generic_string())
-                ->basic_auth(m_credentials->username(), m_credentials->password())
-                ->header("Depth", "1")
-                ->accept(Request::MIMETYPE_XML)
-                ->content_type(Request::MIMETYPE_XML)
-                ->body(XML_QUERY)->request().xml();
+        const auto response_xml = this->propfind_children();
         resource_list = this->parse_xml_response(response_xml->root());
     } catch (...) {
         WebdavExceptionTranslator::translate(m_path);
@@ -44,6 +100,21 @@ std::vector<std::shared_ptr<Resource>> WebdavDirectory::list_resources() const {
     return resource_list;
 }
 
+std::vector<ResourceInfo> WebdavDirectory::list_resource_info() const {
+    std::vector<ResourceInfo> resource_list;
+    try {
+        const auto response_xml = this->propfind_children();
+        resource_list = this->parse_xml_resource_info(response_xml->root());
+    } catch (...) {
+        WebdavExceptionTranslator::translate(m_path);
+    }
+    return resource_list;
+}
+
+std::shared_ptr<Resource> WebdavDirectory::get_resource(const ResourceInfo &info) const {
+    return this->make_resource(append_path(info.name), info);
+}
+
 std::shared_ptr<Directory> WebdavDirectory::get_directory(const std::filesystem::path &path) const {
     const auto resource_path = append_path(path);
     std::shared_ptr<WebdavDirectory> directory;
@@ -51,15 +122,12 @@ std::shared_ptr<Directory> WebdavDirectory::get_directory(const std::filesystem:
         // if it's the root we don't need to run a query
         directory = std::make_shared<WebdavDirectory>(m_base_url, "", "/",
                                                       m_credentials,
-                                                      m_request, "");
+                                                      m_request, "",
+                                                      std::chrono::system_clock::time_point(),
+                                                      m_known_directories);
     } else {
         try {
-            const auto response_xml = m_request->PROPFIND(m_base_url + m_dir_offset + resource_path.generic_string())
-                    ->basic_auth(m_credentials->username(), m_credentials->password())
-                    ->header("Depth", "0")
-                    ->accept(Request::MIMETYPE_XML)
-                    ->content_type(Request::MIMETYPE_XML)
-                    ->body(XML_QUERY)->request().xml();
+            const auto response_xml = this->propfind(resource_path, "0");
             const auto resource_list = this->parse_xml_response(response_xml->root());
             if (resource_list.size() == 1) {
                 directory = std::dynamic_pointer_cast<WebdavDirectory>(resource_list[0]);
@@ -76,47 +144,49 @@ std::shared_ptr<Directory> WebdavDirectory::get_directory(const std::filesystem:
     return directory;
 }
 
-void WebdavDirectory::remove() {
-    if(m_path.generic_string() == "/") {
-        throw exceptions::resource::PermissionDenied(m_path);
-    } else {
-        try {
-            m_request->DELETE(m_base_url + m_dir_offset + m_path.generic_string())
-                    ->basic_auth(m_credentials->username(), m_credentials->password())
-                    ->request();
-        } catch (...) {
-            WebdavExceptionTranslator::translate(m_path);
+bool WebdavDirectory::poll_change() {
+    bool has_changed = false;
+    try {
+        const auto response_xml = this->propfind(m_path, "0");
+        const std::string new_revision = response_xml->select_node(
+                "/*[local-name()='multistatus']"
+                "/*[local-name()='response']"
+                "/*[local-name()='propstat']"
+                "/*[local-name()='prop']"
+                "/*[local-name()='getetag']").node().child_value();
+        // plain webdav servers may not report an etag for collections, there is nothing to compare then
+        if (!new_revision.empty() && new_revision != m_revision) {
+            has_changed = true;
+            m_revision = new_revision;
         }
+    } catch (...) {
+        WebdavExceptionTranslator::translate(m_path);
     }
+    return has_changed;
+}
+
+void WebdavDirectory::remove() {
+    this->delete_resource(m_path);
+}
+
+std::shared_ptr<Resource> WebdavDirectory::copy_to(const std::filesystem::path &path) const {
+    return this->transfer("COPY", destination_path(path));
+}
+
+std::shared_ptr<Resource> WebdavDirectory::move_to(const std::filesystem::path &path) {
+    return this->transfer("MOVE", destination_path(path));
 }
 
 std::shared_ptr<Directory> WebdavDirectory::create_directory(const std::filesystem::path &path) const {
-    std::shared_ptr<WebdavDirectory> directory;
     const auto resource_path = append_path(path);
-    create_parent_directories_if_missing(resource_path);
-    try {
-        m_request->MKCOL(m_base_url + m_dir_offset + resource_path.generic_string())
-                ->basic_auth(m_credentials->username(), m_credentials->password())
-                ->request();
-        directory = std::make_shared<WebdavDirectory>(
-                m_base_url,
-                m_dir_offset,
-                resource_path,
-                m_credentials,
-                m_request,
-                resource_path.filename().generic_string());
-    } catch(request::exceptions::response::MethodNotAllowed &e) {
-        throw exceptions::resource::ResourceConflict(resource_path);
-    } catch (...) {
-        WebdavExceptionTranslator::translate(resource_path);
-    }
-    return directory;
+    this->ensure_parent_collection(resource_path);
+    return this->make_collection(resource_path);
 }
 
 std::shared_ptr<File> WebdavDirectory::create_file(const std::filesystem::path &path) const {
     const auto resource_path = append_path(path);
     std::shared_ptr<File> file;
-    create_parent_directories_if_missing(resource_path);
+    this->ensure_parent_collection(resource_path);
     try {
         if(resource_exists(resource_path)) {
             throw exceptions::resource::ResourceConflict(resource_path);
@@ -139,16 +209,50 @@ std::shared_ptr<File> WebdavDirectory::create_file(const std::filesystem::path &
     return file;
 }
 
+std::shared_ptr<File> WebdavDirectory::create_file(
+        const std::filesystem::path &path, const std::vector<std::uint8_t> &content) const {
+    const auto resource_path = append_path(path);
+    const auto put_new_file = [this, &resource_path, &content] {
+        // `If-None-Match: *` makes the server refuse the PUT if anything exists at the path
+        const auto response = m_request->PUT(m_base_url + m_dir_offset + resource_path.generic_string())
+                ->basic_auth(m_credentials->username(), m_credentials->password())
+                ->if_none_match("*")
+                ->content_type(Request::MIMETYPE_BINARY)
+                ->binary_body(content)
+                ->request();
+        return std::make_shared<WebdavFile>(
+                m_base_url + m_dir_offset,
+                resource_path,
+                m_credentials,
+                m_request,
+                resource_path.filename().generic_string(),
+                response.headers.at("etag"),
+                content.size());
+    };
+    std::shared_ptr<File> file;
+    try {
+        try {
+            file = put_new_file();
+        } catch (const request::exceptions::response::Conflict &) {
+            // missing parents are only looked for once the server has refused the file because of them
+            this->ensure_collection(resource_path.parent_path());
+            file = put_new_file();
+        }
+    } catch (const request::exceptions::response::PreconditionFailed &) {
+        throw exceptions::resource::ResourceConflict(resource_path);
+    } catch (const request::exceptions::response::Conflict &) {
+        throw exceptions::resource::NoSuchResource(resource_path.parent_path());
+    } catch (...) {
+        WebdavExceptionTranslator::translate(resource_path);
+    }
+    return file;
+}
+
 std::shared_ptr<File> WebdavDirectory::get_file(const std::filesystem::path &path) const {
     const auto resource_path = append_path(path);
     std::shared_ptr<WebdavFile> file;
     try {
-        const auto response_xml = m_request->PROPFIND(m_base_url + m_dir_offset + resource_path.generic_string())
-                ->basic_auth(m_credentials->username(), m_credentials->password())
-                ->header("Depth", "0")
-                ->accept(Request::MIMETYPE_XML)
-                ->content_type(Request::MIMETYPE_XML)
-                ->body(XML_QUERY)->request().xml();
+        const auto response_xml = this->propfind(resource_path, "0");
         const auto resourceList = this->parse_xml_response(response_xml->root());
         if (resourceList.size() == 1) {
             file = std::dynamic_pointer_cast<WebdavFile>(resourceList[0]);
@@ -164,60 +268,584 @@ std::shared_ptr<File> WebdavDirectory::get_file(const std::filesystem::path &pat
     return file;
 }
 
+std::shared_ptr<Directory> WebdavDirectory::ensure_directory(const std::filesystem::path &path) const {
+    const auto resource_path = append_path(path);
+    try {
+        this->ensure_collection(resource_path);
+    } catch (...) {
+        WebdavExceptionTranslator::translate(resource_path);
+    }
+    return std::make_shared<WebdavDirectory>(
+            m_base_url,
+            m_dir_offset,
+            resource_path,
+            m_credentials,
+            m_request,
+            resource_path.filename().generic_string(),
+            std::chrono::system_clock::time_point(),
+            m_known_directories);
+}
+
+std::vector<BulkResult> WebdavDirectory::remove_many(const std::vector<std::filesystem::path> &paths) const {
+    // webdav has no batch requests, the best we can do is to send a few at the same time
+    auto results = bulk_results<BulkResult>(paths);
+    run_parallel<BulkResult>(results, [this](const std::shared_ptr<Request> &request, BulkResult &result) {
+        this->with_request(request)->delete_resource(append_path(result.path));
+    });
+    return results;
+}
+
+std::vector<BulkValue<std::shared_ptr<Directory>>> WebdavDirectory::create_directories(
+        const std::vector<std::filesystem::path> &paths) const {
+    using Result = BulkValue<std::shared_ptr<Directory>>;
+    auto results = bulk_results<Result>(paths);
+    // A folder can only be created once its parent exists. So all folders, including missing intermediates, are
+    // created one level at a time. This also keeps two requests from racing for the same intermediate.
+    std::map<std::size_t, std::vector<std::size_t>> levels;
+    std::set<fs::path> intermediate_paths;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const auto resource_path = append_path(results[i].path);
+        levels[std::distance(resource_path.begin(), resource_path.end())].push_back(i);
+        for (auto parent = resource_path.parent_path(); parent != m_path; parent = parent.parent_path()) {
+            const auto relative_parent = parent.lexically_relative(m_path);
+            if (relative_parent.empty() || *relative_parent.begin() == "..") {
+                break;
+            }
+            intermediate_paths.insert(parent);
+        }
+    }
+    for (const auto &result: results) {
+        // requested folders are created as such, even if another one is inside of them
+        intermediate_paths.erase(append_path(result.path));
+    }
+    auto intermediates = bulk_results<Result>({intermediate_paths.begin(), intermediate_paths.end()});
+    std::map<std::size_t, std::vector<std::size_t>> intermediate_levels;
+    for (std::size_t i = 0; i < intermediates.size(); i++) {
+        intermediate_levels[std::distance(intermediates[i].path.begin(), intermediates[i].path.end())].push_back(i);
+    }
+    for (std::size_t depth = 1; !levels.empty() || !intermediate_levels.empty(); depth++) {
+        // intermediates may already exist. If they can't be created, their children will fail on their own.
+        std::vector<Result> level_intermediates;
+        for (const auto index: intermediate_levels[depth]) {
+            level_intermediates.push_back(intermediates[index]);
+        }
+        run_parallel<Result>(level_intermediates, [this](const std::shared_ptr<Request> &request, Result &result) {
+            this->with_request(request)->ensure_collection(result.path);
+        });
+        std::vector<Result> level_results;
+        for (const auto index: levels[depth]) {
+            level_results.push_back(results[index]);
+        }
+        run_parallel<Result>(level_results, [this](const std::shared_ptr<Request> &request, Result &result) {
+            result.value = this->with_request(request)->make_collection(append_path(result.path));
+        });
+        for (std::size_t i = 0; i < level_results.size(); i++) {
+            results[levels[depth][i]] = std::move(level_results[i]);
+        }
+        levels.erase(depth);
+        intermediate_levels.erase(depth);
+    }
+    return results;
+}
+
+std::vector<BulkValue<ResourceInfo>> WebdavDirectory::stat_many(const std::vector<std::filesystem::path> &paths) const {
+    auto results = bulk_results<BulkValue<ResourceInfo>>(paths);
+    run_parallel<BulkValue<ResourceInfo>>(
+            results,
+            [this](const std::shared_ptr<Request> &request, BulkValue<ResourceInfo> &result) {
+                result.value = this->with_request(request)->stat_resource(append_path(result.path));
+            });
+    return results;
+}
+
+std::vector<BulkValue<std::shared_ptr<File>>> WebdavDirectory::upload_many(const std::vector<FileUpload> &files) const {
+    // missing parents are created once for all files they contain
+    std::map<fs::path, std::exception_ptr> parent_errors;
+    for (const auto &file: files) {
+        const auto resource_path = append_path(file.path);
+        if (parent_errors.count(resource_path.parent_path()) == 0) {
+            try {
+                this->ensure_parent_collection(resource_path);
+                parent_errors[resource_path.parent_path()] = nullptr;
+            } catch (...) {
+                parent_errors[resource_path.parent_path()] = std::current_exception();
+            }
+        }
+    }
+    if (const auto server = nextcloud::NextcloudUploadSession::server_url(m_base_url + m_dir_offset)) {
+        if (auto results = this->bulk_upload(*server, files, parent_errors)) {
+            return std::move(*results);
+        }
+    }
+    return upload_parallel(files, [this, &parent_errors](const std::shared_ptr<Request> &request, const FileUpload &file) {
+        const auto resource_path = append_path(file.path);
+        if (const auto &parent_error = parent_errors.at(resource_path.parent_path())) {
+            std::rethrow_exception(parent_error);
+        }
+        return this->with_request(request)->put_file(resource_path, file.content);
+    });
+}
+
+std::shared_ptr<Directory> WebdavDirectory::with_new_connection() const {
+    return this->with_request(m_request->clone());
+}
+
+void WebdavDirectory::search(const SearchQuery &query, const SearchPageHandler &on_page) const {
+    try {
+        if (const auto server = nextcloud::NextcloudUploadSession::server_url(m_base_url + m_dir_offset)) {
+            if (this->dasl_search(*server, query, on_page)) {
+                return;
+            }
+        }
+        // plain webdav servers can't search, so the folders are listed one after another
+        std::deque<fs::path> folders = {m_path};
+        while (!folders.empty()) {
+            const auto folder = std::move(folders.front());
+            folders.pop_front();
+            const auto response_xml = this->propfind(folder, "1");
+            std::vector<SearchResult> results;
+            for (const auto response_node: response_xml->select_nodes(
+                    "/*[local-name()='multistatus']/*[local-name()='response']")) {
+                std::string resource_href;
+                auto info = parse_xml_resource(response_node.node(), resource_href);
+                if (!info || resource_href == folder.generic_string()) {
+                    continue;
+                }
+                if (!info->is_file()) {
+                    folders.emplace_back(resource_href);
+                }
+                results.push_back({resource_href, std::move(*info)});
+            }
+            if (!this->deliver_search_page(query, std::move(results), on_page)) {
+                break;
+            }
+        }
+    } catch (...) {
+        WebdavExceptionTranslator::translate(m_path);
+    }
+}
+
 std::vector<std::shared_ptr<Resource>> WebdavDirectory::parse_xml_response(const xml_node &response) const {
     std::vector<std::shared_ptr<Resource>> resources;
     const auto responseNodeSets = response.select_nodes(
             "/*[local-name()='multistatus']/*[local-name()='response']");
     for (const auto responseNodeSet: responseNodeSets) {
-        const auto responseNode = responseNodeSet.node();
-
-        // read path from xml
-        std::string resource_href = responseNode.select_node("./*[local-name()='href']").node().child_value();
-        // remove path offset from the beginning of the path
-        resource_href.erase(0, m_dir_offset.size());
-        // remove any trailing slashes because webdav returns folders with
-        // trailing slashes.
-        resource_href = remove_trailing_slashes(resource_href);
-        if (resource_href != m_path.generic_string()) {
-            // parse the href as path so the filename/foldername can be
-            // extracted
-            const auto resource_path = fs::path(resource_href);
-            std::shared_ptr<Resource> resource;
-            // if the collection node exists, we can be sure this is a
-            // directory, else it must be a file
-            const auto filename = resource_path.filename().generic_string();
-            if (responseNode.select_node(
-                "./*[local-name()='propstat']"
-                "/*[local-name()='prop']"
-                "/*[local-name()='resourcetype']"
-                "/*[local-name()='collection']")
-            ) {
-                resource = std::make_shared<WebdavDirectory>(
-                        m_base_url,
-                        m_dir_offset,
-                        resource_href,
-                        m_credentials,
-                        m_request,
-                        filename);
-            } else if (const auto revision = responseNode.select_node(
-                "./*[local-name()='propstat']"
-                "/*[local-name()='prop']"
-                "/*[local-name()='getetag']").node().child_value()
-            ) {
-                resource = std::make_shared<WebdavFile>(
-                    m_base_url + m_dir_offset,
-                    resource_href,
-                    m_credentials,
-                    m_request,
-                    filename,
-                    revision);
-            }
-            resources.push_back(resource);
+        std::string resource_href;
+        if (const auto info = parse_xml_resource(responseNodeSet.node(), resource_href)) {
+            resources.push_back(this->make_resource(resource_href, *info));
         }
     }
     return resources;
 }
 
+std::vector<ResourceInfo> WebdavDirectory::parse_xml_resource_info(const xml_node &response) const {
+    std::vector<ResourceInfo> resources;
+    const auto responseNodeSets = response.select_nodes(
+            "/*[local-name()='multistatus']/*[local-name()='response']");
+    resources.reserve(responseNodeSets.size());
+    for (const auto responseNodeSet: responseNodeSets) {
+        std::string resource_href;
+        if (auto info = parse_xml_resource(responseNodeSet.node(), resource_href)) {
+            resources.push_back(std::move(*info));
+        }
+    }
+    return resources;
+}
+
+std::optional<ResourceInfo> WebdavDirectory::parse_xml_resource(const xml_node &responseNode, std::string &resource_href) const {
+    // read path from xml
+    resource_href = responseNode.select_node("./*[local-name()='href']").node().child_value();
+    // remove path offset from the beginning of the path
+    resource_href.erase(0, m_dir_offset.size());
+    // remove any trailing slashes because webdav returns folders with
+    // trailing slashes.
+    resource_href = remove_trailing_slashes(resource_href);
+    if (resource_href == m_path.generic_string()) {
+        // the directory itself is part of every Depth:1 response
+        return std::nullopt;
+    }
+    const auto property = [&responseNode](const std::string &name) {
+        return responseNode.select_node((
+                "./*[local-name()='propstat']/*[local-name()='prop']/*[local-name()='" + name + "']").c_str()).node();
+    };
+    ResourceInfo info;
+    // parse the href as path so the filename/foldername can be extracted
+    info.name = fs::path(resource_href).filename().generic_string();
+    info.revision = property("getetag").child_value();
+    // if the collection node exists, we can be sure this is a directory, else it must be a file
+    if (property("resourcetype").select_node("./*[local-name()='collection']")) {
+        info.kind = ResourceInfo::Kind::DIRECTORY;
+    } else if (!info.revision.empty()) {
+        info.kind = ResourceInfo::Kind::FILE;
+        info.size = std::strtoull(property("getcontentlength").child_value(), nullptr, 10);
+        info.content_type = property("getcontenttype").child_value();
+        info.content_hash = WebdavFile::parse_checksums(WebdavFile::checksums_text(property("checksums")));
+    } else {
+        // neither a collection nor a file with an etag, so there is nothing this entry could be resolved to
+        return std::nullopt;
+    }
+    if (const auto modified = util::parse_rfc1123(property("getlastmodified").child_value())) {
+        info.modified = *modified;
+    }
+    return info;
+}
+
+std::shared_ptr<Resource> WebdavDirectory::make_resource(const std::filesystem::path &resource_path, const ResourceInfo &info) const {
+    if (info.is_file()) {
+        return std::make_shared<WebdavFile>(
+                m_base_url + m_dir_offset,
+                resource_path,
+                m_credentials,
+                m_request,
+                info.name,
+                info.revision,
+                info.size,
+                info.modified,
+                info.content_type,
+                info.content_hash);
+    } else {
+        return std::make_shared<WebdavDirectory>(
+                m_base_url,
+                m_dir_offset,
+                resource_path,
+                m_credentials,
+                m_request,
+                info.name,
+                info.modified,
+                m_known_directories,
+                info.revision);
+    }
+}
+
+bool WebdavDirectory::dasl_search(const std::string &server, const SearchQuery &query, const SearchPageHandler &on_page) const {
+    std::vector<std::string> conditions;
+    const auto compare = [](const std::string &op, const std::string &property, const std::string &literal) {
+        return "<d:" + op + "><d:prop><d:" + property + "/></d:prop><d:literal>" + xml_escape(literal)
+               + "</d:literal></d:" + op + ">";
+    };
+    // an empty `like` pattern matches every name
+    conditions.push_back(compare("like", "displayname", "%" + like_escape(query.name) + "%"));
+    if (query.kind == ResourceInfo::Kind::DIRECTORY) {
+        conditions.emplace_back("<d:is-collection/>");
+    } else if (query.kind == ResourceInfo::Kind::FILE) {
+        conditions.emplace_back("<d:not><d:is-collection/></d:not>");
+    }
+    if (!query.content_type.empty()) {
+        conditions.push_back(compare("eq", "getcontenttype", query.content_type));
+    }
+    if (query.modified_after) {
+        conditions.push_back(compare("gt", "getlastmodified", util::format_iso8601(*query.modified_after)));
+    }
+    std::string where;
+    for (const auto &condition: conditions) {
+        where += condition;
+    }
+    if (conditions.size() > 1) {
+        where = "<d:and>" + where + "</d:and>";
+    }
+    // results are addressed relative to the files of the user on the `dav` endpoint, whose hrefs are encoded
+    const auto files_path = "/files/" + url_encode_segment(m_credentials->username());
+    const WebdavDirectory files_root(
+            server, "/remote.php/dav" + files_path, m_path, m_credentials, m_request, m_name, m_modified,
+            m_known_directories);
+    for (std::size_t offset = 0;; offset += SEARCH_PAGE_SIZE) {
+        std::shared_ptr<pugi::xml_document> response_xml;
+        try {
+            response_xml = m_request->SEARCH(server + "/remote.php/dav/")
+                    ->basic_auth(m_credentials->username(), m_credentials->password())
+                    ->content_type(Request::MIMETYPE_XML)
+                    ->accept(Request::MIMETYPE_XML)
+                    ->body("<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+                           "<d:searchrequest xmlns:d=\"DAV:\" xmlns:oc=\"http://owncloud.org/ns\" "
+                           "xmlns:ns=\"https://github.com/icewind1991/SearchDAV/ns\">"
+                               "<d:basicsearch>"
+                                   "<d:select><d:prop>"
+                                       "<d:getlastmodified/><d:getetag/><d:getcontenttype/><d:resourcetype/>"
+                                       "<d:getcontentlength/><oc:checksums/>"
+                                   "</d:prop></d:select>"
+                                   "<d:from><d:scope>"
+                                       "<d:href>" + xml_escape(files_path + m_path.generic_string()) + "</d:href>"
+                                       "<d:depth>infinity</d:depth>"
+                                   "</d:scope></d:from>"
+                                   "<d:where>" + where + "</d:where>"
+                                   "<d:orderby><d:order><d:prop><oc:fileid/></d:prop><d:ascending/></d:order></d:orderby>"
+                                   "<d:limit>"
+                                       "<d:nresults>" + std::to_string(SEARCH_PAGE_SIZE) + "</d:nresults>"
+                                       "<ns:firstresult>" + std::to_string(offset) + "</ns:firstresult>"
+                                   "</d:limit>"
+                               "</d:basicsearch>"
+                           "</d:searchrequest>")
+                    ->request().xml();
+        } catch (const request::exceptions::response::ResponseException &e) {
+            if (offset == 0 && (e.code == 405 || e.code == 501)) {
+                // the server has no search
+                return false;
+            }
+            throw;
+        }
+        const auto response_nodes = response_xml->select_nodes(
+                "/*[local-name()='multistatus']/*[local-name()='response']");
+        std::vector<SearchResult> results;
+        for (const auto response_node: response_nodes) {
+            std::string resource_href;
+            if (auto info = files_root.parse_xml_resource(response_node.node(), resource_href)) {
+                results.push_back({resource_href, std::move(*info)});
+            }
+        }
+        if (!this->deliver_search_page(query, std::move(results), on_page) || response_nodes.size() < SEARCH_PAGE_SIZE) {
+            return true;
+        }
+    }
+}
+
+std::shared_ptr<pugi::xml_document> WebdavDirectory::propfind_children() const {
+    return this->propfind(m_path, "1");
+}
+
+std::shared_ptr<pugi::xml_document> WebdavDirectory::propfind(
+        const std::filesystem::path &resource_path, const std::string &depth) const {
+    return m_request->PROPFIND(m_base_url + m_dir_offset + resource_path.generic_string())
+            ->basic_auth(m_credentials->username(), m_credentials->password())
+            ->header("Depth", depth)
+            ->accept(Request::MIMETYPE_XML)
+            ->content_type(Request::MIMETYPE_XML)
+            ->body(XML_QUERY)->request().xml();
+}
+
+std::shared_ptr<WebdavDirectory> WebdavDirectory::with_request(const std::shared_ptr<request::Request> &request) const {
+    return std::make_shared<WebdavDirectory>(
+            m_base_url, m_dir_offset, m_path, m_credentials, request, m_name, m_modified, m_known_directories,
+            m_revision);
+}
+
+void WebdavDirectory::delete_resource(const std::filesystem::path &resource_path) const {
+    if (resource_path.generic_string() == "/") {
+        throw exceptions::resource::PermissionDenied(resource_path);
+    }
+    try {
+        m_request->DELETE(m_base_url + m_dir_offset + resource_path.generic_string())
+                ->basic_auth(m_credentials->username(), m_credentials->password())
+                ->request();
+        m_known_directories->remove(resource_path);
+    } catch (...) {
+        WebdavExceptionTranslator::translate(resource_path);
+    }
+}
+
+std::shared_ptr<Directory> WebdavDirectory::transfer(const std::string &verb, const std::filesystem::path &destination) const {
+    std::shared_ptr<Directory> directory;
+    try {
+        // `Depth: infinity` is the default for collections, the whole tree is copied
+        m_request->resource(verb, m_base_url + m_dir_offset + m_path.generic_string())
+                ->basic_auth(m_credentials->username(), m_credentials->password())
+                ->header("Destination", m_base_url + m_dir_offset + destination.generic_string())
+                ->header("Overwrite", "F")
+                ->request();
+        if (verb == "MOVE") {
+            m_known_directories->remove(m_path);
+        }
+        // COPY & MOVE don't describe the result, the handle gets the metadata of the destination from the server
+        const auto info = this->stat_resource(destination);
+        directory = std::make_shared<WebdavDirectory>(
+                m_base_url,
+                m_dir_offset,
+                destination,
+                m_credentials,
+                m_request,
+                destination.filename().generic_string(),
+                info.modified,
+                m_known_directories,
+                info.revision);
+    } catch (const request::exceptions::response::PreconditionFailed &e) {
+        // `Overwrite: F` and the destination exists
+        throw exceptions::resource::ResourceConflict(destination);
+    } catch (const request::exceptions::response::Conflict &e) {
+        // the parent of the destination doesn't exist
+        throw exceptions::resource::NoSuchResource(destination.parent_path());
+    } catch (...) {
+        WebdavExceptionTranslator::translate(m_path);
+    }
+    return directory;
+}
+
+void WebdavDirectory::ensure_collection(const std::filesystem::path &resource_path) const {
+    // this directory & its parents exist, otherwise there wouldn't be a handle for it
+    const auto relative_to_this = m_path.lexically_relative(resource_path);
+    if (m_known_directories->contains(resource_path)
+        || (!relative_to_this.empty() && *relative_to_this.begin() != "..")) {
+        return;
+    }
+    const auto make_collection = [this, &resource_path] {
+        m_request->MKCOL(m_base_url + m_dir_offset + resource_path.generic_string())
+                ->basic_auth(m_credentials->username(), m_credentials->password())
+                ->request();
+    };
+    try {
+        make_collection();
+    } catch (const request::exceptions::response::Conflict &) {
+        // the parent is missing
+        this->ensure_collection(resource_path.parent_path());
+        make_collection();
+    } catch (const request::exceptions::response::MethodNotAllowed &) {
+        // something exists at the path already, which is fine as long as it's a collection
+        if (this->stat_resource(resource_path).kind != ResourceInfo::Kind::DIRECTORY) {
+            throw exceptions::resource::ResourceConflict(resource_path);
+        }
+    }
+    m_known_directories->add(resource_path);
+}
+
+void WebdavDirectory::ensure_parent_collection(const std::filesystem::path &resource_path) const {
+    try {
+        this->ensure_collection(resource_path.parent_path());
+    } catch (...) {
+        WebdavExceptionTranslator::translate(resource_path.parent_path());
+    }
+}
+
+std::shared_ptr<Directory> WebdavDirectory::make_collection(const std::filesystem::path &resource_path) const {
+    std::shared_ptr<WebdavDirectory> directory;
+    try {
+        m_request->MKCOL(m_base_url + m_dir_offset + resource_path.generic_string())
+                ->basic_auth(m_credentials->username(), m_credentials->password())
+                ->request();
+        m_known_directories->add(resource_path);
+        directory = std::make_shared<WebdavDirectory>(
+                m_base_url,
+                m_dir_offset,
+                resource_path,
+                m_credentials,
+                m_request,
+                resource_path.filename().generic_string(),
+                std::chrono::system_clock::time_point(),
+                m_known_directories);
+    } catch(request::exceptions::response::MethodNotAllowed &e) {
+        throw exceptions::resource::ResourceConflict(resource_path);
+    } catch (...) {
+        WebdavExceptionTranslator::translate(resource_path);
+    }
+    return directory;
+}
+
+ResourceInfo WebdavDirectory::stat_resource(const std::filesystem::path &resource_path) const {
+    ResourceInfo info;
+    try {
+        const auto response_xml = this->propfind(resource_path, "0");
+        const auto response_node = response_xml->select_node(
+                "/*[local-name()='multistatus']/*[local-name()='response']").node();
+        std::string resource_href;
+        if (const auto parsed = parse_xml_resource(response_node, resource_href)) {
+            info = *parsed;
+        } else {
+            throw exceptions::cloud::CommunicationError("cannot get resource description");
+        }
+    } catch (...) {
+        WebdavExceptionTranslator::translate(resource_path);
+    }
+    return info;
+}
+
+std::shared_ptr<File> WebdavDirectory::put_file(
+        const std::filesystem::path &resource_path, const std::vector<std::uint8_t> &content) const {
+    std::shared_ptr<File> file;
+    try {
+        const auto response = m_request->PUT(m_base_url + m_dir_offset + resource_path.generic_string())
+                ->basic_auth(m_credentials->username(), m_credentials->password())
+                ->content_type(Request::MIMETYPE_BINARY)
+                ->binary_body(content)
+                ->request();
+        file = std::make_shared<WebdavFile>(
+                m_base_url + m_dir_offset,
+                resource_path,
+                m_credentials,
+                m_request,
+                resource_path.filename().generic_string(),
+                response.headers.at("etag"),
+                content.size());
+    } catch (...) {
+        WebdavExceptionTranslator::translate(resource_path);
+    }
+    return file;
+}
+
+std::optional<std::vector<BulkValue<std::shared_ptr<File>>>> WebdavDirectory::bulk_upload(
+        const std::string &server,
+        const std::vector<FileUpload> &files,
+        const std::map<std::filesystem::path, std::exception_ptr> &parent_errors) const {
+    using nextcloud::NextcloudBulkUpload;
+    auto results = bulk_results<BulkValue<std::shared_ptr<File>>>(paths_of(files));
+    // files are grouped into requests of at most MAX_PARTS files & about MAX_BYTES of content
+    std::vector<std::vector<std::size_t>> groups;
+    std::size_t group_bytes = 0;
+    for (std::size_t i = 0; i < files.size(); i++) {
+        const auto resource_path = append_path(files[i].path);
+        if (const auto &parent_error = parent_errors.at(resource_path.parent_path())) {
+            results[i].error = parent_error;
+            continue;
+        }
+        if (groups.empty() || groups.back().size() >= NextcloudBulkUpload::MAX_PARTS
+            || group_bytes >= NextcloudBulkUpload::MAX_BYTES) {
+            groups.emplace_back();
+            group_bytes = 0;
+        }
+        groups.back().push_back(i);
+        group_bytes += files[i].content.size();
+    }
+    const auto fail_group = [this, &results](const std::vector<std::size_t> &group) {
+        const auto error = translated_error([this] { WebdavExceptionTranslator::translate(m_path); });
+        for (const auto i: group) {
+            results[i].error = error;
+        }
+    };
+    for (std::size_t g = 0; g < groups.size(); g++) {
+        const auto &group = groups[g];
+        std::vector<NextcloudBulkUpload::Part> parts;
+        for (const auto i: group) {
+            std::optional<std::int64_t> modified;
+            if (files[i].modified) {
+                modified = std::chrono::duration_cast<std::chrono::seconds>(
+                        files[i].modified->time_since_epoch()).count();
+            }
+            parts.push_back({append_path(files[i].path).generic_string(), &files[i].content, modified});
+        }
+        try {
+            const auto response = m_request->POST(server + "/remote.php/dav/bulk")
+                    ->basic_auth(m_credentials->username(), m_credentials->password())
+                    ->content_type("multipart/related; boundary=" + BULK_BOUNDARY)
+                    ->accept(Request::MIMETYPE_JSON)
+                    ->binary_body(NextcloudBulkUpload::encode(parts, BULK_BOUNDARY))
+                    ->request();
+            const auto part_responses = NextcloudBulkUpload::decode(response.data, parts);
+            for (std::size_t j = 0; j < group.size(); j++) {
+                auto &result = results[group[j]];
+                const auto resource_path = append_path(result.path);
+                if (part_responses[j].error) {
+                    result.error = std::make_exception_ptr(exceptions::cloud::CommunicationError(
+                            "uploading " + resource_path.generic_string() + " failed: " + part_responses[j].message));
+                } else {
+                    result.value = std::make_shared<WebdavFile>(
+                            m_base_url + m_dir_offset,
+                            resource_path,
+                            m_credentials,
+                            m_request,
+                            resource_path.filename().generic_string(),
+                            part_responses[j].etag,
+                            files[group[j]].content.size());
+                }
+            }
+        } catch (const request::exceptions::response::ResponseException &e) {
+            if (g == 0 && (e.code == 404 || e.code == 405)) {
+                // the bulk endpoint has been added with nextcloud 23
+                return std::nullopt;
+            }
+            fail_group(group);
+        } catch (...) {
+            fail_group(group);
+        }
+    }
+    return results;
+}
+
 bool WebdavDirectory::resource_exists(const std::filesystem::path &resource_path) const {
     bool exists = true;
     try {
@@ -229,15 +857,3 @@ bool WebdavDirectory::resource_exists(const std::filesystem::path &resource_path
     }
     return exists;
 }
-
-void WebdavDirectory::create_parent_directories_if_missing(const std::filesystem::path &absolute_path) const {
-    const auto relative_path = absolute_path.lexically_relative(m_path);
-    if(relative_path.has_parent_path()) {
-        const auto relative_parent_path = relative_path.parent_path();
-        if(relative_parent_path.filename().generic_string() != "..") {
-            if(!resource_exists(m_path / relative_parent_path)) {
-                create_directory(relative_parent_path);
-            }
-        }
-    }
-}
@@ -2,7 +2,10 @@
 
 #include "DirectoryImpl.hpp"
 #include "credentials/BasicCredentialsImpl.hpp"
+#include "util/KnownDirectories.hpp"
 
+#include <map>
+#include <optional>
 #include <utility>
 #include "request/Response.hpp"
 
@@ -12,33 +15,135 @@ namespace CloudSync::webdav {
         WebdavDirectory(
                 const std::string &baseUrl, std::string dirOffset, const std::filesystem::path &dir,
                 std::shared_ptr<credentials::BasicCredentialsImpl> credentials,
-                const std::shared_ptr<request::Request> &request, const std::string &name)
-                : DirectoryImpl(baseUrl, dir, request, name)
+                const std::shared_ptr<request::Request> &request, const std::string &name,
+                std::chrono::system_clock::time_point modified = {},
+                std::shared_ptr<util::KnownDirectories> knownDirectories = nullptr,
+                std::string revision = "")
+                : DirectoryImpl(baseUrl, dir, request, name, modified, std::move(revision))
                 , m_credentials(std::move(credentials))
-                , m_dir_offset(std::move(dirOffset)) {};
+                , m_dir_offset(std::move(dirOffset))
+                , m_known_directories(knownDirectories ? std::move(knownDirectories) : std::make_shared<util::KnownDirectories>()) {};
 
         [[nodiscard]] std::vector<std::shared_ptr<Resource>> list_resources() const override;
 
+        [[nodiscard]] std::vector<ResourceInfo> list_resource_info() const override;
+
+        [[nodiscard]] std::shared_ptr<Resource> get_resource(const ResourceInfo &info) const override;
+
         [[nodiscard]] std::shared_ptr<Directory> get_directory(const std::filesystem::path &path) const override;
 
+        bool poll_change() override;
+
         void remove() override;
 
+        std::shared_ptr<Resource> copy_to(const std::filesystem::path &path) const override;
+
+        std::shared_ptr<Resource> move_to(const std::filesystem::path &path) override;
+
         std::shared_ptr<Directory> create_directory(const std::filesystem::path &path) const override;
 
         std::shared_ptr<File> create_file(const std::filesystem::path &path) const override;
 
+        std::shared_ptr<File> create_file(
+                const std::filesystem::path &path, const std::vector<std::uint8_t> &content) const override;
+
         std::shared_ptr<File> get_file(const std::filesystem::path &path) const override;
 
+        std::shared_ptr<Directory> ensure_directory(const std::filesystem::path &path) const override;
+
+        std::vector<BulkResult> remove_many(const std::vector<std::filesystem::path> &paths) const override;
+
+        std::vector<BulkValue<std::shared_ptr<Directory>>> create_directories(
+                const std::vector<std::filesystem::path> &paths) const override;
+
+        [[nodiscard]] std::vector<BulkValue<ResourceInfo>> stat_many(
+                const std::vector<std::filesystem::path> &paths) const override;
+
+        std::vector<BulkValue<std::shared_ptr<File>>> upload_many(const std::vector<FileUpload> &files) const override;
+
+        void search(const SearchQuery &query, const SearchPageHandler &on_page) const override;
+
+        [[nodiscard]] std::shared_ptr<Directory> with_new_connection() const override;
+
     private:
         static const std::string XML_QUERY;
+        /// results per `SEARCH` request
+        static const std::size_t SEARCH_PAGE_SIZE;
         const std::string m_dir_offset;
 
         const std::shared_ptr<credentials::BasicCredentialsImpl> m_credentials;
 
+        /// directories of this cloud that are known to exist, shared by all of its directory handles
+        const std::shared_ptr<util::KnownDirectories> m_known_directories;
+
+        /// `PROPFIND` request for the children of this directory (`Depth: 1`)
+        [[nodiscard]] std::shared_ptr<pugi::xml_document> propfind_children() const;
+
+        /// `PROPFIND` request for `resource_path` with the given `Depth` header
+        [[nodiscard]] std::shared_ptr<pugi::xml_document> propfind(
+                const std::filesystem::path &resource_path, const std::string &depth) const;
+
+        /// @return a copy of this directory that sends its requests with `request`
+        [[nodiscard]] std::shared_ptr<WebdavDirectory> with_request(const std::shared_ptr<request::Request> &request) const;
+
+        void delete_resource(const std::filesystem::path &resource_path) const;
+
+        /**
+         * Sends a `COPY` or `MOVE` of this directory that doesn't overwrite an existing resource.
+         * @return a handle for the directory at `destination`
+         */
+        [[nodiscard]] std::shared_ptr<Directory> transfer(const std::string &verb, const std::filesystem::path &destination) const;
+
+        /**
+         * Creates the collection at `resource_path` unless it exists. The `MKCOL` is sent first, parents are only
+         * looked at when the server reports one of them missing. Errors of the requests are not translated.
+         */
+        void ensure_collection(const std::filesystem::path &resource_path) const;
+
+        /// `ensure_collection()` for the parent of `resource_path`, with the errors translated
+        void ensure_parent_collection(const std::filesystem::path &resource_path) const;
+
+        /// `MKCOL` without checking for missing parents
+        [[nodiscard]] std::shared_ptr<Directory> make_collection(const std::filesystem::path &resource_path) const;
+
+        /// `PUT` without checking the revision or for missing parents
+        [[nodiscard]] std::shared_ptr<File> put_file(
+                const std::filesystem::path &resource_path, const std::vector<std::uint8_t> &content) const;
+
+        /**
+         * Uploads `files` with the nextcloud bulk endpoint.
+         * @param server url of the nextcloud server
+         * @param parent_errors errors of the parent folders of the files, by their path
+         * @return nothing if the server has no bulk endpoint
+         */
+        [[nodiscard]] std::optional<std::vector<BulkValue<std::shared_ptr<File>>>> bulk_upload(
+                const std::string &server,
+                const std::vector<FileUpload> &files,
+                const std::map<std::filesystem::path, std::exception_ptr> &parent_errors) const;
+
+        /**
+         * Runs `query` with a nextcloud `SEARCH` request ([DASL](https://docs.nextcloud.com/server/latest/developer_manual/client_apis/WebDAV/search.html)),
+         * one page of SEARCH_PAGE_SIZE results at a time.
+         * @param server url of the nextcloud server
+         * @return false if the server doesn't support searching
+         */
+        bool dasl_search(const std::string &server, const SearchQuery &query, const SearchPageHandler &on_page) const;
+
+        [[nodiscard]] ResourceInfo stat_resource(const std::filesystem::path &resource_path) const;
+
         [[nodiscard]] std::vector<std::shared_ptr<Resource>> parse_xml_response(const pugi::xml_node &response) const;
 
-        bool resource_exists(const std::filesystem::path& resource_path) const;
+        [[nodiscard]] std::vector<ResourceInfo> parse_xml_resource_info(const pugi::xml_node &response) const;
 
-        void create_parent_directories_if_missing(const std::filesystem::path& absolute_path) const;
+        /**
+         * Reads a single `response` node of a PROPFIND result.
+         * @param resource_href is set to the path of the described resource.
+         * @return nothing if the node describes this directory itself or can't be resolved to a resource.
+         */
+        [[nodiscard]] std::optional<ResourceInfo> parse_xml_resource(const pugi::xml_node &responseNode, std::string &resource_href) const;
+
+        [[nodiscard]] std::shared_ptr<Resource> make_resource(const std::filesystem::path &resource_path, const ResourceInfo &info) const;
+
+        bool resource_exists(const std::filesystem::path& resource_path) const;
     };
 } // namespace CloudSync::webdav
@@ -21,6 +21,10 @@ namespace CloudSync::webdav {
                 throw exceptions::resource::PermissionDenied(path);
             } catch (request::exceptions::response::Unauthorized &e) {
                 throw exceptions::cloud::AuthorizationFailed();
+            } catch (request::exceptions::response::TooManyRequests &e) {
+                throw exceptions::cloud::Throttled(e.what(), e.retry_after);
+            } catch (request::exceptions::response::ServiceUnavailable &e) {
+                throw exceptions::cloud::Throttled(e.what(), e.retry_after);
             } catch (request::exceptions::response::ResponseException &e) {
                 throw exceptions::cloud::CommunicationError(e.what());
             } catch (request::exceptions::RequestException &e) {
@@ -1,7 +1,13 @@
 #include "WebdavFile.hpp"
 #include "request/Request.hpp"
 #include "WebdavExceptionTranslator.hpp"
+#include "nextcloud/NextcloudUploadSession.hpp"
 #include "CloudSync/exceptions/cloud/CloudException.hpp"
+#include "util/DateTime.hpp"
+#include "util/EndpointConcurrency.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 
 using namespace CloudSync;
 using namespace CloudSync::request;
@@ -11,12 +17,18 @@ using namespace pugi;
 
 const std::string WebdavFile::XML_QUERY =
     "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
-    "<d:propfind xmlns:d=\"DAV:\">"
+    "<d:propfind xmlns:d=\"DAV:\" xmlns:oc=\"http://owncloud.org/ns\">"
         "<d:prop>"
             "<d:getetag/>"
+            "<d:getlastmodified/>"
+            "<d:getcontentlength/>"
+            "<d:getcontenttype/>"
+            "<oc:checksums/>"
         "</d:prop>"
     "</d:propfind>";
 
+const std::string WebdavFile::PARTIAL_UPDATE_MIMETYPE = "application/x-sabredav-partialupdate";
+
 void WebdavFile::remove() {
     try {
         m_request->DELETE(m_resource_path)
@@ -27,6 +39,51 @@ void WebdavFile::remove() {
     }
 }
 
+std::shared_ptr<Resource> WebdavFile::copy_to(const std::filesystem::path &path) const {
+    return this->transfer("COPY", destination_path(path));
+}
+
+std::shared_ptr<Resource> WebdavFile::move_to(const std::filesystem::path &path) {
+    return this->transfer("MOVE", destination_path(path));
+}
+
+std::shared_ptr<WebdavFile> WebdavFile::transfer(const std::string &verb, const std::filesystem::path &destination) const {
+    std::shared_ptr<WebdavFile> file;
+    try {
+        const auto response = m_request->resource(verb, m_resource_path)
+                ->basic_auth(m_credentials->username(), m_credentials->password())
+                ->header("Destination", m_base_url + destination.generic_string())
+                ->header("Overwrite", "F")
+                ->request();
+        file = std::make_shared<WebdavFile>(
+                m_base_url,
+                destination,
+                m_credentials,
+                m_request,
+                destination.filename().generic_string(),
+                revision(),
+                m_size,
+                m_modified,
+                m_content_type,
+                m_content_hash);
+        if (const auto etag = response.headers.find("etag"); etag != response.headers.end()) {
+            file->m_revision = etag->second;
+        } else if (verb == "COPY") {
+            // a copy may have an etag of its own, which the server doesn't always report
+            file->poll_change();
+        }
+    } catch (const request::exceptions::response::PreconditionFailed &e) {
+        // `Overwrite: F` and the destination exists
+        throw exceptions::resource::ResourceConflict(destination);
+    } catch (const request::exceptions::response::Conflict &e) {
+        // the parent of the destination doesn't exist
+        throw exceptions::resource::NoSuchResource(destination.parent_path());
+    } catch (...) {
+        WebdavExceptionTranslator::translate(m_path);
+    }
+    return file;
+}
+
 bool WebdavFile::poll_change() {
     bool has_changed = false;
     try {
@@ -39,19 +96,26 @@ bool WebdavFile::poll_change() {
                 ->body(XML_QUERY)
                 ->request();
 
-        const std::string new_revision = response.xml()
-                ->select_node("/*[local-name()='multistatus']"
-                              "/*[local-name()='response']"
-                              "/*[local-name()='propstat']"
-                              "/*[local-name()='prop']"
-                              "/*[local-name()='getetag']")
-                .node()
-                .child_value();
+        const auto response_xml = response.xml();
+        const auto property = [&response_xml](const std::string &name) {
+            return response_xml->select_node(("/*[local-name()='multistatus']"
+                                              "/*[local-name()='response']"
+                                              "/*[local-name()='propstat']"
+                                              "/*[local-name()='prop']"
+                                              "/*[local-name()='" + name + "']").c_str()).node();
+        };
+        const std::string new_revision = property("getetag").child_value();
         if (!new_revision.empty()) {
             if (revision() != new_revision) {
                 has_changed = true;
                 m_revision = new_revision;
             }
+            m_size = std::strtoull(property("getcontentlength").child_value(), nullptr, 10);
+            m_content_type = property("getcontenttype").child_value();
+            m_content_hash = parse_checksums(checksums_text(property("checksums")));
+            if (const auto modified = util::parse_rfc1123(property("getlastmodified").child_value())) {
+                m_modified = *modified;
+            }
         } else {
             throw exceptions::cloud::InvalidResponse("reading XML failed: missing required 'getetag' property");
         }
@@ -92,6 +156,9 @@ void WebdavFile::write(const std::string& content) {
                 ->body(content)
                 ->request();
         m_revision = response.headers.at("etag");
+        m_size = content.size();
+        // the checksums of the new content are only known once a client has stored them
+        m_content_hash = std::nullopt;
     } catch (...) {
         WebdavExceptionTranslator::translate(m_path);
     }
@@ -103,6 +170,83 @@ void WebdavFile::write_binary(const std::vector<std::uint8_t> &content) {
                 ->binary_body(content)
                 ->request();
         m_revision = response.headers.at("etag");
+        m_size = content.size();
+        // the checksums of the new content are only known once a client has stored them
+        m_content_hash = std::nullopt;
+    } catch (...) {
+        WebdavExceptionTranslator::translate(m_path);
+    }
+}
+
+void WebdavFile::upload_chunked(const upload::UploadSource &source) {
+    const auto server_url = nextcloud::NextcloudUploadSession::server_url(m_base_url);
+    if (!server_url) {
+        // plain webdav has no way to upload a file in parts, the file is streamed with a single request instead
+        try {
+            const auto response = prepare_write_request()
+                    ->file_body(source.path())
+                    ->request();
+            m_revision = response.headers.at("etag");
+            m_size = source.size();
+            m_content_hash = std::nullopt;
+        } catch (...) {
+            WebdavExceptionTranslator::translate(m_path);
+        }
+        return;
+    }
+    try {
+        nextcloud::NextcloudUploadSession session(
+                *server_url, m_path.generic_string(), this->revision(), m_credentials, m_request);
+        upload::ChunkedUpload(m_request, session, source, util::endpoint_controller(*server_url)).run();
+        m_revision = session.etag();
+        m_size = source.size();
+        m_content_hash = std::nullopt;
+    } catch (...) {
+        WebdavExceptionTranslator::translate(m_path);
+    }
+}
+
+void WebdavFile::write_range(std::uint64_t offset, const std::vector<std::uint8_t> &data) {
+    if (data.empty()) {
+        return;
+    }
+    // the last byte of the range is inclusive
+    this->patch(
+            "bytes=" + std::to_string(offset) + "-" + std::to_string(offset + data.size() - 1),
+            data,
+            std::max<std::uint64_t>(m_size, offset + data.size()));
+}
+
+void WebdavFile::append(const std::vector<std::uint8_t> &data) {
+    if (data.empty()) {
+        return;
+    }
+    this->patch("append", data, m_size + data.size());
+}
+
+void WebdavFile::patch(const std::string &update_range, const std::vector<std::uint8_t> &data, std::uint64_t size) {
+    try {
+        const auto response = m_request->PATCH(m_resource_path)
+                ->basic_auth(m_credentials->username(), m_credentials->password())
+                ->if_match(revision())
+                ->header("X-Update-Range", update_range)
+                ->content_type(PARTIAL_UPDATE_MIMETYPE)
+                ->binary_body(data)
+                ->request();
+        m_size = size;
+        m_content_hash = std::nullopt;
+        if (const auto etag = response.headers.find("etag"); etag != response.headers.end()) {
+            m_revision = etag->second;
+        } else {
+            // the revision has changed for sure, without it the next write would fail
+            this->poll_change();
+        }
+    } catch (const request::exceptions::response::ResponseException &e) {
+        if (e.code == 405 || e.code == 501) {
+            // sabre/dav without the partial update plugin, or a server that isn't based on sabre/dav at all
+            throw exceptions::cloud::OperationNotSupported("partial updates of " + m_path.generic_string());
+        }
+        WebdavExceptionTranslator::translate(m_path);
     } catch (...) {
         WebdavExceptionTranslator::translate(m_path);
     }
@@ -114,3 +258,39 @@ std::shared_ptr<request::Request> WebdavFile::prepare_write_request() const {
             ->if_match(revision())
             ->content_type(Request::MIMETYPE_BINARY);
 }
+
+std::optional<ContentHash> WebdavFile::parse_checksums(const std::string &checksums) {
+    static const std::pair<std::string, ContentHash::Algorithm> PREFERRED[] = {
+            {"SHA256:", ContentHash::Algorithm::SHA256},
+            {"SHA1:", ContentHash::Algorithm::SHA1},
+            {"MD5:", ContentHash::Algorithm::MD5}};
+    for (const auto &[prefix, algorithm]: PREFERRED) {
+        std::size_t start = 0;
+        while (start < checksums.size()) {
+            auto end = checksums.find(' ', start);
+            if (end == std::string::npos) {
+                end = checksums.size();
+            }
+            if (checksums.compare(start, prefix.size(), prefix) == 0 && end > start + prefix.size()) {
+                auto value = checksums.substr(start + prefix.size(), end - start - prefix.size());
+                std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+                    return static_cast<char>(std::tolower(c));
+                });
+                return ContentHash{algorithm, value};
+            }
+            start = end + 1;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string WebdavFile::checksums_text(const xml_node &checksums) {
+    std::string text;
+    for (const auto checksum: checksums.children()) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += checksum.child_value();
+    }
+    return text;
+}
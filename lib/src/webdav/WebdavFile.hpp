@@ -11,14 +11,22 @@ namespace CloudSync::webdav {
                 const std::string &baseUrl, const std::filesystem::path &dir,
                 std::shared_ptr<credentials::BasicCredentialsImpl> credentials,
                 const std::shared_ptr<request::Request> &request,
-                const std::string &name, const std::string &revision)
-                : FileImpl(baseUrl, dir, request, name, revision)
+                const std::string &name, const std::string &revision,
+                std::uint64_t size = 0,
+                std::chrono::system_clock::time_point modified = {},
+                const std::string &content_type = "",
+                std::optional<ContentHash> content_hash = std::nullopt)
+                : FileImpl(baseUrl, dir, request, name, revision, size, modified, content_type, std::move(content_hash))
                 , m_credentials(std::move(credentials))
                 , m_resource_path(m_base_url + m_path.generic_string()){
         };
 
         void remove() override;
 
+        std::shared_ptr<Resource> copy_to(const std::filesystem::path &path) const override;
+
+        std::shared_ptr<Resource> move_to(const std::filesystem::path &path) override;
+
         bool poll_change() override;
 
         [[nodiscard]] std::string read() const override;
@@ -27,13 +35,43 @@ namespace CloudSync::webdav {
         void write(const std::string& content) override;
         void write_binary(const std::vector<std::uint8_t>& content) override;
 
+        void write_range(std::uint64_t offset, const std::vector<std::uint8_t>& data) override;
+        void append(const std::vector<std::uint8_t>& data) override;
+
+        /**
+         * Picks the strongest hash from the `oc:checksums` property of owncloud & nextcloud, e.g.
+         * `SHA1:4ec2… MD5:0d60… ADLER32:64c1…`. The checksums are those the uploading client has stored with the file.
+         * @return `std::nullopt` if there is no SHA256, SHA1 or MD5 checksum.
+         */
+        static std::optional<ContentHash> parse_checksums(const std::string &checksums);
+
+        /// @return the text of all `oc:checksum` children of an `oc:checksums` property, separated by spaces.
+        static std::string checksums_text(const pugi::xml_node &checksums);
+
+    protected:
+        void upload_chunked(const upload::UploadSource &source) override;
+
     private:
         static const std::string XML_QUERY;
+        static const std::string PARTIAL_UPDATE_MIMETYPE;
         const std::shared_ptr<credentials::BasicCredentialsImpl> m_credentials;
 
         const std::string m_resource_path;
 
+        /**
+         * Sends a `COPY` or `MOVE` that doesn't overwrite an existing resource.
+         * @return a handle for the file at `destination`
+         */
+        std::shared_ptr<WebdavFile> transfer(const std::string &verb, const std::filesystem::path &destination) const;
+
         std::shared_ptr<request::Request> prepare_read_request() const;
         std::shared_ptr<request::Request> prepare_write_request() const;
+
+        /**
+         * Sends a [sabre/dav partial update](https://sabre.io/dav/http-patch/) of the file.
+         * @param update_range value of the `X-Update-Range` header, `append` or `bytes=<first>-<last>`
+         * @param size the size of the file after the update
+         */
+        void patch(const std::string &update_range, const std::vector<std::uint8_t> &data, std::uint64_t size);
     };
 } // namespace CloudSync::webdav
@@ -0,0 +1,124 @@
+#include "CloudSync/ConcurrencyController.hpp"
+#include "request/exceptions/response/ResponseException.hpp"
+#include <catch2/catch.hpp>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace std::chrono_literals;
+
+namespace {
+    void succeed(ConcurrencyController &controller, std::size_t times, ConcurrencyController::Clock::duration latency) {
+        for (std::size_t i = 0; i < times; i++) {
+            controller.succeeded(latency);
+        }
+    }
+}
+
+SCENARIO("ConcurrencyController", "[concurrency]") {
+    GIVEN("a controller that starts with 4 requests") {
+        ConcurrencyLimits limits;
+        limits.initial = 4;
+        ConcurrencyController controller(limits);
+        REQUIRE(controller.limit() == 4);
+
+        WHEN("rounds of requests succeed at the same latency") {
+            succeed(controller, 4, 10ms);
+            succeed(controller, 5, 10ms);
+            THEN("the limit should grow by one per round") {
+                REQUIRE(controller.limit() == 6);
+            }
+        }
+        WHEN("a request is throttled") {
+            controller.throttled();
+            THEN("the limit should be halved") {
+                REQUIRE(controller.limit() == 2);
+                REQUIRE(controller.paused_until() <= ConcurrencyController::Clock::now());
+            }
+            AND_WHEN("the requests that have been in flight with it are throttled as well") {
+                controller.throttled();
+                controller.throttled();
+                THEN("the limit should only have been halved once") {
+                    REQUIRE(controller.limit() == 2);
+                }
+                AND_WHEN("a request is throttled after that round") {
+                    controller.throttled();
+                    controller.succeeded(10ms);
+                    controller.throttled();
+                    THEN("the limit should be halved again") {
+                        REQUIRE(controller.limit() == 1);
+                    }
+                }
+            }
+        }
+        WHEN("a throttled request asks to retry after a while") {
+            const auto before = ConcurrencyController::Clock::now();
+            controller.throttled(std::chrono::seconds(120));
+            THEN("the endpoint should be paused until then") {
+                REQUIRE(controller.paused_until() >= before + std::chrono::seconds(120));
+            }
+        }
+        WHEN("a response that asks to retry after a while is reported") {
+            const auto before = ConcurrencyController::Clock::now();
+            controller.report(10ms, std::make_exception_ptr(
+                    request::exceptions::response::TooManyRequests("", std::chrono::seconds(120))));
+            THEN("it should count as throttled") {
+                REQUIRE(controller.limit() == 2);
+                REQUIRE(controller.paused_until() >= before + std::chrono::seconds(120));
+            }
+        }
+        WHEN("a round of requests that have been answered with client errors is reported") {
+            for (int i = 0; i < 4; i++) {
+                controller.report(10ms, std::make_exception_ptr(request::exceptions::response::Conflict()));
+            }
+            THEN("the limit should grow, as the endpoint has answered all of them") {
+                REQUIRE(controller.limit() == 5);
+            }
+        }
+        WHEN("the latency grows beyond the tolerance") {
+            succeed(controller, 4, 10ms);
+            REQUIRE(controller.limit() == 5);
+            succeed(controller, 5, 50ms);
+            THEN("the limit should be halved") {
+                REQUIRE(controller.limit() == 2);
+            }
+        }
+        WHEN("the latency grows within the tolerance") {
+            succeed(controller, 4, 10ms);
+            succeed(controller, 5, 15ms);
+            THEN("the limit should still grow") {
+                REQUIRE(controller.limit() == 6);
+            }
+        }
+        WHEN("many requests of a round fail") {
+            succeed(controller, 2, 10ms);
+            controller.failed();
+            controller.failed();
+            THEN("the limit should be kept") {
+                REQUIRE(controller.limit() == 4);
+            }
+        }
+    }
+    GIVEN("a controller with narrow bounds") {
+        ConcurrencyLimits limits;
+        limits.initial = 3;
+        limits.min = 2;
+        limits.max = 4;
+        ConcurrencyController controller(limits);
+        WHEN("all requests succeed for a long time") {
+            for (int round = 0; round < 10; round++) {
+                succeed(controller, controller.limit(), 10ms);
+            }
+            THEN("the limit should stop at the maximum") {
+                REQUIRE(controller.limit() == 4);
+            }
+        }
+        WHEN("requests are throttled for a long time") {
+            for (int i = 0; i < 20; i++) {
+                controller.throttled();
+            }
+            THEN("the limit should stop at the minimum") {
+                REQUIRE(controller.limit() == 2);
+            }
+        }
+    }
+}
@@ -75,6 +75,44 @@ SCENARIO("DropboxDirectory", "[directory][dropbox]") {
                     REQUIRE(list[1]->name() == "test.txt");
                     REQUIRE(list[1]->path() == "/test.txt");
                 }
+                THEN("size & modification time of the file should be kept") {
+                    const auto file = std::dynamic_pointer_cast<File>(list[1]);
+                    REQUIRE(file->size() == 11048);
+                    REQUIRE(file->modified() == std::chrono::system_clock::time_point(std::chrono::seconds(1580331650)));
+                }
+                THEN("the content hash of the file should be kept") {
+                    const auto file = std::dynamic_pointer_cast<File>(list[1]);
+                    REQUIRE(file->content_hash() == ContentHash{ContentHash::Algorithm::DROPBOX, "a59943f6fe5e4cbc540"});
+                }
+            }
+            WHEN("calling list_resource_info() on the directory") {
+                const auto list = directory->list_resource_info();
+                THEN("the dropbox list_folder endpoint should be called") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, url == "https://api.dropboxapi.com/2/files/list_folder");
+                }
+                THEN("a description of all resources contained in the directory should be returned") {
+                    REQUIRE(list.size() == 2);
+                    REQUIRE(list[0].name == "test");
+                    REQUIRE(list[0].id == "id:O4T7biRqN_EAAAAAAAANRg");
+                    REQUIRE(list[0].kind == ResourceInfo::Kind::DIRECTORY);
+                    REQUIRE(list[1].name == "test.txt");
+                    REQUIRE(list[1].kind == ResourceInfo::Kind::FILE);
+                    REQUIRE(list[1].revision == "0159d4da2a6fc2100000001a2504350");
+                    REQUIRE(list[1].size == 11048);
+                    REQUIRE(list[1].modified == std::chrono::system_clock::time_point(std::chrono::seconds(1580331650)));
+                    REQUIRE(list[1].content_hash == ContentHash{ContentHash::Algorithm::DROPBOX, "a59943f6fe5e4cbc540"});
+                    REQUIRE_FALSE(list[0].content_hash.has_value());
+                }
+                AND_WHEN("calling get_resource() for the file entry") {
+                    const auto file = std::dynamic_pointer_cast<File>(directory->get_resource(list[1]));
+                    THEN("a file handle should be returned without making another request") {
+                        Verify(Method(requestMock, request)).Once();
+                        REQUIRE(file->path() == "/test.txt");
+                        REQUIRE(file->revision() == "0159d4da2a6fc2100000001a2504350");
+                        REQUIRE(file->content_hash() == list[1].content_hash);
+                    }
+                }
             }
         }
         AND_GIVEN("2 requests that return a valid dropbox directory listing with `has_more: true` and 1 returning `has_more: false`") {
@@ -219,6 +257,34 @@ SCENARIO("DropboxDirectory", "[directory][dropbox]") {
                 }
             }
         }
+        AND_GIVEN("a request that fails because a folder exists at the path") {
+            When(Method(requestMock, request)).Throw(request::exceptions::response::Conflict(
+                json{{"error_summary", "path/conflict/folder/.."}}.dump()));
+
+            WHEN("calling ensure_directory(a/b) twice") {
+                directory->ensure_directory("a/b");
+                const auto newDir = directory->ensure_directory("a/b");
+                THEN("create_folder_v2 should only be called once for the folder itself") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, url == "https://api.dropboxapi.com/2/files/create_folder_v2");
+                    REQUIRE_REQUEST(0, body == "{\"autorename\":false,\"path\":\"/a/b\"}");
+                }
+                THEN("the existing folder should be returned") {
+                    REQUIRE(newDir->path() == "/a/b");
+                }
+            }
+        }
+        AND_GIVEN("a request that fails because a file exists at the path") {
+            When(Method(requestMock, request)).Throw(request::exceptions::response::Conflict(
+                json{{"error_summary", "path/conflict/file/.."}}.dump()));
+
+            WHEN("calling ensure_directory(a)") {
+                THEN("a ResourceConflict exception should be thrown") {
+                    REQUIRE_THROWS_AS(
+                        directory->ensure_directory("a"), CloudSync::exceptions::resource::ResourceConflict);
+                }
+            }
+        }
         AND_GIVEN("a request that returns a valid file metadata description (without .tag)") {
             When(Method(requestMock, request)).Return(request::StringResponse(
                 200,
@@ -253,6 +319,23 @@ SCENARIO("DropboxDirectory", "[directory][dropbox]") {
                     REQUIRE(newFile->revision() == "0159d4da2a6fc2100000001a2504350");
                 }
             }
+            WHEN("calling create_file(test.txt, abc)") {
+                auto newFile = directory->create_file("test.txt", {'a', 'b', 'c'});
+
+                THEN("the dropbox upload endpoint should be called in add mode with the content as request body") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "POST");
+                    REQUIRE_REQUEST(0, url == "https://content.dropboxapi.com/2/files/upload");
+                    REQUIRE_REQUEST(
+                        0,
+                        query_params.at("arg") == "{\"autorename\":false,\"mode\":\"add\",\"path\":\"/test.txt\"}");
+                    REQUIRE_REQUEST(0, binary_body == std::vector<std::uint8_t>{'a', 'b', 'c'});
+                }
+                THEN("a new file called 'test.txt' should be returned") {
+                    REQUIRE(newFile->name() == "test.txt");
+                    REQUIRE(newFile->revision() == "0159d4da2a6fc2100000001a2504350");
+                }
+            }
         }
         AND_GIVEN("a request that returns a valid file metadata description (with .tag)") {
             When(Method(requestMock, request)).Return(request::StringResponse(
@@ -370,6 +453,198 @@ SCENARIO("DropboxDirectory", "[directory][dropbox]") {
             }
         }
     }
+    GIVEN("a dropbox root directory and a batch job that completes asynchronously") {
+        const auto directory = std::make_shared<DropboxDirectory>("/", credentials, request, "");
+        When(Method(requestMock, request))
+            .Return(request::StringResponse(200, json{{".tag", "async_job_id"}, {"async_job_id", "dbjid:AAC"}}.dump(), "application/json"))
+            .Return(request::StringResponse(200, json{{".tag", "in_progress"}}.dump(), "application/json"))
+            .Return(request::StringResponse(200, json{
+                {".tag", "complete"},
+                {"entries", {
+                    {{".tag", "success"}, {"metadata", {{"name", "a"}, {"path_display", "/a"}}}},
+                    {{".tag", "failure"}, {"failure", {{".tag", "path_lookup"}, {"path_lookup", {{".tag", "not_found"}}}}}}
+                }}}.dump(), "application/json"));
+        WHEN("calling remove_many(a, b)") {
+            const auto results = directory->remove_many({"a", "b"});
+            THEN("the delete_batch endpoint should be called once with all paths") {
+                REQUIRE_REQUEST(0, verb == "POST");
+                REQUIRE_REQUEST(0, url == "https://api.dropboxapi.com/2/files/delete_batch");
+                REQUIRE_REQUEST(0, body == "{\"entries\":[{\"path\":\"/a\"},{\"path\":\"/b\"}]}");
+            }
+            THEN("the job should be polled until it has completed") {
+                Verify(Method(requestMock, request)).Exactly(3);
+                REQUIRE_REQUEST(1, url == "https://api.dropboxapi.com/2/files/delete_batch/check");
+                REQUIRE_REQUEST(1, body == "{\"async_job_id\":\"dbjid:AAC\"}");
+                REQUIRE_REQUEST(2, url == "https://api.dropboxapi.com/2/files/delete_batch/check");
+            }
+            THEN("every path should have its own result") {
+                REQUIRE(results.size() == 2);
+                REQUIRE(results[0].ok());
+                REQUIRE_THROWS_AS(results[1].rethrow_if_failed(), CloudSync::exceptions::resource::NoSuchResource);
+            }
+        }
+        WHEN("calling create_directories(a, b)") {
+            const auto results = directory->create_directories({"a", "b"});
+            THEN("the create_folder_batch endpoint should be called once with all paths") {
+                REQUIRE_REQUEST(0, url == "https://api.dropboxapi.com/2/files/create_folder_batch");
+                REQUIRE_REQUEST(0, body == "{\"autorename\":false,\"force_async\":false,\"paths\":[\"/a\",\"/b\"]}");
+                REQUIRE_REQUEST(1, url == "https://api.dropboxapi.com/2/files/create_folder_batch/check");
+            }
+            THEN("the created directory should be returned and the failure reported") {
+                REQUIRE(results[0].ok());
+                REQUIRE(results[0].value->path() == "/a");
+                REQUIRE_FALSE(results[1].ok());
+                REQUIRE(results[1].value == nullptr);
+            }
+        }
+    }
+    GIVEN("a dropbox root directory and a get_metadata request") {
+        const auto directory = std::make_shared<DropboxDirectory>("/", credentials, request, "");
+        When(Method(requestMock, request)).Return(request::StringResponse(
+            200,
+            json{{".tag", "file"}, {"name", "a.txt"}, {"path_display", "/a.txt"}, {"size", 12}}.dump(),
+            "application/json"));
+        WHEN("calling stat_many(a.txt)") {
+            const auto results = directory->stat_many({"a.txt"});
+            THEN("the get_metadata endpoint should be called, as there is no batch version of it") {
+                Verify(Method(requestMock, request)).Once();
+                REQUIRE_REQUEST(0, url == "https://api.dropboxapi.com/2/files/get_metadata");
+                REQUIRE_REQUEST(0, body == "{\"path\":\"/a.txt\"}");
+            }
+            THEN("the resource info should be returned") {
+                REQUIRE(results.size() == 1);
+                REQUIRE(results[0].ok());
+                REQUIRE(results[0].value.kind == ResourceInfo::Kind::FILE);
+                REQUIRE(results[0].value.size == 12);
+            }
+        }
+    }
+    GIVEN("a dropbox root directory and an upload session that can be committed") {
+        const auto directory = std::make_shared<DropboxDirectory>("/", credentials, request, "");
+        When(Method(requestMock, request))
+            .Return(request::StringResponse(200, json{{"session_id", "sid:a"}}.dump(), "application/json"))
+            .Return(request::StringResponse(200, json{
+                {"entries", {
+                    {{".tag", "success"}, {"name", "a.txt"}, {"path_display", "/folder/a.txt"}, {"rev", "0159d4"}, {"size", 3}}
+                }}}.dump(), "application/json"));
+        WHEN("calling upload_many(folder/a.txt)") {
+            const auto results = directory->upload_many({{"folder/a.txt", {1, 2, 3}}});
+            THEN("the content should be sent to a closed upload session") {
+                REQUIRE_REQUEST(0, verb == "POST");
+                REQUIRE_REQUEST(0, url == "https://content.dropboxapi.com/2/files/upload_session/start");
+                REQUIRE_REQUEST(0, query_params.at("arg") == "{\"close\":true}");
+                REQUIRE_REQUEST(0, binary_body == std::vector<std::uint8_t>{1, 2, 3});
+            }
+            THEN("all sessions should be committed with a single finish_batch call") {
+                Verify(Method(requestMock, request)).Exactly(2);
+                REQUIRE_REQUEST(1, url == "https://api.dropboxapi.com/2/files/upload_session/finish_batch_v2");
+                REQUIRE_REQUEST(1, body == "{\"entries\":[{\"commit\":{\"autorename\":false,\"mode\":\"overwrite\","
+                                           "\"mute\":true,\"path\":\"/folder/a.txt\"},"
+                                           "\"cursor\":{\"offset\":3,\"session_id\":\"sid:a\"}}]}");
+            }
+            THEN("a handle with the new revision should be returned") {
+                REQUIRE(results.size() == 1);
+                REQUIRE(results[0].ok());
+                REQUIRE(results[0].value->path() == "/folder/a.txt");
+                REQUIRE(results[0].value->revision() == "0159d4");
+                REQUIRE(results[0].value->size() == 3);
+            }
+        }
+    }
+    GIVEN("a dropbox root directory and a commit that fails for a file") {
+        const auto directory = std::make_shared<DropboxDirectory>("/", credentials, request, "");
+        When(Method(requestMock, request))
+            .Return(request::StringResponse(200, json{{"session_id", "sid:a"}}.dump(), "application/json"))
+            .Return(request::StringResponse(200, json{
+                {"entries", {
+                    {{".tag", "failure"}, {"failure", {{".tag", "path"}, {"path", {{".tag", "conflict"}, {"conflict", {{".tag", "folder"}}}}}}}}
+                }}}.dump(), "application/json"));
+        WHEN("calling upload_many(a)") {
+            const auto results = directory->upload_many({{"a", {1}}});
+            THEN("the failure should be reported for that file") {
+                REQUIRE_THROWS_AS(results[0].rethrow_if_failed(), CloudSync::exceptions::resource::ResourceConflict);
+            }
+        }
+    }
+    GIVEN("a dropbox directory and two pages of search matches") {
+        const auto directory = std::make_shared<DropboxDirectory>("/docs", credentials, request, "docs");
+        const auto match = [](const json &metadata) {
+            return json{{"match_type", {{".tag", "filename"}}}, {"metadata", {{".tag", "metadata"}, {"metadata", metadata}}}};
+        };
+        When(Method(requestMock, request))
+            .Return(request::StringResponse(200, json{
+                {"matches", {
+                    match({{".tag", "file"}, {"name", "Report.pdf"}, {"path_display", "/docs/Report.pdf"}, {"rev", "01"}, {"size", 3}}),
+                    match({{".tag", "file"}, {"name", "reports.txt"}, {"path_display", "/docs/old/reports.txt"}, {"rev", "02"}})
+                }},
+                {"has_more", true},
+                {"cursor", "c1"}}.dump(), "application/json"))
+            .Return(request::StringResponse(200, json{
+                {"matches", {
+                    match({{".tag", "file"}, {"name", "rep ort.pdf"}, {"path_display", "/docs/rep ort.pdf"}, {"rev", "03"}}),
+                    match({{".tag", "folder"}, {"name", "report"}, {"path_display", "/docs/report"}})
+                }},
+                {"has_more", false}}.dump(), "application/json"));
+        WHEN("searching for files named report") {
+            SearchQuery query;
+            query.name = "report";
+            query.kind = ResourceInfo::Kind::FILE;
+            std::vector<std::vector<SearchResult>> pages;
+            directory->search(query, [&pages](const std::vector<SearchResult> &page) {
+                pages.push_back(page);
+                return true;
+            });
+            THEN("search_v2 should be called for the directory and continued with the cursor") {
+                Verify(Method(requestMock, request)).Exactly(2);
+                REQUIRE_REQUEST(0, url == "https://api.dropboxapi.com/2/files/search_v2");
+                REQUIRE_REQUEST(0, body == "{\"options\":{\"file_status\":\"active\",\"filename_only\":true,"
+                                           "\"max_results\":1000,\"path\":\"/docs\"},\"query\":\"report\"}");
+                REQUIRE_REQUEST(1, url == "https://api.dropboxapi.com/2/files/search/continue_v2");
+                REQUIRE_REQUEST(1, body == "{\"cursor\":\"c1\"}");
+            }
+            THEN("only the files that match the query should be handed over, page by page") {
+                REQUIRE(pages.size() == 1);
+                REQUIRE(pages[0].size() == 2);
+                REQUIRE(pages[0][0].path == "/docs/Report.pdf");
+                REQUIRE(pages[0][0].info.revision == "01");
+                REQUIRE(pages[0][0].info.size == 3);
+                REQUIRE(pages[0][1].path == "/docs/old/reports.txt");
+            }
+        }
+        WHEN("stopping the search after the first page") {
+            directory->search(SearchQuery{"report"}, [](const std::vector<SearchResult> &) {
+                return false;
+            });
+            THEN("the next page should not be requested") {
+                Verify(Method(requestMock, request)).Once();
+            }
+        }
+    }
+    GIVEN("a dropbox root directory and a recursive listing") {
+        const auto directory = std::make_shared<DropboxDirectory>("/", credentials, request, "");
+        When(Method(requestMock, request)).Return(request::StringResponse(200, json{
+            {"entries", {
+                {{".tag", "folder"}, {"name", "a"}, {"path_display", "/a"}},
+                {{".tag", "file"}, {"name", "b.txt"}, {"path_display", "/a/b.txt"}, {"rev", "01"}}
+            }},
+            {"has_more", false},
+            {"cursor", "c1"}}.dump(), "application/json"));
+        WHEN("searching for folders without a name") {
+            SearchQuery query;
+            query.kind = ResourceInfo::Kind::DIRECTORY;
+            std::vector<SearchResult> results;
+            directory->search(query, [&results](const std::vector<SearchResult> &page) {
+                results.insert(results.end(), page.begin(), page.end());
+                return true;
+            });
+            THEN("the whole tree should be listed, as search_v2 needs a text to look for") {
+                REQUIRE_REQUEST(0, url == "https://api.dropboxapi.com/2/files/list_folder");
+                REQUIRE_REQUEST(0, body == "{\"path\":\"\",\"recursive\":true}");
+                REQUIRE(results.size() == 1);
+                REQUIRE(results[0].path == "/a");
+            }
+        }
+    }
     GIVEN("a dropbox (non-root) directory") {
         const auto directory = std::make_shared<DropboxDirectory>("/test", credentials, request, "test");
         AND_GIVEN("a request that returns 200") {
@@ -2,6 +2,7 @@
 #include "request/Request.hpp"
 #include "CloudSync/exceptions/resource/ResourceException.hpp"
 #include "macros/request_mock.hpp"
+#include "macros/temp_file.hpp"
 #include "macros/oauth_mock.hpp"
 #include <catch2/catch.hpp>
 #include <fakeit.hpp>
@@ -105,6 +106,10 @@ SCENARIO("DropboxFile", "[file][dropbox]") {
                     REQUIRE(hasChanged);
                     REQUIRE(file->revision() == "newrevision");
                 }
+                THEN("size and modification time should be updated from the metadata") {
+                    REQUIRE(file->size() == 5);
+                    REQUIRE(file->modified() == std::chrono::system_clock::time_point(std::chrono::seconds(1581453547)));
+                }
             }
         }
         AND_GIVEN("a request that returns 409 conflict") {
@@ -124,5 +129,93 @@ SCENARIO("DropboxFile", "[file][dropbox]") {
                 }
             }
         }
+    }    GIVEN("a DropboxFile instance and a local file that is too large for a single request") {
+        const auto file = std::make_shared<DropboxFile>("/test.txt", credentials, request, "test.txt", "revision-id");
+        const auto local_file = temp_file("cloudsync_dropbox_upload.bin", 5 * 1024 * 1024);
+        AND_GIVEN("a request series that starts, appends to and finishes an upload session") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(200, json{{"session_id", "sessionId"}}.dump(), "application/json"))
+                .Return(request::StringResponse(200, "null", "application/json"))
+                .Return(request::StringResponse(200, json{{"rev", "new-revision"}, {"size", 5 * 1024 * 1024}}.dump(), "application/json"));
+            WHEN("uploading the local file") {
+                file->upload(local_file);
+                THEN("a concurrent upload session should be started") {
+                    Verify(Method(requestMock, request)).Exactly(3);
+                    REQUIRE_REQUEST(0, url == "https://content.dropboxapi.com/2/files/upload_session/start");
+                    REQUIRE(json::parse(requestRecording[0].query_params.at("arg")).at("session_type") == "concurrent");
+                }
+                THEN("the content should be appended and the session closed with the last chunk") {
+                    REQUIRE_REQUEST(1, url == "https://content.dropboxapi.com/2/files/upload_session/append_v2");
+                    REQUIRE_REQUEST(1, binary_body.size() == 5 * 1024 * 1024);
+                    REQUIRE_REQUEST(1, query_params.at("arg") == "{\"close\":true,\"cursor\":{\"offset\":0,\"session_id\":\"sessionId\"}}");
+                }
+                THEN("the session should be committed as an update of the current revision") {
+                    REQUIRE_REQUEST(2, url == "https://content.dropboxapi.com/2/files/upload_session/finish");
+                    const auto arg = json::parse(requestRecording[2].query_params.at("arg"));
+                    REQUIRE(arg.at("cursor").at("offset") == 5 * 1024 * 1024);
+                    REQUIRE(arg.at("commit").at("path") == "/test.txt");
+                    REQUIRE(arg.at("commit").at("mode").at("update") == "revision-id");
+                }
+                THEN("the file should have the new revision") {
+                    REQUIRE(file->revision() == "new-revision");
+                }
+            }
+        }
+        AND_GIVEN("a request series where the upload session can't be committed because of a conflict") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(200, json{{"session_id", "sessionId"}}.dump(), "application/json"))
+                .Return(request::StringResponse(200, "null", "application/json"))
+                .Throw(request::exceptions::response::Conflict(json{{"error_summary", "path/conflict/file/.."}}.dump()));
+            WHEN("uploading the local file") {
+                THEN("a ResourceHasChanged exception should be thrown") {
+                    REQUIRE_THROWS_AS(file->upload(local_file), CloudSync::exceptions::resource::ResourceHasChanged);
+                }
+            }
+        }
+    }
+    GIVEN("a DropboxFile instance in a folder") {
+        const auto file = std::make_shared<DropboxFile>("/folder/test.txt", credentials, request, "test.txt", "revision-id");
+        AND_GIVEN("a request that returns the metadata of the moved file") {
+            When(Method(requestMock, request)).Return(request::StringResponse(200, json{
+                {"metadata", {
+                    {".tag", "file"},
+                    {"name", "moved.txt"},
+                    {"path_display", "/other/moved.txt"},
+                    {"rev", "moved-revision"},
+                    {"size", 12}
+                }}
+            }.dump(), "application/json"));
+            WHEN("moving the file to an absolute path") {
+                const auto moved = std::dynamic_pointer_cast<File>(file->move_to("/other/moved.txt"));
+                THEN("move_v2 should be called without renaming on conflicts") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "POST");
+                    REQUIRE_REQUEST(0, url == "https://api.dropboxapi.com/2/files/move_v2");
+                    REQUIRE_REQUEST(0, body == json{
+                        {"from_path", "/folder/test.txt"},
+                        {"to_path", "/other/moved.txt"},
+                        {"autorename", false}}.dump());
+                }
+                THEN("a handle for the moved file should be returned") {
+                    REQUIRE(moved->path() == "/other/moved.txt");
+                    REQUIRE(moved->revision() == "moved-revision");
+                    REQUIRE(moved->size() == 12);
+                }
+            }
+        }
+        AND_GIVEN("a request that fails because the destination exists") {
+            When(Method(requestMock, request)).Throw(request::exceptions::response::Conflict(
+                json{{"error_summary", "to/conflict/file/.."}}.dump()));
+            WHEN("copying the file next to itself") {
+                THEN("a ResourceConflict should be thrown") {
+                    REQUIRE_THROWS_AS(file->copy_to("copy.txt"), CloudSync::exceptions::resource::ResourceConflict);
+                    REQUIRE_REQUEST(0, url == "https://api.dropboxapi.com/2/files/copy_v2");
+                    REQUIRE_REQUEST(0, body == json{
+                        {"from_path", "/folder/test.txt"},
+                        {"to_path", "/folder/copy.txt"},
+                        {"autorename", false}}.dump());
+                }
+            }
+        }
     }
 }
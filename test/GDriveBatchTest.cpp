@@ -0,0 +1,84 @@
+#include "gdrive/GDriveBatch.hpp"
+#include "request/exceptions/ParseError.hpp"
+#include <catch2/catch.hpp>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace CloudSync::gdrive;
+
+SCENARIO("GDriveBatch", "[gdrive]") {
+    GIVEN("a delete and a create request") {
+        const std::vector<GDriveBatch::Part> parts = {
+            {"DELETE", "/drive/v3/files/fileId", ""},
+            {"POST", "/drive/v3/files?fields=id", "{\"name\":\"folder\"}"}
+        };
+        WHEN("encoding them") {
+            const auto body = GDriveBatch::encode(parts, "boundary");
+            THEN("every request should become an application/http part with a numbered content id") {
+                REQUIRE(body ==
+                    "--boundary\r\n"
+                    "Content-Type: application/http\r\n"
+                    "Content-ID: <item-0>\r\n"
+                    "\r\n"
+                    "DELETE /drive/v3/files/fileId HTTP/1.1\r\n"
+                    "\r\n"
+                    "--boundary\r\n"
+                    "Content-Type: application/http\r\n"
+                    "Content-ID: <item-1>\r\n"
+                    "\r\n"
+                    "POST /drive/v3/files?fields=id HTTP/1.1\r\n"
+                    "Content-Type: application/json; charset=UTF-8\r\n"
+                    "\r\n"
+                    "{\"name\":\"folder\"}\r\n"
+                    "--boundary--\r\n");
+            }
+        }
+    }
+    GIVEN("a batch response with its parts out of order") {
+        const std::string data =
+            "--batch_abc\r\n"
+            "Content-Type: application/http\r\n"
+            "Content-ID: <response-item-1>\r\n"
+            "\r\n"
+            "HTTP/1.1 404 Not Found\r\n"
+            "Content-Type: application/json; charset=UTF-8\r\n"
+            "\r\n"
+            "{\"error\":{\"code\":404}}\r\n"
+            "--batch_abc\r\n"
+            "Content-Type: application/http\r\n"
+            "Content-ID: <response-item-0>\r\n"
+            "\r\n"
+            "HTTP/1.1 204 No Content\r\n"
+            "\r\n"
+            "\r\n"
+            "--batch_abc--\r\n";
+        WHEN("decoding it") {
+            const auto responses = GDriveBatch::decode(data, "multipart/mixed; boundary=batch_abc", 2);
+            THEN("the responses should be in the order of the requests") {
+                REQUIRE(responses.size() == 2);
+                REQUIRE(responses[0].code == 204);
+                REQUIRE(responses[0].data.empty());
+                REQUIRE(responses[1].code == 404);
+                REQUIRE(responses[1].data == "{\"error\":{\"code\":404}}");
+            }
+        }
+        WHEN("decoding it while expecting more parts") {
+            THEN("a ParseError should be thrown") {
+                REQUIRE_THROWS_AS(
+                    GDriveBatch::decode(data, "multipart/mixed; boundary=batch_abc", 3),
+                    request::exceptions::ParseError);
+            }
+        }
+        WHEN("decoding it without a boundary") {
+            THEN("a ParseError should be thrown") {
+                REQUIRE_THROWS_AS(GDriveBatch::decode(data, "multipart/mixed", 2), request::exceptions::ParseError);
+            }
+        }
+    }
+    GIVEN("a drive query") {
+        THEN("it should be percent-encoded for the url of a part") {
+            REQUIRE(GDriveBatch::url_encode("'root' in parents") == "%27root%27%20in%20parents");
+            REQUIRE(GDriveBatch::url_encode("a-b_c.d~e") == "a-b_c.d~e");
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include "gdrive/GDriveDirectory.hpp"
+#include "gdrive/GDriveFile.hpp"
 #include "CloudSync/Cloud.hpp"
 #include "CloudSync/exceptions/cloud/CloudException.hpp"
 #include "CloudSync/exceptions/resource/ResourceException.hpp"
@@ -19,7 +20,7 @@ using namespace CloudSync::request;
 SCENARIO("GDriveDirectory", "[directory][gdrive]") {
     INIT_REQUEST();
     OAUTH_MOCK("mytoken");
-    const std::string BASE_URL = "https://www.googleapis.com/drive/v2";
+    const std::string BASE_URL = "https://www.googleapis.com/drive/v3";
 
     GIVEN("a google drive root directory") {
         const auto directory = std::make_shared<GDriveDirectory>(BASE_URL, "root", "root", "root", "/", credentials, request, "");
@@ -31,20 +32,17 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
         AND_GIVEN("a request that returns a valid folder listing") {
             When(Method(requestMock, request)).Return(request::StringResponse(
                 200,
-                json{{"items",
+                json{{"files",
                       {
-                          {{"kind", "drive#file"},
-                           {"id", "1dInfWIELU8Hc1sP_bsGnVa44DgBpNybI"},
-                           {"title", "testfolder"},
+                          {{"id", "1dInfWIELU8Hc1sP_bsGnVa44DgBpNybI"},
+                           {"name", "testfolder"},
                            {"mimeType", "application/vnd.google-apps.folder"},
-                           {"etag", "2"},
-                           {"parents", {{{"id", "0ANREbljg-Vs3Uk9PVA"}, {"isRoot", true}}}}},
-                          {{"kind", "drive#file"},
-                           {"id", "2iInfWIELU3tc1sPhbsGwVa34DgBpN3Es"},
-                           {"title", "test.txt"},
+                           {"version", "2"}},
+                          {{"id", "2iInfWIELU3tc1sPhbsGwVa34DgBpN3Es"},
+                           {"name", "test.txt"},
                            {"mimeType", "text/plain"},
-                           {"etag", "1"},
-                           {"parents", {{{"id", "0ANREbljg-Vs3Uk9PVA"}, {"isRoot", true}}}}},
+                           {"version", "1"},
+                           {"md5Checksum", "098f6bcd4621d373cade4e832627b4f6"}},
                       }}}
                     .dump(),
                 "application/json"));
@@ -61,7 +59,9 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
                     REQUIRE_REQUEST(
                         0,
                         query_params.at("fields") ==
-                            "items(kind,id,title,mimeType,etag,parents(id,isRoot))");
+                            "nextPageToken,files(id,name,mimeType,version,size,modifiedTime,md5Checksum)");
+                    REQUIRE_REQUEST(0, query_params.at("pageSize") == "1000");
+                    REQUIRE(requestRecording[0].query_params.count("pageToken") == 0);
                 }
                 THEN("a list of 2 resources should be returned") {
                     REQUIRE(resourceList.size() == 2);
@@ -71,6 +71,83 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
                     REQUIRE(file->name() == "test.txt");
                     REQUIRE(file->path() == "/test.txt");
                     REQUIRE(file->revision() == "1");
+                    REQUIRE(file->content_hash() == ContentHash{
+                        ContentHash::Algorithm::MD5, "098f6bcd4621d373cade4e832627b4f6"});
+                }
+            }
+            WHEN("calling list_resource_info()") {
+                const auto resourceList = directory->list_resource_info();
+                THEN("the google drive files endpoint should be called with the listing query") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/files");
+                    REQUIRE_REQUEST(0, query_params.at("q") == "'root' in parents and trashed = false");
+                }
+                THEN("a description of 2 resources including their ids should be returned") {
+                    REQUIRE(resourceList.size() == 2);
+                    REQUIRE(resourceList[0].name == "testfolder");
+                    REQUIRE(resourceList[0].id == "1dInfWIELU8Hc1sP_bsGnVa44DgBpNybI");
+                    REQUIRE(resourceList[0].kind == ResourceInfo::Kind::DIRECTORY);
+                    REQUIRE(resourceList[1].name == "test.txt");
+                    REQUIRE(resourceList[1].revision == "1");
+                    REQUIRE(resourceList[1].kind == ResourceInfo::Kind::FILE);
+                    REQUIRE(resourceList[1].content_hash == ContentHash{
+                        ContentHash::Algorithm::MD5, "098f6bcd4621d373cade4e832627b4f6"});
+                    REQUIRE_FALSE(resourceList[0].content_hash.has_value());
+                }
+                AND_WHEN("calling get_resource() for the file entry") {
+                    const auto file = std::dynamic_pointer_cast<File>(directory->get_resource(resourceList[1]));
+                    THEN("a file handle should be returned without making another request") {
+                        Verify(Method(requestMock, request)).Once();
+                        REQUIRE(file->path() == "/test.txt");
+                        REQUIRE(file->revision() == "1");
+                    }
+                }
+            }
+        }
+        AND_GIVEN("a request series that returns a folder listing spread over two pages") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(
+                    200,
+                    json{{"nextPageToken", "page2token"},
+                         {"files",
+                          {{{"id", "1dInfWIELU8Hc1sP_bsGnVa44DgBpNybI"},
+                            {"name", "testfolder"},
+                            {"mimeType", "application/vnd.google-apps.folder"},
+                            {"version", "2"}}}}}
+                        .dump(),
+                    "application/json"))
+                .Return(request::StringResponse(
+                    200,
+                    json{{"files",
+                          {{{"id", "2iInfWIELU3tc1sPhbsGwVa34DgBpN3Es"},
+                            {"name", "test.txt"},
+                            {"mimeType", "text/plain"},
+                            {"version", "1"}}}}}
+                        .dump(),
+                    "application/json"));
+
+            WHEN("calling list_resources()") {
+                const auto resourceList = directory->list_resources();
+                THEN("the second page should be requested with the page token of the first page") {
+                    Verify(Method(requestMock, request)).Twice();
+                    REQUIRE_REQUEST(1, url == BASE_URL + "/files");
+                    REQUIRE_REQUEST(1, query_params.at("q") == "'root' in parents and trashed = false");
+                    REQUIRE_REQUEST(1, query_params.at("pageSize") == "1000");
+                    REQUIRE_REQUEST(1, query_params.at("pageToken") == "page2token");
+                    REQUIRE_REQUEST(1, bearer_token == "mytoken");
+                }
+                THEN("the resources of both pages should be returned") {
+                    REQUIRE(resourceList.size() == 2);
+                    REQUIRE(resourceList[0]->path() == "/testfolder");
+                    REQUIRE(resourceList[1]->path() == "/test.txt");
+                }
+            }
+            WHEN("calling get_directory(testfolder)") {
+                const auto folder = directory->get_directory("testfolder");
+                THEN("paging should stop as soon as the folder has been found, without prefetching the next page") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE(folder->path() == "/testfolder");
+                    REQUIRE_REQUEST(0, query_params.at("q") == "'root' in parents and name = 'testfolder' and trashed = false");
                 }
             }
         }
@@ -88,21 +165,12 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
                 200,
                 json{
                     {
-                        "items", {
+                        "files", {
                             {
-                                {"kind", "drive#file"},
                                 {"id", "1dInfWIELU8Hc1sP_bsGnVa44DgBpNybI"},
-                                {"title", "testfolder"},
+                                {"name", "testfolder"},
                                 {"mimeType", "application/vnd.google-apps.folder"},
-                                {"etag", "2"},
-                                {
-                                    "parents", {
-                                        {
-                                            {"id", "0ANREbljg-Vs3Uk9PVA"},
-                                            {"isRoot", true}
-                                        }
-                                    }
-                                }
+                                {"version", "2"}
                             }
                         }
                     }
@@ -120,38 +188,44 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
                     REQUIRE_REQUEST(
                         0,
                         query_params.at("q") ==
-                            "'root' in parents and title = 'testfolder' and trashed = false");
+                            "'root' in parents and name = 'testfolder' and trashed = false");
                     REQUIRE_REQUEST(
                         0,
                         query_params.at("fields") ==
-                            "items(kind,id,title,mimeType,etag,parents(id,isRoot))");
+                            "nextPageToken,files(id,name,mimeType,version,size,modifiedTime,md5Checksum)");
                 }
                 THEN("the desired folder should be returned") {
                     REQUIRE(newDir->name() == "testfolder");
                     REQUIRE(newDir->path() == "/testfolder");
                 }
             }
+            WHEN("calling get_directory(testfolder) twice") {
+                directory->get_directory("testfolder");
+                const auto newDir = directory->get_directory("testfolder");
+                THEN("only the first call should query the folder, the second one is answered from the path cache") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE(newDir->path() == "/testfolder");
+                }
+                AND_WHEN("calling list_resources() on the cached folder") {
+                    When(Method(requestMock, request)).Return(request::StringResponse(200, json{{"files", json::array()}}.dump(), "application/json"));
+                    newDir->list_resources();
+                    THEN("the listing should be requested for the cached folder id") {
+                        REQUIRE_REQUEST(1, query_params.at("q") == "'1dInfWIELU8Hc1sP_bsGnVa44DgBpNybI' in parents and trashed = false");
+                    }
+                }
+            }
         }
         AND_GIVEN("a request that returns a file description") {
             When(Method(requestMock, request)).Return(request::StringResponse(
                 200,
                 json{
                     {
-                        "items", {
+                        "files", {
                             {
-                                {"kind", "drive#file"},
                                 {"id", "52InfWIELUrHc1sPlbstnVa44DgBpNyb5"},
-                                {"title", "test.txt"},
+                                {"name", "test.txt"},
                                 {"mimeType", "text/plain"},
-                                {"etag", "2"},
-                                {
-                                    "parents", {
-                                        {
-                                            {"id", "0ANREbljg-Vs3Uk9PVA"},
-                                            {"isRoot", true}
-                                        }
-                                    }
-                                }
+                                {"version", "2"}
                             }
                         }
                     }
@@ -167,11 +241,11 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
                     REQUIRE_REQUEST(
                         0,
                         query_params.at("q") ==
-                            "'root' in parents and title = 'test.txt' and trashed = false");
+                            "'root' in parents and name = 'test.txt' and trashed = false");
                     REQUIRE_REQUEST(
                         0,
                         query_params.at("fields") ==
-                            "items(kind,id,title,mimeType,etag,parents(id,isRoot))");
+                            "nextPageToken,files(id,name,mimeType,version,size,modifiedTime,md5Checksum)");
                 }
                 THEN("the desired file should be returned") {
                     REQUIRE(file->name() == "test.txt");
@@ -179,29 +253,29 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
                     REQUIRE(file->revision() == "2");
                 }
             }
+            WHEN("calling get_file() with a name that contains quotes & backslashes") {
+                directory->get_file("Bob's \\notes.txt");
+                THEN("they should be escaped in the query") {
+                    REQUIRE_REQUEST(
+                        0,
+                        query_params.at("q") ==
+                            "'root' in parents and name = 'Bob\\'s \\\\notes.txt' and trashed = false");
+                }
+            }
         }
         AND_GIVEN("a request series that returns an empty query result and then returns a new folder resource description") {
             When(Method(requestMock, request))
                 .Return(request::StringResponse(
                     200,
-                    json{{"items",{}}}.dump(),
+                    json{{"files",{}}}.dump(),
                 "application/json"))
                 .Return(request::StringResponse(
                     200,
                     json{
-                        {"kind", "drive#file"},
                         {"id", "folderId"},
-                        {"title", "newfolder"},
+                        {"name", "newfolder"},
                         {"mimeType", "application/vnd.google-apps.folder"},
-                        {"etag", "1"},
-                        {
-                            "parents", {
-                                {
-                                    {"id", "0ANREbljg-Vs3Uk9PVA"},
-                                    {"isRoot", true}
-                                }
-                            }
-                        }
+                        {"version", "1"}
                     }.dump(),
                     "application/json"));
             WHEN("calling create_directory(newfolder)") {
@@ -213,11 +287,11 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
                     REQUIRE_REQUEST(
                         1,
                         query_params.at("fields") ==
-                            "kind,id,title,mimeType,etag,parents(id,isRoot)");
+                            "id,name,mimeType,version,size,modifiedTime,md5Checksum");
                     REQUIRE_REQUEST(
                         1,
                         body == "{\"mimeType\":\"application/vnd.google-apps.folder\","
-                                "\"parents\":[{\"id\":\"root\"}],\"title\":\"newfolder\"}");
+                                "\"name\":\"newfolder\",\"parents\":[\"root\"]}");
                     REQUIRE_REQUEST(1, headers.at("Content-Type") == Request::MIMETYPE_JSON);
                 }
                 THEN("the new folder should be returned") {
@@ -226,28 +300,65 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
                 }
             }
         }
+        AND_GIVEN("a request series that returns an empty query result and then two new folder resource descriptions") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(
+                    200,
+                    json{{"files",{}}}.dump(),
+                "application/json"))
+                .Return(request::StringResponse(
+                    200,
+                    json{
+                        {"id", "idA"},
+                        {"name", "a"},
+                        {"mimeType", "application/vnd.google-apps.folder"},
+                        {"version", "1"}
+                    }.dump(),
+                    "application/json"))
+                .Return(request::StringResponse(
+                    200,
+                    json{
+                        {"id", "idB"},
+                        {"name", "b"},
+                        {"mimeType", "application/vnd.google-apps.folder"},
+                        {"version", "1"}
+                    }.dump(),
+                    "application/json"));
+            WHEN("calling ensure_directory(a/b) twice") {
+                directory->ensure_directory("a/b");
+                const auto newDir = directory->ensure_directory("a/b");
+                THEN("the folder inside of a new folder should be created without looking for it first") {
+                    Verify(Method(requestMock, request)).Exactly(3);
+                    REQUIRE_REQUEST(0, verb == "GET");
+                    REQUIRE_REQUEST(1, verb == "POST");
+                    REQUIRE_REQUEST(
+                        1,
+                        body == "{\"mimeType\":\"application/vnd.google-apps.folder\","
+                                "\"name\":\"a\",\"parents\":[\"root\"]}");
+                    REQUIRE_REQUEST(2, verb == "POST");
+                    REQUIRE_REQUEST(
+                        2,
+                        body == "{\"mimeType\":\"application/vnd.google-apps.folder\","
+                                "\"name\":\"b\",\"parents\":[\"idA\"]}");
+                }
+                THEN("the new folder should be returned") {
+                    REQUIRE(newDir->path() == "/a/b");
+                }
+            }
+        }
         AND_GIVEN("a request series that returns an empty query result and then a new file resource description") {
             When(Method(requestMock, request))
                 .Return(request::StringResponse(
                     200,
-                    json{{"items",{}}}.dump(),
+                    json{{"files",{}}}.dump(),
                 "application/json"))
                 .Return(request::StringResponse(
                     200,
                     json{
-                        {"kind", "drive#file"},
                         {"id", "folderId"},
-                        {"title", "newfile.txt"},
+                        {"name", "newfile.txt"},
                         {"mimeType", "text/plain"},
-                        {"etag", "1"},
-                        {
-                            "parents", {
-                                {
-                                    {"id", "0ANREbljg-Vs3Uk9PVA"},
-                                    {"isRoot", true}
-                                }
-                            }
-                        }
+                        {"version", "1"}
                     }
                         .dump(),
                     "application/json"));
@@ -258,12 +369,29 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
                     Verify(Method(requestMock, request)).Exactly(2);
                     REQUIRE_REQUEST(1, verb == "POST");
                     REQUIRE_REQUEST(1, url == BASE_URL + "/files");
-                    REQUIRE_REQUEST(1, query_params.at("fields") == "kind,id,title,mimeType,etag,parents(id,isRoot)");
+                    REQUIRE_REQUEST(1, query_params.at("fields") == "id,name,mimeType,version,size,modifiedTime,md5Checksum");
                     REQUIRE_REQUEST(1, headers.at("Content-Type") == Request::MIMETYPE_JSON);
                     REQUIRE_REQUEST(
                         1,
                         body == "{\"mimeType\":\"text/plain\","
-                                "\"parents\":[{\"id\":\"root\"}],\"title\":\"newfile.txt\"}");
+                                "\"name\":\"newfile.txt\",\"parents\":[\"root\"]}");
+                }
+                THEN("the new file resource should be returned") {
+                    REQUIRE(new_file->name() == "newfile.txt");
+                    REQUIRE(new_file->path() == "/newfile.txt");
+                    REQUIRE(std::dynamic_pointer_cast<GDriveFile>(new_file)->id() == "folderId");
+                }
+            }
+            WHEN("calling create_file(newfile.txt, abc)") {
+                const auto new_file = directory->create_file("newfile.txt", {'a', 'b', 'c'});
+                THEN("the file should be created with its content by a single multipart upload") {
+                    Verify(Method(requestMock, request)).Exactly(2);
+                    REQUIRE_REQUEST(1, verb == "POST");
+                    REQUIRE_REQUEST(1, url == "https://www.googleapis.com/upload/drive/v3/files");
+                    REQUIRE_REQUEST(1, query_params.at("uploadType") == "multipart");
+                    const std::string body(requestRecording[1].binary_body.begin(), requestRecording[1].binary_body.end());
+                    REQUIRE(body.find("{\"name\":\"newfile.txt\",\"parents\":[\"root\"]}") != std::string::npos);
+                    REQUIRE(body.find("\r\n\r\nabc\r\n") != std::string::npos);
                 }
                 THEN("the new file resource should be returned") {
                     REQUIRE(new_file->name() == "newfile.txt");
@@ -292,12 +420,11 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
             When(Method(requestMock, request)).Return(request::StringResponse(
                 200,
                 json{
-                    {"kind", "drive#file"},
                     {"id", "1dInfWIELU8Hc1sP_bsGnVa44DgBpNybI"},
-                    {"title", "test"},
+                    {"name", "test"},
                     {"mimeType", "application/vnd.google-apps.folder"},
-                    {"etag", "2"},
-                    {"parents", {{{"id", "0ANREbljg-Vs3Uk9PVA"}, {"isRoot", false}}}}}
+                    {"version", "2"},
+                    {"parents", {"0ANREbljg-Vs3Uk9PVA"}}}
                     .dump(),
                 "application/json"));
 
@@ -310,7 +437,7 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
                     REQUIRE_REQUEST(
                         0,
                         query_params.at("fields") ==
-                            "kind,id,title,mimeType,etag,parents(id,isRoot)");
+                            "id,name,mimeType,version,size,modifiedTime,md5Checksum,parents");
                 }
 
                 THEN("the parent directory should be returned") {
@@ -320,8 +447,8 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
             }
             WHEN("calling get_directory(../../") {
                 const auto rootDir = directory->get_directory("../../");
-                THEN("only one request should be made. The root cannot be queried") {
-                    Verify(Method(requestMock, request)).Once();
+                THEN("no request should be made. The root cannot be queried and is always known") {
+                    Verify(Method(requestMock, request)).Never();
                 }
                 THEN("the root dir should be returned") {
                     REQUIRE(rootDir->name() == "");
@@ -351,4 +478,213 @@ SCENARIO("GDriveDirectory", "[directory][gdrive]") {
             }
         }
     }
+    GIVEN("a google drive root directory and the batch endpoint") {
+        const auto directory = std::make_shared<GDriveDirectory>(BASE_URL, "root", "root", "root", "/", credentials, request, "");
+        const auto batch_response = [](const std::vector<std::pair<int, json>> &responses) {
+            std::string body;
+            for (std::size_t i = 0; i < responses.size(); i++) {
+                body += "--batch_xyz\r\n"
+                        "Content-Type: application/http\r\n"
+                        "Content-ID: <response-item-" + std::to_string(i) + ">\r\n"
+                        "\r\n"
+                        "HTTP/1.1 " + std::to_string(responses[i].first) + " Status\r\n"
+                        "Content-Type: application/json; charset=UTF-8\r\n"
+                        "\r\n" + (responses[i].second.is_null() ? "" : responses[i].second.dump()) + "\r\n";
+            }
+            return request::StringResponse(200, body + "--batch_xyz--\r\n", "multipart/mixed; boundary=batch_xyz");
+        };
+        const json folder_a = {{"files", {{{"id", "id_a"}, {"name", "a"}, {"mimeType", "application/vnd.google-apps.folder"}, {"version", "3"}}}}};
+        const auto count_occurrences = [](const std::string &text, const std::string &part) {
+            std::size_t count = 0;
+            for (auto position = text.find(part); position != std::string::npos; position = text.find(part, position + 1)) {
+                count++;
+            }
+            return count;
+        };
+
+        AND_GIVEN("a batch response with a found and a missing resource") {
+            When(Method(requestMock, request)).Return(batch_response({{200, folder_a}, {200, {{"files", json::array()}}}}));
+            WHEN("calling stat_many(a, b.txt)") {
+                const auto results = directory->stat_many({"a", "b.txt"});
+                THEN("a single multipart request should be sent to the batch endpoint") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "POST");
+                    REQUIRE_REQUEST(0, url == "https://www.googleapis.com/batch/drive/v3");
+                    REQUIRE_REQUEST(0, headers.at("Content-Type") == "multipart/mixed; boundary=cloudsync_batch");
+                    REQUIRE_REQUEST(0, body.find("GET /drive/v3/files?q=%27root%27%20in%20parents%20and%20name%20%3D%20%27a%27") != std::string::npos);
+                    REQUIRE_REQUEST(0, body.find("%27b.txt%27") != std::string::npos);
+                }
+                THEN("every path should get its own result") {
+                    REQUIRE(results[0].ok());
+                    REQUIRE(results[0].value.id == "id_a");
+                    REQUIRE(results[0].value.kind == ResourceInfo::Kind::DIRECTORY);
+                    REQUIRE_THROWS_AS(results[1].rethrow_if_failed(), CloudSync::exceptions::resource::NoSuchResource);
+                }
+            }
+            WHEN("calling stat_many() with a name that contains a quote") {
+                directory->stat_many({"a", "Bob's notes.txt"});
+                THEN("the quote should be escaped in the query") {
+                    REQUIRE_REQUEST(0, body.find("%27Bob%5C%27s%20notes.txt%27") != std::string::npos);
+                }
+            }
+        }
+        AND_GIVEN("a request series that resolves the root, finds two files and looks up the folder of one of them") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(200, json{{"id", "root_id"}}.dump(), "application/json"))
+                .Return(request::StringResponse(200, json{{"files", {
+                    {{"id", "id_1"}, {"name", "Report.pdf"}, {"mimeType", "application/pdf"}, {"version", "1"}, {"modifiedTime", "2020-02-01T00:00:00Z"}, {"parents", {"id_a"}}},
+                    {{"id", "id_2"}, {"name", "report.txt"}, {"mimeType", "text/plain"}, {"version", "2"}, {"modifiedTime", "2020-02-01T00:00:00Z"}, {"parents", {"root_id"}}},
+                    {{"id", "id_3"}, {"name", "report.md"}, {"mimeType", "text/plain"}, {"version", "3"}, {"modifiedTime", "2020-02-01T00:00:00Z"}, {"parents", {"id_x"}}}
+                }}}.dump(), "application/json"))
+                .Return(batch_response({
+                    {200, {{"id", "id_a"}, {"name", "a"}, {"parents", {"root_id"}}}},
+                    {200, {{"id", "id_x"}, {"name", "shared"}}}}));
+            WHEN("searching for files named report that have been modified after 2020-01-29T21:00:50Z") {
+                SearchQuery query;
+                query.name = "report";
+                query.kind = ResourceInfo::Kind::FILE;
+                query.modified_after = std::chrono::system_clock::time_point(std::chrono::seconds(1580331650));
+                std::vector<SearchResult> results;
+                directory->search(query, [&results](const std::vector<SearchResult> &page) {
+                    results.insert(results.end(), page.begin(), page.end());
+                    return true;
+                });
+                THEN("the query should be sent as files search, after the id of the root has been resolved") {
+                    Verify(Method(requestMock, request)).Exactly(3);
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/files/root");
+                    REQUIRE_REQUEST(0, query_params.at("fields") == "id");
+                    REQUIRE_REQUEST(1, url == BASE_URL + "/files");
+                    REQUIRE_REQUEST(1, query_params.at("q") == "trashed = false and name contains 'report' "
+                                                               "and mimeType != 'application/vnd.google-apps.folder' "
+                                                               "and modifiedTime > '2020-01-29T21:00:50Z'");
+                    REQUIRE_REQUEST(1, query_params.at("fields") == "nextPageToken,files(id,name,mimeType,version,size,"
+                                                                    "modifiedTime,md5Checksum,parents)");
+                }
+                THEN("the unknown parents should be looked up with a single batch") {
+                    REQUIRE_REQUEST(2, url == "https://www.googleapis.com/batch/drive/v3");
+                    REQUIRE_REQUEST(2, body.find("GET /drive/v3/files/id_a?fields=id,name,parents") != std::string::npos);
+                    REQUIRE_REQUEST(2, body.find("GET /drive/v3/files/id_x?fields=id,name,parents") != std::string::npos);
+                }
+                THEN("the results below the root should be returned with their path") {
+                    REQUIRE(results.size() == 2);
+                    REQUIRE(results[0].path == "/a/Report.pdf");
+                    REQUIRE(results[0].info.id == "id_1");
+                    REQUIRE(results[1].path == "/report.txt");
+                }
+            }
+        }
+        AND_GIVEN("a batch response that doesn't find a file and a request that returns the created file") {
+            When(Method(requestMock, request))
+                .Return(batch_response({{200, {{"files", json::array()}}}}))
+                .Return(request::StringResponse(200, json{
+                    {"id", "id_b"}, {"name", "b.txt"}, {"mimeType", "text/plain"}, {"version", "1"}, {"size", "3"}}.dump(),
+                    "application/json"));
+            WHEN("calling upload_many(b.txt)") {
+                const auto results = directory->upload_many({{"b.txt", {1, 2, 3}}});
+                THEN("the file should be created with its content in a single multipart upload") {
+                    Verify(Method(requestMock, request)).Twice();
+                    REQUIRE_REQUEST(1, verb == "POST");
+                    REQUIRE_REQUEST(1, url == "https://www.googleapis.com/upload/drive/v3/files");
+                    REQUIRE_REQUEST(1, query_params.at("uploadType") == "multipart");
+                    REQUIRE_REQUEST(1, headers.at("Content-Type") == "multipart/related; boundary=cloudsync_upload");
+                    const std::string body(requestRecording[1].binary_body.begin(), requestRecording[1].binary_body.end());
+                    REQUIRE(body ==
+                        "--cloudsync_upload\r\n"
+                        "Content-Type: application/json; charset=UTF-8\r\n"
+                        "\r\n"
+                        "{\"name\":\"b.txt\",\"parents\":[\"root\"]}\r\n"
+                        "--cloudsync_upload\r\n"
+                        "Content-Type: application/octet-stream\r\n"
+                        "\r\n"
+                        "\x01\x02\x03\r\n"
+                        "--cloudsync_upload--");
+                }
+                THEN("a handle for the new file should be returned") {
+                    REQUIRE(results[0].ok());
+                    REQUIRE(results[0].value->path() == "/b.txt");
+                    REQUIRE(results[0].value->revision() == "1");
+                }
+            }
+        }
+        AND_GIVEN("a batch response that finds a file and a request that returns the updated file") {
+            When(Method(requestMock, request))
+                .Return(batch_response({{200, {{"files", {{{"id", "id_b"}, {"name", "b.txt"}, {"mimeType", "text/plain"}, {"version", "1"}}}}}}}))
+                .Return(request::StringResponse(200, json{
+                    {"id", "id_b"}, {"name", "b.txt"}, {"mimeType", "text/plain"}, {"version", "2"}, {"size", "3"}}.dump(),
+                    "application/json"));
+            WHEN("calling upload_many(b.txt)") {
+                const auto results = directory->upload_many({{"b.txt", {1, 2, 3}}});
+                THEN("the content of the existing file should be replaced") {
+                    REQUIRE_REQUEST(1, verb == "PATCH");
+                    REQUIRE_REQUEST(1, url == "https://www.googleapis.com/upload/drive/v3/files/id_b");
+                    REQUIRE_REQUEST(1, query_params.at("uploadType") == "media");
+                    REQUIRE_REQUEST(1, binary_body == std::vector<std::uint8_t>{1, 2, 3});
+                }
+                THEN("a handle with the new revision should be returned") {
+                    REQUIRE(results[0].value->revision() == "2");
+                }
+            }
+        }
+        AND_GIVEN("a batch series that finds a folder and then deletes it") {
+            When(Method(requestMock, request))
+                .Return(batch_response({{200, folder_a}}))
+                .Return(batch_response({{204, nullptr}}));
+            WHEN("calling remove_many(a)") {
+                const auto results = directory->remove_many({"a"});
+                THEN("the id should be looked up and the folder deleted by its id") {
+                    Verify(Method(requestMock, request)).Twice();
+                    REQUIRE_REQUEST(1, body.find("DELETE /drive/v3/files/id_a HTTP/1.1") != std::string::npos);
+                    REQUIRE(results[0].ok());
+                }
+            }
+        }
+        AND_GIVEN("a batch series that finds no folder and then creates it") {
+            When(Method(requestMock, request))
+                .Return(batch_response({{200, {{"files", json::array()}}}}))
+                .Return(batch_response({{200, folder_a["files"][0]}}));
+            WHEN("calling create_directories(a)") {
+                const auto results = directory->create_directories({"a"});
+                THEN("the folder should be created in its parent") {
+                    Verify(Method(requestMock, request)).Twice();
+                    REQUIRE_REQUEST(1, body.find("POST /drive/v3/files?fields=") != std::string::npos);
+                    REQUIRE_REQUEST(1, body.find(R"("parents":["root"])") != std::string::npos);
+                }
+                THEN("the created directory should be returned") {
+                    REQUIRE(results[0].ok());
+                    REQUIRE(results[0].value->path() == "/a");
+                }
+            }
+        }
+        AND_GIVEN("a batch series that finds no folder and then creates it once") {
+            When(Method(requestMock, request))
+                .Return(batch_response({{200, {{"files", json::array()}}}}))
+                .Return(batch_response({{200, folder_a["files"][0]}}));
+            WHEN("calling create_directories(a, ./a/, a)") {
+                const auto results = directory->create_directories({"a", "./a/", "a"});
+                THEN("the folder should be looked up and created with a single part each") {
+                    Verify(Method(requestMock, request)).Twice();
+                    REQUIRE(count_occurrences(requestRecording[0].body, "GET /drive/v3/files?") == 1);
+                    REQUIRE(count_occurrences(requestRecording[1].body, "POST /drive/v3/files?fields=") == 1);
+                }
+                THEN("every path should get the created directory") {
+                    REQUIRE(results.size() == 3);
+                    for (const auto &result: results) {
+                        REQUIRE(result.ok());
+                        REQUIRE(result.value->path() == "/a");
+                    }
+                    REQUIRE(results[1].path == "./a/");
+                }
+            }
+        }
+        AND_GIVEN("a batch response that finds an existing folder") {
+            When(Method(requestMock, request)).Return(batch_response({{200, folder_a}}));
+            WHEN("calling create_directories(a)") {
+                const auto results = directory->create_directories({"a"});
+                THEN("a ResourceConflict should be reported without creating a duplicate") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_THROWS_AS(results[0].rethrow_if_failed(), CloudSync::exceptions::resource::ResourceConflict);
+                }
+            }
+        }
+    }
 }
@@ -1,7 +1,9 @@
 #include "gdrive/GDriveFile.hpp"
 #include "CloudSync/Cloud.hpp"
+#include "CloudSync/exceptions/resource/ResourceException.hpp"
 #include "request/Request.hpp"
 #include "macros/request_mock.hpp"
+#include "macros/temp_file.hpp"
 #include "macros/oauth_mock.hpp"
 #include <catch2/catch.hpp>
 #include <fakeit.hpp>
@@ -20,7 +22,7 @@ SCENARIO("GDriveFile", "[file][gdrive]") {
     const std::string BASE_URL = "https://www.googleapis.com/drive/v3";
 
     GIVEN("a google drive file") {
-        const auto file = std::make_shared<GDriveFile>(BASE_URL, "fileId", "/test.txt", credentials, request, "test.txt", "2");
+        const auto file = std::make_shared<GDriveFile>(BASE_URL, "root", "fileId", "/test.txt", credentials, request, "test.txt", "2");
         AND_GIVEN("a request that returns 204") {
             When(Method(requestMock, request)).Return(request::StringResponse(204, ""));
 
@@ -33,55 +35,93 @@ SCENARIO("GDriveFile", "[file][gdrive]") {
                 }
             }
         }
-        AND_GIVEN("a request that returns a download link and a GET request that returns the file content") {
-            When(Method(requestMock, request))
-                .Return(request::StringResponse(200, json{{"downloadUrl", "downloadlink"}}.dump(), "application/json"))
-                .Return(request::StringResponse(200, "file content", "text/plain"));
+        AND_GIVEN("a GET request that returns the file content") {
+            When(Method(requestMock, request)).Return(request::StringResponse(200, "file content", "text/plain"));
 
             WHEN("calling read()") {
                 const auto content = file->read();
-                THEN("a request to get the download link and a resource to download the actual content should be made") {
-                    Verify(Method(requestMock, request)).Twice();
+                THEN("a single request to the media endpoint of the file should be made") {
+                    Verify(Method(requestMock, request)).Once();
                     REQUIRE_REQUEST(0, verb == "GET");
                     REQUIRE_REQUEST(0, url == BASE_URL + "/files/fileId");
-                    REQUIRE_REQUEST(0, query_params.at("fields") == "downloadUrl");
-                    REQUIRE_REQUEST(1, verb == "GET");
-                    REQUIRE_REQUEST(1, url == "downloadlink");
+                    REQUIRE_REQUEST(0, query_params.at("alt") == "media");
+                    REQUIRE_REQUEST(0, bearer_token == "mytoken");
                 }
                 THEN("the files content should be returned") {
                     REQUIRE(content == "file content");
                 }
             }
         }
-        AND_GIVEN("a request that returns a new etag") {
-            When(Method(requestMock, request)).Return(request::StringResponse(200, json{{"etag", "newetag"}}.dump(), "application/json"));
+        AND_GIVEN("a GET request that returns binary file content") {
+            When(Method(requestMock, request_binary)).Return(request::BinaryResponse(200, {0x12, 0x13, 0x14}, "application/octet-stream"));
+
+            WHEN("calling read_binary()") {
+                const auto content = file->read_binary();
+                THEN("a single request to the media endpoint of the file should be made") {
+                    Verify(Method(requestMock, request_binary)).Once();
+                    Verify(Method(requestMock, request)).Never();
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/files/fileId");
+                    REQUIRE_REQUEST(0, query_params.at("alt") == "media");
+                }
+                THEN("the files content should be returned") {
+                    REQUIRE(content == std::vector<std::uint8_t>({0x12, 0x13, 0x14}));
+                }
+            }
+        }
+        AND_GIVEN("a GET request that fails with 404 Not Found") {
+            When(Method(requestMock, request)).Throw(request::exceptions::response::NotFound());
+
+            WHEN("calling read()") {
+                THEN("a NoSuchResource exception should be thrown") {
+                    REQUIRE_THROWS_AS(file->read(), CloudSync::exceptions::resource::NoSuchResource);
+                }
+            }
+        }
+        AND_GIVEN("a request series that returns the current version and then a new version") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(200, json{{"version", "2"}}.dump(), "application/json"))
+                .Return(request::StringResponse(200, json{{"version", "3"}}.dump(), "application/json"));
 
             WHEN("calling write_string(somenewcontent)") {
                 file->write("somenewcontent");
-                THEN("a PUT request should be made to the file upload endpoint") {
-                    Verify(Method(requestMock, request)).Once();
-                    REQUIRE_REQUEST(0, verb == "PUT");
-                    REQUIRE_REQUEST(0, url == "https://www.googleapis.com/upload/drive/v2/files/fileId");
-                    REQUIRE_REQUEST(0, query_params.at("uploadType") == "media");
-                    REQUIRE_REQUEST(0, query_params.at("fields") == "etag");
-                    REQUIRE_REQUEST(0, body == "somenewcontent");
-                    REQUIRE_REQUEST(0, headers.at("If-Match") == "2");
+                THEN("the version should be checked before the content is uploaded") {
+                    Verify(Method(requestMock, request)).Twice();
+                    REQUIRE_REQUEST(0, verb == "GET");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/files/fileId");
+                    REQUIRE_REQUEST(0, query_params.at("fields") == "version");
+                }
+                THEN("a PATCH request should be made to the file upload endpoint") {
+                    REQUIRE_REQUEST(1, verb == "PATCH");
+                    REQUIRE_REQUEST(1, url == "https://www.googleapis.com/upload/drive/v3/files/fileId");
+                    REQUIRE_REQUEST(1, query_params.at("uploadType") == "media");
+                    REQUIRE_REQUEST(1, query_params.at("fields") == "version,size,modifiedTime,mimeType,md5Checksum");
+                    REQUIRE_REQUEST(1, body == "somenewcontent");
                 }
                 THEN("the file revision should be updated") {
-                    REQUIRE(file->revision() == "newetag");
+                    REQUIRE(file->revision() == "3");
                 }
             }
         }
-        AND_GIVEN("a request that returns the current etag (no change)") {
-            When(Method(requestMock, request)).Return(request::StringResponse(200, json{{"etag", "2"}}.dump(), "application/json"));
+        AND_GIVEN("a request that returns a version that differs from the file revision") {
+            When(Method(requestMock, request)).Return(request::StringResponse(200, json{{"version", "5"}}.dump(), "application/json"));
+
+            WHEN("calling write_string(somenewcontent)") {
+                THEN("a ResourceHasChanged exception should be thrown and nothing should be uploaded") {
+                    REQUIRE_THROWS_AS(file->write("somenewcontent"), CloudSync::exceptions::resource::ResourceHasChanged);
+                    Verify(Method(requestMock, request)).Once();
+                }
+            }
+        }
+        AND_GIVEN("a request that returns the current version (no change)") {
+            When(Method(requestMock, request)).Return(request::StringResponse(200, json{{"version", "2"}}.dump(), "application/json"));
 
             WHEN("calling poll_change()") {
                 bool hasChanged = file->poll_change();
-                THEN("the etag field should be requested for the file") {
+                THEN("the version field should be requested for the file") {
                     Verify(Method(requestMock, request)).Once();
                     REQUIRE_REQUEST(0, verb == "GET");
                     REQUIRE_REQUEST(0, url == "https://www.googleapis.com/drive/v3/files/fileId");
-                    REQUIRE_REQUEST(0, query_params.at("fields") == "etag");
+                    REQUIRE_REQUEST(0, query_params.at("fields") == "version,size,modifiedTime,mimeType,md5Checksum");
                 }
                 THEN("false should be returned") {
                     REQUIRE(hasChanged == false);
@@ -91,8 +131,8 @@ SCENARIO("GDriveFile", "[file][gdrive]") {
                 }
             }
         }
-        AND_GIVEN("a request that returns a new etag (new revision)") {
-            When(Method(requestMock, request)).Return(request::StringResponse(200, json{{"etag", "thisisanewetag"}}.dump(), "application/json"));
+        AND_GIVEN("a request that returns a new version (new revision)") {
+            When(Method(requestMock, request)).Return(request::StringResponse(200, json{{"version", "3"}}.dump(), "application/json"));
 
             WHEN("calling poll_change()") {
                 bool hasChanged = file->poll_change();
@@ -100,7 +140,99 @@ SCENARIO("GDriveFile", "[file][gdrive]") {
                     REQUIRE(hasChanged == true);
                 }
                 THEN("the files revision should be updated") {
-                    REQUIRE(file->revision() == "thisisanewetag");
+                    REQUIRE(file->revision() == "3");
+                }
+            }
+        }
+        AND_GIVEN("a request that returns a new version together with size, modification time, mimetype & md5") {
+            When(Method(requestMock, request)).Return(request::StringResponse(200, json{
+                {"version", "3"},
+                {"size", "11048"},
+                {"modifiedTime", "2020-01-29T21:00:50.000Z"},
+                {"mimeType", "text/markdown"},
+                {"md5Checksum", "098f6bcd4621d373cade4e832627b4f6"}
+            }.dump(), "application/json"));
+
+            WHEN("calling poll_change()") {
+                file->poll_change();
+                THEN("the files metadata should be updated") {
+                    REQUIRE(file->size() == 11048);
+                    REQUIRE(file->modified() == std::chrono::system_clock::time_point(std::chrono::seconds(1580331650)));
+                    REQUIRE(file->content_type() == "text/markdown");
+                    REQUIRE(file->content_hash() == ContentHash{
+                        ContentHash::Algorithm::MD5, "098f6bcd4621d373cade4e832627b4f6"});
+                }
+            }
+        }
+    }    GIVEN("a google drive file and a local file that is too large for a single request") {
+        const auto file = std::make_shared<GDriveFile>(BASE_URL, "root", "fileId", "/test.txt", credentials, request, "test.txt", "2");
+        const auto local_file = temp_file("cloudsync_gdrive_upload.bin", 5 * 1024 * 1024);
+        AND_GIVEN("a request series that checks the version and runs a resumable upload") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(200, json{{"version", "2"}}.dump(), "application/json"))
+                .Return(request::StringResponse(200, "", "", {{"location", "https://www.googleapis.com/upload/drive/v3/files/fileId?upload_id=xyz"}}))
+                .Return(request::StringResponse(200, json{{"version", "3"}, {"size", "5242880"}}.dump(), "application/json"));
+            WHEN("uploading the local file") {
+                file->upload(local_file);
+                THEN("a resumable upload should be started on the upload endpoint") {
+                    Verify(Method(requestMock, request)).Exactly(3);
+                    REQUIRE_REQUEST(1, verb == "PATCH");
+                    REQUIRE_REQUEST(1, url == "https://www.googleapis.com/upload/drive/v3/files/fileId");
+                    REQUIRE_REQUEST(1, query_params.at("uploadType") == "resumable");
+                    REQUIRE_REQUEST(1, headers.at("X-Upload-Content-Length") == "5242880");
+                }
+                THEN("the content should be sent to the session uri") {
+                    REQUIRE_REQUEST(2, verb == "PUT");
+                    REQUIRE_REQUEST(2, url == "https://www.googleapis.com/upload/drive/v3/files/fileId?upload_id=xyz");
+                    REQUIRE_REQUEST(2, headers.at("Content-Range") == "bytes 0-5242879/5242880");
+                    REQUIRE_REQUEST(2, binary_body.size() == 5242880);
+                }
+                THEN("the file should have the new revision") {
+                    REQUIRE(file->revision() == "3");
+                    REQUIRE(file->size() == 5242880);
+                }
+            }
+        }
+    }
+    GIVEN("a google drive file in the root folder") {
+        const auto file = std::make_shared<GDriveFile>(BASE_URL, "root", "fileId", "/test.txt", credentials, request, "test.txt", "2");
+        AND_GIVEN("a request series that finds no file at the destination and returns the renamed file") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(200, json{{"files", json::array()}}.dump(), "application/json"))
+                .Return(request::StringResponse(200, json{
+                    {"id", "fileId"},
+                    {"name", "renamed.txt"},
+                    {"mimeType", "text/plain"},
+                    {"version", "3"}}.dump(), "application/json"));
+            WHEN("renaming the file") {
+                const auto moved = std::dynamic_pointer_cast<File>(file->move_to("renamed.txt"));
+                THEN("the destination should be checked for an existing file first") {
+                    Verify(Method(requestMock, request)).Exactly(2);
+                    REQUIRE_REQUEST(0, verb == "GET");
+                    REQUIRE_REQUEST(0, query_params.at("q") == "'root' in parents and name = 'renamed.txt' and trashed = false");
+                }
+                THEN("only the name should be patched, the parents stay the same") {
+                    REQUIRE_REQUEST(1, verb == "PATCH");
+                    REQUIRE_REQUEST(1, url == BASE_URL + "/files/fileId");
+                    REQUIRE_REQUEST(1, body == json{{"name", "renamed.txt"}}.dump());
+                    REQUIRE_REQUEST(1, query_params.count("addParents") == 0);
+                }
+                THEN("a handle for the renamed file should be returned") {
+                    REQUIRE(moved->path() == "/renamed.txt");
+                    REQUIRE(moved->revision() == "3");
+                }
+            }
+        }
+        AND_GIVEN("a request that finds a file at the destination") {
+            When(Method(requestMock, request)).Return(request::StringResponse(200, json{{"files", {{
+                {"id", "otherId"},
+                {"name", "copy.txt"},
+                {"mimeType", "text/plain"},
+                {"version", "1"}}}}}.dump(), "application/json"));
+            WHEN("copying the file") {
+                THEN("a ResourceConflict should be thrown without copying the file") {
+                    REQUIRE_THROWS_AS(file->copy_to("copy.txt"), CloudSync::exceptions::resource::ResourceConflict);
+                    REQUIRE(requestRecording.size() == 1);
                 }
             }
         }
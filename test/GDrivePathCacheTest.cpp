@@ -0,0 +1,62 @@
+#include "gdrive/GDrivePathCache.hpp"
+#include <catch2/catch.hpp>
+
+using namespace Catch;
+using namespace CloudSync::gdrive;
+
+SCENARIO("GDrivePathCache", "[gdrive]") {
+    GIVEN("a path cache with a folder and a file inside of it") {
+        GDrivePathCache cache;
+        cache.put("/folder", {"folderId", "root", true});
+        cache.put("/folder/file.txt", {"fileId", "folderId", false});
+
+        THEN("both resources should be found by their path") {
+            REQUIRE(cache.get("/folder")->id == "folderId");
+            REQUIRE(cache.get("/folder/file.txt")->id == "fileId");
+            REQUIRE(cache.get("/folder/file.txt")->parent_id == "folderId");
+            REQUIRE_FALSE(cache.get("/folder/file.txt")->is_folder);
+        }
+        THEN("unknown paths should not be found") {
+            REQUIRE_FALSE(cache.get("/other"));
+            REQUIRE_FALSE(cache.get("/folder/other.txt"));
+        }
+        WHEN("removing the folder") {
+            cache.remove("/folder");
+            THEN("the folder and everything inside of it should be forgotten") {
+                REQUIRE_FALSE(cache.get("/folder"));
+                REQUIRE_FALSE(cache.get("/folder/file.txt"));
+            }
+        }
+        WHEN("removing the folder by its id") {
+            cache.remove_id("folderId");
+            THEN("the folder and everything inside of it should be forgotten") {
+                REQUIRE_FALSE(cache.get("/folder"));
+                REQUIRE_FALSE(cache.get("/folder/file.txt"));
+            }
+        }
+        WHEN("replacing the children of the root with a listing that still contains the folder") {
+            cache.put("/old.txt", {"oldId", "root", false});
+            cache.put_children("/", {{"folder", {"folderId", "root", true}}, {"new.txt", {"newId", "root", false}}});
+            THEN("the children that are not part of the listing should be forgotten") {
+                REQUIRE_FALSE(cache.get("/old.txt"));
+                REQUIRE(cache.get("/new.txt")->id == "newId");
+            }
+            THEN("the content of the folder that is still present should be kept") {
+                REQUIRE(cache.get("/folder/file.txt")->id == "fileId");
+            }
+        }
+        WHEN("replacing the children of the root with a listing where the folder has a new id") {
+            cache.put_children("/", {{"folder", {"newFolderId", "root", true}}});
+            THEN("the content of the replaced folder should be forgotten") {
+                REQUIRE(cache.get("/folder")->id == "newFolderId");
+                REQUIRE_FALSE(cache.get("/folder/file.txt"));
+            }
+        }
+        WHEN("clearing the cache") {
+            cache.clear();
+            THEN("nothing should be found anymore") {
+                REQUIRE_FALSE(cache.get("/folder"));
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#include "nextcloud/NextcloudBulkUpload.hpp"
+#include "request/exceptions/ParseError.hpp"
+#include <catch2/catch.hpp>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace CloudSync::nextcloud;
+
+SCENARIO("NextcloudBulkUpload", "[nextcloud]") {
+    const std::vector<std::uint8_t> content = {'a', 'b', 'c'};
+    const std::vector<std::uint8_t> empty_content;
+    const std::vector<NextcloudBulkUpload::Part> parts = {
+            {"/folder/a.txt", &content, 1580331650}, {"/b.txt", &empty_content}};
+
+    GIVEN("two files") {
+        WHEN("encoding them") {
+            const auto body = NextcloudBulkUpload::encode(parts, "boundary");
+            THEN("every file should become a part with its path, md5, mtime if known & length") {
+                REQUIRE(std::string(body.begin(), body.end()) ==
+                    "--boundary\r\n"
+                    "X-File-Path: /folder/a.txt\r\n"
+                    "X-File-MD5: 900150983cd24fb0d6963f7d28e17f72\r\n"
+                    "X-File-Mtime: 1580331650\r\n"
+                    "Content-Length: 3\r\n"
+                    "\r\n"
+                    "abc\r\n"
+                    "--boundary\r\n"
+                    "X-File-Path: /b.txt\r\n"
+                    "X-File-MD5: d41d8cd98f00b204e9800998ecf8427e\r\n"
+                    "Content-Length: 0\r\n"
+                    "\r\n"
+                    "\r\n"
+                    "--boundary--\r\n");
+            }
+        }
+    }
+    GIVEN("a response with a written and a failed file") {
+        const std::string data =
+            R"({"/b.txt":{"error":true,"message":"quota exceeded"},"/folder/a.txt":{"error":false,"etag":"5e2f"}})";
+        WHEN("decoding it") {
+            const auto responses = NextcloudBulkUpload::decode(data, parts);
+            THEN("the results should be in the order of the parts") {
+                REQUIRE(responses.size() == 2);
+                REQUIRE_FALSE(responses[0].error);
+                REQUIRE(responses[1].error);
+                REQUIRE(responses[1].message == "quota exceeded");
+            }
+            THEN("the etag should be quoted like the ETag header") {
+                REQUIRE(responses[0].etag == "\"5e2f\"");
+            }
+        }
+    }
+    GIVEN("a response that misses a file") {
+        const std::string data = R"({"/folder/a.txt":{"error":false,"etag":"5e2f"}})";
+        WHEN("decoding it") {
+            THEN("a ParseError should be thrown") {
+                REQUIRE_THROWS_AS(NextcloudBulkUpload::decode(data, parts), request::exceptions::ParseError);
+            }
+        }
+    }
+}
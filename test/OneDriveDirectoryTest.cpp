@@ -1,6 +1,7 @@
 #include "onedrive/OneDriveDirectory.hpp"
 #include "CloudSync/Cloud.hpp"
 #include "CloudSync/exceptions/resource/ResourceException.hpp"
+#include "CloudSync/exceptions/cloud/CloudException.hpp"
 #include "request/Request.hpp"
 #include "macros/request_mock.hpp"
 #include "macros/oauth_mock.hpp"
@@ -16,6 +17,8 @@ using json = nlohmann::json;
 using namespace CloudSync::request;
 
 SCENARIO("OneDriveDirectory", "[directory][onedrive]") {
+    const std::string DRIVE_ITEM_SELECT =
+        "id,name,eTag,root,file,folder,parentReference,size,lastModifiedDateTime,@microsoft.graph.downloadUrl";
     INIT_REQUEST();
     OAUTH_MOCK("mytoken");
     GIVEN("a onedrive root directory") {
@@ -40,8 +43,11 @@ SCENARIO("OneDriveDirectory", "[directory][onedrive]") {
                          "filedownloadlink"},
                         {"eTag", "somerevision"},
                         {"name", "somefile.txt"},
+                        {"size", 11048},
+                        {"lastModifiedDateTime", "2020-01-29T21:00:50Z"},
                         {"parentReference", {{"path", "/drive/root:"}}},
-                        {"file", {{"mimeType", "text/plain"}}}},
+                        {"file", {{"mimeType", "text/plain"},
+                                  {"hashes", {{"quickXorHash", "hVDQ6TMb8DyBvSGNy5tFBbVyLts="}}}}}},
                        {{"name", "somefolder"},
                         {"parentReference", {{"path", "/drive/root:"}}},
                         {"folder", {{"childCount", 0}}}}}}}
@@ -56,6 +62,10 @@ SCENARIO("OneDriveDirectory", "[directory][onedrive]") {
                     REQUIRE_REQUEST(0, verb == "GET");
                     REQUIRE_REQUEST(0, url == "https://graph.microsoft.com/v1.0/me/drive/root/children");
                 }
+                THEN("the largest pages with only the fields of a resource should be requested") {
+                    REQUIRE_REQUEST(0, query_params.at("$top") == "1000");
+                    REQUIRE_REQUEST(0, query_params.at("$select") == DRIVE_ITEM_SELECT);
+                }
 
                 THEN("a list with one file & one directory should be returned") {
                     REQUIRE(dirList.size() == 2);
@@ -64,6 +74,44 @@ SCENARIO("OneDriveDirectory", "[directory][onedrive]") {
                     REQUIRE(dirList[1]->name() == "somefolder");
                     REQUIRE(dirList[1]->path() == "/somefolder");
                 }
+                THEN("size, modification time & mimetype of the file should be kept") {
+                    const auto file = std::dynamic_pointer_cast<File>(dirList[0]);
+                    REQUIRE(file->size() == 11048);
+                    REQUIRE(file->modified() == std::chrono::system_clock::time_point(std::chrono::seconds(1580331650)));
+                    REQUIRE(file->content_type() == "text/plain");
+                }
+                THEN("the QuickXorHash of the file should be kept") {
+                    const auto file = std::dynamic_pointer_cast<File>(dirList[0]);
+                    REQUIRE(file->content_hash() == ContentHash{
+                        ContentHash::Algorithm::QUICK_XOR, "hVDQ6TMb8DyBvSGNy5tFBbVyLts="});
+                }
+            }
+            WHEN("calling list_resource_info()") {
+                const auto dirList = directory->list_resource_info();
+
+                THEN("the /children graph endpoint should have been called") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, url == "https://graph.microsoft.com/v1.0/me/drive/root/children");
+                }
+                THEN("a description of one file & one directory should be returned") {
+                    REQUIRE(dirList.size() == 2);
+                    REQUIRE(dirList[0].name == "somefile.txt");
+                    REQUIRE(dirList[0].id == "ABW1234");
+                    REQUIRE(dirList[0].revision == "somerevision");
+                    REQUIRE(dirList[0].is_file());
+                    REQUIRE(dirList[0].content_hash == ContentHash{
+                        ContentHash::Algorithm::QUICK_XOR, "hVDQ6TMb8DyBvSGNy5tFBbVyLts="});
+                    REQUIRE(dirList[1].name == "somefolder");
+                    REQUIRE_FALSE(dirList[1].is_file());
+                }
+                AND_WHEN("calling get_resource() for the directory entry") {
+                    const auto folder = directory->get_resource(dirList[1]);
+                    THEN("a directory handle should be returned without making another request") {
+                        Verify(Method(requestMock, request)).Once();
+                        REQUIRE_FALSE(folder->is_file());
+                        REQUIRE(folder->path() == "/somefolder");
+                    }
+                }
             }
         }
         AND_GIVEN("a request that returns a valid folder description") {
@@ -149,6 +197,74 @@ SCENARIO("OneDriveDirectory", "[directory][onedrive]") {
             }
         }
 
+        AND_GIVEN("a request series that returns a listing with a download url and the content of the file") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(
+                    200,
+                    json{{"value",
+                          {{{"@microsoft.graph.downloadUrl", "https://public.ch.files.1drv.com/filedownloadlink"},
+                            {"eTag", "somerevision"},
+                            {"name", "somefile.txt"},
+                            {"parentReference", {{"path", "/drive/root:/some/folder"}}},
+                            {"file", json::object()}}}}}
+                        .dump(),
+                    "application/json"))
+                .Return(request::StringResponse(200, "content"));
+
+            WHEN("reading a file of the listing") {
+                const auto file = std::dynamic_pointer_cast<File>(directory->list_resources().at(0));
+                const auto content = file->read();
+
+                THEN("the content should be downloaded from the download url, without the token") {
+                    Verify(Method(requestMock, request)).Exactly(2);
+                    REQUIRE_REQUEST(1, verb == "GET");
+                    REQUIRE_REQUEST(1, url == "https://public.ch.files.1drv.com/filedownloadlink");
+                    REQUIRE(requestRecording[1].bearer_token.empty());
+                    REQUIRE(content == "content");
+                }
+            }
+        }
+
+        AND_GIVEN("a request series that returns a directory listing spread over two pages") {
+            const std::string next_link = "https://graph.microsoft.com/v1.0/me/drive/root:/some/folder:/children"
+                                          "?$top=1000&$skiptoken=abc";
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(
+                    200,
+                    json{{"value",
+                          {{{"eTag", "somerevision"},
+                            {"name", "somefile.txt"},
+                            {"parentReference", {{"path", "/drive/root:/some/folder"}}},
+                            {"file", json::object()}}}},
+                         {"@odata.nextLink", next_link}}
+                        .dump(),
+                    "application/json"))
+                .Return(request::StringResponse(
+                    200,
+                    json{{"value",
+                          {{{"name", "somefolder"},
+                            {"parentReference", {{"path", "/drive/root:/some/folder"}}},
+                            {"folder", {{"childCount", 0}}}}}}}
+                        .dump(),
+                    "application/json"));
+
+            WHEN("calling list_resources()") {
+                const auto dirList = directory->list_resources();
+
+                THEN("the next link of the first page should be followed") {
+                    Verify(Method(requestMock, request)).Exactly(2);
+                    REQUIRE_REQUEST(1, verb == "GET");
+                    REQUIRE_REQUEST(1, url == next_link);
+                    REQUIRE(requestRecording[1].query_params.empty());
+                }
+                THEN("the resources of both pages should be returned") {
+                    REQUIRE(dirList.size() == 2);
+                    REQUIRE(dirList[0]->name() == "somefile.txt");
+                    REQUIRE(dirList[1]->name() == "somefolder");
+                }
+            }
+        }
+
         AND_GIVEN("a request that throws 404 Resource Not Found") {
             When(Method(requestMock, request)).Throw(request::exceptions::response::NotFound(
                 json{{"error", {{"code", "itemNotFound"}, {"message", "The resource could not be found."}}}}.dump()));
@@ -165,6 +281,7 @@ SCENARIO("OneDriveDirectory", "[directory][onedrive]") {
                 200,
                 json{
                     {"name", "somefolder"},
+                    {"eTag", "\"{F1},3\""},
                     {"parentReference", {{"path", "/drive/root:/some/folder"}}},
                     {"folder", {{"childCount", 0}}}}
                     .dump(),
@@ -176,10 +293,34 @@ SCENARIO("OneDriveDirectory", "[directory][onedrive]") {
                     Verify(Method(requestMock, request)).Once();
                     REQUIRE_REQUEST(0, verb == "GET");
                     REQUIRE_REQUEST(0, url == "https://graph.microsoft.com/v1.0/me/drive/root:/some/folder/somefolder");
+                    REQUIRE_REQUEST(0, query_params.at("$select") == DRIVE_ITEM_SELECT);
                 }
                 THEN("the folder 'somefolder' should be returned") {
                     REQUIRE(newDirectory->name() == "somefolder");
                     REQUIRE(newDirectory->path() == "/some/folder/somefolder");
+                    REQUIRE(newDirectory->revision() == "\"{F1},3\"");
+                }
+            }
+        }
+        AND_GIVEN("a request that returns the eTag of the folder") {
+            When(Method(requestMock, request)).AlwaysReturn(request::StringResponse(
+                200,
+                json{{"eTag", "\"{F0},7\""}}.dump(),
+                "application/json"));
+
+            WHEN("calling poll_change() twice") {
+                const bool first_change = directory->poll_change();
+                const bool second_change = directory->poll_change();
+                THEN("the graph resource endpoint should have been called for the eTag only") {
+                    Verify(Method(requestMock, request)).Twice();
+                    REQUIRE_REQUEST(0, verb == "GET");
+                    REQUIRE_REQUEST(0, url == "https://graph.microsoft.com/v1.0/me/drive/root:/some/folder");
+                    REQUIRE_REQUEST(0, query_params.at("$select") == "eTag");
+                }
+                THEN("only the first call should report a change and the revision should be set") {
+                    REQUIRE(first_change);
+                    REQUIRE_FALSE(second_change);
+                    REQUIRE(directory->revision() == "\"{F0},7\"");
                 }
             }
         }
@@ -205,6 +346,7 @@ SCENARIO("OneDriveDirectory", "[directory][onedrive]") {
                     REQUIRE_REQUEST(
                         0,
                         url == "https://graph.microsoft.com/v1.0/me/drive/root:/some/folder/somefile.txt");
+                    REQUIRE_REQUEST(0, query_params.at("$select") == DRIVE_ITEM_SELECT);
                 }
 
                 THEN("the requested file would be returned") {
@@ -254,6 +396,23 @@ SCENARIO("OneDriveDirectory", "[directory][onedrive]") {
                     REQUIRE(newFile->revision() == "somerevision");
                 }
             }
+            WHEN("calling create_file(somefile.txt, abc)") {
+                const auto newFile = directory->create_file("somefile.txt", {'a', 'b', 'c'});
+                THEN("the content endpoint should be called once with the file content and without replacing") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "PUT");
+                    REQUIRE_REQUEST(
+                        0,
+                        url == "https://graph.microsoft.com/v1.0/me/drive/root:"
+                               "/some/folder/somefile.txt:/content");
+                    REQUIRE_REQUEST(0, query_params.at("@microsoft.graph.conflictBehavior") == "fail");
+                    REQUIRE_REQUEST(0, binary_body == std::vector<std::uint8_t>{'a', 'b', 'c'});
+                }
+                THEN("the new file should be returned") {
+                    REQUIRE(newFile->path() == "/some/folder/somefile.txt");
+                    REQUIRE(newFile->revision() == "somerevision");
+                }
+            }
         }
 
         AND_GIVEN("a request sequence that returns 200 and a valid folder description") {
@@ -284,6 +443,230 @@ SCENARIO("OneDriveDirectory", "[directory][onedrive]") {
                     REQUIRE(newFolder->path() == "/some/folder/somefolder");
                 }
             }
+            WHEN("calling ensure_directory(somefolder) twice") {
+                directory->ensure_directory("somefolder");
+                const auto newFolder = directory->ensure_directory("somefolder");
+                THEN("the folder should be addressed by its path once, which creates it along with its parents") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "PATCH");
+                    REQUIRE_REQUEST(
+                        0,
+                        url == "https://graph.microsoft.com/v1.0/me/"
+                               "drive/root:/some/folder/somefolder");
+                    REQUIRE_REQUEST(0, body == "{\"folder\":{}}");
+                }
+                THEN("the folder should be returned") {
+                    REQUIRE(newFolder->path() == "/some/folder/somefolder");
+                }
+            }
+        }
+    }
+    GIVEN("a onedrive directory (non root) and a $batch request") {
+        const auto directory = std::make_shared<OneDriveDirectory>(
+            "https://graph.microsoft.com/v1.0/me/drive/root",
+            "/some/folder",
+            credentials,
+            request,
+            "folder");
+        AND_GIVEN("a batch response with one success and one 404, in reverse order") {
+            When(Method(requestMock, request)).Return(request::StringResponse(
+                200,
+                json{{"responses", {
+                    {{"id", "1"}, {"status", 404}, {"body", {{"error", {{"code", "itemNotFound"}}}}}},
+                    {{"id", "0"}, {"status", 204}}
+                }}}.dump(),
+                "application/json"));
+
+            WHEN("calling remove_many(a, b)") {
+                const auto results = directory->remove_many({"a", "b"});
+                THEN("a single request should be made to the $batch endpoint") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "POST");
+                    REQUIRE_REQUEST(0, url == "https://graph.microsoft.com/v1.0/$batch");
+                    const auto requests = json::parse(requestRecording[0].body).at("requests");
+                    REQUIRE(requests.size() == 2);
+                    REQUIRE(requests[0] == json{{"id", "0"}, {"method", "DELETE"}, {"url", "/me/drive/root:/some/folder/a"}});
+                    REQUIRE(requests[1].at("url") == "/me/drive/root:/some/folder/b");
+                }
+                THEN("the responses should be matched to the paths by their id") {
+                    REQUIRE(results[0].ok());
+                    REQUIRE_THROWS_AS(results[1].rethrow_if_failed(), CloudSync::exceptions::resource::NoSuchResource);
+                }
+            }
+        }
+        AND_GIVEN("a batch response with a folder and a file description") {
+            When(Method(requestMock, request)).Return(request::StringResponse(
+                200,
+                json{{"responses", {
+                    {{"id", "0"}, {"status", 200}, {"body", {
+                        {"name", "a"},
+                        {"parentReference", {{"path", "/drive/root:/some/folder"}}},
+                        {"folder", {{"childCount", 0}}}}}},
+                    {{"id", "1"}, {"status", 200}, {"body", {
+                        {"name", "b.txt"},
+                        {"size", 12},
+                        {"parentReference", {{"path", "/drive/root:/some/folder"}}},
+                        {"file", {{"mimeType", "text/plain"}}}}}}
+                }}}.dump(),
+                "application/json"));
+
+            WHEN("calling stat_many(a, b.txt)") {
+                const auto results = directory->stat_many({"a", "b.txt"});
+                THEN("both items should be requested in a single batch") {
+                    Verify(Method(requestMock, request)).Once();
+                    const auto requests = json::parse(requestRecording[0].body).at("requests");
+                    REQUIRE(requests[0] == json{
+                        {"id", "0"},
+                        {"method", "GET"},
+                        {"url", "/me/drive/root:/some/folder/a?$select=" + DRIVE_ITEM_SELECT}});
+                    REQUIRE(requests[1].at("url").get<std::string>().rfind("/me/drive/root:/some/folder/b.txt?", 0) == 0);
+                }
+                THEN("the resource infos should be returned") {
+                    REQUIRE(results[0].value.kind == ResourceInfo::Kind::DIRECTORY);
+                    REQUIRE(results[1].value.kind == ResourceInfo::Kind::FILE);
+                    REQUIRE(results[1].value.size == 12);
+                }
+            }
+            WHEN("calling create_directories(a)") {
+                const auto results = directory->create_directories({"a"});
+                THEN("the folder should be created in its parent through the $batch endpoint") {
+                    Verify(Method(requestMock, request)).Once();
+                    const auto batch_request = json::parse(requestRecording[0].body).at("requests").at(0);
+                    REQUIRE(batch_request.at("method") == "POST");
+                    REQUIRE(batch_request.at("url") == "/me/drive/root:/some/folder:/children");
+                    REQUIRE(batch_request.at("body").at("name") == "a");
+                    REQUIRE(batch_request.at("body").at("@microsoft.graph.conflictBehavior") == "fail");
+                }
+                THEN("the created directory should be returned") {
+                    REQUIRE(results[0].value->path() == "/some/folder/a");
+                }
+            }
+        }
+        AND_GIVEN("a batch response with a conflict and one with a new folder") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(
+                    200,
+                    json{{"responses", {
+                        {{"id", "0"}, {"status", 409}, {"body", {{"error", {{"code", "nameAlreadyExists"}}}}}}
+                    }}}.dump(),
+                    "application/json"))
+                .Return(request::StringResponse(
+                    200,
+                    json{{"responses", {
+                        {{"id", "0"}, {"status", 201}, {"body", {
+                            {"name", "b"},
+                            {"parentReference", {{"path", "/drive/root:/some/folder/a"}}},
+                            {"folder", {{"childCount", 0}}}}}}
+                    }}}.dump(),
+                    "application/json"));
+            WHEN("calling create_directories(a/b)") {
+                const auto results = directory->create_directories({"a/b"});
+                THEN("the intermediate should be created first, a conflict meaning that it exists already") {
+                    Verify(Method(requestMock, request)).Twice();
+                    const auto intermediate = json::parse(requestRecording[0].body).at("requests").at(0);
+                    REQUIRE(intermediate.at("url") == "/me/drive/root:/some/folder:/children");
+                    REQUIRE(intermediate.at("body").at("name") == "a");
+                    const auto requested = json::parse(requestRecording[1].body).at("requests").at(0);
+                    REQUIRE(requested.at("url") == "/me/drive/root:/some/folder/a:/children");
+                    REQUIRE(requested.at("body").at("name") == "b");
+                }
+                THEN("the requested directory should be returned") {
+                    REQUIRE(results[0].ok());
+                    REQUIRE(results[0].value->path() == "/some/folder/a/b");
+                }
+            }
+        }
+        AND_GIVEN("a request that returns the description of an uploaded file") {
+            When(Method(requestMock, request)).Return(request::StringResponse(
+                200,
+                json{
+                    {"name", "a.txt"},
+                    {"eTag", "\"{etag},2\""},
+                    {"size", 3},
+                    {"parentReference", {{"path", "/drive/root:/some/folder"}}},
+                    {"file", {{"mimeType", "text/plain"}}}}.dump(),
+                "application/json"));
+            WHEN("calling upload_many(a.txt)") {
+                const auto results = directory->upload_many({{"a.txt", {1, 2, 3}}});
+                THEN("the content should be PUT to the path of the file, replacing existing files") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "PUT");
+                    REQUIRE_REQUEST(0, url == "https://graph.microsoft.com/v1.0/me/drive/root:/some/folder/a.txt:/content");
+                    REQUIRE_REQUEST(0, query_params.at("@microsoft.graph.conflictBehavior") == "replace");
+                    REQUIRE_REQUEST(0, binary_body == std::vector<std::uint8_t>{1, 2, 3});
+                }
+                THEN("a handle with the new revision should be returned") {
+                    REQUIRE(results[0].ok());
+                    REQUIRE(results[0].value->path() == "/some/folder/a.txt");
+                    REQUIRE(results[0].value->revision() == "\"{etag},2\"");
+                }
+            }
+        }
+        AND_GIVEN("a request that fails with 401") {
+            When(Method(requestMock, request)).Throw(request::exceptions::response::Unauthorized());
+            WHEN("calling stat_many(a, b)") {
+                const auto results = directory->stat_many({"a", "b"});
+                THEN("every path should report the failed batch") {
+                    REQUIRE_THROWS_AS(results[0].rethrow_if_failed(), CloudSync::exceptions::cloud::AuthorizationFailed);
+                    REQUIRE_THROWS_AS(results[1].rethrow_if_failed(), CloudSync::exceptions::cloud::AuthorizationFailed);
+                }
+            }
+        }
+    }
+    GIVEN("a onedrive directory (non root), search results without the path of their folder and a $batch request") {
+        const auto directory = std::make_shared<OneDriveDirectory>(
+            "https://graph.microsoft.com/v1.0/me/drive/root",
+            "/some/folder",
+            credentials,
+            request,
+            "folder");
+        When(Method(requestMock, request))
+            .Return(request::StringResponse(200, json{{"value", {
+                {{"name", "report.pdf"}, {"eTag", "e1"}, {"file", {{"mimeType", "application/pdf"}}},
+                 {"parentReference", {{"id", "idA"}, {"driveId", "d1"}}}},
+                {{"name", "reports"}, {"folder", {{"childCount", 1}}},
+                 {"parentReference", {{"id", "idB"}, {"driveId", "d1"}, {"path", "/drive/root:/other"}}}},
+                {{"name", "report.txt"}, {"eTag", "e2"}, {"file", {{"mimeType", "text/plain"}}},
+                 {"parentReference", {{"id", "idC"}, {"driveId", "d2"}}}, {"remoteItem", {{"id", "r"}}}}
+            }}}.dump(), "application/json"))
+            .Return(request::StringResponse(200, json{{"responses", {
+                {{"id", "0"}, {"status", 200}, {"body", {
+                    {"id", "idA"},
+                    {"name", "a"},
+                    {"parentReference", {{"path", "/drive/root:/some/folder"}}},
+                    {"folder", {{"childCount", 1}}}}}}
+            }}}.dump(), "application/json"));
+
+        WHEN("searching for \"o'report\"") {
+            std::vector<SearchResult> results;
+            directory->search(SearchQuery{"o'report"}, [&results](const std::vector<SearchResult> &page) {
+                results.insert(results.end(), page.begin(), page.end());
+                return true;
+            });
+            THEN("the search of the folder should be called with the text as parameter alias") {
+                REQUIRE_REQUEST(0, verb == "GET");
+                REQUIRE_REQUEST(0, url == "https://graph.microsoft.com/v1.0/me/drive/root:/some/folder:/search(q=@q)");
+                REQUIRE_REQUEST(0, query_params.at("@q") == "'o''report'");
+            }
+            THEN("the folders without a path should be looked up with a single batch") {
+                Verify(Method(requestMock, request)).Exactly(2);
+                const auto requests = json::parse(requestRecording[1].body).at("requests");
+                REQUIRE(requests.size() == 1);
+                REQUIRE(requests[0].at("url") == "/drives/d1/items/idA?$select=id,name,root,parentReference");
+            }
+        }
+        WHEN("searching for report") {
+            std::vector<SearchResult> results;
+            directory->search(SearchQuery{"report"}, [&results](const std::vector<SearchResult> &page) {
+                results.insert(results.end(), page.begin(), page.end());
+                return true;
+            });
+            THEN("only the results below the directory should be returned, with their full path") {
+                REQUIRE(results.size() == 1);
+                REQUIRE(results[0].path == "/some/folder/a/report.pdf");
+                REQUIRE(results[0].info.revision == "e1");
+                REQUIRE(results[0].info.content_type == "application/pdf");
+            }
         }
     }
 }
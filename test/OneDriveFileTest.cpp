@@ -2,6 +2,7 @@
 #include "onedrive/OneDriveFile.hpp"
 #include "request/Request.hpp"
 #include "macros/request_mock.hpp"
+#include "macros/temp_file.hpp"
 #include "macros/oauth_mock.hpp"
 #include <catch2/catch.hpp>
 #include <fakeit.hpp>
@@ -106,12 +107,28 @@ SCENARIO("OneDriveFile", "[file][onedrive]") {
                         0,
                         url == "https://graph.microsoft.com/v1.0/me/"
                                "drive/root:/folder/file.txt");
+                    REQUIRE_REQUEST(0, query_params.at("$select") == "eTag,size,lastModifiedDateTime,file,@microsoft.graph.downloadUrl");
                 }
                 THEN("the result should be true (the file has changed)") {
                     REQUIRE(fileChanged == true);
                 }
             }
         }
+        AND_GIVEN("a GET request that returns a file description with only a SHA-256 hash") {
+            When(Method(requestMock, request)).Return(request::StringResponse(
+                200,
+                json{{"eTag", "new_file_revision"},
+                     {"file", {{"hashes", {{"sha256Hash", "9F86D081884C7D659A2FEAA0C55AD015A3BF4F1B2B0B822CD15D6C15B0F00A08"}}}}}}.dump(),
+                "application/json"));
+
+            WHEN("calling poll_change()") {
+                file->poll_change();
+                THEN("the file should have the SHA-256 as content hash, in lowercase") {
+                    REQUIRE(file->content_hash() == ContentHash{
+                        ContentHash::Algorithm::SHA256, "9f86d081884c7d659a2feaa0c55ad015a3bf4f1b2b0b822cd15d6c15b0f00a08"});
+                }
+            }
+        }
         AND_GIVEN("a GET request that returns a file description (with the same old revision)") {
             When(Method(requestMock, request)).Return(request::StringResponse(200, json{{"eTag", "file_revision"}}.dump(), "application/json"));
 
@@ -131,4 +148,166 @@ SCENARIO("OneDriveFile", "[file][onedrive]") {
             }
         }
     }
+    GIVEN("a OneDriveFile instance with a download url") {
+        const auto file = std::make_shared<OneDriveFile>(
+            "https://graph.microsoft.com/v1.0/me/drive/root",
+            "/folder/file.txt",
+            credentials,
+            request,
+            "file.txt",
+            "file_revision",
+            12,
+            std::chrono::system_clock::time_point(),
+            "text/plain",
+            std::nullopt,
+            "https://public.ch.files.1drv.com/filedownloadlink");
+        AND_GIVEN("a request series where the download url has expired and the content endpoint returns the content") {
+            When(Method(requestMock, request))
+                .Throw(request::exceptions::response::Unauthorized())
+                .Return(request::StringResponse(200, "file content"));
+
+            WHEN("calling read()") {
+                const auto content = file->read();
+
+                THEN("the content endpoint should be called after the download url has failed") {
+                    Verify(Method(requestMock, request)).Exactly(2);
+                    REQUIRE_REQUEST(0, url == "https://public.ch.files.1drv.com/filedownloadlink");
+                    REQUIRE_REQUEST(1, url == "https://graph.microsoft.com/v1.0/me/drive/root:/folder/file.txt:/content");
+                    REQUIRE_REQUEST(1, bearer_token == "mytoken");
+                    REQUIRE(content == "file content");
+                }
+                AND_WHEN("calling read() again") {
+                    When(Method(requestMock, request)).Return(request::StringResponse(200, "file content"));
+                    file->read();
+                    THEN("the expired download url should not be tried again") {
+                        REQUIRE(requestRecording.size() == 3);
+                        REQUIRE_REQUEST(2, url == "https://graph.microsoft.com/v1.0/me/drive/root:/folder/file.txt:/content");
+                    }
+                }
+            }
+        }
+    }
+    GIVEN("a OneDriveFile instance and a local file that is too large for a single request") {
+        const auto file = std::make_shared<OneDriveFile>(
+            "https://graph.microsoft.com/v1.0/me/drive/root",
+            "/folder/file.txt",
+            credentials,
+            request,
+            "file.txt",
+            "file_revision");
+        const auto local_file = temp_file("cloudsync_onedrive_upload.bin", 5 * 1024 * 1024);
+        AND_GIVEN("a request series that creates an upload session, fails once and then completes it") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(200, json{{"uploadUrl", "https://upload.example.com/session"}}.dump(), "application/json"))
+                .Throw(request::exceptions::response::ServiceUnavailable())
+                .Return(request::StringResponse(200, json{{"nextExpectedRanges", {"0-"}}}.dump(), "application/json"))
+                .Return(request::StringResponse(201, json{{"eTag", "new_revision"}, {"size", 5 * 1024 * 1024}}.dump(), "application/json"));
+            WHEN("uploading the local file") {
+                file->upload(local_file);
+                THEN("an upload session should be created for the current revision") {
+                    Verify(Method(requestMock, request)).Exactly(4);
+                    REQUIRE_REQUEST(0, verb == "POST");
+                    REQUIRE_REQUEST(0, url == "https://graph.microsoft.com/v1.0/me/drive/root:/folder/file.txt:/createUploadSession");
+                    REQUIRE_REQUEST(0, headers.at("If-Match") == "file_revision");
+                }
+                THEN("the chunk should be sent to the upload url without the access token") {
+                    REQUIRE_REQUEST(1, verb == "PUT");
+                    REQUIRE_REQUEST(1, url == "https://upload.example.com/session");
+                    REQUIRE_REQUEST(1, headers.at("Content-Range") == "bytes 0-5242879/5242880");
+                    REQUIRE_REQUEST(1, bearer_token.empty());
+                }
+                THEN("the upload should continue at what the session has received after the failed chunk") {
+                    REQUIRE_REQUEST(2, verb == "GET");
+                    REQUIRE_REQUEST(2, url == "https://upload.example.com/session");
+                    REQUIRE_REQUEST(3, headers.at("Content-Range") == "bytes 0-5242879/5242880");
+                }
+                THEN("the file should have the new revision") {
+                    REQUIRE(file->revision() == "new_revision");
+                }
+            }
+        }
+    }
+    GIVEN("a OneDriveFile instance in a folder") {
+        const auto file = std::make_shared<OneDriveFile>(
+            "https://graph.microsoft.com/v1.0/me/drive/root",
+            "/folder/file.txt",
+            credentials,
+            request,
+            "file.txt",
+            "file_revision");
+        const json renamed_item = {
+            {"name", "renamed.txt"},
+            {"eTag", "renamed_revision"},
+            {"file", json::object()},
+            {"parentReference", {{"path", "/drive/root:/folder"}}}};
+        AND_GIVEN("a PATCH request that returns the renamed driveItem") {
+            When(Method(requestMock, request)).Return(request::StringResponse(200, renamed_item.dump(), "application/json"));
+            WHEN("renaming the file") {
+                const auto moved = std::dynamic_pointer_cast<File>(file->move_to("renamed.txt"));
+                THEN("only the name should be patched, without looking up the parent") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "PATCH");
+                    REQUIRE_REQUEST(0, url == "https://graph.microsoft.com/v1.0/me/drive/root:/folder/file.txt");
+                    REQUIRE_REQUEST(0, body == json{{"name", "renamed.txt"}}.dump());
+                    REQUIRE_REQUEST(0, query_params.at("@microsoft.graph.conflictBehavior") == "fail");
+                }
+                THEN("a handle for the renamed file should be returned") {
+                    REQUIRE(moved->path() == "/folder/renamed.txt");
+                    REQUIRE(moved->revision() == "renamed_revision");
+                }
+            }
+        }
+        AND_GIVEN("a request series that looks up the new parent, starts a copy, reports it as completed and returns the copy") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(200, json{{"id", "otherId"}}.dump(), "application/json"))
+                .Return(request::StringResponse(202, "", "", {{"location", "https://monitor.example.com/copy"}}))
+                .Return(request::StringResponse(200, json{{"status", "completed"}, {"resourceId", "copyId"}}.dump(), "application/json"))
+                .Return(request::StringResponse(200, json{
+                    {"name", "file.txt"},
+                    {"eTag", "copy_revision"},
+                    {"file", json::object()},
+                    {"parentReference", {{"path", "/drive/root:/other"}}}}.dump(), "application/json"));
+            WHEN("copying the file to another folder") {
+                const auto copy = std::dynamic_pointer_cast<File>(file->copy_to("/other/file.txt"));
+                THEN("the copy should reference the new parent by its id") {
+                    Verify(Method(requestMock, request)).Exactly(4);
+                    REQUIRE_REQUEST(0, url == "https://graph.microsoft.com/v1.0/me/drive/root:/other");
+                    REQUIRE_REQUEST(1, verb == "POST");
+                    REQUIRE_REQUEST(1, url == "https://graph.microsoft.com/v1.0/me/drive/root:/folder/file.txt:/copy");
+                    REQUIRE_REQUEST(1, body == json{{"name", "file.txt"}, {"parentReference", {{"id", "otherId"}}}}.dump());
+                }
+                THEN("the monitor should be polled without the access token") {
+                    REQUIRE_REQUEST(2, url == "https://monitor.example.com/copy");
+                    REQUIRE_REQUEST(2, bearer_token.empty());
+                }
+                THEN("a handle for the copy should be returned") {
+                    REQUIRE_REQUEST(3, url == "https://graph.microsoft.com/v1.0/me/drive/root:/other/file.txt");
+                    REQUIRE(copy->path() == "/other/file.txt");
+                    REQUIRE(copy->revision() == "copy_revision");
+                }
+            }
+        }
+        AND_GIVEN("a request series that starts a copy, gets redirected to the new item by the monitor and returns the copy") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(202, "", "", {{"location", "https://monitor.example.com/copy"}}))
+                .Return(request::StringResponse(303, "", "", {{"location", "https://graph.microsoft.com/v1.0/me/drive/items/copyId"}}))
+                .Return(request::StringResponse(200, json{
+                    {"name", "copy.txt"},
+                    {"eTag", "copy_revision"},
+                    {"file", json::object()},
+                    {"parentReference", {{"path", "/drive/root:/folder"}}}}.dump(), "application/json"));
+            WHEN("copying the file within its folder") {
+                const auto copy = std::dynamic_pointer_cast<File>(file->copy_to("copy.txt"));
+                THEN("the redirect should complete the copy without polling again") {
+                    Verify(Method(requestMock, request)).Exactly(3);
+                    REQUIRE_REQUEST(1, url == "https://monitor.example.com/copy");
+                    REQUIRE_REQUEST(2, url == "https://graph.microsoft.com/v1.0/me/drive/root:/folder/copy.txt");
+                }
+                THEN("a handle for the copy should be returned") {
+                    REQUIRE(copy->path() == "/folder/copy.txt");
+                    REQUIRE(copy->revision() == "copy_revision");
+                }
+            }
+        }
+    }
 }
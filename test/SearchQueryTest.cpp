@@ -0,0 +1,67 @@
+#include "CloudSync/SearchQuery.hpp"
+#include <catch2/catch.hpp>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace std::chrono;
+
+SCENARIO("SearchQuery", "[search]") {
+    ResourceInfo file;
+    file.name = "Quarterly Report.pdf";
+    file.content_type = "application/pdf";
+    file.modified = system_clock::time_point(seconds(1580331650));
+    ResourceInfo folder;
+    folder.name = "reports";
+    folder.kind = ResourceInfo::Kind::DIRECTORY;
+
+    GIVEN("an empty query") {
+        const SearchQuery query;
+        THEN("every resource should match") {
+            REQUIRE(query.matches(file));
+            REQUIRE(query.matches(folder));
+        }
+    }
+    GIVEN("a query for a name") {
+        SearchQuery query;
+        query.name = "REPORT";
+        THEN("resources whose name contains it in any case should match") {
+            REQUIRE(query.matches(file));
+            REQUIRE(query.matches(folder));
+        }
+        WHEN("the name is not contained") {
+            query.name = "reportx";
+            THEN("nothing should match") {
+                REQUIRE_FALSE(query.matches(file));
+                REQUIRE_FALSE(query.matches(folder));
+            }
+        }
+    }
+    GIVEN("a query for directories") {
+        SearchQuery query;
+        query.kind = ResourceInfo::Kind::DIRECTORY;
+        THEN("only directories should match") {
+            REQUIRE_FALSE(query.matches(file));
+            REQUIRE(query.matches(folder));
+        }
+    }
+    GIVEN("a query for a mimetype") {
+        SearchQuery query;
+        query.content_type = "application/pdf";
+        THEN("only files with that mimetype should match") {
+            REQUIRE(query.matches(file));
+            REQUIRE_FALSE(query.matches(folder));
+            file.content_type = "text/plain";
+            REQUIRE_FALSE(query.matches(file));
+        }
+    }
+    GIVEN("a query for a modification time") {
+        SearchQuery query;
+        query.modified_after = file.modified - seconds(1);
+        THEN("only resources modified later should match") {
+            REQUIRE(query.matches(file));
+            REQUIRE_FALSE(query.matches(folder));
+            query.modified_after = file.modified;
+            REQUIRE_FALSE(query.matches(file));
+        }
+    }
+}
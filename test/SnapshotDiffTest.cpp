@@ -0,0 +1,118 @@
+#include "CloudSync/SnapshotDiff.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <random>
+
+using namespace Catch;
+using namespace CloudSync;
+
+namespace {
+    std::vector<std::string> paths_of(const std::vector<SnapshotEntry> &entries) {
+        std::vector<std::string> paths;
+        for (const auto &entry: entries) {
+            paths.push_back(entry.path);
+        }
+        return paths;
+    }
+}
+
+SCENARIO("SnapshotDiff", "[sync]") {
+    const std::vector<SnapshotEntry> before = {
+            {"docs", "d1", 0, ResourceInfo::Kind::DIRECTORY},
+            {"docs/a.txt", "r1", 10},
+            {"docs/b.txt", "r1", 20},
+            {"docs/c.txt", "r1", 30},
+            {"music", "d1", 0, ResourceInfo::Kind::DIRECTORY},
+    };
+
+    GIVEN("two equal snapshots") {
+        THEN("the diff should be empty") {
+            REQUIRE(SnapshotDiff::between(before, before).empty());
+        }
+    }
+    GIVEN("a newer snapshot with added, removed & modified entries in another order") {
+        const std::vector<SnapshotEntry> after = {
+                {"docs/d.txt", "r1", 40},
+                {"docs/c.txt", "r1", 31},
+                {"music", "d1", 0, ResourceInfo::Kind::DIRECTORY},
+                {"docs/b.txt", "r2", 20},
+                {"docs", "d1", 0, ResourceInfo::Kind::DIRECTORY},
+        };
+        WHEN("diffing the snapshots") {
+            const auto diff = SnapshotDiff::between(before, after);
+            THEN("every change should be found, sorted by path") {
+                REQUIRE(paths_of(diff.added) == std::vector<std::string>{"docs/d.txt"});
+                REQUIRE(paths_of(diff.removed) == std::vector<std::string>{"docs/a.txt"});
+                REQUIRE(paths_of(diff.modified) == std::vector<std::string>{"docs/b.txt", "docs/c.txt"});
+            }
+            THEN("modified entries should be the ones of the newer snapshot") {
+                REQUIRE(diff.modified[0].revision == "r2");
+                REQUIRE(diff.modified[1].size == 31);
+            }
+        }
+    }
+    GIVEN("paths that are written differently") {
+        const std::vector<SnapshotEntry> after = {
+                {"/docs/", "d1", 0, ResourceInfo::Kind::DIRECTORY},
+                {"docs//a.txt", "r1", 10},
+                {"./docs/./b.txt", "r1", 20},
+                {"docs/c.txt/.", "r1", 30},
+                {"music", "d1", 0, ResourceInfo::Kind::DIRECTORY},
+        };
+        THEN("they should be compared normalized") {
+            REQUIRE(SnapshotDiff::between(before, after).empty());
+        }
+    }
+    GIVEN("a file that has been replaced by a directory") {
+        auto after = before;
+        after[1].kind = ResourceInfo::Kind::DIRECTORY;
+        after[1].size = 0;
+        WHEN("diffing the snapshots") {
+            const auto diff = SnapshotDiff::between(before, after);
+            THEN("the path should be removed and added") {
+                REQUIRE(paths_of(diff.removed) == std::vector<std::string>{"docs/a.txt"});
+                REQUIRE(paths_of(diff.added) == std::vector<std::string>{"docs/a.txt"});
+                REQUIRE(diff.added[0].kind == ResourceInfo::Kind::DIRECTORY);
+                REQUIRE(diff.modified.empty());
+            }
+        }
+    }
+    GIVEN("a snapshot with a path that appears twice") {
+        auto after = before;
+        after.push_back({"docs/a.txt", "r2", 10});
+        THEN("the path should only be reported once") {
+            const auto diff = SnapshotDiff::between(before, after);
+            REQUIRE(paths_of(diff.modified) == std::vector<std::string>{"docs/a.txt"});
+            REQUIRE(diff.added.empty());
+        }
+    }
+    GIVEN("large shuffled snapshots") {
+        std::vector<SnapshotEntry> old_snapshot;
+        std::vector<SnapshotEntry> new_snapshot;
+        for (std::size_t i = 0; i < 100000; i++) {
+            const auto path = "dir" + std::to_string(i % 97) + "/file" + std::to_string(i);
+            old_snapshot.push_back({path, "r1", i});
+            if (i % 10 != 0) {
+                new_snapshot.push_back({path, i % 10 == 1 ? "r2" : "r1", i});
+            }
+        }
+        std::mt19937 random(42);
+        std::shuffle(old_snapshot.begin(), old_snapshot.end(), random);
+        std::shuffle(new_snapshot.begin(), new_snapshot.end(), random);
+        WHEN("diffing them with several threads and with a single one") {
+            const auto parallel = SnapshotDiff::between(old_snapshot, new_snapshot, 8);
+            const auto single = SnapshotDiff::between(old_snapshot, new_snapshot, 1);
+            THEN("both should find the same changes") {
+                REQUIRE(parallel.removed.size() == 10000);
+                REQUIRE(parallel.modified.size() == 10000);
+                REQUIRE(parallel.added.empty());
+                REQUIRE(paths_of(parallel.removed) == paths_of(single.removed));
+                REQUIRE(paths_of(parallel.modified) == paths_of(single.modified));
+                REQUIRE(std::is_sorted(parallel.removed.begin(), parallel.removed.end(),
+                                       [](const SnapshotEntry &first, const SnapshotEntry &second) {
+                                           return first.path < second.path;
+                                       }));
+            }
+        }
+    }
+}
@@ -18,13 +18,14 @@ using namespace CloudSync::request;
 SCENARIO("WebdavDirectory", "[directory][webdav]") {
     const std::string BASE_URL = "http://cloud";
     const std::string xmlQuery = "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
-                           "<d:propfind  xmlns:d=\"DAV:\">"
+                           "<d:propfind  xmlns:d=\"DAV:\" xmlns:oc=\"http://owncloud.org/ns\">"
                                "<d:prop>"
                                    "<d:getlastmodified/>"
                                    "<d:getetag/>"
                                    "<d:getcontenttype/>"
                                    "<d:resourcetype/>"
                                    "<d:getcontentlength/>"
+                                   "<oc:checksums/>"
                                "</d:prop>"
                            "</d:propfind>";
     INIT_REQUEST();
@@ -78,6 +79,7 @@ SCENARIO("WebdavDirectory", "[directory][webdav]") {
                 THEN("a object representing the new directory should be returned") {
                     REQUIRE(new_directory->name() == "folder");
                     REQUIRE(new_directory->path() == "/folder");
+                    REQUIRE(new_directory->revision() == "\"5e18e1bede073\"");
                 }
             }
         }
@@ -98,6 +100,56 @@ SCENARIO("WebdavDirectory", "[directory][webdav]") {
                     REQUIRE(new_directory->path() == "/newDirectory");
                 }
             }
+            WHEN("calling create_directory(a/b) and then create_file(a/c.txt, abc)") {
+                When(Method(requestMock, request))
+                    .Return(request::StringResponse(201))
+                    .Return(request::StringResponse(201))
+                    .Return(request::StringResponse(201, "", "", {{"etag", "\"e1\""}}));
+                directory->create_directory("a/b");
+                directory->create_file("a/c.txt", {'a', 'b', 'c'});
+                THEN("the missing parent should be created once, without looking it up") {
+                    Verify(Method(requestMock, request)).Exactly(3);
+                    REQUIRE_REQUEST(0, verb == "MKCOL");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/a");
+                    REQUIRE_REQUEST(1, verb == "MKCOL");
+                    REQUIRE_REQUEST(1, url == BASE_URL + "/a/b");
+                    REQUIRE_REQUEST(2, verb == "PUT");
+                    REQUIRE_REQUEST(2, url == BASE_URL + "/a/c.txt");
+                }
+            }
+            WHEN("calling ensure_directory(a/b) twice") {
+                directory->ensure_directory("a/b");
+                const auto new_directory = directory->ensure_directory("a/b");
+                THEN("only a single MKCOL request should be made for the folder itself") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "MKCOL");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/a/b");
+                }
+                THEN("the folder should be returned") {
+                    REQUIRE(new_directory->path() == "/a/b");
+                }
+            }
+        }
+        AND_GIVEN("a request series that reports a missing parent and then creates two folders") {
+            When(Method(requestMock, request))
+                .Throw(request::exceptions::response::Conflict())
+                .Return(request::StringResponse(201))
+                .Return(request::StringResponse(201));
+            WHEN("calling ensure_directory(x/y)") {
+                const auto new_directory = directory->ensure_directory("x/y");
+                THEN("the parent should only be created after the folder has been refused") {
+                    Verify(Method(requestMock, request)).Exactly(3);
+                    REQUIRE_REQUEST(0, verb == "MKCOL");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/x/y");
+                    REQUIRE_REQUEST(1, verb == "MKCOL");
+                    REQUIRE_REQUEST(1, url == BASE_URL + "/x");
+                    REQUIRE_REQUEST(2, verb == "MKCOL");
+                    REQUIRE_REQUEST(2, url == BASE_URL + "/x/y");
+                }
+                THEN("the folder should be returned") {
+                    REQUIRE(new_directory->path() == "/x/y");
+                }
+            }
         }
         WHEN("deleting the directory") {
             THEN("a PermissionDenied exeception should be thrown, because the root dir cannot be deleted") {
@@ -128,6 +180,37 @@ SCENARIO("WebdavDirectory", "[directory][webdav]") {
                 }
             }
         }
+        AND_GIVEN("a request that returns 201 with an etag header") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(201, "", "", {{"etag", "\"5e18e1bede073\""}}));
+
+            WHEN("calling create_file(newfile.txt, abc)") {
+                const auto new_file = directory->create_file("newfile.txt", {'a', 'b', 'c'});
+                THEN("a single PUT request should be made that doesn't overwrite an existing resource") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "PUT");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/newfile.txt");
+                    REQUIRE_REQUEST(0, headers.at("If-None-Match") == "*");
+                    REQUIRE_REQUEST(0, binary_body == std::vector<std::uint8_t>{'a', 'b', 'c'});
+                }
+                THEN("an object representing the file should be returned") {
+                    REQUIRE(new_file->path() == "/newfile.txt");
+                    REQUIRE(new_file->revision() == "\"5e18e1bede073\"");
+                    REQUIRE(new_file->size() == 3);
+                }
+            }
+        }
+        AND_GIVEN("a request that returns 412") {
+            When(Method(requestMock, request)).Throw(request::exceptions::response::PreconditionFailed());
+
+            WHEN("calling create_file(newfile.txt, abc)") {
+                THEN("a ResourceConflict exception should be thrown") {
+                    REQUIRE_THROWS_AS(
+                        directory->create_file("newfile.txt", {'a', 'b', 'c'}),
+                        CloudSync::exceptions::resource::ResourceConflict);
+                }
+            }
+        }
 
         AND_GIVEN("a request that returns a valid root webdav directory listing") {
             When(Method(requestMock, request)).Return(request::StringResponse(
@@ -214,6 +297,36 @@ SCENARIO("WebdavDirectory", "[directory][webdav]") {
                     REQUIRE(file->path() == "/somefile.txt");
                     REQUIRE(file->revision() == "\"5e18e1bede073\"");
                 }
+                THEN("the modification time & mimetype of the file should be kept") {
+                    const auto file = std::dynamic_pointer_cast<File>(dirlist[1]);
+                    REQUIRE(file->modified() == std::chrono::system_clock::time_point(std::chrono::seconds(1578688958)));
+                    REQUIRE(file->content_type() == "text/plain");
+                }
+            }
+            WHEN("calling list_resource_info()") {
+                const auto dirlist = directory->list_resource_info();
+                THEN("a PROPFIND request should be made on the current directory") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "PROPFIND");
+                    REQUIRE_REQUEST(0, headers.at("Depth") == "1");
+                }
+                THEN("a description of the directory and the file should be returned") {
+                    REQUIRE(dirlist.size() == 2);
+                    REQUIRE(dirlist[0].name == "subfolder");
+                    REQUIRE(dirlist[0].kind == ResourceInfo::Kind::DIRECTORY);
+                    REQUIRE(dirlist[1].name == "somefile.txt");
+                    REQUIRE(dirlist[1].kind == ResourceInfo::Kind::FILE);
+                    REQUIRE(dirlist[1].revision == "\"5e18e1bede073\"");
+                    REQUIRE(dirlist[1].modified == std::chrono::system_clock::time_point(std::chrono::seconds(1578688958)));
+                }
+                AND_WHEN("calling get_resource() for the file entry") {
+                    const auto file = std::dynamic_pointer_cast<File>(directory->get_resource(dirlist[1]));
+                    THEN("a file handle should be returned without making another request") {
+                        Verify(Method(requestMock, request)).Once();
+                        REQUIRE(file->path() == "/somefile.txt");
+                        REQUIRE(file->revision() == "\"5e18e1bede073\"");
+                    }
+                }
             }
         }
         AND_GIVEN("a request that returns a valid file description") {
@@ -303,6 +416,42 @@ SCENARIO("WebdavDirectory", "[directory][webdav]") {
             REQUIRE(directory->name() == "folder");
         }
 
+        AND_GIVEN("a request that returns the description of the directory itself (Depth:0)") {
+            When(Method(requestMock, request)).AlwaysReturn(request::StringResponse(
+                200,
+                "<?xml version=\"1.0\"?>"
+                "<d:multistatus xmlns:d=\"DAV:\" >"
+                "  <d:response>"
+                "      <d:href>/some/folder/</d:href>"
+                "      <d:propstat>"
+                "          <d:prop>"
+                "              <d:getlastmodified>Fri, 10 Jan 2020 20:42:38 GMT</d:getlastmodified>"
+                "              <d:getetag>&quot;5e18e1bede073&quot;</d:getetag>"
+                "              <d:resourcetype><d:collection/></d:resourcetype>"
+                "          </d:prop>"
+                "          <d:status>HTTP/1.1 200 OK</d:status>"
+                "      </d:propstat>"
+                "  </d:response>"
+                "</d:multistatus>",
+                "application/xml"));
+
+            WHEN("calling poll_change() twice") {
+                const bool first_change = directory->poll_change();
+                const bool second_change = directory->poll_change();
+                THEN("a PROPFIND request on the directory itself should be made each time") {
+                    Verify(Method(requestMock, request)).Twice();
+                    REQUIRE_REQUEST(0, verb == "PROPFIND");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/some/folder");
+                    REQUIRE_REQUEST(0, headers.at("Depth") == "0");
+                    REQUIRE_REQUEST(0, body == xmlQuery);
+                }
+                THEN("only the first call should report a change and the revision should be set") {
+                    REQUIRE(first_change);
+                    REQUIRE_FALSE(second_change);
+                    REQUIRE(directory->revision() == "\"5e18e1bede073\"");
+                }
+            }
+        }
         AND_GIVEN("a request that returns a valid webdav directory description (Depth:0)") {
             When(Method(requestMock, request)).Return(request::StringResponse(
                 200,
@@ -350,6 +499,57 @@ SCENARIO("WebdavDirectory", "[directory][webdav]") {
                 }
             }
         }
+
+        AND_GIVEN("a MOVE request that returns 201 and a PROPFIND request that describes the destination") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(201))
+                .Return(request::StringResponse(
+                    207,
+                    "<?xml version=\"1.0\"?>"
+                    "<d:multistatus xmlns:d=\"DAV:\" >"
+                    "  <d:response>"
+                    "      <d:href>/some/renamed/</d:href>"
+                    "      <d:propstat>"
+                    "          <d:prop>"
+                    "              <d:getlastmodified>Sat, 11 Jan 2020 10:00:00 GMT</d:getlastmodified>"
+                    "              <d:getetag>&quot;renamedRevision&quot;</d:getetag>"
+                    "              <d:resourcetype><d:collection/></d:resourcetype>"
+                    "          </d:prop>"
+                    "          <d:status>HTTP/1.1 200 OK</d:status>"
+                    "      </d:propstat>"
+                    "  </d:response>"
+                    "</d:multistatus>",
+                    "application/xml"));
+
+            WHEN("renaming the directory") {
+                const auto moved = std::dynamic_pointer_cast<Directory>(directory->move_to("renamed"));
+                THEN("a MOVE request should be made to the new path") {
+                    Verify(Method(requestMock, request)).Exactly(2);
+                    REQUIRE_REQUEST(0, verb == "MOVE");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/some/folder");
+                    REQUIRE_REQUEST(0, headers.at("Destination") == BASE_URL + "/some/renamed");
+                    REQUIRE_REQUEST(0, headers.at("Overwrite") == "F");
+                }
+                THEN("the destination should be described with a Depth:0 PROPFIND request") {
+                    REQUIRE_REQUEST(1, verb == "PROPFIND");
+                    REQUIRE_REQUEST(1, url == BASE_URL + "/some/renamed");
+                    REQUIRE_REQUEST(1, headers.at("Depth") == "0");
+                }
+                THEN("a handle with the metadata of the renamed directory should be returned") {
+                    REQUIRE_FALSE(moved->is_file());
+                    REQUIRE(moved->path() == "/some/renamed");
+                    REQUIRE(moved->revision() == "\"renamedRevision\"");
+                    REQUIRE(moved->modified() == std::chrono::system_clock::from_time_t(1578736800));
+                }
+            }
+        }
+
+        WHEN("copying the directory into itself") {
+            THEN("PermissionDenied should be thrown without making a request") {
+                REQUIRE_THROWS_AS(directory->copy_to("folder/inside"), CloudSync::exceptions::resource::PermissionDenied);
+                REQUIRE(requestRecording.empty());
+            }
+        }
     }
 
     GIVEN("a webdav directory with a nextcloud/owncloud dirOffset") {
@@ -411,4 +611,218 @@ SCENARIO("WebdavDirectory", "[directory][webdav]") {
             }
         }
     }
+    GIVEN("a webdav root directory for bulk operations") {
+        const auto directory = std::make_shared<WebdavDirectory>(BASE_URL, "", "/", credentials, request, "");
+        AND_GIVEN("a request that returns 204") {
+            When(Method(requestMock, request)).Return(request::StringResponse(204));
+            WHEN("calling remove_many(a, /)") {
+                const auto results = directory->remove_many({"a", "/"});
+                THEN("a DELETE request should be made for the resource") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "DELETE");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/a");
+                    REQUIRE(results[0].ok());
+                }
+                THEN("the root should not be removed") {
+                    REQUIRE_THROWS_AS(results[1].rethrow_if_failed(), CloudSync::exceptions::resource::PermissionDenied);
+                }
+            }
+        }
+        AND_GIVEN("a request series that creates two folders") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(201))
+                .Return(request::StringResponse(201));
+            WHEN("calling create_directories(x/y)") {
+                const auto results = directory->create_directories({"x/y"});
+                THEN("the missing parent should be created before the requested folder, without looking it up") {
+                    Verify(Method(requestMock, request)).Exactly(2);
+                    REQUIRE_REQUEST(0, verb == "MKCOL");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/x");
+                    REQUIRE_REQUEST(1, verb == "MKCOL");
+                    REQUIRE_REQUEST(1, url == BASE_URL + "/x/y");
+                }
+                THEN("the created folder should be returned") {
+                    REQUIRE(results[0].ok());
+                    REQUIRE(results[0].value->path() == "/x/y");
+                }
+            }
+        }
+        AND_GIVEN("a request that returns 201 with an etag header") {
+            When(Method(requestMock, request)).Return(request::StringResponse(201, "", "", {{"etag", "\"e1\""}}));
+            WHEN("calling upload_many(a.txt)") {
+                const auto results = directory->upload_many({{"a.txt", {'a', 'b', 'c'}}});
+                THEN("the content should be PUT without checking the revision") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "PUT");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/a.txt");
+                    REQUIRE_REQUEST(0, headers.count("If-Match") == 0);
+                    REQUIRE_REQUEST(0, binary_body == std::vector<std::uint8_t>{'a', 'b', 'c'});
+                }
+                THEN("a handle with the new etag should be returned") {
+                    REQUIRE(results[0].ok());
+                    REQUIRE(results[0].value->path() == "/a.txt");
+                    REQUIRE(results[0].value->revision() == "\"e1\"");
+                }
+            }
+        }
+    }
+    GIVEN("a nextcloud root directory for bulk operations") {
+        const auto directory =
+            std::make_shared<WebdavDirectory>(BASE_URL, "/remote.php/webdav", "/", credentials, request, "");
+        AND_GIVEN("a bulk upload response with a written and a failed file") {
+            When(Method(requestMock, request)).Return(request::StringResponse(
+                200,
+                "{\"/a.txt\":{\"error\":false,\"etag\":\"e1\"},\"/b.txt\":{\"error\":true,\"message\":\"quota exceeded\"}}",
+                "application/json"));
+            WHEN("calling upload_many(a.txt, b.txt)") {
+                const auto results = directory->upload_many({
+                    {"a.txt", {'a', 'b', 'c'}, std::chrono::system_clock::from_time_t(1580331650)}, {"b.txt", {}}});
+                THEN("both files should be sent with a single request to the bulk endpoint") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "POST");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/remote.php/dav/bulk");
+                    REQUIRE_REQUEST(0, headers.at("Content-Type") == "multipart/related; boundary=cloudsync_bulk");
+                    const std::string body(requestRecording[0].binary_body.begin(), requestRecording[0].binary_body.end());
+                    REQUIRE(body.find("X-File-Path: /a.txt\r\nX-File-MD5: 900150983cd24fb0d6963f7d28e17f72\r\n") != std::string::npos);
+                    REQUIRE(body.find("X-File-Path: /b.txt\r\nX-File-MD5: d41d8cd98f00b204e9800998ecf8427e\r\n") != std::string::npos);
+                }
+                THEN("only the file with a modification time should be sent with it") {
+                    const std::string body(requestRecording[0].binary_body.begin(), requestRecording[0].binary_body.end());
+                    REQUIRE(body.find("900150983cd24fb0d6963f7d28e17f72\r\nX-File-Mtime: 1580331650\r\n") != std::string::npos);
+                    REQUIRE(body.find("d41d8cd98f00b204e9800998ecf8427e\r\nContent-Length: 0\r\n") != std::string::npos);
+                }
+                THEN("every file should get its own result") {
+                    REQUIRE(results[0].ok());
+                    REQUIRE(results[0].value->revision() == "\"e1\"");
+                    REQUIRE(results[0].value->size() == 3);
+                    REQUIRE_THROWS_AS(results[1].rethrow_if_failed(), CloudSync::exceptions::cloud::CommunicationError);
+                }
+            }
+        }
+        AND_GIVEN("a server without the bulk endpoint") {
+            When(Method(requestMock, request))
+                .Throw(request::exceptions::response::NotFound())
+                .Return(request::StringResponse(201, "", "", {{"etag", "\"e1\""}}));
+            WHEN("calling upload_many(a.txt)") {
+                const auto results = directory->upload_many({{"a.txt", {'a', 'b', 'c'}}});
+                THEN("the file should be PUT instead") {
+                    Verify(Method(requestMock, request)).Twice();
+                    REQUIRE_REQUEST(1, verb == "PUT");
+                    REQUIRE_REQUEST(1, url == BASE_URL + "/remote.php/webdav/a.txt");
+                    REQUIRE(results[0].ok());
+                }
+            }
+        }
+    }
+    GIVEN("webdav listings for searching") {
+        const auto entry = [](const std::string &href, bool folder) {
+            return "<d:response>"
+                   "<d:href>" + href + "</d:href>"
+                   "<d:propstat><d:prop>"
+                   "<d:getlastmodified>Fri, 10 Jan 2020 20:42:38 GMT</d:getlastmodified>"
+                   "<d:getetag>&quot;e&quot;</d:getetag>"
+                   + (folder ? "<d:resourcetype><d:collection/></d:resourcetype>"
+                             : "<d:resourcetype/><d:getcontentlength>3</d:getcontentlength>") +
+                   "</d:prop><d:status>HTTP/1.1 200 OK</d:status></d:propstat>"
+                   "</d:response>";
+        };
+        const auto multistatus = [](const std::string &entries) {
+            return request::StringResponse(
+                207, "<?xml version=\"1.0\"?><d:multistatus xmlns:d=\"DAV:\">" + entries + "</d:multistatus>",
+                "application/xml");
+        };
+        std::vector<SearchResult> results;
+        const auto collect = [&results](const std::vector<SearchResult> &page) {
+            results.insert(results.end(), page.begin(), page.end());
+            return true;
+        };
+        AND_GIVEN("a plain webdav root directory and a listing per folder") {
+            const auto directory = std::make_shared<WebdavDirectory>(BASE_URL, "", "/", credentials, request, "");
+            When(Method(requestMock, request))
+                .Return(multistatus(entry("/", true) + entry("/report.txt", false) + entry("/docs/", true)))
+                .Return(multistatus(entry("/docs/", true) + entry("/docs/old-report.txt", false) + entry("/docs/a.txt", false)));
+            WHEN("searching for report") {
+                directory->search(SearchQuery{"report"}, collect);
+                THEN("every folder should be listed once") {
+                    Verify(Method(requestMock, request)).Twice();
+                    REQUIRE_REQUEST(0, verb == "PROPFIND");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/");
+                    REQUIRE_REQUEST(0, headers.at("Depth") == "1");
+                    REQUIRE_REQUEST(1, url == BASE_URL + "/docs");
+                }
+                THEN("the matching files of all folders should be returned") {
+                    REQUIRE(results.size() == 2);
+                    REQUIRE(results[0].path == "/report.txt");
+                    REQUIRE(results[0].info.size == 3);
+                    REQUIRE(results[1].path == "/docs/old-report.txt");
+                }
+            }
+        }
+        AND_GIVEN("a nextcloud directory and a SEARCH response") {
+            const auto directory = std::make_shared<WebdavDirectory>(
+                BASE_URL, "/remote.php/webdav", "/some/folder", credentials, request, "folder");
+            When(Method(requestMock, request)).Return(multistatus(
+                entry("/remote.php/dav/files/john/some/folder/a/report.txt", false)
+                + entry("/remote.php/dav/files/john/some/folder/reports/", true)));
+            WHEN("searching for files named report") {
+                SearchQuery query;
+                query.name = "report";
+                query.kind = ResourceInfo::Kind::FILE;
+                directory->search(query, collect);
+                THEN("a single SEARCH request should be sent to the dav endpoint") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "SEARCH");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/remote.php/dav/");
+                    REQUIRE_REQUEST(0, body.find("<d:href>/files/john/some/folder</d:href><d:depth>infinity</d:depth>") != std::string::npos);
+                    REQUIRE_REQUEST(0, body.find("<d:where><d:and>"
+                                                 "<d:like><d:prop><d:displayname/></d:prop><d:literal>%report%</d:literal></d:like>"
+                                                 "<d:not><d:is-collection/></d:not>"
+                                                 "</d:and></d:where>") != std::string::npos);
+                    REQUIRE_REQUEST(0, body.find("<d:nresults>500</d:nresults><ns:firstresult>0</ns:firstresult>") != std::string::npos);
+                }
+                THEN("the matching files should be returned with their path") {
+                    REQUIRE(results.size() == 1);
+                    REQUIRE(results[0].path == "/some/folder/a/report.txt");
+                }
+            }
+        }
+        AND_GIVEN("a nextcloud user named by mail address and a SEARCH response") {
+            When(Method(credentialsMock, username)).AlwaysReturn("john@example.com");
+            const auto directory = std::make_shared<WebdavDirectory>(
+                BASE_URL, "/remote.php/webdav", "/some/folder", credentials, request, "folder");
+            When(Method(requestMock, request)).Return(multistatus(
+                entry("/remote.php/dav/files/john%40example.com/some/folder/50%_off.txt", false)));
+            WHEN("searching for a name with wildcards") {
+                directory->search(SearchQuery{"50%_off"}, collect);
+                THEN("the wildcards should be matched literally") {
+                    REQUIRE_REQUEST(0, body.find("<d:literal>%50\\%\\_off%</d:literal>") != std::string::npos);
+                }
+                THEN("the user should be encoded in the scope") {
+                    REQUIRE_REQUEST(0, body.find("<d:href>/files/john%40example.com/some/folder</d:href>") != std::string::npos);
+                }
+                THEN("the results should be returned with their path") {
+                    REQUIRE(results.size() == 1);
+                    REQUIRE(results[0].path == "/some/folder/50%_off.txt");
+                }
+            }
+        }
+        AND_GIVEN("a nextcloud directory and a server that doesn't support SEARCH") {
+            const auto directory = std::make_shared<WebdavDirectory>(
+                BASE_URL, "/remote.php/webdav", "/some/folder", credentials, request, "folder");
+            When(Method(requestMock, request))
+                .Throw(request::exceptions::response::ServerError(501))
+                .Return(multistatus(entry("/remote.php/webdav/some/folder/", true)
+                                    + entry("/remote.php/webdav/some/folder/report.txt", false)));
+            WHEN("searching for report") {
+                directory->search(SearchQuery{"report"}, collect);
+                THEN("the folders should be listed instead") {
+                    Verify(Method(requestMock, request)).Twice();
+                    REQUIRE_REQUEST(1, verb == "PROPFIND");
+                    REQUIRE_REQUEST(1, url == BASE_URL + "/remote.php/webdav/some/folder");
+                    REQUIRE(results.size() == 1);
+                    REQUIRE(results[0].path == "/some/folder/report.txt");
+                }
+            }
+        }
+    }
 }
@@ -1,8 +1,10 @@
 #include "webdav/WebdavFile.hpp"
 #include "CloudSync/Cloud.hpp"
 #include "CloudSync/exceptions/cloud/CloudException.hpp"
+#include "CloudSync/exceptions/resource/ResourceException.hpp"
 #include "request/Request.hpp"
 #include "macros/request_mock.hpp"
+#include "macros/temp_file.hpp"
 #include "macros/basic_auth_mock.hpp"
 #include <catch2/catch.hpp>
 #include <fakeit.hpp>
@@ -62,6 +64,59 @@ SCENARIO("WebdavFile", "[file][webdav]") {
                 }
             }
         }
+        AND_GIVEN("a PATCH request that returns 204 and a new eTag") {
+            When(Method(requestMock, request)).AlwaysReturn(
+                request::StringResponse(204, "", "text/plain", {{"etag", "\"newRevision\""}}));
+            const std::vector<std::uint8_t> data = {'a', 'b', 'c'};
+
+            WHEN("appending to the file") {
+                file->append(data);
+                THEN("a sabre/dav partial update that appends the data should be made") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "PATCH");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/test.txt");
+                    REQUIRE_REQUEST(0, headers.at("X-Update-Range") == "append");
+                    REQUIRE_REQUEST(0, headers.at("Content-Type") == "application/x-sabredav-partialupdate");
+                    REQUIRE_REQUEST(0, headers.at("If-Match") == "\"7f3805660b049baadd3bef287d7d346b\"");
+                    REQUIRE_REQUEST(0, binary_body == data);
+                }
+                THEN("the file should have a new revision") {
+                    REQUIRE(file->revision() == "\"newRevision\"");
+                }
+            }
+            WHEN("writing to an offset of the file") {
+                file->write_range(10, data);
+                THEN("a sabre/dav partial update of the range should be made") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "PATCH");
+                    REQUIRE_REQUEST(0, headers.at("X-Update-Range") == "bytes=10-12");
+                    REQUIRE_REQUEST(0, binary_body == data);
+                }
+                THEN("the file should have grown to the end of the range") {
+                    REQUIRE(file->size() == 13);
+                }
+            }
+        }
+        AND_GIVEN("a server that doesn't support PATCH") {
+            When(Method(requestMock, request)).Throw(request::exceptions::response::ServerError(501));
+
+            WHEN("appending to the file") {
+                THEN("an OperationNotSupported exception should be thrown") {
+                    REQUIRE_THROWS_AS(
+                        file->append({'a'}), CloudSync::exceptions::cloud::OperationNotSupported);
+                }
+            }
+        }
+        AND_GIVEN("a PATCH request that returns 412") {
+            When(Method(requestMock, request)).Throw(request::exceptions::response::PreconditionFailed());
+
+            WHEN("appending to the file") {
+                THEN("a ResourceHasChanged exception should be thrown") {
+                    REQUIRE_THROWS_AS(
+                        file->append({'a'}), CloudSync::exceptions::resource::ResourceHasChanged);
+                }
+            }
+        }
         AND_GIVEN("a request that returns 200 and some text in the body") {
             When(Method(requestMock, request)).Return(request::StringResponse(200, "testtext", "text/plain"));
 
@@ -116,9 +171,13 @@ SCENARIO("WebdavFile", "[file][webdav]") {
                     REQUIRE_REQUEST(
                         0,
                         body == "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
-                                "<d:propfind xmlns:d=\"DAV:\">"
+                                "<d:propfind xmlns:d=\"DAV:\" xmlns:oc=\"http://owncloud.org/ns\">"
                                     "<d:prop>"
                                         "<d:getetag/>"
+                                        "<d:getlastmodified/>"
+                                        "<d:getcontentlength/>"
+                                        "<d:getcontenttype/>"
+                                        "<oc:checksums/>"
                                     "</d:prop>"
                                 "</d:propfind>");
                     REQUIRE_REQUEST(0, headers.at("Depth") == "0");
@@ -140,6 +199,38 @@ SCENARIO("WebdavFile", "[file][webdav]") {
                 THEN("the file should have a new revision") {
                     REQUIRE(file->revision() == "\"1ab803660mm49baads3bef287d7d3466\"");
                 }
+                THEN("the file should have no content hash") {
+                    REQUIRE_FALSE(file->content_hash().has_value());
+                }
+            }
+        }
+        AND_GIVEN("a request that returns 200 and the checksums a nextcloud client has stored") {
+            When(Method(requestMock, request)).Return(request::StringResponse(
+                200,
+                "<?xml version=\"1.0\"?>"
+                "<d:multistatus xmlns:d=\"DAV:\" xmlns:oc=\"http://owncloud.org/ns\">"
+                    "<d:response>"
+                        "<d:href>/file.txt</d:href>"
+                        "<d:propstat>"
+                            "<d:prop>"
+                                "<d:getetag>&quot;newRevision&quot;</d:getetag>"
+                                "<oc:checksums>"
+                                    "<oc:checksum>SHA1:A94A8FE5CCB19BA61C4C0873D391E987982FBBD3 "
+                                    "MD5:098f6bcd4621d373cade4e832627b4f6 ADLER32:045d01c1</oc:checksum>"
+                                "</oc:checksums>"
+                            "</d:prop>"
+                            "<d:status>HTTP/1.1 200 OK</d:status>"
+                        "</d:propstat>"
+                    "</d:response>"
+                "</d:multistatus>",
+                "application/xml"));
+
+            WHEN("calling poll_change()") {
+                file->poll_change();
+                THEN("the file should have the SHA1 as content hash, in lowercase") {
+                    REQUIRE(file->content_hash() == ContentHash{
+                        ContentHash::Algorithm::SHA1, "a94a8fe5ccb19ba61c4c0873d391e987982fbbd3"});
+                }
             }
         }
         AND_GIVEN("a request that returns an invalid xml (not paresable)") {
@@ -160,5 +251,121 @@ SCENARIO("WebdavFile", "[file][webdav]") {
                 }
             }
         }
+    }    GIVEN("a nextcloud file instance and a local file that is too large for a single request") {
+        const auto file = std::make_shared<WebdavFile>(
+            BASE_URL + "/remote.php/webdav",
+            "/folder/test.bin",
+            credentials,
+            request,
+            "test.bin",
+            "\"oldRevision\"");
+        const auto local_file = temp_file("cloudsync_nextcloud_upload.bin", 5 * 1024 * 1024);
+        AND_GIVEN("a request series that creates an upload collection, stores a chunk and assembles the file") {
+            When(Method(requestMock, request))
+                .Return(request::StringResponse(201))
+                .Return(request::StringResponse(201))
+                .Return(request::StringResponse(201, "", "text/plain", {{"etag", "\"newRevision\""}}));
+            WHEN("uploading the local file") {
+                file->upload(local_file);
+                THEN("the chunks should be uploaded with chunking v2") {
+                    Verify(Method(requestMock, request)).Exactly(3);
+                    REQUIRE_REQUEST(0, verb == "MKCOL");
+                    REQUIRE_REQUEST(0, url.rfind(BASE_URL + "/remote.php/dav/uploads/john/", 0) == 0);
+                    REQUIRE_REQUEST(0, headers.at("Destination") == BASE_URL + "/remote.php/dav/files/john/folder/test.bin");
+                    REQUIRE_REQUEST(1, verb == "PUT");
+                    REQUIRE_REQUEST(1, url == requestRecording[0].url + "/1");
+                    REQUIRE_REQUEST(1, headers.at("OC-Total-Length") == "5242880");
+                    REQUIRE_REQUEST(2, verb == "MOVE");
+                    REQUIRE_REQUEST(2, url == requestRecording[0].url + "/.file");
+                    REQUIRE_REQUEST(2, headers.at("If") == "<" + BASE_URL + "/remote.php/dav/files/john/folder/test.bin> ([\"oldRevision\"])");
+                }
+                THEN("the file should have the revision of the assembled file") {
+                    REQUIRE(file->revision() == "\"newRevision\"");
+                }
+            }
+        }
+    }
+    GIVEN("a plain webdav file instance and a local file that is too large for a single request") {
+        const auto file = std::make_shared<WebdavFile>(
+            BASE_URL,
+            "/folder/test.bin",
+            credentials,
+            request,
+            "test.bin",
+            "\"oldRevision\"");
+        const auto local_file = temp_file("cloudsync_webdav_upload.bin", 5 * 1024 * 1024);
+        AND_GIVEN("a PUT request that returns the new eTag") {
+            When(Method(requestMock, request)).Return(request::StringResponse(201, "", "text/plain", {{"etag", "\"newRevision\""}}));
+            WHEN("uploading the local file") {
+                file->upload(local_file);
+                THEN("the file should be streamed with a single PUT request instead of being read into memory") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "PUT");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/folder/test.bin");
+                    REQUIRE_REQUEST(0, file_body == local_file);
+                    REQUIRE_REQUEST(0, binary_body.empty());
+                }
+                THEN("the file should have the new revision") {
+                    REQUIRE(file->revision() == "\"newRevision\"");
+                }
+            }
+        }
+    }
+    GIVEN("the checksums property of a file") {
+        THEN("the strongest known checksum should be picked") {
+            REQUIRE(WebdavFile::parse_checksums("MD5:abc SHA256:DEF ADLER32:1") == ContentHash{
+                ContentHash::Algorithm::SHA256, "def"});
+            REQUIRE(WebdavFile::parse_checksums("ADLER32:1 MD5:abc") == ContentHash{
+                ContentHash::Algorithm::MD5, "abc"});
+        }
+        THEN("there should be no hash if none of the checksums is known") {
+            REQUIRE_FALSE(WebdavFile::parse_checksums("ADLER32:045d01c1").has_value());
+            REQUIRE_FALSE(WebdavFile::parse_checksums("").has_value());
+        }
+    }
+    GIVEN("a webdav file instance in a folder") {
+        const auto file = std::make_shared<WebdavFile>(
+            BASE_URL,
+            "/folder/test.txt",
+            credentials,
+            request,
+            "test.txt",
+            "\"revision\"");
+        AND_GIVEN("a COPY request that returns 201 and the eTag of the copy") {
+            When(Method(requestMock, request)).Return(request::StringResponse(201, "", "text/plain", {{"etag", "\"copyRevision\""}}));
+
+            WHEN("copying the file to a path relative to its folder") {
+                const auto copy = std::dynamic_pointer_cast<File>(file->copy_to("copy.txt"));
+                THEN("a COPY request should be made that doesn't overwrite the destination") {
+                    Verify(Method(requestMock, request)).Once();
+                    REQUIRE_REQUEST(0, verb == "COPY");
+                    REQUIRE_REQUEST(0, url == BASE_URL + "/folder/test.txt");
+                    REQUIRE_REQUEST(0, headers.at("Destination") == BASE_URL + "/folder/copy.txt");
+                    REQUIRE_REQUEST(0, headers.at("Overwrite") == "F");
+                }
+                THEN("a handle for the copy should be returned") {
+                    REQUIRE(copy->path() == "/folder/copy.txt");
+                    REQUIRE(copy->name() == "copy.txt");
+                    REQUIRE(copy->revision() == "\"copyRevision\"");
+                }
+            }
+        }
+        AND_GIVEN("a MOVE request that fails because the destination exists") {
+            When(Method(requestMock, request)).Throw(request::exceptions::response::PreconditionFailed());
+
+            WHEN("moving the file to an absolute path") {
+                THEN("a ResourceConflict should be thrown") {
+                    REQUIRE_THROWS_AS(file->move_to("/other/test.txt"), CloudSync::exceptions::resource::ResourceConflict);
+                    REQUIRE_REQUEST(0, verb == "MOVE");
+                    REQUIRE_REQUEST(0, headers.at("Destination") == BASE_URL + "/other/test.txt");
+                }
+            }
+        }
+        WHEN("moving the file to the root") {
+            THEN("PermissionDenied should be thrown without making a request") {
+                REQUIRE_THROWS_AS(file->move_to("/"), CloudSync::exceptions::resource::PermissionDenied);
+                REQUIRE(requestRecording.empty());
+            }
+        }
     }
 }
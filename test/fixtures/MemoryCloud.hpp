@@ -0,0 +1,481 @@
+#pragma once
+
+#include "CloudSync/Directory.hpp"
+#include "CloudSync/File.hpp"
+#include "CloudSync/exceptions/resource/ResourceException.hpp"
+#include "hash/Hasher.hpp"
+#include "hash/Sha256.hpp"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * A cloud that is kept in memory, for the tests & benchmarks of the sync. It counts the requests a real provider
+ * would need. Like on nextcloud, the revision of a directory changes with everything below it. Bulk operations cost a
+ * single request, like a batch endpoint.
+ */
+namespace CloudSync::fixtures {
+    class MemoryStore {
+    public:
+        struct Node {
+            ResourceInfo::Kind kind = ResourceInfo::Kind::FILE;
+            std::vector<std::uint8_t> content;
+            std::string revision;
+        };
+
+        MemoryStore() {
+            m_nodes["/"] = {ResourceInfo::Kind::DIRECTORY, {}, next_revision()};
+        }
+
+        /// files report a SHA-256 content hash if set, like on most providers. Webdav doesn't report one.
+        bool reports_hashes = false;
+
+        /**
+         * called with the absolute path of a file before it is read or written, to change the cloud in the middle of
+         * a sync or to let a transfer fail by throwing. Not called for bulk operations.
+         */
+        std::function<void(const std::string &path)> before_transfer;
+
+        std::atomic<std::size_t> requests{0};
+        std::atomic<std::uint64_t> bytes_uploaded{0};
+        std::atomic<std::uint64_t> bytes_downloaded{0};
+
+        void reset_counters() {
+            requests = 0;
+            bytes_uploaded = 0;
+            bytes_downloaded = 0;
+        }
+
+        /// @return a copy of the node at the absolute `path`, if there is one
+        bool find(const std::string &path, Node &node) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_nodes.find(path);
+            if (it == m_nodes.end()) {
+                return false;
+            }
+            node = it->second;
+            return true;
+        }
+
+        /// @return what a provider would report about `node`
+        [[nodiscard]] ResourceInfo info(const std::string &name, const Node &node) const {
+            ResourceInfo info;
+            info.name = name;
+            info.revision = node.revision;
+            info.size = node.content.size();
+            info.kind = node.kind;
+            if (reports_hashes && node.kind == ResourceInfo::Kind::FILE) {
+                info.content_hash = ContentHash{
+                        ContentHash::Algorithm::SHA256,
+                        hash::to_hex(hash::Sha256::digest_of(node.content.data(), node.content.size()))};
+            }
+            return info;
+        }
+
+        void transfer(const std::string &path) const {
+            if (before_transfer) {
+                before_transfer(path);
+            }
+        }
+
+        /// @return the entries of the directory at `path` by name
+        std::map<std::string, Node> children(const std::string &path) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::map<std::string, Node> children;
+            const auto prefix = path == "/" ? path : path + "/";
+            for (auto it = m_nodes.lower_bound(prefix); it != m_nodes.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+                const auto name = it->first.substr(prefix.size());
+                if (!name.empty() && name.find('/') == std::string::npos) {
+                    children.emplace(name, it->second);
+                }
+            }
+            return children;
+        }
+
+        /**
+         * Writes a file and creates missing parents.
+         * @param expected_revision the write fails with ResourceHasChanged unless the file has this revision. Empty
+         *        to only write new files, `*` to write in any case.
+         * @return the new revision
+         */
+        std::string write(const std::string &path, const std::vector<std::uint8_t> &content, const std::string &expected_revision) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto existing = m_nodes.find(path);
+            if (expected_revision.empty() && existing != m_nodes.end()) {
+                throw exceptions::resource::ResourceConflict(path);
+            }
+            if (expected_revision != "*" && !expected_revision.empty()
+                && (existing == m_nodes.end() || existing->second.revision != expected_revision)) {
+                throw exceptions::resource::ResourceHasChanged(path);
+            }
+            make_parents(path);
+            auto &node = m_nodes[path];
+            node = {ResourceInfo::Kind::FILE, content, next_revision()};
+            touch_parents(path);
+            return node.revision;
+        }
+
+        std::string make_directory(const std::string &path) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_nodes.count(path) != 0) {
+                throw exceptions::resource::ResourceConflict(path);
+            }
+            make_parents(path);
+            auto &node = m_nodes[path];
+            node = {ResourceInfo::Kind::DIRECTORY, {}, next_revision()};
+            touch_parents(path);
+            return node.revision;
+        }
+
+        void remove(const std::string &path) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_nodes.erase(path) == 0) {
+                throw exceptions::resource::NoSuchResource(path);
+            }
+            const auto prefix = path + "/";
+            for (auto it = m_nodes.lower_bound(prefix); it != m_nodes.end() && it->first.compare(0, prefix.size(), prefix) == 0;) {
+                it = m_nodes.erase(it);
+            }
+            touch_parents(path);
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        std::map<std::string, Node> m_nodes;
+        std::size_t m_revision_counter = 0;
+
+        std::string next_revision() {
+            return "\"" + std::to_string(++m_revision_counter) + "\"";
+        }
+
+        void make_parents(const std::string &path) {
+            for (auto parent = std::filesystem::path(path).parent_path(); parent != "/"; parent = parent.parent_path()) {
+                m_nodes.emplace(parent.generic_string(), Node{ResourceInfo::Kind::DIRECTORY, {}, next_revision()});
+            }
+        }
+
+        void touch_parents(const std::string &path) {
+            for (auto parent = std::filesystem::path(path).parent_path();; parent = parent.parent_path()) {
+                m_nodes[parent.generic_string()].revision = next_revision();
+                if (parent == "/") {
+                    return;
+                }
+            }
+        }
+    };
+
+    inline std::string join(const std::filesystem::path &directory, const std::filesystem::path &path) {
+        return (directory / path.relative_path()).lexically_normal().generic_string();
+    }
+
+    class MemoryFile : public File {
+    public:
+        MemoryFile(std::shared_ptr<MemoryStore> store, std::string path, std::string revision)
+                : m_store(std::move(store))
+                , m_path(std::move(path))
+                , m_revision(std::move(revision)) {}
+
+        [[nodiscard]] std::string name() const override {
+            return std::filesystem::path(m_path).filename().generic_string();
+        }
+
+        [[nodiscard]] std::filesystem::path path() const override {
+            return m_path;
+        }
+
+        [[nodiscard]] std::chrono::system_clock::time_point modified() const override {
+            return {};
+        }
+
+        void remove() override {
+            m_store->requests++;
+            m_store->remove(m_path);
+        }
+
+        std::shared_ptr<Resource> copy_to(const std::filesystem::path &) const override {
+            throw std::logic_error("not supported by the memory cloud");
+        }
+
+        std::shared_ptr<Resource> move_to(const std::filesystem::path &) override {
+            throw std::logic_error("not supported by the memory cloud");
+        }
+
+        [[nodiscard]] bool is_file() const override {
+            return true;
+        }
+
+        [[nodiscard]] std::string revision() const override {
+            return m_revision;
+        }
+
+        [[nodiscard]] std::uint64_t size() const override {
+            MemoryStore::Node node;
+            return m_store->find(m_path, node) ? node.content.size() : 0;
+        }
+
+        [[nodiscard]] std::string content_type() const override {
+            return "";
+        }
+
+        [[nodiscard]] std::optional<ContentHash> content_hash() const override {
+            MemoryStore::Node node;
+            if (!m_store->find(m_path, node)) {
+                return std::nullopt;
+            }
+            return m_store->info(name(), node).content_hash;
+        }
+
+        [[nodiscard]] std::string read() const override {
+            const auto content = read_binary();
+            return {content.begin(), content.end()};
+        }
+
+        [[nodiscard]] std::vector<std::uint8_t> read_binary() const override {
+            m_store->transfer(m_path);
+            m_store->requests++;
+            MemoryStore::Node node;
+            if (!m_store->find(m_path, node)) {
+                throw exceptions::resource::NoSuchResource(m_path);
+            }
+            m_store->bytes_downloaded += node.content.size();
+            return node.content;
+        }
+
+        void write(const std::string &content) override {
+            write_binary({content.begin(), content.end()});
+        }
+
+        void write_binary(const std::vector<std::uint8_t> &content) override {
+            m_store->transfer(m_path);
+            m_store->requests++;
+            m_store->bytes_uploaded += content.size();
+            m_revision = m_store->write(m_path, content, m_revision);
+        }
+
+        void write_range(std::uint64_t, const std::vector<std::uint8_t> &) override {
+            throw std::logic_error("not supported by the memory cloud");
+        }
+
+        void append(const std::vector<std::uint8_t> &) override {
+            throw std::logic_error("not supported by the memory cloud");
+        }
+
+        void upload(const std::filesystem::path &local_file) override {
+            std::ifstream input(local_file, std::ios::binary);
+            write_binary({std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()});
+        }
+
+        bool poll_change() override {
+            m_store->requests++;
+            MemoryStore::Node node;
+            if (!m_store->find(m_path, node)) {
+                throw exceptions::resource::NoSuchResource(m_path);
+            }
+            const bool has_changed = node.revision != m_revision;
+            m_revision = node.revision;
+            return has_changed;
+        }
+
+    private:
+        const std::shared_ptr<MemoryStore> m_store;
+        const std::string m_path;
+        std::string m_revision;
+    };
+
+    class MemoryDirectory : public Directory {
+    public:
+        MemoryDirectory(std::shared_ptr<MemoryStore> store, std::string path, std::string revision = "")
+                : m_store(std::move(store))
+                , m_path(std::move(path))
+                , m_revision(std::move(revision)) {}
+
+        [[nodiscard]] std::string name() const override {
+            return std::filesystem::path(m_path).filename().generic_string();
+        }
+
+        [[nodiscard]] std::filesystem::path path() const override {
+            return m_path;
+        }
+
+        [[nodiscard]] std::chrono::system_clock::time_point modified() const override {
+            return {};
+        }
+
+        void remove() override {
+            m_store->requests++;
+            m_store->remove(m_path);
+        }
+
+        std::shared_ptr<Resource> copy_to(const std::filesystem::path &) const override {
+            throw std::logic_error("not supported by the memory cloud");
+        }
+
+        std::shared_ptr<Resource> move_to(const std::filesystem::path &) override {
+            throw std::logic_error("not supported by the memory cloud");
+        }
+
+        [[nodiscard]] bool is_file() const override {
+            return false;
+        }
+
+        [[nodiscard]] std::vector<std::shared_ptr<Resource>> list_resources() const override {
+            std::vector<std::shared_ptr<Resource>> resources;
+            for (const auto &info: list_resource_info()) {
+                resources.push_back(get_resource(info));
+            }
+            return resources;
+        }
+
+        [[nodiscard]] std::vector<ResourceInfo> list_resource_info() const override {
+            m_store->requests++;
+            std::vector<ResourceInfo> infos;
+            for (const auto &[name, node]: m_store->children(m_path)) {
+                infos.push_back(m_store->info(name, node));
+            }
+            return infos;
+        }
+
+        [[nodiscard]] std::shared_ptr<Resource> get_resource(const ResourceInfo &info) const override {
+            const auto path = join(m_path, info.name);
+            if (info.is_file()) {
+                return std::make_shared<MemoryFile>(m_store, path, info.revision);
+            }
+            return std::make_shared<MemoryDirectory>(m_store, path, info.revision);
+        }
+
+        [[nodiscard]] std::string revision() const override {
+            return m_revision;
+        }
+
+        bool poll_change() override {
+            m_store->requests++;
+            MemoryStore::Node node;
+            if (!m_store->find(m_path, node)) {
+                throw exceptions::resource::NoSuchResource(m_path);
+            }
+            const bool has_changed = node.revision != m_revision;
+            m_revision = node.revision;
+            return has_changed;
+        }
+
+        std::shared_ptr<Directory> get_directory(const std::filesystem::path &path) const override {
+            m_store->requests++;
+            const auto resource_path = join(m_path, path);
+            MemoryStore::Node node;
+            if (!m_store->find(resource_path, node) || node.kind != ResourceInfo::Kind::DIRECTORY) {
+                throw exceptions::resource::NoSuchResource(resource_path);
+            }
+            return std::make_shared<MemoryDirectory>(m_store, resource_path, node.revision);
+        }
+
+        std::shared_ptr<Directory> create_directory(const std::filesystem::path &path) const override {
+            m_store->requests++;
+            const auto resource_path = join(m_path, path);
+            return std::make_shared<MemoryDirectory>(m_store, resource_path, m_store->make_directory(resource_path));
+        }
+
+        std::shared_ptr<Directory> ensure_directory(const std::filesystem::path &path) const override {
+            try {
+                return get_directory(path);
+            } catch (const exceptions::resource::NoSuchResource &) {
+                return create_directory(path);
+            }
+        }
+
+        std::shared_ptr<File> create_file(const std::filesystem::path &path) const override {
+            return create_file(path, {});
+        }
+
+        std::shared_ptr<File> create_file(
+                const std::filesystem::path &path, const std::vector<std::uint8_t> &content) const override {
+            const auto resource_path = join(m_path, path);
+            m_store->transfer(resource_path);
+            m_store->requests++;
+            m_store->bytes_uploaded += content.size();
+            return std::make_shared<MemoryFile>(m_store, resource_path, m_store->write(resource_path, content, ""));
+        }
+
+        std::shared_ptr<File> get_file(const std::filesystem::path &path) const override {
+            m_store->requests++;
+            const auto resource_path = join(m_path, path);
+            MemoryStore::Node node;
+            if (!m_store->find(resource_path, node) || node.kind != ResourceInfo::Kind::FILE) {
+                throw exceptions::resource::NoSuchResource(resource_path);
+            }
+            return std::make_shared<MemoryFile>(m_store, resource_path, node.revision);
+        }
+
+        std::vector<BulkResult> remove_many(const std::vector<std::filesystem::path> &paths) const override {
+            m_store->requests++;
+            std::vector<BulkResult> results(paths.size());
+            for (std::size_t i = 0; i < paths.size(); i++) {
+                results[i].path = paths[i];
+                try {
+                    m_store->remove(join(m_path, paths[i]));
+                } catch (...) {
+                    results[i].error = std::current_exception();
+                }
+            }
+            return results;
+        }
+
+        std::vector<BulkValue<std::shared_ptr<Directory>>> create_directories(
+                const std::vector<std::filesystem::path> &paths) const override {
+            m_store->requests++;
+            std::vector<BulkValue<std::shared_ptr<Directory>>> results(paths.size());
+            for (std::size_t i = 0; i < paths.size(); i++) {
+                results[i].path = paths[i];
+                try {
+                    const auto resource_path = join(m_path, paths[i]);
+                    results[i].value = std::make_shared<MemoryDirectory>(
+                            m_store, resource_path, m_store->make_directory(resource_path));
+                } catch (...) {
+                    results[i].error = std::current_exception();
+                }
+            }
+            return results;
+        }
+
+        [[nodiscard]] std::vector<BulkValue<ResourceInfo>> stat_many(
+                const std::vector<std::filesystem::path> &paths) const override {
+            m_store->requests++;
+            std::vector<BulkValue<ResourceInfo>> results(paths.size());
+            for (std::size_t i = 0; i < paths.size(); i++) {
+                results[i].path = paths[i];
+                const auto resource_path = join(m_path, paths[i]);
+                MemoryStore::Node node;
+                if (m_store->find(resource_path, node)) {
+                    results[i].value = m_store->info(paths[i].filename().generic_string(), node);
+                } else {
+                    results[i].error = std::make_exception_ptr(exceptions::resource::NoSuchResource(resource_path));
+                }
+            }
+            return results;
+        }
+
+        std::vector<BulkValue<std::shared_ptr<File>>> upload_many(const std::vector<FileUpload> &) const override {
+            throw std::logic_error("not supported by the memory cloud");
+        }
+
+        void search(const SearchQuery &, const SearchPageHandler &) const override {
+            throw std::logic_error("not supported by the memory cloud");
+        }
+
+        [[nodiscard]] std::shared_ptr<Directory> with_new_connection() const override {
+            return std::make_shared<MemoryDirectory>(m_store, m_path, m_revision);
+        }
+
+    private:
+        const std::shared_ptr<MemoryStore> m_store;
+        const std::string m_path;
+        std::string m_revision;
+    };
+}
@@ -0,0 +1,63 @@
+#include "hash/DropboxContentHasher.hpp"
+#include "hash/Sha256.hpp"
+#include <catch2/catch.hpp>
+#include <fstream>
+
+using namespace Catch;
+using namespace CloudSync;
+
+namespace {
+    /// the content hash computed one block after another
+    std::string sequential_hash(const std::vector<std::uint8_t> &data) {
+        hash::Sha256 overall;
+        for (std::size_t offset = 0; offset < data.size(); offset += hash::DropboxContentHasher::BLOCK_SIZE) {
+            const auto length = std::min(hash::DropboxContentHasher::BLOCK_SIZE, data.size() - offset);
+            overall.update(hash::Sha256::digest_of(data.data() + offset, length));
+        }
+        return overall.finish();
+    }
+}
+
+SCENARIO("DropboxContentHasher", "[hash]") {
+    GIVEN("content of a bit more than 3 blocks") {
+        std::vector<std::uint8_t> data(3 * hash::DropboxContentHasher::BLOCK_SIZE + 12345);
+        for (std::size_t i = 0; i < data.size(); i++) {
+            data[i] = static_cast<std::uint8_t>(i % 253);
+        }
+        const auto expected = sequential_hash(data);
+        WHEN("hashing it at once on several threads") {
+            hash::DropboxContentHasher hasher(4);
+            hasher.update(data);
+            THEN("the hash should be the same as when hashing the blocks one after another") {
+                REQUIRE(hasher.finish() == expected);
+            }
+        }
+        WHEN("hashing it in pieces that don't line up with the blocks") {
+            hash::DropboxContentHasher hasher(4);
+            for (std::size_t offset = 0; offset < data.size(); offset += 3000000) {
+                hasher.update(data.data() + offset, std::min<std::size_t>(3000000, data.size() - offset));
+            }
+            THEN("the hash should be the same as when hashing the blocks one after another") {
+                REQUIRE(hasher.finish() == expected);
+            }
+        }
+        WHEN("hashing it from a local file") {
+            const auto path = std::filesystem::temp_directory_path() / "cloudsync_dropbox_hash_test.bin";
+            {
+                std::ofstream stream(path, std::ios::binary);
+                stream.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+            }
+            const auto hash = hash::DropboxContentHasher::of_file(path, 4);
+            std::filesystem::remove(path);
+            THEN("the hash should be the same as when hashing the blocks one after another") {
+                REQUIRE(hash == expected);
+            }
+        }
+    }
+    GIVEN("no content") {
+        THEN("the hash should be the SHA-256 of no block digests") {
+            hash::DropboxContentHasher hasher;
+            REQUIRE(hasher.finish() == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#include "hash/Md5.hpp"
+#include <catch2/catch.hpp>
+#include <string>
+
+using namespace Catch;
+using namespace CloudSync;
+
+namespace {
+    std::vector<std::uint8_t> bytes(const std::string &text) {
+        return {text.begin(), text.end()};
+    }
+}
+
+SCENARIO("Md5", "[hash]") {
+    GIVEN("the test suite of RFC 1321") {
+        THEN("every message should have the expected digest") {
+            REQUIRE(hash::Md5::hex(bytes("")) == "d41d8cd98f00b204e9800998ecf8427e");
+            REQUIRE(hash::Md5::hex(bytes("a")) == "0cc175b9c0f1b6a831c399e269772661");
+            REQUIRE(hash::Md5::hex(bytes("abc")) == "900150983cd24fb0d6963f7d28e17f72");
+            REQUIRE(hash::Md5::hex(bytes("message digest")) == "f96b697d7cb7938d525a2f31aaf161d0");
+            REQUIRE(hash::Md5::hex(bytes("abcdefghijklmnopqrstuvwxyz")) == "c3fcd3d76192e4007dfb496cca67e13b");
+            REQUIRE(hash::Md5::hex(bytes(
+                "12345678901234567890123456789012345678901234567890123456789012345678901234567890"))
+                    == "57edf4a22be3c955ac49da2e2107b67a");
+        }
+    }
+    GIVEN("a message that spans many blocks") {
+        std::vector<std::uint8_t> data(1000003);
+        for (std::size_t i = 0; i < data.size(); i++) {
+            data[i] = static_cast<std::uint8_t>(i % 251);
+        }
+        WHEN("hashing it in pieces that don't line up with the blocks") {
+            hash::Md5 md5;
+            for (std::size_t offset = 0; offset < data.size(); offset += 7777) {
+                md5.update(data.data() + offset, std::min<std::size_t>(7777, data.size() - offset));
+            }
+            THEN("the digest should be the same as for the whole message") {
+                const auto digest = md5.finish();
+                REQUIRE(digest == hash::Md5::hex(data));
+                REQUIRE(digest == "c767382bbc15b14aff5ccfad14bdd82e");
+            }
+        }
+    }
+}
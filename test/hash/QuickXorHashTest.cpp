@@ -0,0 +1,96 @@
+#include "hash/QuickXorHash.hpp"
+#include <catch2/catch.hpp>
+#include <string>
+
+using namespace Catch;
+using namespace CloudSync;
+
+namespace {
+    /// transliteration of the reference implementation of Microsoft, which shifts every byte on its own
+    std::vector<std::uint8_t> reference_state(const std::vector<std::uint8_t> &data) {
+        std::uint64_t cells[3] = {};
+        std::size_t shift = 0;
+        for (const auto byte: data) {
+            const auto cell = shift / 64;
+            const auto offset = shift % 64;
+            const std::size_t bits_in_cell = cell == 2 ? 32 : 64;
+            cells[cell] ^= static_cast<std::uint64_t>(byte) << offset;
+            if (offset > bits_in_cell - 8) {
+                cells[cell == 2 ? 0 : cell + 1] ^= static_cast<std::uint64_t>(byte) >> (bits_in_cell - offset);
+            }
+            shift = (shift + 11) % 160;
+        }
+        std::vector<std::uint8_t> state(20);
+        for (std::size_t i = 0; i < 20; i++) {
+            state[i] = static_cast<std::uint8_t>(cells[i / 8] >> (8 * (i % 8)));
+        }
+        for (std::size_t i = 0; i < 8; i++) {
+            state[12 + i] ^= static_cast<std::uint8_t>(static_cast<std::uint64_t>(data.size()) >> (8 * i));
+        }
+        return state;
+    }
+
+    std::string base64(const std::vector<std::uint8_t> &data) {
+        static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string encoded;
+        std::uint32_t buffer = 0;
+        int bits = 0;
+        for (const auto byte: data) {
+            buffer = (buffer << 8) | byte;
+            bits += 8;
+            while (bits >= 6) {
+                bits -= 6;
+                encoded += ALPHABET[(buffer >> bits) & 0x3f];
+            }
+        }
+        if (bits > 0) {
+            encoded += ALPHABET[(buffer << (6 - bits)) & 0x3f];
+        }
+        while (encoded.size() % 4 != 0) {
+            encoded += '=';
+        }
+        return encoded;
+    }
+
+    std::string quick_xor(const std::vector<std::uint8_t> &data, std::size_t piece_size) {
+        hash::QuickXorHash hasher;
+        for (std::size_t offset = 0; offset < data.size(); offset += piece_size) {
+            hasher.update(data.data() + offset, std::min(piece_size, data.size() - offset));
+        }
+        return hasher.finish();
+    }
+}
+
+SCENARIO("QuickXorHash", "[hash]") {
+    GIVEN("no content") {
+        THEN("the hash should be 20 zero bytes") {
+            REQUIRE(quick_xor({}, 1) == "AAAAAAAAAAAAAAAAAAAAAAAAAAA=");
+        }
+    }
+    GIVEN("content that spans many rows of 160 bytes") {
+        std::vector<std::uint8_t> data(100003);
+        for (std::size_t i = 0; i < data.size(); i++) {
+            data[i] = static_cast<std::uint8_t>((i * 31 + 7) % 256);
+        }
+        const auto expected = base64(reference_state(data));
+        WHEN("hashing it at once") {
+            THEN("the hash should match the reference implementation") {
+                REQUIRE(quick_xor(data, data.size()) == expected);
+            }
+        }
+        WHEN("hashing it in pieces that don't line up with the rows") {
+            THEN("the hash should match the reference implementation") {
+                REQUIRE(quick_xor(data, 1) == expected);
+                REQUIRE(quick_xor(data, 97) == expected);
+                REQUIRE(quick_xor(data, 4099) == expected);
+            }
+        }
+    }
+    GIVEN("a short text") {
+        const std::string text = "The quick brown fox jumps over the lazy dog";
+        THEN("the hash should match the reference implementation") {
+            const std::vector<std::uint8_t> data(text.begin(), text.end());
+            REQUIRE(quick_xor(data, 5) == base64(reference_state(data)));
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#include "hash/Sha1.hpp"
+#include <catch2/catch.hpp>
+#include <string>
+
+using namespace Catch;
+using namespace CloudSync;
+
+namespace {
+    std::string sha1(const std::string &text) {
+        hash::Sha1 sha1;
+        sha1.update(std::vector<std::uint8_t>(text.begin(), text.end()));
+        return sha1.finish();
+    }
+}
+
+SCENARIO("Sha1", "[hash]") {
+    GIVEN("the test suite of RFC 3174") {
+        THEN("every message should have the expected digest") {
+            REQUIRE(sha1("") == "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+            REQUIRE(sha1("abc") == "a9993e364706816aba3e25717850c26c9cd0d89d");
+            REQUIRE(sha1("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")
+                    == "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+        }
+    }
+}
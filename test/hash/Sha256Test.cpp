@@ -0,0 +1,37 @@
+#include "hash/Sha256.hpp"
+#include <catch2/catch.hpp>
+#include <string>
+
+using namespace Catch;
+using namespace CloudSync;
+
+namespace {
+    std::string sha256(const std::string &text) {
+        hash::Sha256 sha256;
+        sha256.update(std::vector<std::uint8_t>(text.begin(), text.end()));
+        return sha256.finish();
+    }
+}
+
+SCENARIO("Sha256", "[hash]") {
+    GIVEN("the examples of FIPS 180-4") {
+        THEN("every message should have the expected digest") {
+            REQUIRE(sha256("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+            REQUIRE(sha256("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+            REQUIRE(sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")
+                    == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+        }
+    }
+    GIVEN("a million times the letter a") {
+        const std::vector<std::uint8_t> data(1000000, 'a');
+        WHEN("hashing it in pieces that don't line up with the blocks") {
+            hash::Sha256 sha256;
+            for (std::size_t offset = 0; offset < data.size(); offset += 999) {
+                sha256.update(data.data() + offset, std::min<std::size_t>(999, data.size() - offset));
+            }
+            THEN("the digest should match the one of FIPS 180-4") {
+                REQUIRE(sha256.finish() == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+            }
+        }
+    }
+}
@@ -3,6 +3,7 @@
 #include "request/Request.hpp"
 #include "shared_ptr_mock.hpp"
 #include <catch2/catch.hpp>
+#include <filesystem>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -18,6 +19,7 @@ struct RequestRecording {
     const std::string url;
     std::string body;
     std::vector<std::uint8_t> binary_body;
+    std::filesystem::path file_body;
     std::string bearer_token;
     std::string basic_username;
     std::string basic_password;
@@ -68,6 +70,11 @@ static std::vector<RequestRecording> requestRecording;
     When(Method(requestMock, binary_body)).AlwaysDo([request](const std::vector<std::uint8_t>& content){               \
         requestRecording.back().binary_body = content;                                                                 \
         return request;                                                                                                \
-    })
+    });                                                                                                                \
+    When(Method(requestMock, file_body)).AlwaysDo([request](const std::filesystem::path& path){                        \
+        requestRecording.back().file_body = path;                                                                      \
+        return request;                                                                                                \
+    });                                                                                                                \
+    When(Method(requestMock, clone)).AlwaysReturn(request)
 
 #define REQUIRE_REQUEST(number, condition) REQUIRE(requestRecording.at(number).condition)
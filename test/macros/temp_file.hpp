@@ -0,0 +1,15 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+/// writes a file of `size` bytes to the temp directory. The content is `i % 251` for byte `i`.
+inline std::filesystem::path temp_file(const std::string &name, std::size_t size) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    for (std::size_t i = 0; i < size; i++) {
+        stream.put(static_cast<char>(i % 251));
+    }
+    return path;
+}
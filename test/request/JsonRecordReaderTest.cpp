@@ -0,0 +1,99 @@
+#include "request/JsonRecordReader.hpp"
+#include "request/StringResponse.hpp"
+#include <catch2/catch.hpp>
+#include <nlohmann/json.hpp>
+
+using namespace Catch;
+using namespace CloudSync;
+using json = nlohmann::json;
+using namespace CloudSync::request;
+
+SCENARIO("JsonRecordReader", "[request]") {
+    const std::vector<std::string> record_fields = {".tag", "name", "size", "parentReference/path", "parents/0/id", "file"};
+    const std::vector<std::string> page_fields = {"cursor", "has_more"};
+
+    GIVEN("a listing page with an array of entries and some paging information") {
+        const std::string data = json{
+            {"entries", {
+                {
+                    {".tag", "file"},
+                    {"name", "test.txt"},
+                    {"size", 11048},
+                    {"content_hash", "a59943f6fe5e4cbc540"},
+                    {"parentReference", {{"id", "123"}, {"path", "/drive/root:/folder"}}},
+                    {"file", {{"mimeType", "text/plain"}}},
+                    {"sharing_info", {{"read_only", false}, {"modified_by", "dbid:AAH4f99T0taONIb"}}}
+                },
+                {
+                    {".tag", "folder"},
+                    {"name", "folder"},
+                    {"parents", {{{"id", "0ANREbljg-Vs3Uk9PVA"}, {"isRoot", true}}, {{"id", "second"}}}}
+                }
+            }},
+            {"cursor", "AAEunngK5i6uSxwrSlvTngxpzli3qKoVouhB8LtojjN9gA"},
+            {"has_more", true}
+        }.dump();
+
+        WHEN("reading the records from the entries array") {
+            const auto result = JsonRecordReader::read(data, "entries", record_fields, page_fields);
+            THEN("one record per entry should be returned") {
+                REQUIRE(result.records.size() == 2);
+            }
+            THEN("the requested scalar fields should be extracted as text") {
+                REQUIRE(result.records[0].at(".tag") == "file");
+                REQUIRE(result.records[0].at("name") == "test.txt");
+                REQUIRE(result.records[0].at("size") == "11048");
+                REQUIRE(result.records[1].at("name") == "folder");
+            }
+            THEN("nested fields should be addressable by their path") {
+                REQUIRE(result.records[0].at("parentReference/path") == "/drive/root:/folder");
+                REQUIRE(result.records[1].at("parents/0/id") == "0ANREbljg-Vs3Uk9PVA");
+            }
+            THEN("requested objects should be marked as present") {
+                REQUIRE(result.records[0].contains("file"));
+                REQUIRE_FALSE(result.records[1].contains("file"));
+            }
+            THEN("missing fields should not be contained in the record") {
+                REQUIRE_FALSE(result.records[1].contains("size"));
+                REQUIRE(result.records[1].value("size", "0") == "0");
+                REQUIRE_THROWS_AS(result.records[1].at("size"), exceptions::ParseError);
+            }
+            THEN("the top-level page fields should be extracted") {
+                REQUIRE(result.page.at("cursor") == "AAEunngK5i6uSxwrSlvTngxpzli3qKoVouhB8LtojjN9gA");
+                REQUIRE(result.page.at("has_more") == "true");
+            }
+            THEN("record() should fail because there is more than one record") {
+                REQUIRE_THROWS_AS(result.record(), exceptions::ParseError);
+            }
+        }
+    }
+    GIVEN("a single object that is wrapped in a top-level key") {
+        const std::string data = json{
+            {"metadata", {{"name", "folder"}, {"id", "id:123"}}}
+        }.dump();
+        WHEN("reading the records from the wrapping key") {
+            const auto result = JsonRecordReader::read(data, "metadata", record_fields);
+            THEN("the wrapped object should be the only record") {
+                REQUIRE(result.record().at("name") == "folder");
+            }
+        }
+    }
+    GIVEN("a single object") {
+        const auto response = StringResponse(200, json{{"name", "test.txt"}, {"size", 12.5}}.dump(), "application/json");
+        WHEN("reading the records with an empty records key through the response") {
+            const auto result = response.json_records("", record_fields);
+            THEN("the object itself should be the only record") {
+                REQUIRE(result.record().at("name") == "test.txt");
+                REQUIRE(result.record().at("size") == "12.5");
+            }
+        }
+    }
+    GIVEN("an invalid json document") {
+        const std::string data = "{\"entries\": [{\"name\": \"test.txt\"";
+        WHEN("reading the records") {
+            THEN("a ParseError should be thrown") {
+                REQUIRE_THROWS_AS(JsonRecordReader::read(data, "entries", record_fields), exceptions::ParseError);
+            }
+        }
+    }
+}
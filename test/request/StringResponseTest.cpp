@@ -53,6 +53,36 @@ SCENARIO("StringResponse", "[request]") {
             }
         }
     }
+    WHEN("constructing a Response with code 429 and a Retry-After header in seconds") {
+        THEN("a TooManyRequests exception with the delay should be thrown") {
+            try {
+                StringResponse(429, "slow down", "text/plain", {{"retry-after", "120"}});
+                FAIL("no exception has been thrown");
+            } catch (const exceptions::response::TooManyRequests& e) {
+                REQUIRE(e.retry_after == std::chrono::seconds(120));
+            }
+        }
+    }
+    WHEN("constructing a Response with code 503 and a Retry-After header with a date in the past") {
+        THEN("a ServiceUnavailable exception without delay should be thrown") {
+            try {
+                StringResponse(503, "maintenance", "text/plain", {{"retry-after", "Fri, 10 Jan 2020 20:42:38 GMT"}});
+                FAIL("no exception has been thrown");
+            } catch (const exceptions::response::ServiceUnavailable& e) {
+                REQUIRE(e.retry_after == std::chrono::seconds(0));
+            }
+        }
+    }
+    WHEN("constructing a Response with code 429 without a Retry-After header") {
+        THEN("the exception should have no delay") {
+            try {
+                StringResponse(429, "slow down");
+                FAIL("no exception has been thrown");
+            } catch (const exceptions::response::TooManyRequests& e) {
+                REQUIRE_FALSE(e.retry_after);
+            }
+        }
+    }
     WHEN("constructing a StringResponse with a json body") {
         THEN("calling .json() on the exception should parse the json response") {
             try {
@@ -0,0 +1,62 @@
+#include "sync/DebounceQueue.hpp"
+#include <catch2/catch.hpp>
+
+using namespace Catch;
+using namespace CloudSync::sync;
+using namespace std::chrono_literals;
+
+SCENARIO("DebounceQueue", "[sync]") {
+    DebounceQueue queue(500ms, 2s);
+    const auto start = DebounceQueue::Clock::now();
+
+    GIVEN("an empty queue") {
+        THEN("nothing should be ready") {
+            REQUIRE(queue.empty());
+            REQUIRE_FALSE(queue.next_ready().has_value());
+            REQUIRE(queue.pop_ready(start + 1h).empty());
+        }
+    }
+    GIVEN("a burst of pushes for the same path") {
+        queue.push("a.txt", start);
+        queue.push("a.txt", start + 100ms);
+        queue.push("a.txt", start + 300ms);
+
+        THEN("the path should be queued once") {
+            REQUIRE(queue.size() == 1);
+        }
+        THEN("the path should not be ready before the quiet period after the last push has ended") {
+            REQUIRE(queue.pop_ready(start + 500ms).empty());
+            REQUIRE(queue.pop_ready(start + 799ms).empty());
+        }
+        THEN("the path should be ready once after the quiet period") {
+            REQUIRE(queue.pop_ready(start + 800ms) == std::vector<std::string>{"a.txt"});
+            REQUIRE(queue.empty());
+            REQUIRE(queue.pop_ready(start + 1h).empty());
+        }
+    }
+    GIVEN("a path that is pushed all the time") {
+        for (auto time = start; time < start + 5s; time += 100ms) {
+            queue.push("log.txt", time);
+        }
+        THEN("it should be ready at the max delay after its first push") {
+            REQUIRE(queue.pop_ready(start + 2s) == std::vector<std::string>{"log.txt"});
+        }
+    }
+    GIVEN("paths that have been pushed at different times") {
+        queue.push("late.txt", start + 200ms);
+        queue.push("early.txt", start);
+
+        THEN("the next ready time should be the one of the earliest path") {
+            REQUIRE(queue.next_ready() == start + 500ms);
+        }
+        THEN("they should be ready in the order of their deadlines") {
+            REQUIRE(queue.pop_ready(start + 600ms) == std::vector<std::string>{"early.txt"});
+            REQUIRE(queue.pop_ready(start + 700ms) == std::vector<std::string>{"late.txt"});
+        }
+        THEN("all of them should be returned when flushing") {
+            REQUIRE(queue.pop_ready(DebounceQueue::Clock::time_point::max())
+                    == std::vector<std::string>{"early.txt", "late.txt"});
+            REQUIRE(queue.empty());
+        }
+    }
+}
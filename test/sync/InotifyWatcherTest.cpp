@@ -0,0 +1,94 @@
+#ifdef __linux__
+
+#include "sync/InotifyWatcher.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <fstream>
+
+using namespace Catch;
+using namespace CloudSync::sync;
+using namespace std::chrono_literals;
+namespace fs = std::filesystem;
+
+namespace {
+    /// reads events until none arrive for a short while
+    std::vector<WatchEvent> read_all(InotifyWatcher &watcher) {
+        std::vector<WatchEvent> events;
+        for (auto batch = watcher.read_events(200ms); !batch.empty(); batch = watcher.read_events(200ms)) {
+            events.insert(events.end(), batch.begin(), batch.end());
+        }
+        return events;
+    }
+
+    bool contains(const std::vector<WatchEvent> &events, WatchEvent::Type type, const std::string &path) {
+        return std::any_of(events.begin(), events.end(), [&](const WatchEvent &event) {
+            return event.type == type && event.path == path;
+        });
+    }
+}
+
+SCENARIO("InotifyWatcher", "[sync]") {
+    const auto root = fs::temp_directory_path() / "cloudsync_inotify_test";
+    fs::remove_all(root);
+    fs::create_directories(root / "a" / "b");
+    fs::create_directories(root / "c");
+
+    GIVEN("a watched tree") {
+        InotifyWatcher watcher(root);
+        REQUIRE(watcher.watch_tree(""));
+        REQUIRE(watcher.watch_count() == 4);
+
+        WHEN("writing a file in a subdirectory") {
+            std::ofstream(root / "a" / "b" / "file.txt") << "content";
+            const auto events = read_all(watcher);
+            THEN("a change of the file should be reported") {
+                REQUIRE(contains(events, WatchEvent::Type::CHANGED, "a/b/file.txt"));
+            }
+        }
+        WHEN("creating a directory") {
+            fs::create_directories(root / "new");
+            const auto events = read_all(watcher);
+            THEN("the directory should be reported and watched") {
+                REQUIRE(contains(events, WatchEvent::Type::DIRECTORY_ADDED, "new"));
+                REQUIRE(watcher.watch_count() == 5);
+            }
+            AND_WHEN("writing a file in the new directory") {
+                std::ofstream(root / "new" / "file.txt") << "content";
+                THEN("a change of the file should be reported") {
+                    REQUIRE(contains(read_all(watcher), WatchEvent::Type::CHANGED, "new/file.txt"));
+                }
+            }
+        }
+        WHEN("renaming a directory") {
+            fs::rename(root / "a", root / "d");
+            read_all(watcher);
+            std::ofstream(root / "d" / "b" / "file.txt") << "content";
+            THEN("changes below it should be reported with the new path") {
+                REQUIRE(contains(read_all(watcher), WatchEvent::Type::CHANGED, "d/b/file.txt"));
+            }
+        }
+        WHEN("interrupting a wait") {
+            watcher.interrupt();
+            const auto start = std::chrono::steady_clock::now();
+            const auto events = watcher.read_events(10s);
+            THEN("it should return right away") {
+                REQUIRE(events.empty());
+                REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+            }
+        }
+    }
+    GIVEN("a watcher with fewer watches than directories") {
+        InotifyWatcher watcher(root, 2);
+        WHEN("watching the tree") {
+            const bool is_complete = watcher.watch_tree("");
+            THEN("the directories beyond the limit should be left unwatched") {
+                REQUIRE_FALSE(is_complete);
+                REQUIRE(watcher.watch_count() == 2);
+                REQUIRE_FALSE(watcher.unwatched().empty());
+            }
+        }
+    }
+    fs::remove_all(root);
+}
+
+#endif
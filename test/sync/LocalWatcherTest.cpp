@@ -0,0 +1,154 @@
+#ifdef __linux__
+
+#include "CloudSync/LocalWatcher.hpp"
+#include "CloudSync/SyncEngine.hpp"
+#include "fixtures/MemoryCloud.hpp"
+#include <catch2/catch.hpp>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace std::chrono_literals;
+namespace fs = std::filesystem;
+
+namespace {
+    std::vector<std::uint8_t> bytes(const std::string &content) {
+        return {content.begin(), content.end()};
+    }
+
+    std::string remote_content(const fixtures::MemoryStore &store, const std::string &path) {
+        fixtures::MemoryStore::Node node;
+        if (!store.find(path, node)) {
+            return "";
+        }
+        return {node.content.begin(), node.content.end()};
+    }
+
+    /// the outcomes of the uploads of a watcher, by path
+    class Uploads {
+    public:
+        LocalWatcher::UploadHandler handler() {
+            return [this](const fs::path &path, std::exception_ptr error) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_outcomes[path.generic_string()].push_back(std::move(error));
+                }
+                m_changed.notify_all();
+            };
+        }
+
+        /// waits for the next upload of `path`. @return the error it has failed with
+        std::exception_ptr next(const std::string &path) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto &outcomes = m_outcomes[path];
+            const auto seen = m_seen[path]++;
+            REQUIRE(m_changed.wait_for(lock, 5s, [&outcomes, seen] {
+                return outcomes.size() > seen;
+            }));
+            return outcomes[seen];
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_changed;
+        std::map<std::string, std::vector<std::exception_ptr>> m_outcomes;
+        std::map<std::string, std::size_t> m_seen;
+    };
+
+    void write_local(const fs::path &file, const std::string &content) {
+        std::ofstream(file, std::ios::binary | std::ios::trunc) << content;
+    }
+}
+
+SCENARIO("LocalWatcher", "[sync]") {
+    const auto root = fs::temp_directory_path() / "cloudsync_local_watcher_test";
+    fs::remove_all(root);
+    const auto local_root = root / "local";
+    const auto state_file = root / "state";
+    fs::create_directories(local_root);
+    const auto store = std::make_shared<fixtures::MemoryStore>();
+    const auto remote_root = std::make_shared<fixtures::MemoryDirectory>(store, "/");
+    LocalWatcherOptions options;
+    options.quiet_period = 50ms;
+    Uploads uploads;
+
+    GIVEN("a watcher without a sync") {
+        LocalWatcher watcher(local_root, remote_root, options, uploads.handler());
+        watcher.start();
+
+        WHEN("a new file is written") {
+            write_local(local_root / "a.txt", "local");
+            THEN("it should be uploaded") {
+                REQUIRE(uploads.next("a.txt") == nullptr);
+                REQUIRE(remote_content(*store, "/a.txt") == "local");
+            }
+            AND_WHEN("it is changed in the cloud and then locally") {
+                REQUIRE(uploads.next("a.txt") == nullptr);
+                store->write("/a.txt", bytes("remote change"), "*");
+                write_local(local_root / "a.txt", "local change");
+                THEN("the upload should fail and the change in the cloud should be kept") {
+                    REQUIRE_THROWS_AS(std::rethrow_exception(uploads.next("a.txt")),
+                                      exceptions::resource::ResourceHasChanged);
+                    REQUIRE(remote_content(*store, "/a.txt") == "remote change");
+                }
+            }
+        }
+        WHEN("a file that is in the cloud already is written") {
+            store->write("/a.txt", bytes("remote"), "");
+            write_local(local_root / "a.txt", "local");
+            THEN("the upload should fail and the file in the cloud should be kept") {
+                REQUIRE_THROWS_AS(std::rethrow_exception(uploads.next("a.txt")),
+                                  exceptions::resource::ResourceConflict);
+                REQUIRE(remote_content(*store, "/a.txt") == "remote");
+            }
+        }
+    }
+    GIVEN("a watcher along with a sync") {
+        write_local(local_root / "a.txt", "synced");
+        SyncEngine engine(local_root, remote_root, state_file);
+        REQUIRE(engine.sync().uploads == 1);
+        options.state_file = state_file;
+        LocalWatcher watcher(local_root, remote_root, options, uploads.handler());
+        watcher.start();
+
+        WHEN("a synced file is changed locally") {
+            write_local(local_root / "a.txt", "local change");
+            THEN("it should be uploaded") {
+                REQUIRE(uploads.next("a.txt") == nullptr);
+                REQUIRE(remote_content(*store, "/a.txt") == "local change");
+            }
+            AND_WHEN("syncing after the upload") {
+                REQUIRE(uploads.next("a.txt") == nullptr);
+                watcher.stop();
+                const auto result = engine.sync();
+                THEN("the file should be known to be synced") {
+                    REQUIRE(result.changes() == 0);
+                    REQUIRE(result.conflicts.empty());
+                }
+            }
+        }
+        WHEN("a synced file is changed in the cloud and then locally") {
+            store->write("/a.txt", bytes("remote change"), "*");
+            write_local(local_root / "a.txt", "local change");
+            THEN("the upload should fail and the change in the cloud should be kept") {
+                REQUIRE_THROWS_AS(std::rethrow_exception(uploads.next("a.txt")),
+                                  exceptions::resource::ResourceConflict);
+                REQUIRE(remote_content(*store, "/a.txt") == "remote change");
+            }
+            AND_WHEN("syncing") {
+                REQUIRE(uploads.next("a.txt") != nullptr);
+                watcher.stop();
+                const auto result = engine.sync();
+                THEN("it should be a conflict") {
+                    REQUIRE(result.conflicts == std::vector<fs::path>{"a.txt"});
+                }
+            }
+        }
+    }
+    fs::remove_all(root);
+}
+
+#endif
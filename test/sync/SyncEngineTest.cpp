@@ -0,0 +1,298 @@
+#include "CloudSync/SyncEngine.hpp"
+#include "CloudSync/exceptions/cloud/CloudException.hpp"
+#include "fixtures/MemoryCloud.hpp"
+#include "sync/SyncState.hpp"
+#include "sync/TransferJournal.hpp"
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <iterator>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace CloudSync::sync;
+namespace fs = std::filesystem;
+
+namespace {
+    std::vector<std::uint8_t> bytes(const std::string &content) {
+        return {content.begin(), content.end()};
+    }
+
+    void write_local(const fs::path &file, const std::string &content) {
+        fs::create_directories(file.parent_path());
+        std::ofstream(file, std::ios::binary | std::ios::trunc) << content;
+    }
+
+    std::string read_local(const fs::path &file) {
+        std::ifstream input(file, std::ios::binary);
+        return {std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    }
+
+    /// @return the local file as a sync would have scanned it
+    LocalEntry stat_local(const fs::path &file) {
+        return {ResourceInfo::Kind::FILE, fs::file_size(file),
+                static_cast<std::int64_t>(fs::last_write_time(file).time_since_epoch().count())};
+    }
+
+    TransferIntent download(const std::string &path, const std::string &revision) {
+        TransferIntent intent;
+        intent.type = TransferIntent::Type::DOWNLOAD;
+        intent.path = path;
+        intent.revision = revision;
+        return intent;
+    }
+
+    TransferIntent upload(const std::string &path, const std::string &revision, const LocalEntry &local) {
+        TransferIntent intent;
+        intent.path = path;
+        intent.revision = revision;
+        intent.local = local;
+        return intent;
+    }
+
+    std::string remote_content(const fixtures::MemoryStore &store, const std::string &path) {
+        fixtures::MemoryStore::Node node;
+        if (!store.find(path, node)) {
+            return "";
+        }
+        return {node.content.begin(), node.content.end()};
+    }
+}
+
+SCENARIO("SyncEngine", "[sync]") {
+    const auto root = fs::temp_directory_path() / "cloudsync_sync_engine_test";
+    fs::remove_all(root);
+    const auto local_root = root / "local";
+    const auto state_file = root / "state";
+    const auto journal_file = fs::path(state_file) += ".journal";
+    fs::create_directories(local_root);
+    const auto store = std::make_shared<fixtures::MemoryStore>();
+    const auto remote_root = std::make_shared<fixtures::MemoryDirectory>(store, "/");
+    SyncOptions options;
+    // the root is only recorded with its revision when pruning
+    options.prune_unchanged_directories = true;
+    SyncEngine engine(local_root, remote_root, state_file, options);
+
+    GIVEN("files on both sides that have never been synced") {
+        write_local(local_root / "docs" / "local.txt", "local");
+        store->write("/remote.txt", bytes("remote"), "");
+
+        WHEN("syncing") {
+            const auto result = engine.sync();
+            THEN("each side should get the files of the other one") {
+                REQUIRE(result.uploads == 1);
+                REQUIRE(result.downloads == 1);
+                REQUIRE(result.created_directories == 1);
+                REQUIRE(result.conflicts.empty());
+                REQUIRE(result.errors.empty());
+                REQUIRE(remote_content(*store, "/docs/local.txt") == "local");
+                REQUIRE(read_local(local_root / "remote.txt") == "remote");
+            }
+            THEN("the journal should be gone") {
+                REQUIRE_FALSE(fs::exists(journal_file));
+            }
+            AND_WHEN("syncing again") {
+                const auto again = engine.sync();
+                THEN("there should be nothing to do") {
+                    REQUIRE(again.changes() == 0);
+                    REQUIRE(again.conflicts.empty());
+                }
+            }
+            AND_WHEN("a file is changed on each side and synced again") {
+                write_local(local_root / "docs" / "local.txt", "local, changed");
+                store->write("/remote.txt", bytes("remote, changed"), "*");
+                const auto again = engine.sync();
+                THEN("the changes should be transferred") {
+                    REQUIRE(again.uploads == 1);
+                    REQUIRE(again.downloads == 1);
+                    REQUIRE(remote_content(*store, "/docs/local.txt") == "local, changed");
+                    REQUIRE(read_local(local_root / "remote.txt") == "remote, changed");
+                }
+            }
+        }
+    }
+    GIVEN("a sync that has been interrupted") {
+        write_local(local_root / "synced.txt", "synced");
+        REQUIRE(engine.sync().uploads == 1);
+        const auto synced_state = SyncState::load(state_file);
+        REQUIRE_FALSE(synced_state.entries.at("").revision.empty());
+
+        WHEN("a download has been moved in place but not recorded") {
+            const auto revision = store->write("/new.txt", bytes("new"), "");
+            write_local(local_root / "new.txt", "new");
+            {
+                TransferJournal journal(journal_file);
+                const auto id = journal.begin(download("new.txt", revision));
+                journal.written(id, stat_local(local_root / "new.txt"));
+            }
+            const auto result = engine.resume();
+            THEN("it should be recorded without being downloaded again") {
+                REQUIRE(result.downloads == 0);
+                const auto state = SyncState::load(state_file);
+                const auto &entry = state.entries.at("new.txt");
+                REQUIRE(entry.revision == revision);
+                REQUIRE(entry.local_modified == stat_local(local_root / "new.txt").modified);
+                REQUIRE_FALSE(fs::exists(journal_file));
+            }
+        }
+        WHEN("a download has been written but not moved in place") {
+            const auto revision = store->write("/new.txt", bytes("new"), "");
+            const auto partial_file = local_root / "new.txt.cloudsync.part";
+            write_local(partial_file, "new");
+            {
+                TransferJournal journal(journal_file);
+                const auto id = journal.begin(download("new.txt", revision));
+                journal.written(id, stat_local(partial_file));
+            }
+            const auto result = engine.resume();
+            THEN("it should be moved in place and recorded") {
+                REQUIRE(result.downloads == 1);
+                REQUIRE_FALSE(fs::exists(partial_file));
+                REQUIRE(read_local(local_root / "new.txt") == "new");
+                REQUIRE(SyncState::load(state_file).entries.at("new.txt").revision == revision);
+            }
+        }
+        WHEN("a download hasn't been written yet") {
+            const auto revision = store->write("/new.txt", bytes("new"), "");
+            TransferJournal(journal_file).begin(download("new.txt", revision));
+            const auto result = engine.resume();
+            THEN("it should be run again") {
+                REQUIRE(result.downloads == 1);
+                REQUIRE(read_local(local_root / "new.txt") == "new");
+                REQUIRE(SyncState::load(state_file).entries.at("new.txt").revision == revision);
+            }
+        }
+        WHEN("an upload hasn't reached the cloud") {
+            write_local(local_root / "new.txt", "new");
+            TransferJournal(journal_file).begin(upload("new.txt", "", stat_local(local_root / "new.txt")));
+            const auto result = engine.resume();
+            THEN("it should be run again") {
+                REQUIRE(result.uploads == 1);
+                REQUIRE(remote_content(*store, "/new.txt") == "new");
+                REQUIRE(SyncState::load(state_file).entries.count("new.txt") == 1);
+            }
+        }
+        WHEN("an upload has reached the cloud but hasn't been recorded, on a provider that reports hashes") {
+            store->reports_hashes = true;
+            write_local(local_root / "new.txt", "new");
+            TransferJournal(journal_file).begin(upload("new.txt", "", stat_local(local_root / "new.txt")));
+            const auto revision = store->write("/new.txt", bytes("new"), "");
+            store->reset_counters();
+            const auto result = engine.resume();
+            THEN("it should be recorded once the hash has confirmed it") {
+                REQUIRE(result.uploads == 0);
+                REQUIRE(store->bytes_uploaded == 0);
+                REQUIRE(SyncState::load(state_file).entries.at("new.txt").revision == revision);
+            }
+        }
+        WHEN("the file of an upload has been changed since") {
+            write_local(local_root / "synced.txt", "changed");
+            TransferJournal(journal_file).begin(upload(
+                    "synced.txt", synced_state.entries.at("synced.txt").revision, {ResourceInfo::Kind::FILE, 6, 1}));
+            const auto result = engine.resume();
+            THEN("nothing should be transferred and the next sync should list the cloud again") {
+                REQUIRE(result.changes() == 0);
+                const auto state = SyncState::load(state_file);
+                REQUIRE(state.entries.at("").revision.empty());
+                REQUIRE(state.entries.at("synced.txt") == synced_state.entries.at("synced.txt"));
+                REQUIRE_FALSE(fs::exists(journal_file));
+            }
+            AND_WHEN("syncing") {
+                const auto synced = engine.sync();
+                THEN("the change should be uploaded") {
+                    REQUIRE(synced.uploads == 1);
+                    REQUIRE(remote_content(*store, "/synced.txt") == "changed");
+                }
+            }
+        }
+    }
+    GIVEN("a tree that has been synced before") {
+        write_local(local_root / "docs" / "a.txt", "a");
+        write_local(local_root / "docs" / "b.txt", "b");
+        REQUIRE(engine.sync().uploads == 2);
+        const auto synced_state = SyncState::load(state_file);
+
+        WHEN("the file in the cloud is changed while a local change is uploaded") {
+            write_local(local_root / "docs" / "a.txt", "local change");
+            bool changed = false;
+            store->before_transfer = [&store, &changed](const std::string &path) {
+                if (!changed) {
+                    changed = true;
+                    store->write(path, bytes("remote change"), "*");
+                }
+            };
+            const auto result = engine.sync();
+            THEN("it should be a conflict and neither side should be overwritten") {
+                REQUIRE(result.uploads == 0);
+                REQUIRE(result.conflicts == std::vector<fs::path>{"docs/a.txt"});
+                REQUIRE(result.errors.empty());
+                REQUIRE(remote_content(*store, "/docs/a.txt") == "remote change");
+                REQUIRE(read_local(local_root / "docs" / "a.txt") == "local change");
+            }
+            THEN("the state of the file should be kept and its parents listed again by the next sync") {
+                const auto state = SyncState::load(state_file);
+                REQUIRE(state.entries.at("docs/a.txt") == synced_state.entries.at("docs/a.txt"));
+                REQUIRE(state.entries.at("docs").revision.empty());
+                REQUIRE(state.entries.at("").revision.empty());
+            }
+        }
+        WHEN("an upload fails") {
+            write_local(local_root / "docs" / "a.txt", "local change");
+            store->before_transfer = [](const std::string &) {
+                throw exceptions::cloud::CommunicationError("connection reset");
+            };
+            const auto result = engine.sync();
+            THEN("the error should be reported for the file") {
+                REQUIRE(result.uploads == 0);
+                REQUIRE(result.errors.size() == 1);
+                REQUIRE(result.errors[0].path == "docs/a.txt");
+                REQUIRE_THROWS_AS(result.errors[0].rethrow_if_failed(), exceptions::cloud::CommunicationError);
+                REQUIRE(remote_content(*store, "/docs/a.txt") == "a");
+            }
+            AND_WHEN("syncing again once the cloud is available") {
+                store->before_transfer = nullptr;
+                const auto again = engine.sync();
+                THEN("the change should be uploaded") {
+                    REQUIRE(again.uploads == 1);
+                    REQUIRE(again.errors.empty());
+                    REQUIRE(remote_content(*store, "/docs/a.txt") == "local change");
+                }
+            }
+        }
+        WHEN("a download fails") {
+            store->write("/docs/b.txt", bytes("remote change"), "*");
+            store->before_transfer = [](const std::string &) {
+                throw exceptions::cloud::CommunicationError("connection reset");
+            };
+            const auto result = engine.sync();
+            THEN("the local file should be left alone") {
+                REQUIRE(result.downloads == 0);
+                REQUIRE(result.errors.size() == 1);
+                REQUIRE(read_local(local_root / "docs" / "b.txt") == "b");
+                REQUIRE_FALSE(fs::exists(local_root / "docs" / "b.txt.cloudsync.part"));
+            }
+            AND_WHEN("syncing again once the cloud is available") {
+                store->before_transfer = nullptr;
+                const auto again = engine.sync();
+                THEN("the change should be downloaded") {
+                    REQUIRE(again.downloads == 1);
+                    REQUIRE(read_local(local_root / "docs" / "b.txt") == "remote change");
+                }
+            }
+        }
+        WHEN("a file is removed locally and the other one in the cloud") {
+            fs::remove(local_root / "docs" / "a.txt");
+            store->remove("/docs/b.txt");
+            const auto result = engine.sync();
+            THEN("each removal should be carried out on the other side") {
+                REQUIRE(result.remote_removals == 1);
+                REQUIRE(result.local_removals == 1);
+                REQUIRE(remote_content(*store, "/docs/a.txt").empty());
+                REQUIRE_FALSE(fs::exists(local_root / "docs" / "b.txt"));
+                const auto state = SyncState::load(state_file);
+                REQUIRE(state.entries.count("docs/a.txt") == 0);
+                REQUIRE(state.entries.count("docs/b.txt") == 0);
+            }
+        }
+    }
+    fs::remove_all(root);
+}
@@ -0,0 +1,177 @@
+#include "sync/SyncPlanner.hpp"
+#include <catch2/catch.hpp>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace CloudSync::sync;
+
+namespace {
+    using Kind = ResourceInfo::Kind;
+    using Type = SyncAction::Type;
+
+    ResourceInfo remote_file(const std::string &name, const std::string &revision, std::uint64_t size) {
+        ResourceInfo info;
+        info.name = name;
+        info.revision = revision;
+        info.size = size;
+        return info;
+    }
+
+    ResourceInfo remote_directory(const std::string &name) {
+        ResourceInfo info;
+        info.name = name;
+        info.kind = Kind::DIRECTORY;
+        return info;
+    }
+
+    std::vector<std::pair<Type, std::string>> plan(
+            const LocalSnapshot &local, const RemoteSnapshot &remote, const SyncState &state, bool same_content = false) {
+        std::vector<std::pair<Type, std::string>> actions;
+        for (const auto &action: plan_sync(local, remote, state, [same_content](const std::string &) {
+            return same_content;
+        })) {
+            actions.emplace_back(action.type, action.path);
+        }
+        return actions;
+    }
+
+    using Actions = std::vector<std::pair<Type, std::string>>;
+}
+
+SCENARIO("plan_sync", "[sync]") {
+    GIVEN("a tree that has been synced before") {
+        SyncState state;
+        state.entries["docs"] = {Kind::DIRECTORY, "", "d1"};
+        state.entries["docs/a.txt"] = {Kind::FILE, "", "r1", 10, 100};
+        state.entries["docs/b.txt"] = {Kind::FILE, "", "r2", 20, 200};
+        LocalSnapshot local = {
+                {"docs", {Kind::DIRECTORY}},
+                {"docs/a.txt", {Kind::FILE, 10, 100}},
+                {"docs/b.txt", {Kind::FILE, 20, 200}}};
+        RemoteSnapshot remote = {
+                {"docs", remote_directory("docs")},
+                {"docs/a.txt", remote_file("a.txt", "r1", 10)},
+                {"docs/b.txt", remote_file("b.txt", "r2", 20)}};
+        remote["docs"].revision = "d1";
+
+        WHEN("nothing has changed") {
+            THEN("there should be nothing to do") {
+                REQUIRE(plan(local, remote, state).empty());
+            }
+        }
+        WHEN("a file has been changed locally and another one in the cloud") {
+            local["docs/a.txt"].modified = 101;
+            remote["docs/b.txt"].revision = "r3";
+            THEN("the first one should be uploaded and the second one downloaded") {
+                REQUIRE(plan(local, remote, state) == Actions{{Type::UPLOAD, "docs/a.txt"}, {Type::DOWNLOAD, "docs/b.txt"}});
+            }
+        }
+        WHEN("a file has been changed on both sides") {
+            local["docs/a.txt"].size = 11;
+            remote["docs/a.txt"] = remote_file("a.txt", "r4", 11);
+            THEN("it should be a conflict") {
+                REQUIRE(plan(local, remote, state) == Actions{{Type::CONFLICT, "docs/a.txt"}});
+            }
+            THEN("it should only be recorded if both sides have the same content") {
+                REQUIRE(plan(local, remote, state, true) == Actions{{Type::RECORD, "docs/a.txt"}});
+            }
+        }
+        WHEN("a file has been removed locally and another one in the cloud") {
+            local.erase("docs/a.txt");
+            remote.erase("docs/b.txt");
+            THEN("the first one should be removed in the cloud and the second one locally") {
+                REQUIRE(plan(local, remote, state) == Actions{{Type::REMOVE_REMOTE, "docs/a.txt"}, {Type::REMOVE_LOCAL, "docs/b.txt"}});
+            }
+        }
+        WHEN("the directory has been removed locally") {
+            local = {};
+            THEN("it should be removed in the cloud with a single action") {
+                REQUIRE(plan(local, remote, state) == Actions{{Type::REMOVE_REMOTE, "docs"}});
+            }
+            AND_WHEN("a file in it has been changed in the cloud") {
+                remote["docs/b.txt"].revision = "r3";
+                THEN("the whole directory should be a conflict") {
+                    REQUIRE(plan(local, remote, state) == Actions{{Type::CONFLICT, "docs"}});
+                }
+            }
+        }
+        WHEN("the directory has been removed in the cloud") {
+            remote = {};
+            THEN("it should be removed locally with a single action") {
+                REQUIRE(plan(local, remote, state) == Actions{{Type::REMOVE_LOCAL, "docs"}});
+            }
+            AND_WHEN("a file has been added to it locally") {
+                local["docs/c.txt"] = {Kind::FILE, 5, 300};
+                THEN("the whole directory should be a conflict") {
+                    REQUIRE(plan(local, remote, state) == Actions{{Type::CONFLICT, "docs"}});
+                }
+            }
+        }
+        WHEN("the directory has been removed on both sides") {
+            local = {};
+            remote = {};
+            THEN("the state should forget it") {
+                REQUIRE(plan(local, remote, state) == Actions{{Type::FORGET, "docs"}});
+            }
+        }
+        WHEN("the revision of the directory has changed") {
+            remote["docs"].revision = "d2";
+            THEN("only the new revision should be recorded") {
+                REQUIRE(plan(local, remote, state) == Actions{{Type::RECORD, "docs"}});
+            }
+        }
+        WHEN("a file has been replaced by a directory in the cloud") {
+            remote.erase("docs/a.txt");
+            remote["docs/a.txt"] = remote_directory("a.txt");
+            remote["docs/a.txt/c.txt"] = remote_file("c.txt", "r5", 1);
+            THEN("the directory should be a conflict, without actions for its content") {
+                REQUIRE(plan(local, remote, state) == Actions{{Type::CONFLICT, "docs/a.txt"}});
+            }
+        }
+    }
+    GIVEN("a directory and a sibling whose name starts with the name of the directory") {
+        SyncState state;
+        state.entries["photos"] = {Kind::DIRECTORY, "", "d1"};
+        state.entries["photos.old"] = {Kind::DIRECTORY, "", "d2"};
+        state.entries["photos.old/x.jpg"] = {Kind::FILE, "", "r1", 10, 100};
+        state.entries["photos/y.jpg"] = {Kind::FILE, "", "r2", 20, 200};
+        LocalSnapshot local = {
+                {"photos", {Kind::DIRECTORY}},
+                {"photos.old", {Kind::DIRECTORY}},
+                {"photos.old/x.jpg", {Kind::FILE, 10, 100}},
+                {"photos/y.jpg", {Kind::FILE, 20, 200}}};
+        RemoteSnapshot remote;
+
+        WHEN("both have been removed in the cloud") {
+            THEN("each should be removed locally with a single action") {
+                REQUIRE(plan(local, remote, state) == Actions{
+                        {Type::REMOVE_LOCAL, "photos"},
+                        {Type::REMOVE_LOCAL, "photos.old"}});
+            }
+        }
+        WHEN("both have been removed in the cloud and a file has been changed locally in the directory") {
+            local["photos/y.jpg"].modified = 201;
+            THEN("its content shouldn't get actions besides the conflict of the directory") {
+                REQUIRE(plan(local, remote, state) == Actions{
+                        {Type::CONFLICT, "photos"},
+                        {Type::REMOVE_LOCAL, "photos.old"}});
+            }
+        }
+    }
+    GIVEN("nothing has been synced before") {
+        const SyncState state;
+        const LocalSnapshot local = {
+                {"local", {Kind::DIRECTORY}},
+                {"local/a.txt", {Kind::FILE, 1, 1}}};
+        const RemoteSnapshot remote = {
+                {"remote", remote_directory("remote")},
+                {"remote/b.txt", remote_file("b.txt", "r1", 2)}};
+        THEN("new directories should be created before their content is transferred") {
+            REQUIRE(plan(local, remote, state) == Actions{
+                    {Type::CREATE_REMOTE_DIRECTORY, "local"},
+                    {Type::UPLOAD, "local/a.txt"},
+                    {Type::CREATE_LOCAL_DIRECTORY, "remote"},
+                    {Type::DOWNLOAD, "remote/b.txt"}});
+        }
+    }
+}
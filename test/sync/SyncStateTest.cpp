@@ -0,0 +1,65 @@
+#include "sync/SyncState.hpp"
+#include <catch2/catch.hpp>
+#include <fstream>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace CloudSync::sync;
+
+SCENARIO("SyncState", "[sync]") {
+    const auto file = std::filesystem::temp_directory_path() / "cloudsync_state_test";
+    std::filesystem::remove(file);
+
+    GIVEN("no state file") {
+        THEN("an empty state should be loaded") {
+            REQUIRE(SyncState::load(file).entries.empty());
+        }
+    }
+    GIVEN("a state with a directory and files whose names need escaping") {
+        SyncState state;
+        state.entries[""] = {ResourceInfo::Kind::DIRECTORY, "", "\"root\""};
+        state.entries["a"] = {ResourceInfo::Kind::DIRECTORY, "id_a", "\"5e18e1bede073\""};
+        state.entries["a/tab\tand\\backslash.txt"] = {ResourceInfo::Kind::FILE, "id_b", "rev1", 1234, -56789};
+        state.entries["a/line\nbreak.txt"] = {ResourceInfo::Kind::FILE, "", "rev2", 0, 42};
+
+        WHEN("saving & loading it") {
+            state.save(file);
+            const auto loaded = SyncState::load(file);
+            THEN("all entries should be the same") {
+                REQUIRE(loaded.entries == state.entries);
+            }
+            THEN("no temporary file should be left") {
+                REQUIRE_FALSE(std::filesystem::exists(file.string() + ".tmp"));
+            }
+        }
+        WHEN("removing the tree of the directory") {
+            state.entries["ab"] = {ResourceInfo::Kind::FILE, "", "rev3"};
+            state.remove_tree("a");
+            THEN("only the root and the sibling with a common prefix should be left") {
+                REQUIRE(state.entries.size() == 2);
+                REQUIRE(state.entries.count("") == 1);
+                REQUIRE(state.entries.count("ab") == 1);
+            }
+        }
+    }
+    GIVEN("a file that hasn't been written by a sync") {
+        std::ofstream(file) << "something else\n";
+        THEN("loading it should fail") {
+            REQUIRE_THROWS_AS(SyncState::load(file), std::runtime_error);
+        }
+    }
+    GIVEN("the files that are kept next to the state") {
+        const StateFiles state_files(file);
+        THEN("the state, its journal and its upload log should be among them, also through another path") {
+            REQUIRE(state_files.contains(file));
+            REQUIRE(state_files.contains(std::filesystem::path(file) += ".journal"));
+            REQUIRE(state_files.contains(std::filesystem::path(file) += ".uploads"));
+            REQUIRE(state_files.contains(file.parent_path() / "." / file.filename()));
+        }
+        THEN("other files next to it should not") {
+            REQUIRE_FALSE(state_files.contains(std::filesystem::path(file) += ".txt"));
+            REQUIRE_FALSE(state_files.contains(file.parent_path() / "other" / file.filename()));
+        }
+    }
+    std::filesystem::remove(file);
+}
@@ -0,0 +1,153 @@
+#include "sync/TransferJournal.hpp"
+#include <catch2/catch.hpp>
+#include <fstream>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace CloudSync::sync;
+
+namespace {
+    TransferIntent upload(const std::string &path, const std::string &revision) {
+        return {TransferIntent::Type::UPLOAD, path, revision, LocalEntry{ResourceInfo::Kind::FILE, 10, 1234}};
+    }
+}
+
+SCENARIO("TransferJournal", "[sync]") {
+    const auto file = std::filesystem::temp_directory_path() / "cloudsync_journal_test";
+    std::filesystem::remove(file);
+
+    GIVEN("no journal") {
+        THEN("nothing should be pending") {
+            const auto contents = TransferJournal::read(file);
+            REQUIRE(contents.pending.empty());
+            REQUIRE(contents.committed.empty());
+            REQUIRE(contents.aborted.empty());
+        }
+    }
+    GIVEN("a journal with transfers in every stage") {
+        TransferJournal journal(file);
+        const auto uploaded = journal.begin(upload("a/tab\tname.txt", ""));
+        const auto failed = journal.begin(upload("b.txt", "rev1"));
+        const auto downloading = journal.begin({TransferIntent::Type::DOWNLOAD, "c.txt", "rev2"});
+        const auto waiting = journal.begin(upload("d.txt", "rev3"));
+        journal.commit(uploaded, {ResourceInfo::Kind::FILE, "id", "rev4", 10, 1234});
+        journal.abort(failed);
+        journal.written(downloading, {ResourceInfo::Kind::FILE, 20, 5678});
+
+        WHEN("reading it") {
+            const auto contents = TransferJournal::read(file);
+            THEN("finished transfers should be told apart from pending ones") {
+                REQUIRE(contents.committed.size() == 1);
+                REQUIRE(contents.committed[0].first == "a/tab\tname.txt");
+                REQUIRE(contents.committed[0].second.revision == "rev4");
+                REQUIRE(contents.aborted == std::vector<std::string>{"b.txt"});
+                REQUIRE(contents.pending.size() == 2);
+            }
+            THEN("pending transfers should be read as they have been recorded") {
+                const auto &download = contents.pending.at(downloading);
+                REQUIRE(download.type == TransferIntent::Type::DOWNLOAD);
+                REQUIRE(download.path == "c.txt");
+                REQUIRE(download.revision == "rev2");
+                REQUIRE_FALSE(download.local);
+                REQUIRE(download.written->size == 20);
+                REQUIRE(download.written->modified == 5678);
+                const auto &upload = contents.pending.at(waiting);
+                REQUIRE(upload.local->size == 10);
+                REQUIRE(upload.local->modified == 1234);
+                REQUIRE_FALSE(upload.written);
+            }
+        }
+        WHEN("the last record has been cut off") {
+            std::ofstream(file, std::ios::binary | std::ios::app) << "C\t" << waiting << "\td.txt\tid";
+            THEN("it should be ignored") {
+                REQUIRE(TransferJournal::read(file).pending.count(waiting) == 1);
+            }
+        }
+        WHEN("compacting it") {
+            REQUIRE(journal.records() == 7);
+            journal.compact();
+            THEN("only the pending transfers should be kept") {
+                REQUIRE(journal.records() == 0);
+                REQUIRE(journal.pending() == 2);
+                const auto contents = TransferJournal::read(file);
+                REQUIRE(contents.committed.empty());
+                REQUIRE(contents.aborted.empty());
+                REQUIRE(contents.pending.size() == 2);
+                REQUIRE(contents.pending.at(downloading).written);
+            }
+            THEN("new records should be appended to the compacted journal") {
+                journal.commit(waiting, {ResourceInfo::Kind::FILE, "id", "rev5", 10, 1234});
+                const auto contents = TransferJournal::read(file);
+                REQUIRE(contents.committed.size() == 1);
+                REQUIRE(contents.pending.size() == 1);
+            }
+        }
+        WHEN("removing it") {
+            journal.remove();
+            THEN("the file should be gone") {
+                REQUIRE_FALSE(std::filesystem::exists(file));
+            }
+        }
+    }
+    GIVEN("an interrupted journal that is resumed") {
+        {
+            TransferJournal interrupted(file);
+            interrupted.begin(upload("a.txt", "rev1"));
+        }
+        TransferJournal resumed(file, true);
+        const auto again = resumed.begin(upload("a.txt", "rev1"));
+
+        WHEN("the transfers haven't been begun all again yet") {
+            THEN("the interrupted journal should be kept") {
+                const auto contents = TransferJournal::read(file);
+                REQUIRE(contents.pending.size() == 1);
+                REQUIRE(contents.pending.begin()->second.path == "a.txt");
+            }
+        }
+        WHEN("replacing the interrupted journal") {
+            resumed.replace_previous();
+            resumed.commit(again, {ResourceInfo::Kind::FILE, "id", "rev2", 10, 1234});
+            THEN("the records of the resumed journal should be read") {
+                const auto contents = TransferJournal::read(file);
+                REQUIRE(contents.pending.empty());
+                REQUIRE(contents.committed.size() == 1);
+                auto staged = file;
+                staged += ".tmp";
+                REQUIRE_FALSE(std::filesystem::exists(staged));
+            }
+        }
+        resumed.remove();
+    }
+    GIVEN("a sync with many more transfers than the state has entries") {
+        constexpr std::size_t TRANSFERS = 5000;
+        TransferJournal journal(file);
+        std::vector<std::uint64_t> ids;
+        for (std::size_t i = 0; i < TRANSFERS; i++) {
+            ids.push_back(journal.begin(upload(std::to_string(i) + ".txt", "")));
+        }
+        WHEN("committing them one by one and compacting whenever it is needed") {
+            std::size_t state_entries = 10;
+            std::size_t compactions = 0;
+            for (const auto id: ids) {
+                journal.commit(id, {ResourceInfo::Kind::FILE, "id", "rev", 10, 1234});
+                state_entries++;
+                if (journal.needs_compaction(state_entries)) {
+                    journal.compact();
+                    compactions++;
+                }
+            }
+            THEN("the journal should only be compacted a few times") {
+                REQUIRE(compactions >= 1);
+                REQUIRE(compactions <= 3);
+                REQUIRE(TransferJournal::read(file).pending.empty());
+            }
+        }
+    }
+    GIVEN("a file that hasn't been written by a sync") {
+        std::ofstream(file) << "something else\n";
+        THEN("reading it should fail") {
+            REQUIRE_THROWS_AS(TransferJournal::read(file), std::runtime_error);
+        }
+    }
+    std::filesystem::remove(file);
+}
@@ -0,0 +1,76 @@
+#include "sync/UploadLog.hpp"
+#include <catch2/catch.hpp>
+#include <fstream>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace CloudSync::sync;
+
+namespace {
+    using Records = std::vector<std::pair<std::string, SyncStateEntry>>;
+
+    SyncStateEntry uploaded(const std::string &revision, std::int64_t modified) {
+        return {ResourceInfo::Kind::FILE, "", revision, 10, modified};
+    }
+}
+
+SCENARIO("UploadLog", "[sync]") {
+    const auto state_file = std::filesystem::temp_directory_path() / "cloudsync_upload_log_test";
+    std::filesystem::remove(std::filesystem::path(state_file) += ".uploads");
+    std::filesystem::remove(std::filesystem::path(state_file) += ".uploads.taken");
+    const UploadLog log(state_file);
+
+    GIVEN("no uploads") {
+        THEN("nothing should be taken") {
+            REQUIRE(log.take().empty());
+        }
+    }
+    GIVEN("a log with uploads of files whose names need escaping") {
+        log.append("a/tab\tname.txt", uploaded("rev1", 1234));
+        log.append("b.txt", uploaded("rev2", -5678));
+        log.append("a/tab\tname.txt", uploaded("rev3", 9012));
+
+        WHEN("taking them") {
+            const auto taken = log.take();
+            THEN("all of them should be taken in the order of their uploads") {
+                REQUIRE(taken == Records{
+                        {"a/tab\tname.txt", uploaded("rev1", 1234)},
+                        {"b.txt", uploaded("rev2", -5678)},
+                        {"a/tab\tname.txt", uploaded("rev3", 9012)}});
+            }
+            AND_WHEN("releasing them") {
+                log.release();
+                THEN("they should not be taken again") {
+                    REQUIRE(log.take().empty());
+                }
+            }
+            AND_WHEN("uploading another file and taking the uploads again without releasing them") {
+                log.append("c.txt", uploaded("rev4", 42));
+                const auto again = log.take();
+                THEN("the new upload should be taken after the previous ones") {
+                    REQUIRE(again.size() == 4);
+                    REQUIRE(again.back() == std::make_pair(std::string("c.txt"), uploaded("rev4", 42)));
+                }
+            }
+            AND_WHEN("uploading another file and releasing the taken ones") {
+                log.append("c.txt", uploaded("rev4", 42));
+                log.release();
+                THEN("only the new upload should be taken") {
+                    REQUIRE(log.take() == Records{{"c.txt", uploaded("rev4", 42)}});
+                }
+            }
+        }
+        WHEN("the last upload has only been recorded in part") {
+            std::ofstream(std::filesystem::path(state_file) += ".uploads", std::ios::app) << "c.txt\t\trev";
+            THEN("it should be ignored") {
+                REQUIRE(log.take().size() == 3);
+            }
+        }
+    }
+    GIVEN("a file that hasn't been written by an UploadLog") {
+        std::ofstream(std::filesystem::path(state_file) += ".uploads") << "something else\n";
+        THEN("taking uploads should fail") {
+            REQUIRE_THROWS_AS(log.take(), std::runtime_error);
+        }
+    }
+}
@@ -0,0 +1,206 @@
+#include "upload/ChunkedUpload.hpp"
+#include "request/exceptions/RequestException.hpp"
+#include "macros/request_mock.hpp"
+#include "macros/temp_file.hpp"
+#include <catch2/catch.hpp>
+#include <fakeit.hpp>
+#include <algorithm>
+#include <mutex>
+
+using namespace fakeit;
+using namespace Catch;
+using namespace CloudSync;
+using namespace CloudSync::upload;
+
+namespace {
+    constexpr std::size_t MiB = 1024 * 1024;
+
+    /// records the chunks it receives and fails the chunks it's told to fail
+    class FakeUploadSession : public UploadSession {
+    public:
+        explicit FakeUploadSession(Limits limits) : m_limits(limits) {}
+
+        Limits limits(std::uint64_t) const override {
+            return m_limits;
+        }
+
+        void start(std::uint64_t total_size) override {
+            started_with = total_size;
+        }
+
+        void upload_chunk(const std::shared_ptr<request::Request> &, const Chunk &chunk) override {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (failures > 0) {
+                failures--;
+                std::rethrow_exception(failure);
+            }
+            chunks.push_back({chunk.index, chunk.offset, chunk.data.size(), chunk.last, chunk.data.front()});
+        }
+
+        std::optional<std::uint64_t> received_bytes(const std::shared_ptr<request::Request> &) override {
+            received_bytes_calls++;
+            return received;
+        }
+
+        void finish(std::uint64_t total_size) override {
+            finished_with = total_size;
+        }
+
+        struct Received {
+            std::size_t index;
+            std::uint64_t offset;
+            std::size_t size;
+            bool last;
+            std::uint8_t first_byte;
+        };
+
+        std::mutex mutex;
+        std::vector<Received> chunks;
+        std::size_t failures = 0;
+        std::exception_ptr failure = std::make_exception_ptr(request::exceptions::RequestException("connection reset"));
+        std::optional<std::uint64_t> received;
+        std::size_t received_bytes_calls = 0;
+        std::uint64_t started_with = 0;
+        std::uint64_t finished_with = 0;
+
+    private:
+        const Limits m_limits;
+    };
+}
+
+SCENARIO("ChunkSizer", "[upload]") {
+    GIVEN("limits of 1 MiB to 32 MiB in steps of 1 MiB") {
+        ChunkSizer sizer({MiB, 32 * MiB, MiB, false});
+        THEN("the first chunk should have the initial size") {
+            REQUIRE(sizer.next(1024 * MiB) == ChunkSizer::INITIAL_CHUNK_SIZE);
+        }
+        THEN("no chunk should be larger than what is remaining") {
+            REQUIRE(sizer.next(3) == 3);
+        }
+        WHEN("a chunk has been uploaded quickly") {
+            sizer.succeeded(ChunkSizer::INITIAL_CHUNK_SIZE, std::chrono::milliseconds(100));
+            THEN("the next chunk should be twice as large") {
+                REQUIRE(sizer.next(1024 * MiB) == 2 * ChunkSizer::INITIAL_CHUNK_SIZE);
+            }
+        }
+        WHEN("a chunk has been uploaded slowly") {
+            sizer.succeeded(ChunkSizer::INITIAL_CHUNK_SIZE, ChunkSizer::TARGET_CHUNK_DURATION * 3);
+            THEN("the next chunk should be half as large") {
+                REQUIRE(sizer.next(1024 * MiB) == ChunkSizer::INITIAL_CHUNK_SIZE / 2);
+            }
+        }
+        WHEN("many chunks have failed") {
+            for (int i = 0; i < 20; i++) {
+                sizer.failed();
+            }
+            THEN("the chunk size should not go below the minimum") {
+                REQUIRE(sizer.next(1024 * MiB) == MiB);
+            }
+        }
+    }
+    GIVEN("a granularity of 320 KiB") {
+        ChunkSizer sizer({320 * 1024, 60 * MiB, 320 * 1024, false});
+        THEN("chunks should be a multiple of the granularity") {
+            REQUIRE(sizer.next(1024 * MiB) % (320 * 1024) == 0);
+        }
+    }
+}
+
+SCENARIO("ChunkedUpload", "[upload]") {
+    INIT_REQUEST();
+    const auto local_file = temp_file("cloudsync_chunked_upload.bin", 20 * MiB + 5);
+    const UploadSource source(local_file);
+    ConcurrencyLimits limits;
+    ConcurrencyController controller(limits);
+
+    GIVEN("a session that needs chunks in order") {
+        FakeUploadSession session({MiB, 4 * MiB, MiB, false});
+        WHEN("uploading the file") {
+            ChunkedUpload(request, session, source, controller).run();
+            THEN("the session should have been started and finished with the size of the file") {
+                REQUIRE(session.started_with == 20 * MiB + 5);
+                REQUIRE(session.finished_with == 20 * MiB + 5);
+            }
+            THEN("the chunks should cover the file without gaps and only the last one should be marked as such") {
+                std::uint64_t offset = 0;
+                for (std::size_t i = 0; i < session.chunks.size(); i++) {
+                    REQUIRE(session.chunks[i].offset == offset);
+                    REQUIRE(session.chunks[i].last == (i + 1 == session.chunks.size()));
+                    REQUIRE(session.chunks[i].first_byte == offset % 251);
+                    offset += session.chunks[i].size;
+                }
+                REQUIRE(offset == 20 * MiB + 5);
+            }
+        }
+        AND_GIVEN("a chunk that fails once and a server that has received the first MiB of it") {
+            session.failures = 1;
+            session.received = MiB;
+            WHEN("uploading the file") {
+                ChunkedUpload(request, session, source, controller).run();
+                THEN("the upload should continue at what the server has received") {
+                    REQUIRE(session.received_bytes_calls == 1);
+                    REQUIRE(session.chunks.front().offset == MiB);
+                }
+            }
+        }
+        AND_GIVEN("a chunk that fails more often than it is retried") {
+            session.failures = ChunkedUpload::MAX_CHUNK_RETRIES + 1;
+            THEN("the error should be thrown") {
+                REQUIRE_THROWS_AS(ChunkedUpload(request, session, source, controller).run(), request::exceptions::RequestException);
+            }
+        }
+        AND_GIVEN("a chunk that is throttled once with a Retry-After of a second") {
+            session.failures = 1;
+            session.failure = std::make_exception_ptr(
+                    request::exceptions::response::TooManyRequests("", std::chrono::seconds(1)));
+            WHEN("uploading the file") {
+                const auto started = std::chrono::steady_clock::now();
+                ChunkedUpload(request, session, source, controller).run();
+                const auto duration = std::chrono::steady_clock::now() - started;
+                THEN("the chunk should be sent again once the server has asked for it") {
+                    REQUIRE(session.finished_with == 20 * MiB + 5);
+                    REQUIRE(duration >= std::chrono::seconds(1));
+                }
+                THEN("the endpoint should get fewer requests at once") {
+                    REQUIRE(controller.limit() < limits.initial);
+                }
+            }
+        }
+        AND_GIVEN("a chunk that fails with a client error") {
+            session.failures = 1;
+            session.failure = std::make_exception_ptr(request::exceptions::response::Conflict());
+            THEN("the error should be thrown without a retry") {
+                REQUIRE_THROWS_AS(ChunkedUpload(request, session, source, controller).run(), request::exceptions::response::Conflict);
+                REQUIRE(session.received_bytes_calls == 0);
+            }
+        }
+    }
+    GIVEN("a session that allows parallel chunks and an endpoint that takes three at the same time") {
+        FakeUploadSession session({MiB, 2 * MiB, MiB, true});
+        limits.initial = 3;
+        ConcurrencyController endpoint(limits);
+        AND_GIVEN("a chunk that fails once") {
+            session.failures = 1;
+            WHEN("uploading the file") {
+                ChunkedUpload(request, session, source, endpoint).run();
+                THEN("every part of the file should have been received exactly once, with the index of its position") {
+                    auto chunks = session.chunks;
+                    std::sort(chunks.begin(), chunks.end(), [](const auto &a, const auto &b) {
+                        return a.offset < b.offset;
+                    });
+                    std::uint64_t offset = 0;
+                    for (std::size_t i = 0; i < chunks.size(); i++) {
+                        REQUIRE(chunks[i].index == i);
+                        REQUIRE(chunks[i].offset == offset);
+                        offset += chunks[i].size;
+                    }
+                    REQUIRE(offset == 20 * MiB + 5);
+                    REQUIRE(chunks.back().last);
+                }
+                THEN("each worker should have used its own request") {
+                    Verify(Method(requestMock, clone)).Twice();
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#include "util/DateTime.hpp"
+#include <catch2/catch.hpp>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace std::chrono;
+
+SCENARIO("DateTime", "[util]") {
+    // 2020-01-29T21:00:50Z
+    const auto expected = system_clock::time_point(seconds(1580331650));
+
+    GIVEN("ISO 8601 timestamps") {
+        THEN("UTC timestamps should be parsed") {
+            REQUIRE(util::parse_iso8601("2020-01-29T21:00:50Z") == expected);
+        }
+        THEN("fractional seconds should be parsed to millisecond precision") {
+            REQUIRE(util::parse_iso8601("2020-01-29T21:00:50.123Z") == expected + milliseconds(123));
+            REQUIRE(util::parse_iso8601("2020-01-29T21:00:50.5Z") == expected + milliseconds(500));
+            REQUIRE(util::parse_iso8601("2020-01-29T21:00:50.1234567Z") == expected + milliseconds(123));
+        }
+        THEN("timezone offsets should be applied") {
+            REQUIRE(util::parse_iso8601("2020-01-29T22:00:50+01:00") == expected);
+            REQUIRE(util::parse_iso8601("2020-01-29T20:30:50-00:30") == expected);
+        }
+        THEN("invalid timestamps should not be parsed") {
+            REQUIRE_FALSE(util::parse_iso8601(""));
+            REQUIRE_FALSE(util::parse_iso8601("2020-01-29"));
+            REQUIRE_FALSE(util::parse_iso8601("2020-13-29T21:00:50Z"));
+            REQUIRE_FALSE(util::parse_iso8601("2020-01-29T21:00:50Zgarbage"));
+        }
+        THEN("points in time should be formatted in UTC with whole seconds") {
+            REQUIRE(util::format_iso8601(expected) == "2020-01-29T21:00:50Z");
+            REQUIRE(util::format_iso8601(expected + milliseconds(999)) == "2020-01-29T21:00:50Z");
+            REQUIRE(util::format_iso8601(system_clock::time_point()) == "1970-01-01T00:00:00Z");
+            REQUIRE(util::parse_iso8601(util::format_iso8601(expected)) == expected);
+        }
+    }
+    GIVEN("RFC 1123 dates") {
+        THEN("valid dates should be parsed") {
+            REQUIRE(util::parse_rfc1123("Wed, 29 Jan 2020 21:00:50 GMT") == expected);
+            REQUIRE(util::parse_rfc1123("Fri, 10 Jan 2020 20:42:38 GMT") == system_clock::time_point(seconds(1578688958)));
+        }
+        THEN("invalid dates should not be parsed") {
+            REQUIRE_FALSE(util::parse_rfc1123(""));
+            REQUIRE_FALSE(util::parse_rfc1123("Wed, 29 Foo 2020 21:00:50 GMT"));
+            REQUIRE_FALSE(util::parse_rfc1123("Wed, 29 Jan 2020 21:00:50"));
+        }
+    }
+}
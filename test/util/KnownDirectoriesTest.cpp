@@ -0,0 +1,39 @@
+#include "util/KnownDirectories.hpp"
+#include <catch2/catch.hpp>
+
+using namespace Catch;
+using namespace CloudSync;
+
+SCENARIO("KnownDirectories", "[util]") {
+    util::KnownDirectories known_directories;
+    THEN("only the root should be known") {
+        REQUIRE(known_directories.contains("/"));
+        REQUIRE_FALSE(known_directories.contains("/a"));
+    }
+    GIVEN("a deep directory that is known") {
+        known_directories.add("/a/b/c");
+        THEN("the directory & all of its parents should be known") {
+            REQUIRE(known_directories.contains("/a/b/c"));
+            REQUIRE(known_directories.contains("/a/b"));
+            REQUIRE(known_directories.contains("/a"));
+        }
+        THEN("its children & siblings with a common prefix should not be known") {
+            REQUIRE_FALSE(known_directories.contains("/a/b/c/d"));
+            REQUIRE_FALSE(known_directories.contains("/a/b/cd"));
+            REQUIRE_FALSE(known_directories.contains("/a/b/c-d"));
+            REQUIRE_FALSE(known_directories.contains("/a/bc"));
+        }
+        WHEN("removing one of its parents") {
+            known_directories.add("/a/b-c");
+            known_directories.remove("/a/b");
+            THEN("the parent and everything below it should be forgotten") {
+                REQUIRE_FALSE(known_directories.contains("/a/b/c"));
+                REQUIRE_FALSE(known_directories.contains("/a/b"));
+            }
+            THEN("siblings of the parent should still be known") {
+                REQUIRE(known_directories.contains("/a/b-c"));
+                REQUIRE(known_directories.contains("/a"));
+            }
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#include "util/Parallel.hpp"
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using namespace Catch;
+using namespace CloudSync;
+using namespace std::chrono_literals;
+
+SCENARIO("parallel_for", "[util]") {
+    GIVEN("more items than workers") {
+        const std::size_t count = 100;
+        std::vector<std::atomic<int>> calls(count);
+        std::mutex workers_mutex;
+        std::set<std::size_t> workers;
+        WHEN("running an operation for every item") {
+            util::parallel_for(count, 4, [&](std::size_t worker, std::size_t index) {
+                calls[index]++;
+                std::lock_guard<std::mutex> lock(workers_mutex);
+                workers.insert(worker);
+            });
+            THEN("every item should have been handled exactly once") {
+                for (const auto &item_calls: calls) {
+                    REQUIRE(item_calls == 1);
+                }
+            }
+            THEN("only worker ids below the maximum should have been used") {
+                REQUIRE_FALSE(workers.empty());
+                REQUIRE(*workers.rbegin() < 4);
+            }
+        }
+    }
+    GIVEN("a single worker") {
+        std::vector<std::size_t> order;
+        WHEN("running an operation for every item") {
+            util::parallel_for(3, 1, [&order](std::size_t worker, std::size_t index) {
+                REQUIRE(worker == 0);
+                order.push_back(index);
+            });
+            THEN("the items should have been handled in order on the calling thread") {
+                REQUIRE(order == std::vector<std::size_t>{0, 1, 2});
+            }
+        }
+    }
+    GIVEN("an operation that fails for one item") {
+        const auto operation = [](std::size_t, std::size_t index) {
+            if (index == 5) {
+                throw std::runtime_error("failed");
+            }
+        };
+        THEN("the exception should be rethrown once all workers have stopped") {
+            REQUIRE_THROWS_AS(util::parallel_for(20, 3, operation), std::runtime_error);
+        }
+    }
+    GIVEN("no items") {
+        THEN("the operation should not be called") {
+            util::parallel_for(0, 4, [](std::size_t, std::size_t) {
+                FAIL("operation has been called");
+            });
+        }
+    }
+    GIVEN("a controller that allows two requests at once") {
+        ConcurrencyLimits limits;
+        limits.initial = 2;
+        ConcurrencyController controller(limits);
+        std::vector<std::atomic<int>> calls(50);
+        std::mutex workers_mutex;
+        std::set<std::size_t> workers;
+        WHEN("the endpoint throttles the first request") {
+            util::parallel_for(calls.size(), controller.limit(), controller, [&](std::size_t worker, std::size_t index) {
+                if (index == 0) {
+                    controller.throttled();
+                }
+                calls[index]++;
+                std::lock_guard<std::mutex> lock(workers_mutex);
+                workers.insert(worker);
+            });
+            THEN("every item should still have been handled exactly once") {
+                REQUIRE(controller.limit() == 1);
+                for (const auto &item_calls: calls) {
+                    REQUIRE(item_calls == 1);
+                }
+            }
+            THEN("no more workers than the limit should have been used") {
+                REQUIRE(*workers.rbegin() < 2);
+            }
+        }
+        WHEN("the endpoint has asked to retry later") {
+            controller.throttled(30ms);
+            const auto paused_until = controller.paused_until();
+            std::atomic<bool> early{false};
+            util::parallel_for(3, controller.limit(), controller, [&](std::size_t, std::size_t) {
+                if (ConcurrencyController::Clock::now() < paused_until) {
+                    early = true;
+                }
+            });
+            THEN("no item should have been handled before the pause has ended") {
+                REQUIRE_FALSE(early);
+            }
+        }
+    }
+}